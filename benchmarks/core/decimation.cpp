@@ -0,0 +1,54 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/geometry/QuadricDecimation.h"
+#include "saiga/core/geometry/vertex.h"
+#include "saiga/core/math/random.h"
+#include "saiga/core/time/Benchmark.h"
+
+using namespace Saiga;
+
+SAIGA_REGISTER_BENCHMARK(Decimation)
+{
+    // Height field with 200k triangles
+    int N = 317;
+    TriangleMesh<VertexNC, uint32_t> mesh;
+    for (int y = 0; y < N; ++y)
+    {
+        for (int x = 0; x < N; ++x)
+        {
+            VertexNC v;
+            float h    = 5 * std::sin(x * 0.05f) * std::cos(y * 0.07f) + linearRand(0.0f, 0.05f);
+            v.position = vec4(x, h, y, 1);
+            mesh.vertices.push_back(v);
+        }
+    }
+    for (int y = 0; y < N - 1; ++y)
+    {
+        for (int x = 0; x < N - 1; ++x)
+        {
+            uint32_t a = y * N + x, b = a + 1, c = a + N, d = c + 1;
+            mesh.faces.push_back({a, c, b});
+            mesh.faces.push_back({b, c, d});
+        }
+    }
+
+    // The half edge mesh is rebuilt in every iteration. Items are the removed faces.
+    int target   = mesh.faces.size() / 10;
+    int toRemove = mesh.faces.size() - target;
+
+    auto serial = [&]() {
+        auto copy = mesh;
+        decimateQuadric(copy, target, false);
+    };
+    suite.run("qem_200k_serial", serial, toRemove);
+
+    auto parallel = [&]() {
+        auto copy = mesh;
+        decimateQuadric(copy, target, true);
+    };
+    suite.run("qem_200k_parallel", parallel, toRemove);
+}
@@ -0,0 +1,46 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/image/image.h"
+#include "saiga/core/math/random.h"
+#include "saiga/core/time/Benchmark.h"
+
+#include <cstdio>
+
+using namespace Saiga;
+
+SAIGA_REGISTER_BENCHMARK(ImageIO)
+{
+    int w = 1280, h = 720;
+    TemplatedImage<ucvec4> img(h, w);
+
+    // Smooth gradient with some noise, so that the png compression has a realistic amount of work.
+    for (int i = 0; i < h; ++i)
+    {
+        for (int j = 0; j < w; ++j)
+        {
+            unsigned char n = Random::uniformInt(0, 15);
+            img(i, j)       = ucvec4(i % 256, j % 256, (i + j) % 256 + n, 255);
+        }
+    }
+
+    double bytes = img.size();
+
+    std::string rawFile = "saiga_bench_image.saigai";
+    std::string pngFile = "saiga_bench_image.png";
+
+    suite.run("saveRaw_720p", [&]() { img.saveRaw(rawFile); }, bytes);
+    suite.run("loadRaw_720p", [&]() { TemplatedImage<ucvec4> tmp; tmp.loadRaw(rawFile); }, bytes);
+
+    if (img.save(pngFile))
+    {
+        suite.run("savePng_720p", [&]() { img.save(pngFile); }, bytes);
+        suite.run("loadPng_720p", [&]() { TemplatedImage<ucvec4> tmp(pngFile); }, bytes);
+    }
+
+    std::remove(rawFile.c_str());
+    std::remove(pngFile.c_str());
+}
@@ -0,0 +1,39 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/geometry/kdtree.h"
+#include "saiga/core/math/random.h"
+#include "saiga/core/time/Benchmark.h"
+
+using namespace Saiga;
+
+SAIGA_REGISTER_BENCHMARK(KDTree)
+{
+    int N = 100000;
+    std::vector<vec3> points(N);
+    for (auto& p : points) p = linearRand(vec3(-1, -1, -1), vec3(1, 1, 1));
+
+    std::vector<vec3> queries(1000);
+    for (auto& p : queries) p = linearRand(vec3(-1, -1, -1), vec3(1, 1, 1));
+
+    suite.run("build_100k", [&]() { KDTree<3, vec3> tree(points); }, N);
+
+    KDTree<3, vec3> tree(points);
+    vec3 sum = vec3::Zero();
+
+    auto nn = [&]() {
+        for (auto& q : queries) sum += tree.nearestNeighbour(q);
+    };
+    suite.run("nn_1k", nn, queries.size());
+
+    auto knn = [&]() {
+        for (auto& q : queries) sum += tree.nearestNeighbours(q, 10).front();
+    };
+    suite.run("knn10_1k", knn, queries.size());
+
+    // Prevent the compiler from removing the queries
+    if (sum.x() == 12345) std::cout << sum.transpose() << std::endl;
+}
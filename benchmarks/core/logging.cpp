@@ -0,0 +1,63 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/time/Benchmark.h"
+#include "saiga/core/util/AsyncLogger.h"
+#include "saiga/core/util/Thread/omp.h"
+
+#include <mutex>
+#include <sstream>
+
+using namespace Saiga;
+
+SAIGA_REGISTER_BENCHMARK(Logging)
+{
+    // Every thread writes this many messages per run.
+    int messages = 2000;
+    int total    = messages * OMP::getMaxThreads();
+
+    // Both loggers write into a string that is discarded, so only the logging overhead is measured.
+    std::mutex mutex;
+    std::ostringstream syncOut;
+    suite.run("sync_stream", [&]() {
+#pragma omp parallel for
+        for (int i = 0; i < total; ++i)
+        {
+            std::unique_lock lock(mutex);
+            syncOut << "Frame " << i << " tracked with " << 0.5 * i << " inliers." << std::endl;
+        }
+        syncOut.str("");
+    },
+              total);
+
+    auto& logger = AsyncLogger::instance();
+    size_t bytes = 0;
+    logger.setSink([&](const std::string& text) { bytes += text.size(); });
+
+    // Including the formatting in the flush thread.
+    suite.run("async", [&]() {
+#pragma omp parallel for
+        for (int i = 0; i < total; ++i)
+        {
+            SAIGA_LOG(Info, "Frame ", i, " tracked with ", 0.5 * i, " inliers.");
+        }
+        logger.flush();
+    },
+              total);
+
+    // A disabled level only costs a relaxed load.
+    suite.run("async_disabled", [&]() {
+#pragma omp parallel for
+        for (int i = 0; i < total; ++i)
+        {
+            SAIGA_LOG(Verbose, "Frame ", i, " tracked with ", 0.5 * i, " inliers.");
+        }
+    },
+              total);
+
+    logger.setStdoutSink();
+    SAIGA_LOG(Info, "Logging benchmark: ", bytes, " bytes written, ", logger.numDropped(), " messages dropped.");
+}
@@ -0,0 +1,37 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/time/Benchmark.h"
+#include "saiga/core/util/perlinnoise.h"
+
+#include <vector>
+
+using namespace Saiga;
+
+SAIGA_REGISTER_BENCHMARK(PerlinNoise)
+{
+    int w = 1024, h = 1024, octaves = 8;
+    std::vector<float> data(w * h);
+    ImageView<float> img(h, w, data.data());
+    vec2 origin(0, 0), step(0.01, 0.01);
+
+    PerlinNoise noise;
+    suite.run("fBm_scalar", [&]() {
+        for (int r = 0; r < h; ++r)
+        {
+            for (int c = 0; c < w; ++c) img(r, c) = noise.fBm(c * step.x(), r * step.y(), 0, octaves);
+        }
+    },
+              w * h);
+
+    suite.run("fBmField", [&]() { noise.fBmField(img, origin, step, 0, octaves); }, w * h);
+
+    std::vector<float> volume(128 * 128 * 64);
+    suite.run("fBmVolume", [&]() {
+        noise.fBmVolume(volume.data(), ivec3(128, 128, 64), vec3(0, 0, 0), vec3(0.01, 0.01, 0.01), octaves);
+    },
+              volume.size());
+}
@@ -0,0 +1,98 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/math/random.h"
+#include "saiga/core/time/Benchmark.h"
+#include "saiga/core/util/TextParser.h"
+#include "saiga/core/util/tostring.h"
+
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace Saiga;
+
+SAIGA_REGISTER_BENCHMARK(NumberIO)
+{
+    Random::setSeed(3984561);
+
+    // Lines of a BAL/g2o like file: two indices and 7 doubles with full precision
+    int lines = 100000;
+    std::vector<double> values(lines * 7);
+    for (auto& v : values) v = Random::sampleDouble(-1000, 1000);
+
+    std::string text;
+    {
+        std::ostringstream strm;
+        strm.precision(17);
+        for (int i = 0; i < lines; ++i)
+        {
+            strm << i << " " << i + 1;
+            for (int j = 0; j < 7; ++j) strm << " " << values[i * 7 + j];
+            strm << "\n";
+        }
+        text = strm.str();
+    }
+    std::vector<double> parsed(values.size());
+
+    // Items are bytes
+    suite.run("istream", [&]() {
+        std::istringstream strm(text);
+        int a, b;
+        for (int i = 0; i < lines; ++i)
+        {
+            strm >> a >> b;
+            for (int j = 0; j < 7; ++j) strm >> parsed[i * 7 + j];
+        }
+    },
+              text.size());
+
+    suite.run("strtod", [&]() {
+        char* cur = text.data();
+        for (int i = 0; i < lines; ++i)
+        {
+            std::strtol(cur, &cur, 10);
+            std::strtol(cur, &cur, 10);
+            for (int j = 0; j < 7; ++j) parsed[i * 7 + j] = std::strtod(cur, &cur);
+        }
+    },
+              text.size());
+
+    suite.run("TextParser", [&]() {
+        TextParser parser(std::string_view(text.data(), text.size()));
+        int a, b;
+        for (int i = 0; i < lines; ++i)
+        {
+            parser >> a >> b;
+            parser.parseArray(parsed.data() + i * 7, 7);
+        }
+    },
+              text.size());
+    SAIGA_ASSERT(parsed == values);
+
+    // Formatting with round trip precision
+    std::string out;
+    suite.run("ostream_format", [&]() {
+        std::ostringstream strm;
+        strm.precision(17);
+        for (auto v : values) strm << v << " ";
+        out = strm.str();
+    },
+              text.size());
+
+    suite.run("formatNumber", [&]() {
+        out.clear();
+        char buffer[32];
+        for (auto v : values)
+        {
+            char* last = formatNumber(buffer, buffer + sizeof(buffer), v);
+            *last++    = ' ';
+            out.append(buffer, last);
+        }
+    },
+              text.size());
+}
@@ -0,0 +1,75 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/time/Benchmark.h"
+#include "saiga/core/util/Thread/ObjectPool.h"
+#include "saiga/core/util/Thread/omp.h"
+
+#include <array>
+#include <vector>
+
+using namespace Saiga;
+
+// Roughly the size of a small map point.
+struct PoolTestObject
+{
+    std::array<double, 12> data;
+    PoolTestObject(double v) { data.fill(v); }
+};
+
+SAIGA_REGISTER_BENCHMARK(ObjectPool)
+{
+    // Each thread creates a batch of objects and destroys them again.
+    int batch      = 1024;
+    int rounds     = 64;
+    int threads    = OMP::getMaxThreads();
+    long int items = long(threads) * batch * rounds;
+
+    suite.run("new_delete", [&]() {
+#pragma omp parallel
+        {
+            std::vector<PoolTestObject*> objs(batch);
+            for (int r = 0; r < rounds; ++r)
+            {
+                for (int i = 0; i < batch; ++i) objs[i] = new PoolTestObject(i);
+                for (int i = 0; i < batch; ++i) delete objs[i];
+            }
+        }
+    },
+              items);
+
+    ObjectPool<PoolTestObject> pool;
+    suite.run("object_pool", [&]() {
+#pragma omp parallel
+        {
+            std::vector<PoolHandle> objs(batch);
+            for (int r = 0; r < rounds; ++r)
+            {
+                for (int i = 0; i < batch; ++i) objs[i] = pool.create(i);
+                for (int i = 0; i < batch; ++i) pool.destroy(objs[i]);
+            }
+        }
+    },
+              items);
+
+    // Objects are destroyed by a different thread than the one that created them.
+    std::vector<PoolHandle> shared(threads * batch);
+    suite.run("object_pool_cross_thread", [&]() {
+#pragma omp parallel
+        {
+            int tid = OMP::getThreadNum();
+            for (int r = 0; r < rounds; ++r)
+            {
+                for (int i = 0; i < batch; ++i) shared[tid * batch + i] = pool.create(i);
+#pragma omp barrier
+                int other = (tid + 1) % OMP::getNumThreads();
+                for (int i = 0; i < batch; ++i) pool.destroy(shared[other * batch + i]);
+#pragma omp barrier
+            }
+        }
+    },
+              items);
+}
@@ -0,0 +1,43 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/math/random.h"
+#include "saiga/core/time/Benchmark.h"
+#include "saiga/core/util/Algorithm.h"
+#include "saiga/core/util/ParallelPrimitives.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace Saiga;
+
+SAIGA_REGISTER_BENCHMARK(ParallelPrimitives)
+{
+    int N = 1 << 22;
+    std::vector<int> counts(N), offsets(N);
+    for (auto& c : counts) c = Random::uniformInt(0, 10);
+
+    suite.run("exclusive_scan_serial", [&]() { exclusive_scan(counts.begin(), counts.end(), offsets.begin(), 0); },
+              N);
+    suite.run("exclusive_scan_parallel", [&]() { CPU::exclusiveScan<int>(counts, offsets); }, N);
+
+    std::vector<uint32_t> keys(N), tmp;
+    for (auto& k : keys) k = Random::uniformInt(0, std::numeric_limits<int>::max());
+
+    suite.run("std_sort_u32", [&]() {
+        tmp = keys;
+        std::sort(tmp.begin(), tmp.end());
+    },
+              N);
+    suite.run("radix_sort_u32", [&]() {
+        tmp = keys;
+        CPU::radixSort<uint32_t>(tmp);
+    },
+              N);
+
+    std::vector<int> selected(N);
+    suite.run("compact", [&]() { CPU::compact<int>(counts, selected, [](int c) { return c > 5; }); }, N);
+}
@@ -0,0 +1,41 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/math/RandomStream.h"
+#include "saiga/core/math/random.h"
+#include "saiga/core/time/Benchmark.h"
+
+#include <vector>
+
+using namespace Saiga;
+
+SAIGA_REGISTER_BENCHMARK(Random)
+{
+    size_t n = 10 * 1000 * 1000;
+    std::vector<double> data(n);
+
+    suite.run("gaussRand", [&]() {
+        for (auto& d : data) d = Random::gaussRand(0, 1);
+    },
+              n);
+
+    RandomStream rng(Random::urand64());
+    suite.run("fillGaussian", [&]() { rng.fillGaussian(data.data(), n, 0, 1); }, n);
+    suite.run("fillUniform", [&]() { rng.fillUniform(data.data(), n, 0, 1); }, n);
+
+    // Sampling the observations of one camera in the synthetic scenes.
+    int samples = 10000;
+    int size    = 100000;
+    int rounds  = 100;
+    suite.run("uniqueIndices", [&]() {
+        for (int r = 0; r < rounds; ++r) Random::uniqueIndices(samples, size, rng);
+    },
+              long(samples) * rounds);
+    suite.run("sortedUniqueIndices", [&]() {
+        for (int r = 0; r < rounds; ++r) Random::sortedUniqueIndices(samples, size, rng);
+    },
+              long(samples) * rounds);
+}
@@ -0,0 +1,35 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/image/TerrainPyramid.h"
+#include "saiga/core/time/Benchmark.h"
+
+using namespace Saiga;
+
+SAIGA_REGISTER_BENCHMARK(TerrainPyramid)
+{
+    int size = 2048, levels = 4, tileSize = 128;
+    auto source = TerrainPyramid::perlinSource(PerlinNoise(), 1.0f / 256, 8);
+
+    TemplatedImage<float> heights;
+    TemplatedImage<ucvec4> normals;
+
+    // All levels from scratch (without a cache directory)
+    suite.run("generate", [&]() {
+        TerrainPyramid pyramid(size, size, levels, tileSize, source);
+        for (int l = 0; l < levels; ++l) pyramid.assembleLevel(l, heights, normals);
+    },
+              size * size);
+
+    // One changed tile of level 0. The pyramid is kept in memory.
+    TerrainPyramid pyramid(size, size, levels, tileSize, source);
+    for (int l = 0; l < levels; ++l) pyramid.assembleLevel(l, heights, normals);
+    suite.run("invalidate_tile", [&]() {
+        pyramid.invalidate(500, 500, 10, 10);
+        for (int l = 0; l < levels; ++l) pyramid.assembleLevel(l, heights, normals);
+    },
+              tileSize * tileSize);
+}
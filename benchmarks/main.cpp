@@ -0,0 +1,20 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/time/Benchmark.h"
+
+/**
+ * Runs all benchmarks that are registered with SAIGA_REGISTER_BENCHMARK.
+ *
+ * Example: Record a baseline and check a later build against it
+ *
+ * ./saiga_bench --json=baseline.json
+ * ./saiga_bench --baseline=baseline.json --threshold=0.05
+ */
+int main(int argc, char* argv[])
+{
+    return Saiga::BenchmarkSuite::main(argc, argv);
+}
@@ -0,0 +1,51 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/math/random.h"
+#include "saiga/core/time/Benchmark.h"
+#include "saiga/vision/recursive/BARecursive.h"
+#include "saiga/vision/scene/SynteticScene.h"
+
+using namespace Saiga;
+
+// The repository does not ship BAL datasets, therefore the problems are generated with SynteticScene.
+SAIGA_REGISTER_BENCHMARK(BA)
+{
+    Random::setSeed(34976346);
+
+    SynteticScene sscene;
+    sscene.numCameras     = 50;
+    sscene.numWorldPoints = 2000;
+    sscene.numImagePoints = 200;
+    Scene scene           = sscene.circleSphere();
+    scene.addWorldPointNoise(0.01);
+    scene.addImagePointNoise(1.0);
+    scene.addExtrinsicNoise(0.01);
+
+    double observations = 0;
+    for (auto& img : scene.images) observations += img.stereoPoints.size();
+
+    OptimizationOptions op;
+    op.maxIterations          = 3;
+    op.maxIterativeIterations = 25;
+    op.iterativeTolerance     = 1e-50;
+    op.numThreads             = 1;
+
+    for (auto solver : {OptimizationOptions::SolverType::Iterative, OptimizationOptions::SolverType::Direct})
+    {
+        op.solverType = solver;
+        BARec ba;
+        ba.optimizationOptions = op;
+
+        auto f = [&]() {
+            Scene cpy = scene;
+            ba.create(cpy);
+            ba.initAndSolve();
+        };
+        std::string name = solver == OptimizationOptions::SolverType::Iterative ? "rec_pcg" : "rec_ldlt";
+        suite.run(name, f, observations);
+    }
+}
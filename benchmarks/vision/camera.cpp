@@ -0,0 +1,48 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/math/random.h"
+#include "saiga/core/time/Benchmark.h"
+#include "saiga/vision/cameraModel/CameraModelBatch.h"
+
+using namespace Saiga;
+
+// Undistortion of all pixels of a VGA image with the scalar reference, the batched kernel and the lookup map.
+SAIGA_REGISTER_BENCHMARK(CameraUndistortion)
+{
+    Random::setSeed(9634);
+
+    Intrinsics4 K(525, 525, 319.5, 239.5);
+    Distortion dis;
+    dis << -0.28, 0.07, 1e-4, -2e-4, 0.01;
+
+    const int w = 640, h = 480, n = w * h;
+    std::vector<double> u(n), v(n), xu(n), yu(n);
+    for (int i = 0; i < n; ++i)
+    {
+        u[i] = Random::sampleDouble(0, w - 1);
+        v[i] = Random::sampleDouble(0, h - 1);
+    }
+
+    suite.run(
+        "scalar_vga",
+        [&]() {
+            for (int i = 0; i < n; ++i)
+            {
+                Vec2 p = undistortNormalizedPoint(K.unproject2(Vec2(u[i], v[i])), dis);
+                xu[i]  = p(0);
+                yu[i]  = p(1);
+            }
+        },
+        n);
+
+    suite.run(
+        "batch_vga", [&]() { CameraBatch::unprojectUndistortN(K, dis, u.data(), v.data(), xu.data(), yu.data(), n); },
+        n);
+
+    UndistortionMap<double> map(K, dis, w, h);
+    suite.run("map_vga", [&]() { map.undistortN(u.data(), v.data(), xu.data(), yu.data(), n); }, n);
+}
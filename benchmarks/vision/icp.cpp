@@ -0,0 +1,37 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/math/random.h"
+#include "saiga/core/time/Benchmark.h"
+#include "saiga/vision/icp/ICPAlign.h"
+
+using namespace Saiga;
+
+SAIGA_REGISTER_BENCHMARK(ICP)
+{
+    Random::setSeed(2364346);
+
+    int N = 1000;
+    SE3 T = SE3::exp(Vec6::Random() * 0.1);
+
+    AlignedVector<ICP::Correspondence> corrs(N);
+    for (auto& c : corrs)
+    {
+        c.refPoint  = Vec3::Random();
+        c.refNormal = Vec3::Random().normalized();
+        c.srcPoint  = T * c.refPoint + Vec3::Random() * 0.001;
+        c.srcNormal = T.so3() * c.refNormal;
+    }
+
+    SE3 sum;
+    suite.run("pointToPointDirect_1k", [&]() { sum = sum * ICP::pointToPointDirect(corrs); }, N);
+    suite.run("pointToPointIterative_1k", [&]() { sum = sum * ICP::pointToPointIterative(corrs); }, N);
+    suite.run("pointToPlane_1k", [&]() { sum = sum * ICP::pointToPlane(corrs, SE3(), SE3()); }, N);
+    suite.run("planeToPlane_1k", [&]() { sum = sum * ICP::planeToPlane(corrs); }, N);
+
+    // Prevent the compiler from removing the alignments
+    if (sum.translation().x() == 12345) std::cout << sum << std::endl;
+}
@@ -0,0 +1,45 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/image/image.h"
+#include "saiga/core/math/random.h"
+#include "saiga/core/time/Benchmark.h"
+
+#ifdef SAIGA_USE_OPENCV
+#    include "saiga/vision/orb/ORBextractor.h"
+
+using namespace Saiga;
+
+SAIGA_REGISTER_BENCHMARK(ORB)
+{
+    Random::setSeed(786234);
+
+    // Random rectangles on a gray background produce enough corners for the detector.
+    int w = 640, h = 480;
+    TemplatedImage<unsigned char> img(h, w);
+    img.getImageView().set(128);
+    for (int r = 0; r < 300; ++r)
+    {
+        int x0 = Random::uniformInt(0, w - 40), y0 = Random::uniformInt(0, h - 40);
+        int x1 = x0 + Random::uniformInt(5, 40), y1 = y0 + Random::uniformInt(5, 40);
+        unsigned char color = Random::uniformInt(0, 255);
+        for (int i = y0; i < y1; ++i)
+            for (int j = x0; j < x1; ++j) img(i, j) = color;
+    }
+
+    int nfeatures = 1000;
+    ORBextractor extractor(nfeatures, 1.2, 4, 20, 7);
+    FeatureDistributionBucketing dis(ivec2(w, h), nfeatures, ivec2(80, 80));
+
+    std::vector<kpt_t> kps;
+    TemplatedImage<uchar> des;
+    auto f = [&]() {
+        kps.clear();
+        extractor(img.getImageView(), kps, des, dis, true);
+    };
+    suite.run("extract_640x480", f, w * h);
+}
+#endif
@@ -0,0 +1,181 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/math/random.h"
+#include "saiga/core/time/Benchmark.h"
+#include "saiga/core/util/Thread/omp.h"
+#include "saiga/vision/kernels/PGO.h"
+#include "saiga/vision/kernels/PGOBatch.h"
+#include "saiga/vision/recursive/PGORecursive.h"
+#include "saiga/vision/scene/PoseGraph.h"
+#include "saiga/vision/scene/SynteticScene.h"
+
+using namespace Saiga;
+
+// The pose graph is extracted from a synthetic BA scene, because no PGO datasets are part of the repository.
+SAIGA_REGISTER_BENCHMARK(PGO)
+{
+    Random::setSeed(9823745);
+
+    SynteticScene sscene;
+    sscene.numCameras     = 500;
+    sscene.numWorldPoints = 5000;
+    sscene.numImagePoints = 100;
+    Scene scene           = sscene.circleSphere();
+
+    PoseGraph pg(scene, 10);
+    pg.addNoise(0.05);
+
+    OptimizationOptions op;
+    op.maxIterations          = 3;
+    op.maxIterativeIterations = 25;
+    op.iterativeTolerance     = 1e-50;
+    op.numThreads             = 1;
+
+    for (auto solver : {OptimizationOptions::SolverType::Iterative, OptimizationOptions::SolverType::Direct})
+    {
+        op.solverType = solver;
+        PGORec pgo;
+        pgo.optimizationOptions = op;
+
+        auto f = [&]() {
+            PoseGraph cpy = pg;
+            pgo.create(cpy);
+            pgo.initAndSolve();
+        };
+        std::string name = solver == OptimizationOptions::SolverType::Iterative ? "rec_pcg" : "rec_ldlt";
+        suite.run(name, f, pg.edges.size());
+    }
+}
+
+// Odometry chain with random loop closures, similar to the sphere/garage/torus datasets.
+static PoseGraph chainPoseGraph(int numPoses, int loopClosures)
+{
+    PoseGraph pg;
+    SE3 current;
+    for (int i = 0; i < numPoses; ++i)
+    {
+        current = current * SE3::exp(Vec6::Random() * 0.1);
+        PoseVertex pv;
+#ifdef PGO_SIM3
+        pv.se3 = sim3(current, 1.0);
+#else
+        pv.se3 = current;
+#endif
+        pg.poses.push_back(pv);
+    }
+    pg.poses.front().constant = true;
+
+    auto addEdge = [&](int i, int j) {
+        PoseEdge e;
+        e.from = i;
+        e.to   = j;
+        e.setRel(pg.poses[i].se3, pg.poses[j].se3);
+        pg.edges.push_back(e);
+    };
+    for (int i = 0; i < numPoses - 1; ++i) addEdge(i, i + 1);
+    for (int k = 0; k < loopClosures; ++k)
+    {
+        int i = Random::uniformInt(0, numPoses - 3);
+        int j = Random::uniformInt(i + 2, numPoses - 1);
+        addEdge(i, j);
+    }
+    pg.sortEdges();
+    pg.edges.erase(std::unique(pg.edges.begin(), pg.edges.end(),
+                               [](const PoseEdge& a, const PoseEdge& b) { return a.from == b.from && a.to == b.to; }),
+                   pg.edges.end());
+    pg.addNoise(0.01);
+    return pg;
+}
+
+// One LM iteration with a single CG step. Dominated by the quadratic form assembly.
+SAIGA_REGISTER_BENCHMARK(PGOAssembly)
+{
+    Random::setSeed(2384764);
+    PoseGraph pg = chainPoseGraph(50000, 100000);
+
+    OptimizationOptions op;
+    op.maxIterations          = 1;
+    op.maxIterativeIterations = 1;
+    op.solverType             = OptimizationOptions::SolverType::Iterative;
+
+    for (int threads : {1, std::max(2, OMP::getMaxThreads())})
+    {
+        op.numThreads = threads;
+        PGORec pgo;
+        pgo.optimizationOptions = op;
+
+        auto f = [&]() {
+            PoseGraph cpy = pg;
+            pgo.create(cpy);
+            pgo.initAndSolve();
+        };
+        suite.run("chain_50k_t" + std::to_string(threads), f, pg.edges.size());
+    }
+}
+
+// Residual and Jacobian of the scalar and the batched PGO kernel. Items are edges.
+template <typename TransformationType>
+static void pgoKernelBenchmark(BenchmarkSuite& suite, const std::string& name)
+{
+    using Scalar = Kernel::PGO<TransformationType>;
+    using Batch  = Kernel::PGOBatch<TransformationType>;
+    int N        = 4096;
+
+    AlignedVector<TransformationType> from(N), to(N), measurement(N);
+    std::vector<double> weight(N, 1);
+    for (int i = 0; i < N; ++i)
+    {
+        from[i]        = TransformationType::exp(TransformationType::Tangent::Random());
+        to[i]          = TransformationType::exp(TransformationType::Tangent::Random());
+        auto noise     = TransformationType::exp(TransformationType::Tangent::Random() * 0.01);
+        measurement[i] = noise * to[i] * from[i].inverse();
+    }
+
+    double sum = 0;
+
+    auto scalar = [&]() {
+        typename Scalar::ResidualType res;
+        typename Scalar::PoseJacobiType Jfrom, Jto;
+        for (int i = 0; i < N; ++i)
+        {
+            Scalar::evaluateResidualAndJacobian(from[i], to[i], measurement[i].inverse(), res, Jfrom, Jto, weight[i]);
+            sum += res(0) + Jfrom(0, 0) + Jto(0, 0);
+        }
+    };
+    suite.run(name + "_scalar", scalar, N);
+
+    auto batched = [&]() {
+        constexpr int B = Batch::BatchSize;
+        typename Batch::Transformations f, t, m;
+        typename Batch::Lane w;
+        typename Batch::Residuals res;
+        typename Batch::PoseJacobiType Jfrom[B], Jto[B];
+        for (int i = 0; i < N; i += B)
+        {
+            for (int l = 0; l < B; ++l)
+            {
+                f.set(l, from[i + l]);
+                t.set(l, to[i + l]);
+                m.set(l, measurement[i + l]);
+                w(l) = weight[i + l];
+            }
+            Batch::evaluateResidualAndJacobian(f, t, m, w, res, Jfrom, Jto);
+            sum += res[0].sum() + Jfrom[0](0, 0) + Jto[0](0, 0);
+        }
+    };
+    suite.run(name + "_batch", batched, N);
+
+    // Prevent the compiler from removing the kernels
+    if (sum == 12345) std::cout << sum << std::endl;
+}
+
+SAIGA_REGISTER_BENCHMARK(PGOKernel)
+{
+    Random::setSeed(120938);
+    pgoKernelBenchmark<SE3>(suite, "se3");
+    pgoKernelBenchmark<Sim3>(suite, "sim3");
+}
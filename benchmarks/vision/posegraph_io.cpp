@@ -0,0 +1,61 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/math/random.h"
+#include "saiga/core/time/Benchmark.h"
+#include "saiga/vision/scene/PoseGraph.h"
+
+#include <cstdio>
+#include <fstream>
+
+using namespace Saiga;
+
+SAIGA_REGISTER_BENCHMARK(PoseGraphIO)
+{
+    Random::setSeed(3984561);
+
+    // Random walk with odometry edges and loop closures (about the size of the sphere dataset)
+    int N = 20000;
+    PoseGraph pg;
+    SE3 current;
+    for (int i = 0; i < N; ++i)
+    {
+        current = current * SE3::exp(Vec6::Random() * 0.1);
+        PoseVertex pv;
+#ifdef PGO_SIM3
+        pv.se3 = sim3(current, 1.0);
+#else
+        pv.se3 = current;
+#endif
+        pg.poses.push_back(pv);
+    }
+    for (int i = 0; i < 3 * N; ++i)
+    {
+        PoseEdge e;
+        e.from = (i < N - 1) ? i : Random::uniformInt(0, N - 2);
+        e.to   = (i < N - 1) ? i + 1 : Random::uniformInt(e.from + 1, N - 1);
+        e.setRel(pg.poses[e.from].se3, pg.poses[e.to].se3);
+        pg.edges.push_back(e);
+    }
+
+    std::string g2oFile    = "saiga_bench_posegraph.g2o";
+    std::string binaryFile = "saiga_bench_posegraph.pgb";
+    pg.saveG2O(g2oFile);
+    pg.saveBinary(binaryFile);
+
+    auto fileSize = [](const std::string& file) {
+        std::ifstream strm(file, std::ios::binary | std::ios::ate);
+        return double(strm.tellg());
+    };
+
+    // Items are bytes
+    suite.run("loadG2O_20k", [&]() { PoseGraph tmp; tmp.loadG2O(g2oFile); }, fileSize(g2oFile));
+    suite.run("saveBinary_20k", [&]() { pg.saveBinary(binaryFile); }, fileSize(binaryFile));
+    suite.run("loadBinary_20k", [&]() { PoseGraph tmp; tmp.loadBinary(binaryFile); }, fileSize(binaryFile));
+
+    std::remove(g2oFile.c_str());
+    std::remove(binaryFile.c_str());
+}
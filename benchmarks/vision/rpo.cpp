@@ -0,0 +1,88 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/math/random.h"
+#include "saiga/core/time/Benchmark.h"
+#include "saiga/core/util/Thread/omp.h"
+#include "saiga/vision/reconstruction/RobustPoseOptimization.h"
+
+using namespace Saiga;
+
+// Many small pose refinements, for example the relocalization candidates of a single frame.
+SAIGA_REGISTER_BENCHMARK(RobustPoseOptimization)
+{
+    using RPO     = RobustPoseOptimization<double>;
+    using Obs     = RPO::Obs;
+    using Problem = RPO::PoseProblem;
+
+    Random::setSeed(3457234);
+
+    const int numProblems     = 256;
+    const int obsPerProblem   = 300;
+    const double outlierRatio = 0.1;
+
+    RPO rpo = {2.45, 2.8};
+    AlignedVector<StereoCamera4Base<double>> cameras = {StereoCamera4Base<double>(500, 500, 320, 240, 40)};
+    auto& K                                          = cameras.front();
+
+    AlignedVector<Vec3> wps;
+    AlignedVector<Obs> obs;
+    AlignedVector<Problem> problems(numProblems);
+    AlignedVector<SE3> groundTruth(numProblems);
+
+    for (int p = 0; p < numProblems; ++p)
+    {
+        SE3 pose = SE3::exp(Vec6::Random() * 0.1);
+
+        auto& problem = problems[p];
+        problem.begin = wps.size();
+        for (int i = 0; i < obsPerProblem; ++i)
+        {
+            // Sample in view space and transform back to world space
+            Vec3 pv(Random::sampleDouble(-4, 4), Random::sampleDouble(-3, 3), Random::sampleDouble(2, 10));
+            Obs o;
+            o.ip = K.project(pv) + Vec2(Random::gaussRand(0, 1), Random::gaussRand(0, 1));
+            if (Random::sampleBool(0.3)) o.depth = pv.z();
+            if (Random::sampleBool(outlierRatio)) o.ip += Vec2(Random::sampleDouble(-50, 50), 0);
+            wps.push_back(pose.inverse() * pv);
+            obs.push_back(o);
+        }
+        problem.end    = wps.size();
+        groundTruth[p] = pose;
+    }
+    AlignedVector<int> outlier(obs.size());
+
+    auto reset = [&]() {
+        std::fill(outlier.begin(), outlier.end(), false);
+        for (int p = 0; p < numProblems; ++p)
+        {
+            problems[p].pose = SE3::exp(Vec6::Random() * 0.02) * groundTruth[p];
+        }
+    };
+
+    suite.run(
+        "single_256",
+        [&]() {
+            reset();
+            for (auto& p : problems)
+            {
+                p.inliers = rpo.optimizePoseRobust(wps.data() + p.begin, obs.data() + p.begin,
+                                                   outlier.data() + p.begin, p.end - p.begin, p.pose, K);
+            }
+        },
+        numProblems);
+
+    for (int threads : {1, std::max(2, OMP::getMaxThreads())})
+    {
+        suite.run(
+            "batch_256_t" + std::to_string(threads),
+            [&]() {
+                reset();
+                rpo.optimizePoseRobustBatch(wps, obs, outlier, cameras, problems, threads);
+            },
+            numProblems);
+    }
+}
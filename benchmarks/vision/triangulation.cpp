@@ -0,0 +1,38 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/math/random.h"
+#include "saiga/core/time/Benchmark.h"
+#include "saiga/vision/reconstruction/TriangulationBatch.h"
+#include "saiga/vision/scene/Scene.h"
+#include "saiga/vision/scene/SynteticScene.h"
+
+using namespace Saiga;
+
+// Re-triangulation of all points of a synthetic scene. The number of items is the number of points, so the
+// throughput is reported in points per second.
+SAIGA_REGISTER_BENCHMARK(Triangulation)
+{
+    Random::setSeed(2389746);
+
+    SynteticScene sscene;
+    sscene.numCameras     = 200;
+    sscene.numWorldPoints = 100000;
+    sscene.numImagePoints = 2500;
+    Scene scene           = sscene.circleSphere();
+    scene.addWorldPointNoise(0.05);
+
+    for (int iterations : {0, 3})
+    {
+        TriangulationBatchSettings settings;
+        settings.refinementIterations = iterations;
+        TriangulationBatch tb(settings);
+
+        // Triangulation only depends on the observations, so the result is the same in every run.
+        auto f = [&]() { tb.triangulate(scene); };
+        suite.run(iterations == 0 ? "dlt_100k" : "dlt_gn3_100k", f, scene.worldPoints.size());
+    }
+}
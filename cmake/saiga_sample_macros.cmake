@@ -54,6 +54,9 @@ macro(saiga_make_test _modules)
     add_executable(${PROG_NAME} ${PROG_SRC} )
 
     target_link_libraries(${PROG_NAME} GTest::GTest GTest::Main)
+    if(SAIGA_LIBSTDCXX_DIR)
+        set_target_properties(${PROG_NAME} PROPERTIES BUILD_RPATH "${SAIGA_LIBSTDCXX_DIR}")
+    endif()
     target_link_libraries(${PROG_NAME} ${${_modules}})
 
     add_test(NAME ${PROG_NAME}
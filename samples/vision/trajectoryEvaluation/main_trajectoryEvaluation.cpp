@@ -0,0 +1,117 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+#include "saiga/core/time/all.h"
+#include "saiga/core/util/commandLineArguments.h"
+#include "saiga/core/util/tostring.h"
+#include "saiga/vision/slam/TrajectoryEvaluation.h"
+
+#include <fstream>
+#include <iomanip>
+#include <map>
+
+using namespace Saiga;
+
+/**
+ * Evaluates many trajectories in the TUM format against ground truth.
+ *
+ * Single ground truth:
+ *      vision_trajectoryEvaluation --groundtruth=gt.txt --estimates=run1.txt,run2.txt
+ * Bulk evaluation with a list file. Each line contains "<estimate> <groundtruth>":
+ *      vision_trajectoryEvaluation --list=runs.txt
+ *
+ * Prints one line per run with the ATE (rmse, mean, max) and the RPE rmse of each delta.
+ */
+int main(int argc, char* argv[])
+{
+    CommandLineArguments cla;
+    cla.arguments.push_back({"groundtruth", 'g', "Ground truth trajectory", "", false, false});
+    cla.arguments.push_back({"estimates", 'e', "Comma separated list of estimated trajectories", "", false, false});
+    cla.arguments.push_back({"list", 'l', "File with one '<estimate> <groundtruth>' pair per line", "", false, false});
+    cla.arguments.push_back({"deltas", 'd', "Comma separated list of RPE frame deltas", "1", false, false});
+    cla.arguments.push_back({"maxdiff", 0, "Maximum timestamp difference for the association", "0.02", false, false});
+    cla.arguments.push_back({"scale", 's', "Align with scale (monocular)", "0", true, false});
+    cla.parse(argc, argv);
+
+    std::vector<std::pair<std::string, std::string>> runs;
+    if (!cla.get("list").empty())
+    {
+        std::ifstream strm(cla.get("list"));
+        SAIGA_ASSERT(strm.is_open(), "Could not open " + cla.get("list"));
+        std::string estimate, groundTruth;
+        while (strm >> estimate >> groundTruth) runs.emplace_back(estimate, groundTruth);
+    }
+    if (!cla.get("estimates").empty())
+    {
+        SAIGA_ASSERT(!cla.get("groundtruth").empty(), "--groundtruth is required for --estimates");
+        for (auto& e : split(cla.get("estimates"), ',')) runs.emplace_back(e, cla.get("groundtruth"));
+    }
+    if (runs.empty())
+    {
+        cla.printHelp();
+        return 0;
+    }
+
+    Trajectory::TrajectoryEvaluationSettings settings;
+    settings.alignScale        = cla.getFlag("scale");
+    settings.maxTimeDifference = std::stod(cla.get("maxdiff"));
+    settings.rpeDeltas.clear();
+    for (auto& d : split(cla.get("deltas"), ','))
+    {
+        int delta = std::stoi(d);
+        if (delta < 1)
+        {
+            std::cout << "Invalid delta " << delta << ". The RPE deltas must be positive." << std::endl;
+            return 1;
+        }
+        settings.rpeDeltas.push_back(delta);
+    }
+
+    std::cout << "estimate associated ate_rmse ate_mean ate_max";
+    for (auto d : settings.rpeDeltas) std::cout << " rpe_t_" << d << " rpe_r_" << d;
+    std::cout << std::endl;
+
+    // Most runs share the same ground truth
+    std::map<std::string, Trajectory::TrajectorySoA> groundTruths;
+
+    Timer timer;
+    timer.start();
+    for (auto& [estimateFile, groundTruthFile] : runs)
+    {
+        auto it = groundTruths.find(groundTruthFile);
+        if (it == groundTruths.end())
+        {
+            Trajectory::TrajectorySoA gt;
+            if (!gt.loadTUM(groundTruthFile))
+            {
+                std::cout << "Could not load " << groundTruthFile << std::endl;
+                continue;
+            }
+            gt.sort();
+            it = groundTruths.emplace(groundTruthFile, std::move(gt)).first;
+        }
+
+        Trajectory::TrajectorySoA estimate;
+        if (!estimate.loadTUM(estimateFile))
+        {
+            std::cout << "Could not load " << estimateFile << std::endl;
+            continue;
+        }
+        estimate.sort();
+
+        auto result = Trajectory::evaluate(estimate, it->second, settings);
+        std::cout << estimateFile << " " << result.associated << " " << result.ate.rms() << " " << result.ate.mean
+                  << " " << result.ate.max;
+        for (size_t d = 0; d < settings.rpeDeltas.size(); ++d)
+        {
+            double rotationDeg = result.rpeRotation[d].rms() * 180.0 / pi<double>();
+            std::cout << " " << result.rpeTranslation[d].rms() << " " << rotationDeg;
+        }
+        std::cout << std::endl;
+    }
+    timer.stop();
+    std::cout << "Evaluated " << runs.size() << " runs in " << timer.getTimeMS() << " ms." << std::endl;
+    return 0;
+}
@@ -9,6 +9,7 @@
 #include "saiga/core/image/image.h"
 #include "saiga/core/math/floatingPoint.h"
 #include "saiga/core/model/ModelLoader.h"
+#include "saiga/core/util/AsyncLogger.h"
 #include "saiga/core/util/ConsoleColor.h"
 #include "saiga/core/util/Thread/threadName.h"
 #include "saiga/core/util/assert.h"
@@ -92,6 +93,7 @@ void SaigaParameters::fromConfigFile(const std::string& file)
     mainThreadName   = ini.GetAddString("saiga", "mainThreadName", mainThreadName.c_str());
     logging_enabled  = ini.GetAddBool("saiga", "logging", logging_enabled);
     verbose_logging  = ini.GetAddLong("saiga", "verbose_logging", verbose_logging);
+    async_logging    = ini.GetAddBool("saiga", "async_logging", async_logging);
     if (ini.changed()) ini.SaveFile(file.c_str());
 }
 
@@ -222,6 +224,7 @@ void initSaiga(const SaigaParameters& params)
     }
 
     el::Loggers::reconfigureLogger("default", defaultConf);
+    if (params.async_logging) AsyncLogger::instance().routeEasylogging();
 
 
     printSaigaInfo();
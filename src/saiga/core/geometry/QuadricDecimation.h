@@ -0,0 +1,497 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/config.h"
+#include "saiga/core/math/math.h"
+#include "saiga/core/util/Thread/omp.h"
+
+#include "half_edge_mesh.h"
+#include "triangle_mesh.h"
+
+#include <algorithm>
+#include <limits>
+#include <queue>
+#include <vector>
+
+namespace Saiga
+{
+struct QuadricDecimationSettings
+{
+    // Stop if the cheapest collapse has a larger quadric error.
+    double maxError = std::numeric_limits<double>::infinity();
+
+    // Boundary vertices are never moved. (Boundary vertices are never removed either way.)
+    bool lockBoundary = true;
+
+    // Reject collapses which change a face normal more than this. (cos of the angle)
+    double minNormalDot = 0.2;
+
+    // Number of independent regions in decimateParallel. 0 = 4 * number of OpenMP threads.
+    int partitions = 0;
+};
+
+/**
+ * Mesh simplification with quadric error metrics on top of the HalfEdgeMesh.
+ *
+ * Garland, Heckbert: "Surface Simplification Using Quadric Error Metrics", SIGGRAPH 1997
+ *
+ * The edge collapses are ordered by a priority queue. Outdated queue entries are detected with per vertex
+ * version numbers, so an edge is never searched or removed from the queue.
+ * A collapse is rejected if it would create a non-manifold mesh (link condition) or flip a face.
+ *
+ * decimateParallel() splits the mesh into slabs along the longest axis. A collapse is executed by the thread
+ * of a slab only if the one-rings of both vertices are completely inside this slab. Therefore the threads
+ * never touch the same faces. The remaining edges at the slab borders are collapsed afterwards by a single
+ * thread.
+ *
+ * Usage:
+ *
+ * HalfEdgeMesh<VertexNT, uint32_t> hem(mesh);
+ * QuadricDecimation<VertexNT, uint32_t> qem(hem);
+ * qem.decimateParallel(mesh.faces.size() / 10);
+ * hem.toIFS(mesh);
+ * mesh.removeUnusedVertices();
+ */
+template <typename vertex_t, typename index_t>
+class QuadricDecimation
+{
+   public:
+    using MeshType = HalfEdgeMesh<vertex_t, index_t>;
+
+    QuadricDecimation(MeshType& mesh, const QuadricDecimationSettings& settings = QuadricDecimationSettings());
+
+    // Collapses edges until the mesh has at most targetFaces faces. Returns the number of removed faces.
+    int decimate(int targetFaces);
+    int decimateParallel(int targetFaces);
+
+    int numFaces() const { return faceCount; }
+
+   private:
+    // Symmetric 4x4 matrix
+    struct Quadric
+    {
+        double a2 = 0, ab = 0, ac = 0, ad = 0, b2 = 0, bc = 0, bd = 0, c2 = 0, cd = 0, d2 = 0;
+
+        Quadric() {}
+        // Squared distance to the plane n*x + d = 0
+        Quadric(const Vec3& n, double d, double w)
+            : a2(w * n.x() * n.x()),
+              ab(w * n.x() * n.y()),
+              ac(w * n.x() * n.z()),
+              ad(w * n.x() * d),
+              b2(w * n.y() * n.y()),
+              bc(w * n.y() * n.z()),
+              bd(w * n.y() * d),
+              c2(w * n.z() * n.z()),
+              cd(w * n.z() * d),
+              d2(w * d * d)
+        {
+        }
+
+        Quadric& operator+=(const Quadric& o)
+        {
+            a2 += o.a2;
+            ab += o.ab;
+            ac += o.ac;
+            ad += o.ad;
+            b2 += o.b2;
+            bc += o.bc;
+            bd += o.bd;
+            c2 += o.c2;
+            cd += o.cd;
+            d2 += o.d2;
+            return *this;
+        }
+
+        double error(const Vec3& p) const
+        {
+            double x = p.x(), y = p.y(), z = p.z();
+            return a2 * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x + b2 * y * y + 2 * bc * y * z +
+                   2 * bd * y + c2 * z * z + 2 * cd * z + d2;
+        }
+
+        // The minimum of the quadric. Returns false if the system is singular.
+        bool optimum(Vec3& p) const
+        {
+            Mat3 A;
+            A << a2, ab, ac, ab, b2, bc, ac, bc, c2;
+            double det = A.determinant();
+            if (std::abs(det) < 1e-12) return false;
+            p = A.inverse() * Vec3(-ad, -bd, -cd);
+            return true;
+        }
+    };
+
+    struct Collapse
+    {
+        double cost;
+        // The collapsed half edge. The end vertex 'b' is merged into the start vertex 'a'.
+        int he;
+        int a, b;
+        int versionA, versionB;
+        bool operator>(const Collapse& other) const { return cost > other.cost; }
+    };
+    using Queue = std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>>;
+
+    MeshType& mesh;
+    QuadricDecimationSettings settings;
+    int faceCount = 0;
+
+    std::vector<Quadric> quadrics;
+    std::vector<int> versions;
+    std::vector<char> boundary;
+    // Slab of each vertex in the parallel mode. -1 = no restriction
+    std::vector<int> partition;
+
+    Vec3 position(int v) const { return mesh.vertices[v].v.position.template head<3>().template cast<double>(); }
+
+    template <typename F>
+    void forEachNeighbour(int v, F f) const;
+
+    int valence(int v) const;
+    bool isNeighbour(int v, int x) const;
+    bool insidePartition(int v, int part) const;
+
+    bool computeCollapse(int he, Collapse& c, Vec3& target) const;
+    bool checkNormals(int v, int other, const Vec3& target) const;
+    bool canCollapse(const Collapse& c, const Vec3& target, int part) const;
+
+    void pushEdges(int v, Queue& queue, int part) const;
+    // Runs the collapses of the queue. Returns the number of removed faces.
+    int run(Queue& queue, int part, int facesToRemove);
+};
+
+template <typename vertex_t, typename index_t>
+QuadricDecimation<vertex_t, index_t>::QuadricDecimation(MeshType& mesh, const QuadricDecimationSettings& settings)
+    : mesh(mesh), settings(settings)
+{
+    int n = mesh.vertices.size();
+    quadrics.resize(n);
+    versions.resize(n, 0);
+    boundary.resize(n, 0);
+
+    for (auto& f : mesh.faces)
+    {
+        if (!f.valid) continue;
+        faceCount++;
+
+        auto& e1 = mesh.edgeList[f.halfEdge];
+        auto& e2 = mesh.edgeList[e1.nextHalfEdge];
+        auto& e3 = mesh.edgeList[e2.nextHalfEdge];
+
+        Vec3 p1 = position(e1.vertex);
+        Vec3 p2 = position(e2.vertex);
+        Vec3 p3 = position(e3.vertex);
+
+        // Area weighted plane quadric
+        Vec3 normal = (p2 - p1).cross(p3 - p1);
+        double area = normal.norm();
+        if (area < 1e-20) continue;
+        normal /= area;
+        Quadric q(normal, -normal.dot(p1), area * 0.5);
+        quadrics[e1.vertex] += q;
+        quadrics[e2.vertex] += q;
+        quadrics[e3.vertex] += q;
+    }
+
+    for (int i = 0; i < (int)mesh.edgeList.size(); ++i)
+    {
+        auto& e = mesh.edgeList[i];
+        if (e.valid && e.oppositeHalfEdge == -1)
+        {
+            boundary[e.vertex]            = 1;
+            boundary[mesh.startVertex(i)] = 1;
+        }
+    }
+}
+
+template <typename vertex_t, typename index_t>
+template <typename F>
+void QuadricDecimation<vertex_t, index_t>::forEachNeighbour(int v, F f) const
+{
+    int first = -1;
+    for (int he : mesh.outgoingHalfEdges(v))
+    {
+        if (first == -1) first = he;
+        f(mesh.edgeList[he].vertex);
+    }
+    if (first != -1 && mesh.edgeList[mesh.edgeList[first].prevHalfEdge].oppositeHalfEdge == -1)
+    {
+        f(mesh.edgeList[mesh.edgeList[first].nextHalfEdge].vertex);
+    }
+}
+
+template <typename vertex_t, typename index_t>
+int QuadricDecimation<vertex_t, index_t>::valence(int v) const
+{
+    int n = 0;
+    forEachNeighbour(v, [&](int) { n++; });
+    return n;
+}
+
+template <typename vertex_t, typename index_t>
+bool QuadricDecimation<vertex_t, index_t>::isNeighbour(int v, int x) const
+{
+    bool found = false;
+    forEachNeighbour(v, [&](int y) { found |= (x == y); });
+    return found;
+}
+
+template <typename vertex_t, typename index_t>
+bool QuadricDecimation<vertex_t, index_t>::insidePartition(int v, int part) const
+{
+    if (part == -1) return true;
+    if (partition[v] != part) return false;
+    bool inside = true;
+    forEachNeighbour(v, [&](int x) { inside &= (partition[x] == part); });
+    return inside;
+}
+
+template <typename vertex_t, typename index_t>
+bool QuadricDecimation<vertex_t, index_t>::computeCollapse(int he, Collapse& c, Vec3& target) const
+{
+    auto& e = mesh.edgeList[he];
+    if (!e.valid) return false;
+
+    int a = mesh.startVertex(he);
+    int b = e.vertex;
+
+    // The removed vertex must be an interior vertex. Try the other direction otherwise.
+    if (boundary[b])
+    {
+        if (boundary[a] || e.oppositeHalfEdge == -1) return false;
+        he = e.oppositeHalfEdge;
+        std::swap(a, b);
+    }
+
+    Quadric q = quadrics[a];
+    q += quadrics[b];
+
+    if (boundary[a] && settings.lockBoundary)
+    {
+        target = position(a);
+    }
+    else if (!q.optimum(target))
+    {
+        // Singular system (for example a planar region): use the best of the endpoints and the midpoint
+        Vec3 pa = position(a), pb = position(b);
+        Vec3 candidates[3] = {pa, pb, (pa + pb) * 0.5};
+        double best        = std::numeric_limits<double>::infinity();
+        for (auto& p : candidates)
+        {
+            double err = q.error(p);
+            if (err < best)
+            {
+                best   = err;
+                target = p;
+            }
+        }
+    }
+
+    c.cost     = std::max(q.error(target), 0.0);
+    c.he       = he;
+    c.a        = a;
+    c.b        = b;
+    c.versionA = versions[a];
+    c.versionB = versions[b];
+    return true;
+}
+
+// Checks the faces of v, which don't contain 'other', if v is moved to target.
+template <typename vertex_t, typename index_t>
+bool QuadricDecimation<vertex_t, index_t>::checkNormals(int v, int other, const Vec3& target) const
+{
+    for (int he : mesh.outgoingHalfEdges(v))
+    {
+        auto& e = mesh.edgeList[he];
+        int x   = e.vertex;
+        int y   = mesh.edgeList[e.nextHalfEdge].vertex;
+        if (x == other || y == other) continue;
+
+        Vec3 pv = position(v), px = position(x), py = position(y);
+        Vec3 n1 = (px - pv).cross(py - pv);
+        Vec3 n2 = (px - target).cross(py - target);
+        double l1 = n1.norm(), l2 = n2.norm();
+        // Degenerated face. Relative to the edge lengths, because the positions are stored as float.
+        if (l2 <= 1e-5 * (px - target).norm() * (py - target).norm()) return false;
+        if (l1 > 1e-20 && n1.dot(n2) < settings.minNormalDot * l1 * l2) return false;
+    }
+    return true;
+}
+
+template <typename vertex_t, typename index_t>
+bool QuadricDecimation<vertex_t, index_t>::canCollapse(const Collapse& c, const Vec3& target, int part) const
+{
+    int a = c.a, b = c.b;
+    if (!insidePartition(a, part) || !insidePartition(b, part)) return false;
+
+    // Link condition: a and b may only share the two opposite vertices of the removed faces
+    int common = 0;
+    forEachNeighbour(b, [&](int x) { common += isNeighbour(a, x); });
+    if (common != 2) return false;
+
+    // The merged vertex must have at least 3 neighbours
+    if (valence(a) + valence(b) - 4 < 3) return false;
+
+    return checkNormals(a, b, target) && checkNormals(b, a, target);
+}
+
+template <typename vertex_t, typename index_t>
+void QuadricDecimation<vertex_t, index_t>::pushEdges(int v, Queue& queue, int part) const
+{
+    for (int he : mesh.outgoingHalfEdges(v))
+    {
+        int x = mesh.edgeList[he].vertex;
+        if (part != -1 && partition[x] != part) continue;
+        Collapse c;
+        Vec3 target;
+        if (computeCollapse(he, c, target)) queue.push(c);
+    }
+}
+
+template <typename vertex_t, typename index_t>
+int QuadricDecimation<vertex_t, index_t>::run(Queue& queue, int part, int facesToRemove)
+{
+    int removed = 0;
+    while (removed < facesToRemove && !queue.empty())
+    {
+        Collapse c = queue.top();
+        queue.pop();
+
+        if (c.cost > settings.maxError) break;
+
+        // Outdated entry
+        auto& e = mesh.edgeList[c.he];
+        if (!e.valid || e.vertex != c.b || mesh.startVertex(c.he) != c.a || versions[c.a] != c.versionA ||
+            versions[c.b] != c.versionB)
+            continue;
+
+        Collapse current;
+        Vec3 target;
+        if (!computeCollapse(c.he, current, target) || current.he != c.he) continue;
+        if (!canCollapse(current, target, part)) continue;
+
+        mesh.halfEdgeCollapse(c.he);
+        mesh.vertices[c.a].v.position.template head<3>() = target.template cast<float>();
+        quadrics[c.a] += quadrics[c.b];
+        versions[c.a]++;
+        versions[c.b]++;
+        removed += 2;
+
+        pushEdges(c.a, queue, part);
+    }
+    return removed;
+}
+
+template <typename vertex_t, typename index_t>
+int QuadricDecimation<vertex_t, index_t>::decimate(int targetFaces)
+{
+    partition.clear();
+    Queue queue;
+    for (int i = 0; i < (int)mesh.edgeList.size(); ++i)
+    {
+        auto& e = mesh.edgeList[i];
+        if (!e.valid || (e.oppositeHalfEdge != -1 && e.oppositeHalfEdge < i)) continue;
+        Collapse c;
+        Vec3 target;
+        if (computeCollapse(i, c, target)) queue.push(c);
+    }
+    int removed = run(queue, -1, faceCount - targetFaces);
+    faceCount -= removed;
+    return removed;
+}
+
+template <typename vertex_t, typename index_t>
+int QuadricDecimation<vertex_t, index_t>::decimateParallel(int targetFaces)
+{
+    int parts = settings.partitions > 0 ? settings.partitions : 4 * OMP::getMaxThreads();
+    int n     = mesh.vertices.size();
+    if (parts <= 1 || faceCount <= targetFaces) return decimate(targetFaces);
+
+    // Split along the longest axis at the quantiles, so each slab has the same number of vertices
+    Vec3 low  = Vec3::Constant(std::numeric_limits<double>::infinity());
+    Vec3 high = -low;
+    for (int i = 0; i < n; ++i)
+    {
+        if (!mesh.vertices[i].valid) continue;
+        low  = low.cwiseMin(position(i));
+        high = high.cwiseMax(position(i));
+    }
+    int axis;
+    (high - low).maxCoeff(&axis);
+
+    std::vector<std::pair<double, int>> order;
+    order.reserve(n);
+    for (int i = 0; i < n; ++i) order.emplace_back(position(i)(axis), i);
+    std::sort(order.begin(), order.end());
+
+    partition.resize(n);
+    for (int i = 0; i < n; ++i) partition[order[i].second] = int64_t(i) * parts / n;
+
+    // Faces which can be removed by the thread of a slab and the initial edges of each slab.
+    // The edges are collected before the parallel loop, because the other threads modify the edge list.
+    std::vector<int> partFaces(parts, 0);
+    std::vector<std::vector<int>> partEdges(parts);
+    for (int i = 0; i < (int)mesh.edgeList.size(); ++i)
+    {
+        auto& e = mesh.edgeList[i];
+        if (!e.valid || (e.oppositeHalfEdge != -1 && e.oppositeHalfEdge < i)) continue;
+        int p = partition[e.vertex];
+        if (partition[mesh.startVertex(i)] == p) partEdges[p].push_back(i);
+    }
+    for (auto& f : mesh.faces)
+    {
+        if (!f.valid) continue;
+        auto& e1 = mesh.edgeList[f.halfEdge];
+        int p    = partition[e1.vertex];
+        if (insidePartition(e1.vertex, p) && insidePartition(mesh.edgeList[e1.nextHalfEdge].vertex, p) &&
+            insidePartition(mesh.edgeList[e1.prevHalfEdge].vertex, p))
+            partFaces[p]++;
+    }
+
+    int toRemove = faceCount - targetFaces;
+    int removed  = 0;
+
+#pragma omp parallel for schedule(dynamic) reduction(+ : removed)
+    for (int p = 0; p < parts; ++p)
+    {
+        Queue queue;
+        for (int i : partEdges[p])
+        {
+            Collapse c;
+            Vec3 target;
+            if (computeCollapse(i, c, target)) queue.push(c);
+        }
+        // Only the same fraction as in the whole mesh. The faces at the slab borders can't be removed here and a
+        // larger share would over-simplify the inside of the slab.
+        int target = int64_t(toRemove) * partFaces[p] / faceCount;
+        removed += run(queue, p, target);
+    }
+    faceCount -= removed;
+
+    // The slab borders
+    return removed + decimate(targetFaces);
+}
+
+/**
+ * Simplifies a triangle mesh with QuadricDecimation. The unused vertices are removed afterwards.
+ * Returns the number of removed faces.
+ */
+template <typename vertex_t, typename index_t>
+int decimateQuadric(TriangleMesh<vertex_t, index_t>& mesh, int targetFaces, bool parallel = true,
+                    const QuadricDecimationSettings& settings = QuadricDecimationSettings())
+{
+    HalfEdgeMesh<vertex_t, index_t> hem(mesh);
+    QuadricDecimation<vertex_t, index_t> qem(hem, settings);
+    int removed = parallel ? qem.decimateParallel(targetFaces) : qem.decimate(targetFaces);
+    hem.toIFS(mesh);
+    mesh.removeUnusedVertices();
+    return removed;
+}
+
+}  // namespace Saiga
@@ -46,7 +46,7 @@ class HalfEdgeMesh
         bool valid = true;
         vertex_t v;
         // one outgoing halfedge
-        int halfEdge;
+        int halfEdge = -1;
     };
 
     struct HalfFace
@@ -80,6 +80,45 @@ class HalfEdgeMesh
     void removeFace(int f);
 
     void getNeighbours(int vertex, std::vector<int>& neighs);
+
+    /**
+     * Iterates over the outgoing half edges of a vertex without allocating memory.
+     * For boundary vertices the iteration starts at the first half edge of the fan, so all outgoing half edges
+     * are visited.
+     *
+     * for (int he : mesh.outgoingHalfEdges(v))
+     * {
+     *     int neighbour = mesh.edgeList[he].vertex;
+     * }
+     */
+    struct OneRingIterator
+    {
+        const HalfEdgeMesh* mesh;
+        int first;
+        int current;
+
+        int operator*() const { return current; }
+        OneRingIterator& operator++()
+        {
+            int op  = mesh->edgeList[current].oppositeHalfEdge;
+            current = (op == -1) ? -1 : mesh->edgeList[op].nextHalfEdge;
+            if (current == first) current = -1;
+            return *this;
+        }
+        bool operator!=(const OneRingIterator& other) const { return current != other.current; }
+    };
+
+    struct OneRing
+    {
+        OneRingIterator first, last;
+        OneRingIterator begin() const { return first; }
+        OneRingIterator end() const { return last; }
+    };
+
+    OneRing outgoingHalfEdges(int vertex) const;
+
+    // The vertex where this half edge starts
+    int startVertex(int he) const { return edgeList[edgeList[he].prevHalfEdge].vertex; }
 };
 
 template <typename vertex_t, typename index_t>
@@ -463,7 +502,12 @@ void HalfEdgeMesh<vertex_t, index_t>::halfEdgeCollapse(int he)
     if (o1 != -1) edgeList[o1].oppositeHalfEdge = o2;
     if (o2 != -1) edgeList[o2].oppositeHalfEdge = o1;
 
-    if (o1 != -1) vertices[w1].halfEdge = o1;
+    // The removed half edges might be the reference edges of the remaining vertices
+    if (o1 != -1)
+        vertices[w1].halfEdge = o1;
+    else if (o2 != -1)
+        vertices[w1].halfEdge = edgeList[o2].nextHalfEdge;
+    if (o2 != -1) vertices[newVertex].halfEdge = o2;
 
 
 
@@ -483,7 +527,11 @@ void HalfEdgeMesh<vertex_t, index_t>::halfEdgeCollapse(int he)
         if (o3 != -1) edgeList[o3].oppositeHalfEdge = o4;
         if (o4 != -1) edgeList[o4].oppositeHalfEdge = o3;
 
-        if (o3 != -1) vertices[w2].halfEdge = o3;
+        if (o3 != -1)
+            vertices[w2].halfEdge = o3;
+        else if (o4 != -1)
+            vertices[w2].halfEdge = edgeList[o4].nextHalfEdge;
+        if (o2 == -1 && o4 != -1) vertices[newVertex].halfEdge = o4;
 
 
         //        std::cout << "o3,o4 " << o3 << "," << o4 << std::endl;
@@ -631,59 +679,36 @@ void HalfEdgeMesh<vertex_t, index_t>::removeFace(int f)
 }
 
 template <typename vertex_t, typename index_t>
-void HalfEdgeMesh<vertex_t, index_t>::getNeighbours(int vertex, std::vector<int>& neighs)
+typename HalfEdgeMesh<vertex_t, index_t>::OneRing HalfEdgeMesh<vertex_t, index_t>::outgoingHalfEdges(int vertex) const
 {
-    // ================================================================================
-
-    // iterate over all triangles of the removed vertex
-    // update the vertices of the "incostd::ming" edges
-    int startHf   = vertices[vertex].halfEdge;
-    int currentHf = startHf;
+    int start = vertices[vertex].halfEdge;
+    if (start == -1 || !vertices[vertex].valid) return {{this, -1, -1}, {this, -1, -1}};
 
+    // Rotate backwards until the boundary (or once around for interior vertices)
+    int first = start;
     while (true)
     {
-        HalfEdge& current = edgeList[currentHf];
-        neighs.push_back(current.vertex);
-
-        if (current.oppositeHalfEdge == -1)
-        {
-            break;
-        }
-
-        // this he points towards the vertex
-        HalfEdge& flip = edgeList[current.oppositeHalfEdge];
-        currentHf      = flip.nextHalfEdge;
-
-        if (currentHf == startHf)
-        {
-            //            neighs.push_back(edgeList[currentHf].vertex);
-            return;
-        }
+        int op = edgeList[edgeList[first].prevHalfEdge].oppositeHalfEdge;
+        if (op == -1 || op == start) break;
+        first = op;
     }
+    return {{this, first, first}, {this, first, -1}};
+}
 
-    //    if(currentHf != startHf)
+template <typename vertex_t, typename index_t>
+void HalfEdgeMesh<vertex_t, index_t>::getNeighbours(int vertex, std::vector<int>& neighs)
+{
+    int first = -1;
+    for (int he : outgoingHalfEdges(vertex))
     {
-        // we need to iterate in the opposite direction
-        startHf   = vertices[vertex].halfEdge;
-        currentHf = startHf;
-
-        while (true)
-        {
-            HalfEdge& current = edgeList[currentHf];
-            HalfEdge& flip    = edgeList[current.prevHalfEdge];
-            //            SAIGA_ASSERT(flip.vertex == removeVertex);
-            //            flip.vertex = newVertex;
-
-            if (flip.oppositeHalfEdge == -1) break;
-
-            currentHf = flip.oppositeHalfEdge;
-
-
-            if (currentHf == startHf) break;
+        if (first == -1) first = he;
+        neighs.push_back(edgeList[he].vertex);
+    }
 
-            neighs.push_back(edgeList[currentHf].vertex);
-        }
-        //        SAIGA_ASSERT(currentHf == startHf);
+    // The last neighbour of a boundary vertex is only connected by an incoming half edge
+    if (first != -1 && edgeList[edgeList[first].prevHalfEdge].oppositeHalfEdge == -1)
+    {
+        neighs.push_back(edgeList[edgeList[first].nextHalfEdge].vertex);
     }
 }
 
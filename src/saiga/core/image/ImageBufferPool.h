@@ -0,0 +1,102 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/config.h"
+
+#include "templatedImage.h"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Saiga
+{
+/**
+ * A thread safe pool of images with shared ownership.
+ *
+ * acquire() returns a shared_ptr to an image of the requested size. When the last owner releases the image, the
+ * buffer is returned to the pool and reused by the next acquire() with the same size. The pool itself must be
+ * owned by a shared_ptr. Images that are still in use when the pool is destroyed are freed normally.
+ *
+ * auto pool = ImageBufferPool<float>::create();
+ * std::shared_ptr<TemplatedImage<float>> img = pool->acquire(480, 640);
+ */
+template <typename T>
+class ImageBufferPool : public std::enable_shared_from_this<ImageBufferPool<T>>
+{
+   public:
+    using ImageType = TemplatedImage<T>;
+    using Handle    = std::shared_ptr<ImageType>;
+
+    // At most 'maxFree' unused buffers are kept. Additional buffers are freed on release.
+    static std::shared_ptr<ImageBufferPool> create(int maxFree = 32)
+    {
+        return std::shared_ptr<ImageBufferPool>(new ImageBufferPool(maxFree));
+    }
+
+    // The content of the returned image is undefined.
+    Handle acquire(int h, int w)
+    {
+        std::unique_ptr<ImageType> img;
+        {
+            std::unique_lock lock(mutex);
+            for (auto it = freeList.begin(); it != freeList.end(); ++it)
+            {
+                if ((*it)->h == h && (*it)->w == w)
+                {
+                    img = std::move(*it);
+                    freeList.erase(it);
+                    break;
+                }
+            }
+            if (!img) allocations++;
+        }
+        if (!img) img = std::make_unique<ImageType>(h, w);
+
+        std::weak_ptr<ImageBufferPool> weakPool = this->shared_from_this();
+        return Handle(img.release(), [weakPool](ImageType* ptr) {
+            if (auto pool = weakPool.lock())
+            {
+                pool->release(std::unique_ptr<ImageType>(ptr));
+            }
+            else
+            {
+                delete ptr;
+            }
+        });
+    }
+
+    size_t numFree()
+    {
+        std::unique_lock lock(mutex);
+        return freeList.size();
+    }
+
+    // The number of images created by this pool. If this number keeps growing, maxFree is too small.
+    size_t numAllocations()
+    {
+        std::unique_lock lock(mutex);
+        return allocations;
+    }
+
+   private:
+    ImageBufferPool(int maxFree) : maxFree(maxFree) {}
+
+    void release(std::unique_ptr<ImageType> img)
+    {
+        std::unique_lock lock(mutex);
+        if ((int)freeList.size() < maxFree) freeList.push_back(std::move(img));
+    }
+
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ImageType>> freeList;
+    int maxFree;
+    size_t allocations = 0;
+};
+
+}  // namespace Saiga
@@ -0,0 +1,386 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "TerrainPyramid.h"
+
+#include "saiga/core/util/assert.h"
+#include "saiga/core/util/tostring.h"
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <unordered_set>
+
+namespace Saiga
+{
+// Images are only processed in parallel if they are larger than this. Smaller images are usually processed inside a
+// parallel loop over tiles.
+static constexpr size_t parallelPixels = 128 * 128;
+
+// The shortest exact representation. The cache keys must only be equal for exactly equal parameters.
+static std::string exactNumber(float v)
+{
+    char buffer[32];
+    return std::string(buffer, formatNumber(buffer, buffer + sizeof(buffer), v));
+}
+
+// dst(r, c) = mean of the 2x2 block at src(2r, 2c)
+static void downsample2x2(ImageView<const float> src, ImageView<float> dst)
+{
+#pragma omp parallel for if (size_t(dst.rows) * dst.cols > parallelPixels)
+    for (int r = 0; r < dst.rows; ++r)
+    {
+        const float* s0 = src.rowPtr(2 * r);
+        const float* s1 = src.rowPtr(2 * r + 1);
+        float* d        = dst.rowPtr(r);
+#pragma omp simd
+        for (int c = 0; c < dst.cols; ++c)
+        {
+            d[c] = 0.25f * (s0[2 * c] + s0[2 * c + 1] + s1[2 * c] + s1[2 * c + 1]);
+        }
+    }
+}
+
+// Loads an image that was written with saveRaw. Returns false if the file is missing or has the wrong size.
+template <typename T>
+static bool loadCached(const std::string& file, TemplatedImage<T>& img, int size)
+{
+    std::error_code ec;
+    auto fileSize = std::filesystem::file_size(file, ec);
+    if (ec || fileSize != 4 * sizeof(int) + size_t(size) * size * sizeof(T)) return false;
+    return img.loadRaw(file) && img.type == TemplatedImage<T>::TType::type && img.h == size && img.w == size;
+}
+
+// Writes to a temporary file first, so that an interrupted write never leaves a broken cache file.
+static void saveCached(const std::string& file, const Image& img)
+{
+    std::string tmp = file + ".tmp";
+    if (img.saveRaw(tmp))
+    {
+        std::error_code ec;
+        std::filesystem::rename(tmp, file, ec);
+    }
+}
+
+TerrainPyramid::TerrainPyramid(int width, int height, int levels, int tileSize, HeightSource source,
+                               const std::string& cacheDirectory, size_t memoryBudget, float pixelSize,
+                               float heightScale)
+    : width(width),
+      height(height),
+      levels(levels),
+      tileSize(tileSize),
+      source(source),
+      cacheDirectory(cacheDirectory),
+      pixelSize(pixelSize),
+      heightScale(heightScale),
+      heightCache(memoryBudget / 2, [](const HeightImage& img) { return img->size(); }),
+      tileCache(memoryBudget / 2, [](const std::shared_ptr<const TerrainTile>& tile) { return tile->bytes(); })
+{
+    SAIGA_ASSERT(levels >= 1 && tileSize >= 2 && tileSize % 2 == 0);
+    SAIGA_ASSERT(width % (tileSize << (levels - 1)) == 0 && height % (tileSize << (levels - 1)) == 0,
+                 "The terrain size must be a multiple of the largest tile.");
+    SAIGA_ASSERT(source.heights);
+
+    if (!cacheDirectory.empty())
+    {
+        SAIGA_ASSERT(!source.key.empty() && source.key.find('\n') == std::string::npos,
+                     "A cache directory requires a single line source key.");
+        std::filesystem::create_directories(cacheDirectory);
+        checkCacheDirectory();
+    }
+}
+
+TerrainPyramid::HeightSource TerrainPyramid::perlinSource(const PerlinNoise& noise, float scale, int octaves,
+                                                            float lacunarity, float gain)
+{
+    // The sum of all octave amplitudes
+    float amplitude = gain == 1 ? octaves : (1 - std::pow(gain, octaves)) / (1 - gain);
+    float norm      = 1.0f / amplitude;
+
+    HeightSource source;
+    source.heights = [=](ImageView<float> out, int x, int y) {
+        noise.fBmField(out, vec2(x * scale, y * scale), vec2(scale, scale), 0, octaves, lacunarity, gain);
+        for (int r = 0; r < out.rows; ++r)
+        {
+            float* row = out.rowPtr(r);
+#pragma omp simd
+            for (int c = 0; c < out.cols; ++c) row[c] *= norm;
+        }
+    };
+
+    std::stringstream strm;
+    strm << "perlin " << std::hex << noise.hash() << std::dec << " " << exactNumber(scale) << " " << octaves << " "
+         << exactNumber(lacunarity) << " " << exactNumber(gain);
+    source.key = strm.str();
+    return source;
+}
+
+std::shared_ptr<const TerrainTile> TerrainPyramid::tile(const TerrainTileId& id)
+{
+    SAIGA_ASSERT(id.level >= 0 && id.level < levels);
+    SAIGA_ASSERT(id.x >= 0 && id.x < tilesX(id.level) && id.y >= 0 && id.y < tilesY(id.level));
+    return tileCache.getOrLoad(id, [&]() { return createTile(id); });
+}
+
+void TerrainPyramid::prefetch(const std::vector<TerrainTileId>& ids)
+{
+    // Collect the missing height tiles of each level. Their children are only needed if they are not cached.
+    std::vector<std::unordered_set<TerrainTileId, TerrainTileIdHash>> required(levels);
+    std::function<void(TerrainTileId)> require = [&](TerrainTileId id) {
+        if (!required[id.level].insert(id).second) return;
+        if (id.level == 0 || heightCache.exists(id)) return;
+        if (!cacheDirectory.empty() && std::filesystem::exists(cacheFile(id, "height"))) return;
+        for (int dy = 0; dy < 2; ++dy)
+        {
+            for (int dx = 0; dx < 2; ++dx)
+            {
+                require({id.level - 1, 2 * id.x + dx, 2 * id.y + dy});
+            }
+        }
+    };
+
+    for (auto& id : ids)
+    {
+        if (tileCache.exists(id)) continue;
+        if (!cacheDirectory.empty() && std::filesystem::exists(cacheFile(id, "normal")))
+        {
+            require(id);
+            continue;
+        }
+        // The normals also need the heights of the 4 neighbours.
+        const int offsets[5][2] = {{0, 0}, {-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+        for (auto& o : offsets)
+        {
+            TerrainTileId n = {id.level, id.x + o[0], id.y + o[1]};
+            if (n.x >= 0 && n.x < tilesX(n.level) && n.y >= 0 && n.y < tilesY(n.level)) require(n);
+        }
+    }
+
+    // Bottom up, so that each level can be processed in parallel.
+    for (int level = 0; level < levels; ++level)
+    {
+        std::vector<TerrainTileId> levelIds(required[level].begin(), required[level].end());
+#pragma omp parallel for schedule(dynamic)
+        for (int i = 0; i < (int)levelIds.size(); ++i)
+        {
+            heights(levelIds[i]);
+        }
+    }
+
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < (int)ids.size(); ++i)
+    {
+        tile(ids[i]);
+    }
+}
+
+void TerrainPyramid::assembleLevel(int level, TemplatedImage<float>& heights, TemplatedImage<ucvec4>& normals)
+{
+    auto ids = levelTiles(level);
+    prefetch(ids);
+
+    heights.create(levelHeight(level), levelWidth(level));
+    normals.create(levelHeight(level), levelWidth(level));
+
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < (int)ids.size(); ++i)
+    {
+        auto t = tile(ids[i]);
+        int y  = ids[i].y * tileSize;
+        int x  = ids[i].x * tileSize;
+        t->heights->getConstImageView().copyTo(heights.getImageView().subImageView(y, x, tileSize, tileSize));
+        t->normals.getConstImageView().copyTo(normals.getImageView().subImageView(y, x, tileSize, tileSize));
+    }
+}
+
+void TerrainPyramid::invalidate(int x, int y, int w, int h)
+{
+    if (w <= 0 || h <= 0) return;
+
+    for (int level = 0; level < levels; ++level)
+    {
+        int size = tileSize << level;
+        int x0 = x / size, x1 = (x + w - 1) / size;
+        int y0 = y / size, y1 = (y + h - 1) / size;
+
+        // The normals of the neighbours use the border of the changed tiles.
+        for (int ty = std::max(y0 - 1, 0); ty <= std::min(y1 + 1, tilesY(level) - 1); ++ty)
+        {
+            for (int tx = std::max(x0 - 1, 0); tx <= std::min(x1 + 1, tilesX(level) - 1); ++tx)
+            {
+                TerrainTileId id = {level, tx, ty};
+                bool changed     = tx >= x0 && tx <= x1 && ty >= y0 && ty <= y1;
+
+                tileCache.erase(id);
+                if (changed) heightCache.erase(id);
+
+                if (!cacheDirectory.empty())
+                {
+                    std::error_code ec;
+                    std::filesystem::remove(cacheFile(id, "normal"), ec);
+                    if (changed) std::filesystem::remove(cacheFile(id, "height"), ec);
+                }
+            }
+        }
+    }
+}
+
+std::vector<TerrainTileId> TerrainPyramid::levelTiles(int level) const
+{
+    std::vector<TerrainTileId> ids;
+    ids.reserve(tilesX(level) * tilesY(level));
+    for (int y = 0; y < tilesY(level); ++y)
+    {
+        for (int x = 0; x < tilesX(level); ++x)
+        {
+            ids.push_back({level, x, y});
+        }
+    }
+    return ids;
+}
+
+TerrainPyramid::HeightImage TerrainPyramid::heights(const TerrainTileId& id)
+{
+    return heightCache.getOrLoad(id, [&]() { return createHeights(id); });
+}
+
+TerrainPyramid::HeightImage TerrainPyramid::createHeights(const TerrainTileId& id)
+{
+    auto img = std::make_shared<TemplatedImage<float>>(tileSize, tileSize);
+
+    std::string file;
+    if (!cacheDirectory.empty())
+    {
+        file = cacheFile(id, "height");
+        if (loadCached(file, *img, tileSize)) return img;
+    }
+
+    if (id.level == 0)
+    {
+        source.heights(img->getImageView(), id.x * tileSize, id.y * tileSize);
+    }
+    else
+    {
+        int half = tileSize / 2;
+        for (int dy = 0; dy < 2; ++dy)
+        {
+            for (int dx = 0; dx < 2; ++dx)
+            {
+                auto child = heights({id.level - 1, 2 * id.x + dx, 2 * id.y + dy});
+                auto dst   = img->getImageView().subImageView(dy * half, dx * half, half, half);
+                downsample2x2(child->getConstImageView(), dst);
+            }
+        }
+    }
+    generated++;
+
+    if (!file.empty()) saveCached(file, *img);
+    return img;
+}
+
+std::shared_ptr<const TerrainTile> TerrainPyramid::createTile(const TerrainTileId& id)
+{
+    auto tile     = std::make_shared<TerrainTile>();
+    tile->id      = id;
+    tile->heights = heights(id);
+
+    std::string file;
+    if (!cacheDirectory.empty())
+    {
+        file = cacheFile(id, "normal");
+        if (loadCached(file, tile->normals, tileSize)) return tile;
+    }
+
+    // The neighbours at the border. Outside of the map the border pixel is repeated.
+    auto neighbour = [&](int dx, int dy) -> HeightImage {
+        TerrainTileId n = {id.level, id.x + dx, id.y + dy};
+        if (n.x < 0 || n.x >= tilesX(n.level) || n.y < 0 || n.y >= tilesY(n.level)) return nullptr;
+        return heights(n);
+    };
+    HeightImage left = neighbour(-1, 0), right = neighbour(1, 0), top = neighbour(0, -1), bottom = neighbour(0, 1);
+
+    auto h = tile->heights->getConstImageView();
+    tile->normals.create(tileSize, tileSize);
+    auto normals = tile->normals.getImageView();
+
+    // Central differences in world space
+    float scale = heightScale / (2 * pixelSize * (1 << id.level));
+
+#pragma omp parallel if (size_t(tileSize) * tileSize > parallelPixels)
+    {
+        // The current row with one extra pixel on both sides
+        std::vector<float> mid(tileSize + 2);
+
+#pragma omp for
+        for (int r = 0; r < tileSize; ++r)
+        {
+            const float* up =
+                r > 0 ? h.rowPtr(r - 1) : (top ? top->getConstImageView().rowPtr(tileSize - 1) : h.rowPtr(r));
+            const float* down =
+                r < tileSize - 1 ? h.rowPtr(r + 1) : (bottom ? bottom->getConstImageView().rowPtr(0) : h.rowPtr(r));
+
+            std::copy(h.rowPtr(r), h.rowPtr(r) + tileSize, mid.begin() + 1);
+            mid[0]            = left ? left->getConstImageView()(r, tileSize - 1) : h(r, 0);
+            mid[tileSize + 1] = right ? right->getConstImageView()(r, 0) : h(r, tileSize - 1);
+
+            const float* m     = mid.data();
+            unsigned char* out = reinterpret_cast<unsigned char*>(normals.rowPtr(r));
+#pragma omp simd
+            for (int c = 0; c < tileSize; ++c)
+            {
+                float dx  = (m[c + 2] - m[c]) * scale;
+                float dz  = (down[c] - up[c]) * scale;
+                float inv = 1.0f / std::sqrt(dx * dx + dz * dz + 1.0f);
+
+                out[4 * c + 0] = (unsigned char)((-dx * inv * 0.5f + 0.5f) * 255.0f + 0.5f);
+                out[4 * c + 1] = (unsigned char)((inv * 0.5f + 0.5f) * 255.0f + 0.5f);
+                out[4 * c + 2] = (unsigned char)((-dz * inv * 0.5f + 0.5f) * 255.0f + 0.5f);
+                out[4 * c + 3] = 255;
+            }
+        }
+    }
+
+    if (!file.empty()) saveCached(file, tile->normals);
+    return tile;
+}
+
+std::string TerrainPyramid::cacheFile(const TerrainTileId& id, const std::string& type) const
+{
+    return cacheDirectory + "/" + std::to_string(id.level) + "_" + std::to_string(id.x) + "_" + std::to_string(id.y) +
+           "." + type;
+}
+
+void TerrainPyramid::checkCacheDirectory()
+{
+    std::stringstream strm;
+    strm << width << " " << height << " " << levels << " " << tileSize << " " << exactNumber(pixelSize) << " "
+         << exactNumber(heightScale);
+    std::string layout = strm.str();
+
+    // The tiles depend on the layout and on the height source.
+    std::string metaFile = cacheDirectory + "/pyramid.txt";
+    std::string cachedLayout, cachedKey;
+    {
+        std::ifstream in(metaFile);
+        std::getline(in, cachedLayout);
+        std::getline(in, cachedKey);
+    }
+    if (cachedLayout == layout && cachedKey == source.key)
+    {
+        matchedCache = true;
+        return;
+    }
+
+    for (auto& entry : std::filesystem::directory_iterator(cacheDirectory))
+    {
+        auto ext = entry.path().extension();
+        if (ext == ".height" || ext == ".normal" || ext == ".tmp") std::filesystem::remove(entry.path());
+    }
+    std::ofstream(metaFile) << layout << "\n" << source.key << std::endl;
+}
+
+}  // namespace Saiga
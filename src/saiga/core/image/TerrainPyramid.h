@@ -0,0 +1,161 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/config.h"
+#include "saiga/core/math/math.h"
+#include "saiga/core/util/DataStructures/ObjectCache.h"
+#include "saiga/core/util/perlinnoise.h"
+
+#include "templatedImage.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Saiga
+{
+struct SAIGA_CORE_API TerrainTileId
+{
+    int level = 0;
+    int x     = 0;
+    int y     = 0;
+
+    bool operator==(const TerrainTileId& other) const
+    {
+        return level == other.level && x == other.x && y == other.y;
+    }
+};
+
+struct SAIGA_CORE_API TerrainTileIdHash
+{
+    size_t operator()(const TerrainTileId& id) const
+    {
+        return (size_t(id.level) * 73856093) ^ (size_t(id.x) * 19349663) ^ (size_t(id.y) * 83492791);
+    }
+};
+
+struct SAIGA_CORE_API TerrainTile
+{
+    TerrainTileId id;
+    // tileSize x tileSize heights in [0,1]
+    std::shared_ptr<const TemplatedImage<float>> heights;
+    // The y-up normals (x, height, z) mapped to [0,255]. The alpha channel is unused.
+    TemplatedImage<ucvec4> normals;
+
+    size_t bytes() const { return heights->size() + normals.size(); }
+};
+
+/**
+ * The level 0 heights of a TerrainPyramid.
+ */
+struct SAIGA_CORE_API TerrainHeightSource
+{
+    // Writes the heights in [0,1] of the level 0 pixels (x + c, y + r) to out(r, c).
+    std::function<void(ImageView<float> out, int x, int y)> heights;
+
+    // Identifies the heights, for example the generator parameters or the file name and modification time of an
+    // input image. The files in a cache directory are only used if they were written with the same key.
+    // Single line. Required if a cache directory is used.
+    std::string key;
+};
+
+/**
+ * A tiled mip pyramid of a heightmap and its normal map, generated on the CPU.
+ *
+ * Level 0 has the full resolution (width x height). Each following level halves the resolution with a 2x2 box filter.
+ * Every level is split into tiles of tileSize x tileSize pixels, so tile (l, x, y) covers the same area as the 4
+ * tiles (l-1, 2x..2x+1, 2y..2y+1).
+ *
+ * - Tiles are created on demand. The heights of level 0 come from the height function, the heights of the other
+ *   levels from their 4 children. The normals use the heights of the neighbour tiles at the border, so there are no
+ *   seams.
+ * - Tiles are kept in memory up to the memory budget (least recently used tiles are evicted).
+ * - If a cache directory is given, every created tile is also written there and later loaded instead of generated.
+ *   The directory is cleared if it was written for a different layout or source key.
+ *   After a part of the map changed, invalidate() removes the affected tiles, so only these are generated again.
+ * - All functions are thread safe, except invalidate(), which must not run concurrently with tile requests.
+ *
+ * Usage:
+ *
+ * TerrainPyramid pyramid(4096, 4096, 5, 256, TerrainPyramid::perlinSource(PerlinNoise(), 1.0 / 512), "terrain/");
+ * pyramid.prefetch(pyramid.levelTiles(4));
+ * auto tile = pyramid.tile({0, 3, 5});
+ */
+class SAIGA_CORE_API TerrainPyramid
+{
+   public:
+    using HeightSource = TerrainHeightSource;
+
+    /**
+     * The width and height must be multiples of tileSize * 2^(levels-1).
+     * 'pixelSize' is the world space distance between two level 0 pixels and 'heightScale' the world space height
+     * of 1. Both are only used for the normals.
+     */
+    TerrainPyramid(int width, int height, int levels, int tileSize, HeightSource source,
+                   const std::string& cacheDirectory = "", size_t memoryBudget = size_t(512) * 1024 * 1024,
+                   float pixelSize = 1, float heightScale = 1);
+
+    // fBm of the noise at (x, y) * scale, normalized to [0,1]. The key contains all parameters.
+    static HeightSource perlinSource(const PerlinNoise& noise, float scale, int octaves = 8, float lacunarity = 2.0,
+                                       float gain = 0.5);
+
+    // Returns the tile. It is loaded from the cache directory or generated if necessary.
+    std::shared_ptr<const TerrainTile> tile(const TerrainTileId& id);
+
+    // Creates all these tiles in parallel.
+    void prefetch(const std::vector<TerrainTileId>& ids);
+
+    // Copies the full level into the images (for example for uploading it to the GPU).
+    void assembleLevel(int level, TemplatedImage<float>& heights, TemplatedImage<ucvec4>& normals);
+
+    /**
+     * The level 0 region [x, x+w) x [y, y+h) has changed.
+     * All tiles that depend on this region are removed from memory and the cache directory.
+     */
+    void invalidate(int x, int y, int w, int h);
+
+    std::vector<TerrainTileId> levelTiles(int level) const;
+
+    int numLevels() const { return levels; }
+    int getTileSize() const { return tileSize; }
+    int levelWidth(int level) const { return width >> level; }
+    int levelHeight(int level) const { return height >> level; }
+    int tilesX(int level) const { return levelWidth(level) / tileSize; }
+    int tilesY(int level) const { return levelHeight(level) / tileSize; }
+
+    // Number of tiles that were generated (and not loaded from the cache directory).
+    size_t numGenerated() const { return generated; }
+
+    // The cache directory already existed for this layout and source key, so its tiles are used.
+    bool cacheMatched() const { return matchedCache; }
+
+   private:
+    using HeightImage = std::shared_ptr<const TemplatedImage<float>>;
+
+    HeightImage heights(const TerrainTileId& id);
+    HeightImage createHeights(const TerrainTileId& id);
+    std::shared_ptr<const TerrainTile> createTile(const TerrainTileId& id);
+
+    std::string cacheFile(const TerrainTileId& id, const std::string& type) const;
+    // Deletes the cache files if they were created for a different pyramid layout or source.
+    void checkCacheDirectory();
+
+    int width, height, levels, tileSize;
+    HeightSource source;
+    std::string cacheDirectory;
+    float pixelSize, heightScale;
+    bool matchedCache = false;
+
+    std::atomic<size_t> generated = 0;
+
+    ObjectCache<TerrainTileId, HeightImage, NoParams, TerrainTileIdHash> heightCache;
+    ObjectCache<TerrainTileId, std::shared_ptr<const TerrainTile>, NoParams, TerrainTileIdHash> tileCache;
+};
+
+}  // namespace Saiga
@@ -13,6 +13,8 @@
 #include "saiga/core/image/png_wrapper.h"
 #include "saiga/core/image/templatedImage.h"
 #include "saiga/core/math/imath.h"
+#include "saiga/core/util/BufferedFileWriter.h"
+#include "saiga/core/util/MemoryMappedFile.h"
 #include "saiga/core/util/color.h"
 #include "saiga/core/util/fileChecker.h"
 #include "saiga/core/util/tostring.h"
@@ -21,6 +23,7 @@
 #include "internal/stb_image_read_wrapper.h"
 #include "internal/stb_image_write_wrapper.h"
 
+#include <algorithm>
 #include <fstream>
 namespace Saiga
 {
@@ -143,6 +146,15 @@ bool Image::loadFromMemory(ArrayView<const char> data)
 {
     bool erg = false;
 
+#ifdef SAIGA_USE_PNG
+    // use libpng for png images
+    const char pngSignature[4] = {char(0x89), 'P', 'N', 'G'};
+    if (data.size() >= 4 && std::equal(pngSignature, pngSignature + 4, data.data()))
+    {
+        return PNG::loadFromMemory(*this, data, false);
+    }
+#endif
+
 #ifdef SAIGA_USE_FREEIMAGE
     erg = FIP::loadFromMemory(data, *this);
     return erg;
@@ -187,24 +199,17 @@ bool Image::save(const std::string& path) const
 bool Image::loadRaw(const std::string& path)
 {
     clear();
-    std::fstream stream;
 
-    try
-    {
-        stream.open(path, std::ios::in | std::ios::binary);
-    }
-    catch (const std::fstream::failure& e)
+    MemoryMappedFile file(path);
+    if (!file.isOpen())
     {
-        std::cout << e.what() << std::endl;
-        std::cout << "Exception opening/reading file\n";
+        std::cout << "Could not open file " << path << std::endl;
         return false;
     }
+    MemoryReader reader(file.view<char>());
 
-    int magic;
-    stream.read((char*)&magic, sizeof(int));
-    stream.read((char*)&width, sizeof(int));
-    stream.read((char*)&height, sizeof(int));
-    stream.read((char*)&type, sizeof(int));
+    int magic = 0;
+    reader >> magic >> width >> height >> type;
     pitchBytes = 0;
 
     SAIGA_ASSERT(magic == SAIGA_BINARY_IMAGE_MAGIC_NUMBER);
@@ -216,46 +221,32 @@ bool Image::loadRaw(const std::string& path)
     int es = elementSize(type);
     for (int i = 0; i < height; ++i)
     {
-        // store it compact
-        stream.read((char*)rowPtr(i), width * es);
+        // stored compact
+        reader.read(rowPtr(i), width * es);
     }
 
-    stream.close();
-
-    return true;
+    return reader.ok();
 }
 
 bool Image::saveRaw(const std::string& path) const
 {
-    std::fstream stream;
-
-    try
+    BufferedFileWriter writer(path);
+    if (!writer.isOpen())
     {
-        stream.open(path, std::ios::out | std::ios::binary);
-    }
-    catch (const std::fstream::failure& e)
-    {
-        std::cout << e.what() << std::endl;
-        std::cout << "Exception opening/reading file\n";
+        std::cout << "Could not open file " << path << std::endl;
         return false;
     }
 
-    int magic = 8574385;
-    stream.write((char*)&magic, sizeof(int));
-    stream.write((char*)&width, sizeof(int));
-    stream.write((char*)&height, sizeof(int));
-    stream.write((char*)&type, sizeof(int));
+    int magic = SAIGA_BINARY_IMAGE_MAGIC_NUMBER;
+    writer << magic << width << height << type;
 
     int es = elementSize(type);
     for (int i = 0; i < height; ++i)
     {
         // store it compact
-        stream.write((char*)rowPtr(i), width * es);
+        writer.write(rowPtr(i), width * es);
     }
-    stream.flush();
-    stream.close();
-
-    return true;
+    return writer.close();
 }
 
 bool Image::saveConvert(const std::string& path, float minValue, float maxValue)
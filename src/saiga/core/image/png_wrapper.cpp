@@ -58,18 +58,32 @@ static void writepng_error_handler(png_structp png_ptr, png_const_charp msg)
 }
 
 
-bool readPNG(PngImage* img, const std::string& path, bool invertY)
+struct PNGMemoryReader
 {
-    PNGLoadStore pngls;
+    ArrayView<const char> data;
+    size_t offset = 0;
+};
+
+static void readpng_memory_callback(png_structp png_ptr, png_bytep out, png_size_t length)
+{
+    auto reader = static_cast<PNGMemoryReader*>(png_get_io_ptr(png_ptr));
+    if (reader->offset + length > reader->data.size())
+    {
+        png_error(png_ptr, "read past the end of the memory buffer");
+    }
+    memcpy(out, reader->data.data() + reader->offset, length);
+    reader->offset += length;
+}
 
+// Reads from 'infile' if it is not null and from 'memory' otherwise.
+static bool readPNG(PngImage* img, FILE* infile, PNGMemoryReader* memory, bool invertY)
+{
     png_structp png_ptr;
     png_infop info_ptr;
 
     unsigned int sig_read = 0;
     int interlace_type;
 
-    if ((pngls.infile = fopen(path.c_str(), "rb")) == NULL) return false;
-
     /* Create and initialize the png_struct
      * with the desired error handler
      * functions.  If you want to use the
@@ -86,7 +100,6 @@ bool readPNG(PngImage* img, const std::string& path, bool invertY)
 
     if (png_ptr == NULL)
     {
-        fclose(pngls.infile);
         return false;
     }
 
@@ -95,7 +108,6 @@ bool readPNG(PngImage* img, const std::string& path, bool invertY)
     info_ptr = png_create_info_struct(png_ptr);
     if (info_ptr == NULL)
     {
-        fclose(pngls.infile);
         png_destroy_read_struct(&png_ptr, NULL, NULL);
         return false;
     }
@@ -114,7 +126,6 @@ bool readPNG(PngImage* img, const std::string& path, bool invertY)
         /* Free all of the memory associated
          * with the png_ptr and info_ptr */
         png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
-        fclose(pngls.infile);
         /* If we get here, we had a
          * problem reading the file */
         return false;
@@ -122,7 +133,14 @@ bool readPNG(PngImage* img, const std::string& path, bool invertY)
 
     /* Set up the output control if
      * you are using standard C streams */
-    png_init_io(png_ptr, pngls.infile);
+    if (infile)
+    {
+        png_init_io(png_ptr, infile);
+    }
+    else
+    {
+        png_set_read_fn(png_ptr, memory, readpng_memory_callback);
+    }
 
     /* If we have already
      * read some of the signature */
@@ -195,9 +213,6 @@ bool readPNG(PngImage* img, const std::string& path, bool invertY)
      * and free any memory allocated */
     png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
 
-    /* Close the file */
-    fclose(pngls.infile);
-
     /* That's it */
     return true;
 }
@@ -543,8 +558,23 @@ bool save(const Image& img, const std::string& path, bool invertY)
 
 bool load(Image& img, const std::string& path, bool invertY)
 {
+    FILE* infile = fopen(path.c_str(), "rb");
+    if (!infile) return false;
+
+    PNG::PngImage pngimg;
+    bool erg = PNG::readPNG(&pngimg, infile, nullptr, invertY);
+    fclose(infile);
+    if (erg) PNG::convert(pngimg, img);
+    return erg;
+}
+
+bool loadFromMemory(Image& img, ArrayView<const char> data, bool invertY)
+{
+    PNGMemoryReader reader;
+    reader.data = data;
+
     PNG::PngImage pngimg;
-    bool erg = PNG::readPNG(&pngimg, path, invertY);
+    bool erg = PNG::readPNG(&pngimg, nullptr, &reader, invertY);
     if (erg) PNG::convert(pngimg, img);
     return erg;
 }
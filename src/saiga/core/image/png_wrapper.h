@@ -59,6 +59,7 @@ struct SAIGA_CORE_API PngImage
 
 SAIGA_LOCAL bool save(const Image& img, const std::string& path, bool invertY = false);
 SAIGA_LOCAL bool load(Image& img, const std::string& path, bool invertY = false);
+SAIGA_LOCAL bool loadFromMemory(Image& img, ArrayView<const char> data, bool invertY = false);
 
 }  // namespace PNG
 }  // namespace Saiga
@@ -0,0 +1,296 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "RandomStream.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+
+namespace Saiga
+{
+// Below this number of blocks the bulk functions are not parallelized.
+static constexpr int64_t parallelBlocks = 1 << 12;
+
+// Tables of the ziggurat method for normal random numbers with 128 layers.
+// Marsaglia and Tsang, "The Ziggurat Method for Generating Random Variables", 2000, in the formulation of
+// Doornik, "An Improved Ziggurat Method to Generate Normal Random Samples", 2005.
+struct Ziggurat
+{
+    static constexpr double R = 3.442619855899;
+    static constexpr double V = 9.91256303526217e-3;
+
+    double x[129];
+    // x[i+1] / x[i]
+    double ratio[128];
+
+    Ziggurat()
+    {
+        double f = std::exp(-0.5 * R * R);
+        x[0]     = V / f;
+        x[1]     = R;
+        x[128]   = 0;
+        for (int i = 2; i < 128; ++i)
+        {
+            x[i] = std::sqrt(-2 * std::log(V / x[i - 1] + f));
+            f    = std::exp(-0.5 * x[i] * x[i]);
+        }
+        for (int i = 0; i < 128; ++i) ratio[i] = x[i + 1] / x[i];
+    }
+};
+
+static const Ziggurat& ziggurat()
+{
+    static Ziggurat z;
+    return z;
+}
+
+// The rejected cases (< 1%) of the ziggurat. 'u' and 'layer' are from the first try.
+static double normalSlow(const Ziggurat& z, double u, int layer, RandomStream& rng)
+{
+    while (true)
+    {
+        if (layer == 0)
+        {
+            // Sample from the tail beyond R
+            double x, y;
+            do
+            {
+                x = std::log(1.0 - rng.uniformDouble()) / Ziggurat::R;
+                y = std::log(1.0 - rng.uniformDouble());
+            } while (-2 * y < x * x);
+            return u < 0 ? x - Ziggurat::R : Ziggurat::R - x;
+        }
+
+        double x  = u * z.x[layer];
+        double f0 = std::exp(-0.5 * (z.x[layer] * z.x[layer] - x * x));
+        double f1 = std::exp(-0.5 * (z.x[layer + 1] * z.x[layer + 1] - x * x));
+        if (f1 + rng.uniformDouble() * (f0 - f1) < 1.0) return x;
+
+        uint64_t bits = rng.next64();
+        u             = 2 * RandomStream::toDouble(bits) - 1;
+        layer         = bits & 0x7F;
+        if (std::abs(u) < z.ratio[layer]) return u * z.x[layer];
+    }
+}
+
+// Standard normal sample from 64 random bits. The rare rejections draw more numbers from the stream created by
+// 'fallback'.
+template <typename Fallback>
+static inline double normal(const Ziggurat& z, uint64_t bits, Fallback fallback)
+{
+    // The upper 53 bits are used for u and the lowest 7 bits for the layer.
+    double u  = 2 * RandomStream::toDouble(bits) - 1;
+    int layer = bits & 0x7F;
+    if (std::abs(u) < z.ratio[layer]) return u * z.x[layer];
+    RandomStream rng = fallback();
+    return normalSlow(z, u, layer, rng);
+}
+
+// Same with 32 bits (24 for u)
+template <typename Fallback>
+static inline float normal(const Ziggurat& z, uint32_t bits, Fallback fallback)
+{
+    double u  = 2 * double(RandomStream::toFloat(bits)) - 1;
+    int layer = bits & 0x7F;
+    if (std::abs(u) < z.ratio[layer]) return u * z.x[layer];
+    RandomStream rng = fallback();
+    return normalSlow(z, u, layer, rng);
+}
+
+double RandomStream::gauss(double mean, double stddev)
+{
+    auto& z       = ziggurat();
+    uint64_t bits = next64();
+    double u      = 2 * toDouble(bits) - 1;
+    int layer     = bits & 0x7F;
+    double g      = std::abs(u) < z.ratio[layer] ? u * z.x[layer] : normalSlow(z, u, layer, *this);
+    return mean + stddev * g;
+}
+
+RandomStream RandomStream::fallbackStream(uint64_t element) const
+{
+    RandomStream rng(*this);
+    rng.stream = ~stream;
+    rng.seek(element << 16);
+    return rng;
+}
+
+void RandomStream::fillUniform(float* out, size_t n, float low, float high)
+{
+    int64_t numBlocks = (n + 3) / 4;
+    uint64_t first    = take(numBlocks);
+    float scale       = high - low;
+
+#pragma omp parallel for if (numBlocks > parallelBlocks)
+    for (int64_t b = 0; b < numBlocks; ++b)
+    {
+        auto r = block(first + b);
+        for (int j = 0; j < 4; ++j)
+        {
+            size_t i = b * 4 + j;
+            if (i < n) out[i] = low + scale * toFloat(r[j]);
+        }
+    }
+}
+
+void RandomStream::fillUniform(double* out, size_t n, double low, double high)
+{
+    int64_t numBlocks = (n + 1) / 2;
+    uint64_t first    = take(numBlocks);
+    double scale      = high - low;
+
+#pragma omp parallel for if (numBlocks > parallelBlocks)
+    for (int64_t b = 0; b < numBlocks; ++b)
+    {
+        auto r = block(first + b);
+        for (int j = 0; j < 2; ++j)
+        {
+            size_t i = b * 2 + j;
+            if (i < n) out[i] = low + scale * toDouble((uint64_t(r[2 * j]) << 32) | r[2 * j + 1]);
+        }
+    }
+}
+
+void RandomStream::fillGaussian(float* out, size_t n, float mean, float stddev)
+{
+    int64_t numBlocks = (n + 3) / 4;
+    uint64_t first    = take(numBlocks);
+    auto& z           = ziggurat();
+
+#pragma omp parallel for if (numBlocks > parallelBlocks)
+    for (int64_t b = 0; b < numBlocks; ++b)
+    {
+        auto r = block(first + b);
+        for (int j = 0; j < 4; ++j)
+        {
+            uint64_t i = b * 4 + j;
+            if (i < n) out[i] = mean + stddev * normal(z, r[j], [&]() { return fallbackStream((first + b) * 4 + j); });
+        }
+    }
+}
+
+void RandomStream::fillGaussian(double* out, size_t n, double mean, double stddev)
+{
+    int64_t numBlocks = (n + 1) / 2;
+    uint64_t first    = take(numBlocks);
+    auto& z           = ziggurat();
+
+#pragma omp parallel for if (numBlocks > parallelBlocks)
+    for (int64_t b = 0; b < numBlocks; ++b)
+    {
+        auto r = block(first + b);
+        for (int j = 0; j < 2; ++j)
+        {
+            uint64_t i    = b * 2 + j;
+            uint64_t bits = (uint64_t(r[2 * j]) << 32) | r[2 * j + 1];
+            if (i < n) out[i] = mean + stddev * normal(z, bits, [&]() { return fallbackStream((first + b) * 2 + j); });
+        }
+    }
+}
+
+namespace Random
+{
+// Floyd's algorithm: For j in [n-k, n) pick t in [0, j]. If t was already taken, take j instead.
+// Every k-subset has the same probability.
+static void floydBitfield(int sampleCount, int indexSize, RandomStream& rng, std::vector<uint64_t>& used,
+                          std::vector<int>* data)
+{
+    used.assign((indexSize + 63) / 64, 0);
+    for (int j = indexSize - sampleCount; j < indexSize; ++j)
+    {
+        int t = rng.uniformInt(0, j);
+        if (used[t / 64] & (uint64_t(1) << (t % 64))) t = j;
+        used[t / 64] |= uint64_t(1) << (t % 64);
+        if (data) data->push_back(t);
+    }
+}
+
+static inline int lowestSetBit(uint64_t bits)
+{
+#if defined(__GNUC__)
+    return __builtin_ctzll(bits);
+#else
+    int b = 0;
+    while (!(bits & 1))
+    {
+        bits >>= 1;
+        ++b;
+    }
+    return b;
+#endif
+}
+
+// In the dense case a bit field is cheaper than a hash set.
+static bool isDense(int sampleCount, int indexSize)
+{
+    return int64_t(indexSize) <= int64_t(sampleCount) * 32;
+}
+
+std::vector<int> uniqueIndices(int sampleCount, int indexSize, RandomStream& rng)
+{
+    SAIGA_ASSERT(sampleCount >= 0 && sampleCount <= indexSize);
+
+    std::vector<int> data;
+    data.reserve(sampleCount);
+
+    if (isDense(sampleCount, indexSize))
+    {
+        std::vector<uint64_t> used;
+        floydBitfield(sampleCount, indexSize, rng, used, &data);
+    }
+    else
+    {
+        std::unordered_set<int> used;
+        used.reserve(sampleCount * 2);
+        for (int j = indexSize - sampleCount; j < indexSize; ++j)
+        {
+            int t = rng.uniformInt(0, j);
+            if (!used.insert(t).second)
+            {
+                t = j;
+                used.insert(t);
+            }
+            data.push_back(t);
+        }
+    }
+
+    // Floyd's algorithm selects a uniform subset, but the insertion order is not a uniform permutation (j is always
+    // the last element if it was taken). Shuffle it, so the order is random like in the original implementation.
+    for (int i = sampleCount - 1; i > 0; --i)
+    {
+        std::swap(data[i], data[rng.uniformInt(0, i)]);
+    }
+    return data;
+}
+
+std::vector<int> sortedUniqueIndices(int sampleCount, int indexSize, RandomStream& rng)
+{
+    SAIGA_ASSERT(sampleCount >= 0 && sampleCount <= indexSize);
+    if (!isDense(sampleCount, indexSize))
+    {
+        auto data = uniqueIndices(sampleCount, indexSize, rng);
+        std::sort(data.begin(), data.end());
+        return data;
+    }
+
+    // Collect the set bits in order instead of sorting.
+    std::vector<uint64_t> used;
+    floydBitfield(sampleCount, indexSize, rng, used, nullptr);
+    std::vector<int> data;
+    data.reserve(sampleCount);
+    for (int w = 0; w < (int)used.size(); ++w)
+    {
+        for (uint64_t bits = used[w]; bits; bits &= bits - 1)
+        {
+            data.push_back(w * 64 + lowestSetBit(bits));
+        }
+    }
+    return data;
+}
+}  // namespace Random
+
+}  // namespace Saiga
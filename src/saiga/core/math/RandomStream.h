@@ -0,0 +1,188 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/config.h"
+#include "saiga/core/util/assert.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace Saiga
+{
+/**
+ * A counter based random number generator (Philox4x32-10, Salmon et al. "Parallel random numbers: as easy as
+ * 1, 2, 3", 2011).
+ *
+ * The output is a pure function of (seed, stream, index). Parallel code is therefore reproducible independent of the
+ * number of threads. Either each thread/task uses its own stream, or all threads use block(index) of one stream.
+ *
+ * Usage:
+ *
+ * RandomStream rng(seed);
+ * rng.fillGaussian(noise.data(), noise.size(), 0, stddev);
+ *
+ * #pragma omp parallel for
+ * for (int i = 0; i < n; ++i)
+ * {
+ *      RandomStream local(seed, i);
+ *      int x = local.uniformInt(0, 10);
+ * }
+ *
+ * RandomStream also fulfills the UniformRandomBitGenerator requirements, so it can be used with std::shuffle and the
+ * std distributions.
+ */
+class SAIGA_CORE_API RandomStream
+{
+   public:
+    using result_type = uint32_t;
+    using Block       = std::array<uint32_t, 4>;
+
+    RandomStream(uint64_t seed = 0, uint64_t stream = 0)
+        : key{uint32_t(seed), uint32_t(seed >> 32)}, stream(stream)
+    {
+    }
+
+    // The 4 random numbers at this index. Does not change the state.
+    Block block(uint64_t index) const
+    {
+        return philox({uint32_t(index), uint32_t(index >> 32), uint32_t(stream), uint32_t(stream >> 32)}, key);
+    }
+
+    // ============ Sequential interface ============
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return 0xFFFFFFFF; }
+
+    result_type operator()()
+    {
+        if (used == 4)
+        {
+            current = block(counter++);
+            used    = 0;
+        }
+        return current[used++];
+    }
+
+    uint64_t next64()
+    {
+        uint64_t hi = (*this)();
+        return (hi << 32) | (*this)();
+    }
+
+    // [low, high)
+    double uniformDouble(double low = 0, double high = 1) { return low + (high - low) * toDouble(next64()); }
+    float uniformFloat(float low = 0, float high = 1) { return low + (high - low) * toFloat((*this)()); }
+
+    // [low, high] (inclusive, same as Random::uniformInt)
+    int uniformInt(int low, int high)
+    {
+        SAIGA_DEBUG_ASSERT(low <= high);
+        uint64_t range = uint64_t(int64_t(high) - int64_t(low)) + 1;
+        // Multiply shift without rejection (Lemire). The bias of range/2^32 is negligible for typical ranges.
+        return int(int64_t(low) + int64_t(uint64_t((*this)()) * range >> 32));
+    }
+
+    // Normal distribution (Ziggurat method)
+    double gauss(double mean = 0, double stddev = 1);
+
+    // ============ Bulk interface ============
+    // The numbers are generated in parallel (OpenMP) from the following blocks of this stream.
+    // The result does not depend on the number of threads.
+
+    void fillUniform(float* out, size_t n, float low = 0, float high = 1);
+    void fillUniform(double* out, size_t n, double low = 0, double high = 1);
+    void fillGaussian(float* out, size_t n, float mean = 0, float stddev = 1);
+    void fillGaussian(double* out, size_t n, double mean = 0, double stddev = 1);
+
+    // Fills an array of fixed size Eigen vectors (for example Vec3 or vec2).
+    template <typename VectorType>
+    void fillUniform(VectorType* out, size_t n, const VectorType& low, const VectorType& high)
+    {
+        if (n == 0) return;
+        fillUniform(scalars(out), n * VectorType::SizeAtCompileTime);
+        for (size_t i = 0; i < n; ++i)
+        {
+            out[i] = low + (high - low).cwiseProduct(out[i]);
+        }
+    }
+
+    template <typename VectorType>
+    void fillGaussian(VectorType* out, size_t n, typename VectorType::Scalar mean = 0,
+                      typename VectorType::Scalar stddev = 1)
+    {
+        if (n == 0) return;
+        fillGaussian(scalars(out), n * VectorType::SizeAtCompileTime, mean, stddev);
+    }
+
+    // The index of the next block.
+    uint64_t position() const { return counter; }
+    void seek(uint64_t index)
+    {
+        counter = index;
+        used    = 4;
+    }
+
+    // Uniform in [0,1) with full mantissa precision.
+    static double toDouble(uint64_t x) { return (x >> 11) * (1.0 / (uint64_t(1) << 53)); }
+    static float toFloat(uint32_t x) { return (x >> 8) * (1.0f / (1u << 24)); }
+
+    static Block philox(Block ctr, std::array<uint32_t, 2> k)
+    {
+        for (int round = 0; round < 10; ++round)
+        {
+            uint64_t p0 = uint64_t(0xD2511F53) * ctr[0];
+            uint64_t p1 = uint64_t(0xCD9E8D57) * ctr[2];
+            ctr         = {uint32_t(p1 >> 32) ^ ctr[1] ^ k[0], uint32_t(p1), uint32_t(p0 >> 32) ^ ctr[3] ^ k[1],
+                   uint32_t(p0)};
+            k[0] += 0x9E3779B9;
+            k[1] += 0xBB67AE85;
+        }
+        return ctr;
+    }
+
+   private:
+    template <typename VectorType>
+    static typename VectorType::Scalar* scalars(VectorType* v)
+    {
+        static_assert(sizeof(VectorType) == sizeof(typename VectorType::Scalar) * VectorType::SizeAtCompileTime,
+                      "The vector type must be densely packed.");
+        return v->data();
+    }
+
+    // Used by the bulk functions for the rare cases that need more random numbers than one block.
+    RandomStream fallbackStream(uint64_t element) const;
+
+    // Reserves the blocks for a bulk call.
+    uint64_t take(uint64_t numBlocks)
+    {
+        uint64_t first = counter;
+        seek(counter + numBlocks);
+        return first;
+    }
+
+    std::array<uint32_t, 2> key;
+    uint64_t stream;
+    uint64_t counter = 0;
+    Block current;
+    int used = 4;
+};
+
+namespace Random
+{
+/**
+ * Returns 'sampleCount' unique integers between 0 and indexSize-1 in O(sampleCount) (Floyd's algorithm).
+ * The returned indices are in random order (a uniform permutation of a uniform subset).
+ */
+SAIGA_CORE_API std::vector<int> uniqueIndices(int sampleCount, int indexSize, RandomStream& rng);
+
+// Same as above, but sorted. Faster than sorting the result of uniqueIndices if sampleCount is large.
+SAIGA_CORE_API std::vector<int> sortedUniqueIndices(int sampleCount, int indexSize, RandomStream& rng);
+}  // namespace Random
+
+}  // namespace Saiga
@@ -6,6 +6,7 @@
 
 #include "saiga/core/math/random.h"
 
+#include "saiga/core/math/RandomStream.h"
 #include "saiga/core/util/assert.h"
 
 #include <chrono>
@@ -71,22 +72,8 @@ double gaussRand(double mean, double stddev)
 
 std::vector<int> uniqueIndices(int sampleCount, int indexSize)
 {
-    SAIGA_ASSERT(sampleCount <= indexSize);
-
-    std::vector<bool> used(indexSize, false);
-    std::vector<int> data(sampleCount);
-
-    for (int j = 0; j < sampleCount;)
-    {
-        int s = uniformInt(0, indexSize - 1);
-        if (!used[s])
-        {
-            data[j] = s;
-            used[s] = true;
-            j++;
-        }
-    }
-    return data;
+    RandomStream rng(urand64());
+    return uniqueIndices(sampleCount, indexSize, rng);
 }
 
 
@@ -72,6 +72,7 @@ SAIGA_CORE_API uint64_t urand64();
 /**
  * Returns 'sampleCount' unique integers between 0 and indexSize-1
  * The returned indices are NOT sorted!
+ * For bulk and parallel random numbers see RandomStream.h.
  */
 SAIGA_CORE_API std::vector<int> uniqueIndices(int sampleCount, int indexSize);
 
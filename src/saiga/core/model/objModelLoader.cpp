@@ -8,7 +8,8 @@
 
 #include "saiga/core/math/String.h"
 #include "saiga/core/time/all.h"
-#include "saiga/core/util/file.h"
+#include "saiga/core/util/MemoryMappedFile.h"
+#include "saiga/core/util/TextParser.h"
 #include "saiga/core/util/fileChecker.h"
 #include "saiga/core/util/tostring.h"
 
@@ -51,17 +52,19 @@ bool ObjModelLoader::loadFile(const std::string& _file)
     tg.faces     = 0;
     triangleGroups.push_back(tg);
 
-    std::vector<std::string> data;
     {
         //        SAIGA_BLOCK_TIMER();
-        data = File::loadFileStringArray(file);
-        File::removeWindowsLineEnding(data);
-    }
-    {
-        //        SAIGA_BLOCK_TIMER();
-        for (auto& line : data)
+        // The lines are parsed directly from the mapped file
+        MemoryMappedFile mmf(file);
+        if (!mmf.isOpen())
+        {
+            std::cerr << "Could not open file " << file << std::endl;
+            return false;
+        }
+        TextParser data(mmf.view<char>());
+        while (!data.atEnd())
         {
-            lineParser.set(line);
+            lineParser.set(data.line());
             parseLine();
         }
     }
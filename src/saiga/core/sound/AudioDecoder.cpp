@@ -0,0 +1,245 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "AudioDecoder.h"
+
+#include "saiga/core/util/assert.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#ifdef SAIGA_USE_OPUS
+#    include "opusfile.h"
+#endif
+
+#include "internal/noGraphicsAPI.h"
+
+namespace Saiga
+{
+namespace sound
+{
+static bool readDecoded(std::istream& stream, void* dst, int size, int offset)
+{
+    stream.read(reinterpret_cast<char*>(dst), size);
+    auto bytes = reinterpret_cast<char*>(dst);
+    for (int i = 0; i < size; ++i)
+    {
+        bytes[i] -= offset;
+    }
+    return bool(stream);
+}
+
+static bool hasTag(const unsigned char* tag, const char* expected, int offset)
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        if (tag[i] != (unsigned char)(expected[i] + offset)) return false;
+    }
+    return true;
+}
+
+// http://www.dunsanyinteractive.com/blogs/oliver/?p=72
+bool readWaveHeader(std::istream& stream, WAVE_Format& format, WAVE_Data& data, int& offset)
+{
+    const int allowedOffset = 0x42;
+
+    RIFF_Header riff_header;
+    if (!stream.read((char*)&riff_header, sizeof(RIFF_Header)))
+    {
+        std::cout << "Invalid RIFF or WAVE Header" << std::endl;
+        return false;
+    }
+
+    // check for RIFF and WAVE tag in memeory
+    if (hasTag(riff_header.chunkID, "RIFF", 0) && hasTag(riff_header.format, "WAVE", 0))
+    {
+        // normal riff wave header.
+        offset = 0;
+    }
+    else if (hasTag(riff_header.chunkID, "RIFF", allowedOffset) && hasTag(riff_header.format, "WAVE", allowedOffset))
+    {
+        //'encoded' wave header.
+        offset = allowedOffset;
+    }
+    else
+    {
+        std::cout << "Invalid RIFF or WAVE Header" << std::endl;
+        return false;
+    }
+
+    // Read in the 2nd chunk for the wave info
+    readDecoded(stream, &format, sizeof(WAVE_Format), offset);
+    // check for fmt tag in memory
+    if (!hasTag((unsigned char*)format.subChunkID, "fmt ", 0))
+    {
+        std::cout << "Invalid Wave Format" << std::endl;
+        return false;
+    }
+
+    // check for extra parameters;
+    if (format.subChunkSize > 16)
+    {
+        short bla;  // ignore them
+        stream.read((char*)&bla, sizeof(short));
+    }
+
+    // Read in the the last byte of data before the sound file
+    readDecoded(stream, &data, sizeof(WAVE_Data), offset);
+
+    // check for data tag in memory
+    if (!hasTag((unsigned char*)data.subChunkID, "data", 0))
+    {
+        std::cout << "Invalid data header" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool WaveDecoder::open(const std::string& file)
+{
+    stream.open(file, std::ifstream::binary);
+    if (!stream.is_open())
+    {
+        std::cout << "Could not open file " << file << std::endl;
+        return false;
+    }
+
+    WAVE_Format format;
+    WAVE_Data data;
+    if (!readWaveHeader(stream, format, data, offset)) return false;
+
+    if ((format.bitsPerSample != 8 && format.bitsPerSample != 16) || format.numChannels < 1)
+    {
+        std::cout << "Unsupported wave format in " << file << ": " << format.bitsPerSample << " bits, "
+                  << format.numChannels << " channels" << std::endl;
+        return false;
+    }
+
+    channels       = format.numChannels;
+    sampleRate     = format.sampleRate;
+    bytesPerSample = format.bitsPerSample / 8;
+    dataBytes      = data.subChunk2Size;
+    dataStart      = stream.tellg();
+    return true;
+}
+
+int WaveDecoder::read(int16_t* out, int frames)
+{
+    size_t frameBytes = size_t(bytesPerSample) * channels;
+    size_t bytes      = std::min(size_t(frames) * frameBytes, dataBytes - bytesRead) / frameBytes * frameBytes;
+    if (bytes == 0) return 0;
+
+    unsigned char* dst;
+    if (bytesPerSample == 2)
+    {
+        dst = reinterpret_cast<unsigned char*>(out);
+    }
+    else
+    {
+        scratch.resize(bytes);
+        dst = scratch.data();
+    }
+
+    stream.read(reinterpret_cast<char*>(dst), bytes);
+    bytes = stream.gcount() / frameBytes * frameBytes;
+    bytesRead += bytes;
+
+    if (offset != 0)
+    {
+        for (size_t i = 0; i < bytes; ++i) dst[i] -= offset;
+    }
+
+    if (bytesPerSample == 1)
+    {
+        // 8 bit wave samples are unsigned
+        for (size_t i = 0; i < bytes; ++i) out[i] = int16_t((int(dst[i]) - 128) * 256);
+    }
+    return int(bytes / frameBytes);
+}
+
+bool WaveDecoder::rewind()
+{
+    stream.clear();
+    stream.seekg(dataStart);
+    bytesRead = 0;
+    return bool(stream);
+}
+
+#ifdef SAIGA_USE_OPUS
+OpusFileDecoder::~OpusFileDecoder()
+{
+    if (file) op_free(static_cast<OggOpusFile*>(file));
+}
+
+bool OpusFileDecoder::open(const std::string& filename)
+{
+    int error;
+    file = op_open_file(filename.c_str(), &error);
+    if (error || !file)
+    {
+        std::cout << "could not open file: " << filename << std::endl;
+        file = nullptr;
+        return false;
+    }
+
+    // The <tt>libopusfile</tt> API always decodes files to 48kHz.
+    // The original sample rate is not preserved by the lossy compression.
+    sampleRate = 48000;
+    channels   = op_channel_count(static_cast<OggOpusFile*>(file), -1);
+    return channels == 1 || channels == 2;
+}
+
+int OpusFileDecoder::read(int16_t* out, int frames)
+{
+    auto f    = static_cast<OggOpusFile*>(file);
+    int total = 0;
+    while (total < frames)
+    {
+        // op_read returns the number of samples per channel
+        int n = op_read(f, out + total * channels, (frames - total) * channels, nullptr);
+        if (n <= 0)
+        {
+            if (n < 0) std::cout << "Opus decode error " << n << std::endl;
+            break;
+        }
+        total += n;
+    }
+    return total;
+}
+
+bool OpusFileDecoder::rewind()
+{
+    return op_pcm_seek(static_cast<OggOpusFile*>(file), 0) == 0;
+}
+#endif
+
+std::unique_ptr<AudioDecoder> openDecoder(const std::string& file)
+{
+    std::string ending = file.substr(file.find_last_of(".") + 1);
+
+#ifdef SAIGA_USE_OPUS
+    if (ending == "opus")
+    {
+        auto decoder = std::make_unique<OpusFileDecoder>();
+        if (decoder->open(file)) return decoder;
+        return nullptr;
+    }
+#endif
+
+    if (ending == "wav")
+    {
+        auto decoder = std::make_unique<WaveDecoder>();
+        if (decoder->open(file)) return decoder;
+        return nullptr;
+    }
+
+    std::cout << "Unknown file extension for sound file: " << file << std::endl;
+    return nullptr;
+}
+
+}  // namespace sound
+}  // namespace Saiga
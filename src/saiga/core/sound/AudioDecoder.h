@@ -0,0 +1,119 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/config.h"
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Saiga
+{
+namespace sound
+{
+struct SAIGA_LOCAL RIFF_Header
+{
+    unsigned char chunkID[4];
+    int chunkSize;  // size not including chunkSize or chunkID
+    unsigned char format[4];
+};
+
+/*
+ * Struct to hold fmt subchunk data for WAVE files.
+ */
+struct SAIGA_LOCAL WAVE_Format
+{
+    char subChunkID[4];
+    int subChunkSize;
+    short audioFormat;
+    short numChannels;
+    int sampleRate;
+    int byteRate;
+    short blockAlign;
+    short bitsPerSample;
+};
+
+/*
+ * Struct to hold the data of the wave file
+ */
+struct SAIGA_LOCAL WAVE_Data
+{
+    char subChunkID[4];  // should contain the word data
+    int subChunk2Size;   // Stores the size of the data block
+};
+
+/**
+ * Reads the headers of a wave file. Afterwards the stream points to the first sample.
+ * 'offset' is the value that was added to each byte of an 'encoded' wave file (0 for normal files).
+ */
+SAIGA_CORE_API bool readWaveHeader(std::istream& stream, WAVE_Format& format, WAVE_Data& data, int& offset);
+
+/**
+ * Decodes a sound file piece by piece to interleaved 16 bit PCM.
+ * Does not depend on OpenAL, so it can also be used without an audio device.
+ */
+class SAIGA_CORE_API AudioDecoder
+{
+   public:
+    virtual ~AudioDecoder() {}
+
+    int channels   = 0;
+    int sampleRate = 0;
+
+    // Decodes up to 'frames' frames (= frames * channels samples). Returns the number of decoded frames.
+    // 0 means the end of the file.
+    virtual int read(int16_t* out, int frames) = 0;
+
+    // Jumps back to the first frame.
+    virtual bool rewind() = 0;
+};
+
+// Uncompressed 8 and 16 bit wave files. 8 bit samples are converted to 16 bit.
+class SAIGA_CORE_API WaveDecoder : public AudioDecoder
+{
+   public:
+    bool open(const std::string& file);
+
+    int read(int16_t* out, int frames) override;
+    bool rewind() override;
+
+   private:
+    std::ifstream stream;
+    std::streampos dataStart;
+    size_t dataBytes = 0;
+    size_t bytesRead = 0;
+    int bytesPerSample;
+    int offset;
+    std::vector<unsigned char> scratch;
+};
+
+#ifdef SAIGA_USE_OPUS
+// Ogg Opus files (with libopusfile). Always 48kHz.
+class SAIGA_CORE_API OpusFileDecoder : public AudioDecoder
+{
+   public:
+    ~OpusFileDecoder();
+
+    bool open(const std::string& file);
+
+    int read(int16_t* out, int frames) override;
+    bool rewind() override;
+
+   private:
+    // OggOpusFile
+    void* file = nullptr;
+};
+#endif
+
+// Selects the decoder by the file ending. Returns nullptr if the file could not be opened.
+SAIGA_CORE_API std::unique_ptr<AudioDecoder> openDecoder(const std::string& file);
+
+}  // namespace sound
+}  // namespace Saiga
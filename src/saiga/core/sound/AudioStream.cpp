@@ -0,0 +1,164 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "AudioStream.h"
+
+#include "saiga/core/util/assert.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "internal/noGraphicsAPI.h"
+
+namespace Saiga
+{
+namespace sound
+{
+size_t PcmRingBuffer::read(int16_t* out, size_t n)
+{
+    size_t r = readPos.load(std::memory_order_relaxed);
+    size_t w = writePos.load(std::memory_order_acquire);
+    n        = std::min(n, w - r);
+
+    // At most two copies, because the samples can wrap around the end.
+    size_t offset = r % data.size();
+    size_t first  = std::min(n, data.size() - offset);
+    std::copy(data.begin() + offset, data.begin() + offset + first, out);
+    std::copy(data.begin(), data.begin() + (n - first), out + first);
+
+    readPos.store(r + n, std::memory_order_release);
+    return n;
+}
+
+int16_t* PcmRingBuffer::writeBlock(size_t& n)
+{
+    size_t w      = writePos.load(std::memory_order_relaxed);
+    size_t r      = readPos.load(std::memory_order_acquire);
+    size_t offset = w % data.size();
+    n             = std::min(data.size() - (w - r), data.size() - offset);
+    return data.data() + offset;
+}
+
+AudioStream::AudioStream(Private, std::unique_ptr<AudioDecoder> _decoder, bool loop, int chunkFrames)
+    : decoder(std::move(_decoder)),
+      loop(loop),
+      chunkFrames(chunkFrames),
+      buffer(size_t(2) * chunkFrames * decoder->channels)
+{
+    SAIGA_ASSERT(decoder->channels > 0 && chunkFrames > 0);
+}
+
+std::shared_ptr<AudioStream> AudioStream::open(const std::string& file, bool loop, int chunkFrames)
+{
+    auto decoder = openDecoder(file);
+    if (!decoder) return nullptr;
+    return create(std::move(decoder), loop, chunkFrames);
+}
+
+std::shared_ptr<AudioStream> AudioStream::create(std::unique_ptr<AudioDecoder> decoder, bool loop, int chunkFrames)
+{
+    SAIGA_ASSERT(decoder);
+    auto stream = std::make_shared<AudioStream>(Private(), std::move(decoder), loop, chunkFrames);
+    stream->decode();
+    return stream;
+}
+
+int AudioStream::read(int16_t* out, int frames)
+{
+    int n = int(buffer.read(out, size_t(frames) * channels()) / channels());
+
+    if (!endOfStream)
+    {
+        if (n < frames) underruns++;
+        if (buffer.freeSpace() >= size_t(chunkFrames) * channels()) scheduleDecode();
+    }
+    return n;
+}
+
+void AudioStream::decode()
+{
+    std::unique_lock lock(decodeMutex);
+
+    bool rewound = false;
+    while (!endOfStream)
+    {
+        size_t n;
+        int16_t* block = buffer.writeBlock(n);
+        int frames     = int(std::min(n / channels(), size_t(chunkFrames)));
+        if (frames == 0) break;
+
+        int decoded = decoder->read(block, frames);
+        if (decoded > 0)
+        {
+            buffer.commit(size_t(decoded) * channels());
+            rewound = false;
+        }
+        else if (loop && !rewound && decoder->rewind())
+        {
+            // Stops after an empty file
+            rewound = true;
+        }
+        else
+        {
+            endOfStream = true;
+        }
+    }
+}
+
+void AudioStream::scheduleDecode()
+{
+    if (decodeScheduled.exchange(true)) return;
+    auto self = shared_from_this();
+    audioDecodePool().enqueue([self]() {
+        self->decode();
+        self->decodeScheduled = false;
+    });
+}
+
+int audioDecodeThreads()
+{
+    return std::max(2, int(std::thread::hardware_concurrency()) / 2);
+}
+
+ThreadPool& audioDecodePool()
+{
+    static ThreadPool pool(audioDecodeThreads(), "AudioDecode");
+    return pool;
+}
+
+int NullAudioSink::pull(AudioStream& stream, int frames)
+{
+    period.resize(size_t(frames) * stream.channels());
+    int n = stream.read(period.data(), frames);
+    for (int i = 0; i < n * stream.channels(); ++i)
+    {
+        checksum += period[i];
+    }
+    framesPlayed += n;
+    return n;
+}
+
+void NullAudioSink::drain(AudioStream& stream, int periodFrames, bool realTime)
+{
+    auto periodTime = std::chrono::duration<double>(double(periodFrames) / stream.sampleRate());
+    while (!stream.finished())
+    {
+        int n = pull(stream, periodFrames);
+        if (realTime)
+        {
+            std::this_thread::sleep_for(periodTime);
+        }
+        else if (n == 0)
+        {
+            // Wait for the decoder
+            std::this_thread::yield();
+        }
+    }
+}
+
+}  // namespace sound
+}  // namespace Saiga
@@ -0,0 +1,138 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/config.h"
+#include "saiga/core/util/Thread/threadPool.h"
+
+#include "AudioDecoder.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Saiga
+{
+namespace sound
+{
+/**
+ * A lock free ring buffer of PCM samples for one producer and one consumer thread.
+ * The memory is allocated once in the constructor.
+ */
+class SAIGA_CORE_API PcmRingBuffer
+{
+   public:
+    PcmRingBuffer(size_t capacity) : data(capacity) {}
+
+    size_t capacity() const { return data.size(); }
+    size_t size() const { return writePos.load(std::memory_order_acquire) - readPos.load(std::memory_order_acquire); }
+    size_t freeSpace() const { return capacity() - size(); }
+
+    // Consumer: Copies up to n samples to out. Returns the number of copied samples.
+    size_t read(int16_t* out, size_t n);
+
+    // Producer: The largest contiguous free block. Write the samples there and then call commit().
+    int16_t* writeBlock(size_t& n);
+    void commit(size_t n) { writePos.store(writePos.load(std::memory_order_relaxed) + n, std::memory_order_release); }
+
+   private:
+    std::vector<int16_t> data;
+    // Increase monotonically and are taken modulo the capacity
+    alignas(SAIGA_CACHE_LINE_SIZE) std::atomic<size_t> readPos  = 0;
+    alignas(SAIGA_CACHE_LINE_SIZE) std::atomic<size_t> writePos = 0;
+};
+
+/**
+ * Streams a sound file through a small PCM buffer instead of decoding it completely.
+ *
+ * The buffer holds two chunks. While one chunk is played, the other one is decoded by a task on the shared
+ * audioDecodePool() (double buffering). Long music tracks therefore start immediately and use a constant amount of
+ * memory. open() fills the buffer before it returns, so playback can start right away.
+ *
+ * The consumer (an output sink) calls read() from a single thread.
+ *
+ * A stream is always owned by a shared_ptr, because the decode tasks keep it alive. Use open() or create().
+ */
+class SAIGA_CORE_API AudioStream : public std::enable_shared_from_this<AudioStream>
+{
+    // Passkey of the constructor. Only open() and create() can construct a stream.
+    struct Private
+    {
+        explicit Private() = default;
+    };
+
+   public:
+    AudioStream(Private, std::unique_ptr<AudioDecoder> decoder, bool loop, int chunkFrames);
+
+    // Returns nullptr if the file could not be opened.
+    static std::shared_ptr<AudioStream> open(const std::string& file, bool loop = false, int chunkFrames = 8192);
+
+    // Streams from an already opened decoder. Fills the buffer before it returns like open().
+    static std::shared_ptr<AudioStream> create(std::unique_ptr<AudioDecoder> decoder, bool loop = false,
+                                               int chunkFrames = 8192);
+
+    int channels() const { return decoder->channels; }
+    int sampleRate() const { return decoder->sampleRate; }
+
+    /**
+     * Copies up to 'frames' frames of interleaved 16 bit samples to out and returns the number of copied frames.
+     * Less frames are returned at the end of the stream or if the decoder could not keep up (an underrun).
+     */
+    int read(int16_t* out, int frames);
+
+    // All frames have been read.
+    bool finished() const { return endOfStream && buffer.size() == 0; }
+
+    size_t numUnderruns() const { return underruns; }
+
+    // Decodes until the buffer is full. This is usually called by the decode pool.
+    void decode();
+
+   private:
+    void scheduleDecode();
+
+    std::unique_ptr<AudioDecoder> decoder;
+    bool loop;
+    int chunkFrames;
+    PcmRingBuffer buffer;
+
+    std::mutex decodeMutex;
+    std::atomic<bool> decodeScheduled = false;
+    std::atomic<bool> endOfStream     = false;
+    std::atomic<size_t> underruns     = 0;
+};
+
+/**
+ * The worker threads that decode the audio streams and load the sounds of the SoundManager.
+ * Created on first use.
+ */
+SAIGA_CORE_API ThreadPool& audioDecodePool();
+SAIGA_CORE_API int audioDecodeThreads();
+
+/**
+ * An output that discards the samples. Used to test and benchmark the decoding without an audio device.
+ */
+class SAIGA_CORE_API NullAudioSink
+{
+   public:
+    // Reads one period like an audio device would. Returns the number of received frames.
+    int pull(AudioStream& stream, int frames);
+
+    // Pulls periods until the stream is finished. If realTime is set, waits the duration of each period.
+    void drain(AudioStream& stream, int periodFrames = 1024, bool realTime = false);
+
+    size_t framesPlayed = 0;
+    // Sum of all received samples. Used to compare the output of different decode paths.
+    int64_t checksum = 0;
+
+   private:
+    std::vector<int16_t> period;
+};
+
+}  // namespace sound
+}  // namespace Saiga
@@ -50,18 +50,13 @@ struct COpusCodec::Impl
         _decoder.reset(err == OPUS_OK ? raw : throw OpusErrorException(err));
     }
 
-    std::vector<unsigned char> decode_frame(std::istream& fin)
+    bool decode_frame(std::istream& fin, std::vector<unsigned char>& out)
     {
-        std::cout << "decode frame" << std::endl;
-
-        std::vector<unsigned char> out;
         char ch[4] = {0};
 
-        if (!fin.read(ch, 4) && fin.eof()) return out;
+        if (!fin.read(ch, 4) && fin.eof()) return false;
 
         uint32_t len = char_to_int(ch);
-        std::cout << (int)ch[0] << " " << (int)ch[1] << " " << (int)ch[2] << " " << (int)ch[3] << " " << std::endl;
-        std::cout << "len " << len << " " << _state.data.size() << std::endl;
         if (len > _state.data.size()) throw std::runtime_error("Invalid payload length");
 
         fin.read(ch, 4);
@@ -132,7 +127,7 @@ struct COpusCodec::Impl
         _state.lost_prev = lost;
         _state.frameno++;
 
-        return out;
+        return true;
     }
 
    private:
@@ -170,7 +165,14 @@ COpusCodec::~COpusCodec()
 
 std::vector<unsigned char> COpusCodec::decode_frame(std::istream& fin)
 {
-    return _pimpl->decode_frame(fin);
+    std::vector<unsigned char> out;
+    _pimpl->decode_frame(fin, out);
+    return out;
+}
+
+bool COpusCodec::decode_frame(std::istream& fin, std::vector<unsigned char>& out)
+{
+    return _pimpl->decode_frame(fin, out);
 }
 
 }  // namespace Saiga
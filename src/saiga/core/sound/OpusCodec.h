@@ -36,6 +36,10 @@ struct COpusCodec
 
     std::vector<unsigned char> decode_frame(std::istream& fin);
 
+    // Appends the decoded frame to out. Reusing out avoids an allocation per frame.
+    // Returns false at the end of the input.
+    bool decode_frame(std::istream& fin, std::vector<unsigned char>& out);
+
    private:
     struct Impl;
     std::unique_ptr<Impl> _pimpl;
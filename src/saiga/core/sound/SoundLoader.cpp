@@ -59,13 +59,9 @@ void readDecode(std::ifstream& stream, void* dst, int size, int offset)
  */
 Sound* SoundLoader::loadWaveFileRaw(const std::string& filename)
 {
-    //    std::cout << "loadWaveFileRaw " << filename << std::endl;
-    int allowedOffset = 0x42;
-    int offset        = 0;
-
     WAVE_Format wave_format;
-    RIFF_Header riff_header;
     WAVE_Data wave_data;
+    int offset;
 
     std::ifstream stream(filename, std::ifstream::binary);
     if (!stream.is_open())
@@ -74,65 +70,8 @@ Sound* SoundLoader::loadWaveFileRaw(const std::string& filename)
         return nullptr;
     }
 
-    // Read in the first chunk into the struct
-    stream.read((char*)&riff_header, sizeof(RIFF_Header));
+    if (!readWaveHeader(stream, wave_format, wave_data, offset)) return nullptr;
 
-    // check for RIFF and WAVE tag in memeory
-    if (riff_header.chunkID[0] == 'R' && riff_header.chunkID[1] == 'I' && riff_header.chunkID[2] == 'F' &&
-        riff_header.chunkID[3] == 'F' && riff_header.format[0] == 'W' && riff_header.format[1] == 'A' &&
-        riff_header.format[2] == 'V' && riff_header.format[3] == 'E')
-    {
-        // normal riff wave header.
-        offset = 0;
-    }
-    else if (riff_header.chunkID[0] == 'R' + allowedOffset && riff_header.chunkID[1] == 'I' + allowedOffset &&
-             riff_header.chunkID[2] == 'F' + allowedOffset && riff_header.chunkID[3] == 'F' + allowedOffset &&
-             riff_header.format[0] == 'W' + allowedOffset && riff_header.format[1] == 'A' + allowedOffset &&
-             riff_header.format[2] == 'V' + allowedOffset && riff_header.format[3] == 'E' + allowedOffset)
-    {
-        //'encoded' wave header.
-        offset = 0x42;
-        //        std::cout << "found encoded riff wave header! " << std::endl;
-        //        return nullptr;
-    }
-    else
-    {
-        //        std::cout << (int)riff_header.chunkID[0] << " " << " " << (int) 'R' << " " <<  (int)'R' +
-        //        allowedOffset << " " << (int)(riff_header.chunkID[0] - (char)allowedOffset) <<  std::endl;
-        std::cout << "Invalid RIFF or WAVE Header" << std::endl;
-        return nullptr;
-    }
-
-    // Read in the 2nd chunk for the wave info
-    //    stream.read( (char*)&wave_format,sizeof(WAVE_Format));
-    readDecode(stream, &wave_format, sizeof(WAVE_Format), offset);
-    // check for fmt tag in memory
-    if (wave_format.subChunkID[0] != 'f' || wave_format.subChunkID[1] != 'm' || wave_format.subChunkID[2] != 't' ||
-        wave_format.subChunkID[3] != ' ')
-    {
-        std::cout << "Invalid Wave Format" << std::endl;
-        return nullptr;
-    }
-
-    // check for extra parameters;
-    if (wave_format.subChunkSize > 16)
-    {
-        short bla;  // ignore them
-        stream.read((char*)&bla, sizeof(short));
-    }
-
-    // Read in the the last byte of data before the sound file
-    //    stream.read( (char*)&wave_data,sizeof(WAVE_Data));
-
-    readDecode(stream, &wave_data, sizeof(WAVE_Data), offset);
-
-    // check for data tag in memory
-    if (wave_data.subChunkID[0] != 'd' || wave_data.subChunkID[1] != 'a' || wave_data.subChunkID[2] != 't' ||
-        wave_data.subChunkID[3] != 'a')
-    {
-        std::cout << "Invalid data header" << std::endl;
-        return nullptr;
-    }
     //        std::cout << "size of data: " << wave_data.subChunk2Size << std::endl;
 
     std::vector<unsigned char> data(wave_data.subChunk2Size);
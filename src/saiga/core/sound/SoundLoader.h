@@ -9,44 +9,13 @@
 #include "saiga/config.h"
 #include "saiga/core/math/math.h"
 
+#include "AudioDecoder.h"
 #include "Sound.h"
 
 namespace Saiga
 {
 namespace sound
 {
-struct SAIGA_LOCAL RIFF_Header
-{
-    unsigned char chunkID[4];
-    int chunkSize;  // size not including chunkSize or chunkID
-    unsigned char format[4];
-};
-
-/*
- * Struct to hold fmt subchunk data for WAVE files.
- */
-struct SAIGA_LOCAL WAVE_Format
-{
-    char subChunkID[4];
-    int subChunkSize;
-    short audioFormat;
-    short numChannels;
-    int sampleRate;
-    int byteRate;
-    short blockAlign;
-    short bitsPerSample;
-};
-
-/*
- * Struct to hold the data of the wave file
- */
-struct SAIGA_LOCAL WAVE_Data
-{
-    char subChunkID[4];  // should contain the word data
-    int subChunk2Size;   // Stores the size of the data block
-};
-
-
 class SAIGA_CORE_API SoundLoader
 {
    public:
@@ -11,6 +11,7 @@
 
 #include <al.h>
 #include <alc.h>
+#include <algorithm>
 #include <iostream>
 
 #ifdef SAIGA_USE_ALUT
@@ -45,6 +46,8 @@ SoundManager::~SoundManager()
 {
     std::cout << "~SoundManager" << std::endl;
 
+    if (parallelSoundLoaderRunning) joinParallelSoundLoader();
+    streams.clear();
 
     delete quietSoundSource;
 
@@ -308,13 +311,14 @@ void SoundManager::startParallelSoundLoader(int threadCount)
     SAIGA_ASSERT(threadCount > 0);
     std::cout << "startParallelSoundLoader " << threadCount << std::endl;
 
-    int oldthreadCount = this->threadCount;
-    this->threadCount += threadCount;
+    // Keep one worker free for the audio streams.
+    threadCount = std::max(1, std::min(threadCount, audioDecodeThreads() - 1));
+
     loadingDoneCounter += threadCount;
     parallelSoundLoaderRunning = true;
-    for (int i = oldthreadCount; i < this->threadCount; ++i)
+    for (int i = 0; i < threadCount; ++i)
     {
-        soundLoaderThreads.push_back(new std::thread(&SoundManager::loadSoundsThreadStart, this));
+        soundLoaderJobs.push_back(audioDecodePool().enqueue([this]() { loadSoundsThreadStart(); }));
     }
 }
 
@@ -322,14 +326,12 @@ void SoundManager::joinParallelSoundLoader()
 {
     std::cout << "joinParallelSoundLoader " << std::endl;
     SAIGA_ASSERT(parallelSoundLoaderRunning);
-    for (int i = 0; i < threadCount; ++i)
+    for (auto& job : soundLoaderJobs)
     {
-        soundLoaderThreads[i]->join();
-        delete soundLoaderThreads[i];
+        job.get();
     }
-    soundLoaderThreads.clear();
+    soundLoaderJobs.clear();
     parallelSoundLoaderRunning = false;
-    this->threadCount          = 0;
 
     SAIGA_ASSERT(loadingDoneCounter.load() == 0);
 }
@@ -454,6 +456,13 @@ void SoundManager::setMusicVolume(float v)
             s.setMasterVolume(musicVolume);
         }
     }
+    for (auto& s : streams)
+    {
+        if (s->isMusic())
+        {
+            s->setVolume(musicVolume);
+        }
+    }
 }
 
 void SoundManager::setEffectsVolume(float v)
@@ -468,6 +477,13 @@ void SoundManager::setEffectsVolume(float v)
             s.setMasterVolume(effectsVolume);
         }
     }
+    for (auto& s : streams)
+    {
+        if (!s->isMusic())
+        {
+            s->setVolume(effectsVolume);
+        }
+    }
 }
 
 void SoundManager::setMute(bool b)
@@ -502,6 +518,33 @@ void SoundManager::setTimeScaleNonFixed(float scale)
     assert_no_alerror();
 }
 
+std::shared_ptr<StreamingSoundSource> SoundManager::playStream(const std::string& file, bool isMusic, bool loop)
+{
+    auto stream = AudioStream::open(file, loop);
+    if (!stream)
+    {
+        std::cout << "Could not open sound stream: " << file << std::endl;
+        return nullptr;
+    }
+
+    auto s = std::make_shared<StreamingSoundSource>(stream, isMusic);
+    s->setVolume(isMusic ? musicVolume : effectsVolume);
+    s->play();
+    streams.push_back(s);
+    return s;
+}
+
+void SoundManager::update()
+{
+    for (auto& s : streams)
+    {
+        s->update();
+    }
+    streams.erase(std::remove_if(streams.begin(), streams.end(),
+                                 [](const std::shared_ptr<StreamingSoundSource>& s) { return s->finished(); }),
+                  streams.end());
+}
+
 void SoundManager::startCapturing()
 {
     const int SRATE = 44100;
@@ -11,12 +11,14 @@
 
 #include "OpenAL.h"
 #include "SoundSource.h"
+#include "StreamingSoundSource.h"
 
 #include <atomic>
+#include <future>
 #include <list>
 #include <map>
+#include <memory>
 #include <mutex>
-#include <thread>
 #include <vector>
 
 typedef struct ALCdevice_struct ALCdevice;
@@ -57,8 +59,10 @@ class SAIGA_CORE_API SoundManager
     void insertLoadedSoundIntoMap(const std::string& file, Sound* sound);
     void loadSoundsThreadStart();
 
-    int threadCount = 0;
-    std::vector<std::thread*> soundLoaderThreads;
+    // The loader jobs run on the audioDecodePool()
+    std::vector<std::future<void>> soundLoaderJobs;
+
+    std::vector<std::shared_ptr<StreamingSoundSource>> streams;
 
     std::list<std::string> soundQueue;
     mutable std::mutex soundQueueLock;
@@ -80,6 +84,16 @@ class SAIGA_CORE_API SoundManager
 
     void setMute(bool b);
 
+    /**
+     * Plays a long sound (for example music) without decoding it completely.
+     * The file is decoded in small chunks on the audioDecodePool(). update() must be called once per frame.
+     */
+    std::shared_ptr<StreamingSoundSource> playStream(const std::string& file, bool isMusic = true, bool loop = false);
+
+    // Refills the buffers of all playing streams and removes the finished ones.
+    // A stopped stream is kept, so it can be resumed with play() through the returned handle.
+    void update();
+
     void setTimeScale(float scale);
     void setTimeScaleNonFixed(float scale);
 
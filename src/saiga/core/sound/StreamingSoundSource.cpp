@@ -0,0 +1,100 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "StreamingSoundSource.h"
+
+#include "internal/noGraphicsAPI.h"
+
+#include <al.h>
+#include <alc.h>
+
+namespace Saiga
+{
+namespace sound
+{
+StreamingSoundSource::StreamingSoundSource(std::shared_ptr<AudioStream> _stream, bool music, int numBuffers,
+                                           int bufferFrames)
+    : stream(std::move(_stream)), music(music), bufferFrames(bufferFrames)
+{
+    SAIGA_ASSERT(stream->channels() == 1 || stream->channels() == 2);
+    format = stream->channels() == 1 ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;
+    pcm.resize(size_t(bufferFrames) * stream->channels());
+
+    alGenSources(1, &source);
+    buffers.resize(numBuffers);
+    alGenBuffers(numBuffers, buffers.data());
+    freeBuffers = buffers;
+    assert_no_alerror();
+}
+
+StreamingSoundSource::~StreamingSoundSource()
+{
+    alSourceStop(source);
+    alSourcei(source, AL_BUFFER, 0);
+    alDeleteSources(1, &source);
+    alDeleteBuffers(buffers.size(), buffers.data());
+}
+
+void StreamingSoundSource::play()
+{
+    playing = true;
+    update();
+}
+
+void StreamingSoundSource::stop()
+{
+    playing = false;
+    alSourceStop(source);
+    assert_no_alerror();
+}
+
+void StreamingSoundSource::setVolume(float f)
+{
+    alSourcef(source, AL_GAIN, f);
+    assert_no_alerror();
+}
+
+void StreamingSoundSource::update()
+{
+    ALint processed = 0;
+    alGetSourcei(source, AL_BUFFERS_PROCESSED, &processed);
+    for (int i = 0; i < processed; ++i)
+    {
+        ALuint b;
+        alSourceUnqueueBuffers(source, 1, &b);
+        freeBuffers.push_back(b);
+    }
+
+    if (!playing) return;
+
+    while (!freeBuffers.empty())
+    {
+        int frames = stream->read(pcm.data(), bufferFrames);
+        if (frames == 0) break;
+
+        ALuint b = freeBuffers.back();
+        freeBuffers.pop_back();
+        alBufferData(b, format, pcm.data(), frames * stream->channels() * sizeof(int16_t), stream->sampleRate());
+        alSourceQueueBuffers(source, 1, &b);
+    }
+
+    // Restart after an underrun
+    ALint state, queued;
+    alGetSourcei(source, AL_SOURCE_STATE, &state);
+    alGetSourcei(source, AL_BUFFERS_QUEUED, &queued);
+    if (state != AL_PLAYING && queued > 0) alSourcePlay(source);
+    assert_no_alerror();
+}
+
+bool StreamingSoundSource::finished()
+{
+    ALint queued;
+    alGetSourcei(source, AL_BUFFERS_QUEUED, &queued);
+    return stream->finished() && queued == 0;
+}
+
+}  // namespace sound
+}  // namespace Saiga
@@ -0,0 +1,61 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/config.h"
+
+#include "AudioStream.h"
+#include "OpenAL.h"
+
+namespace Saiga
+{
+namespace sound
+{
+/**
+ * Plays an AudioStream with a queue of small OpenAL buffers.
+ * update() must be called regularly (for example once per frame) to refill the played buffers.
+ */
+class SAIGA_CORE_API StreamingSoundSource
+{
+   public:
+    StreamingSoundSource(std::shared_ptr<AudioStream> stream, bool music = false, int numBuffers = 4,
+                         int bufferFrames = 4096);
+    ~StreamingSoundSource();
+
+    StreamingSoundSource(const StreamingSoundSource&) = delete;
+    StreamingSoundSource& operator=(const StreamingSoundSource&) = delete;
+
+    void play();
+    void stop();
+    void setVolume(float f);
+
+    void update();
+
+    bool isMusic() const { return music; }
+    bool isPlaying() const { return playing; }
+
+    // The stream has ended and all buffers have been played.
+    bool finished();
+
+    AudioStream& getStream() { return *stream; }
+
+   private:
+    std::shared_ptr<AudioStream> stream;
+    unsigned int source = 0;
+    int format;
+    bool music;
+    int bufferFrames;
+    bool playing = false;
+
+    std::vector<unsigned int> buffers;
+    // The buffers that are not queued
+    std::vector<unsigned int> freeBuffers;
+    std::vector<int16_t> pcm;
+};
+
+}  // namespace sound
+}  // namespace Saiga
@@ -0,0 +1,396 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "Benchmark.h"
+
+#include "saiga/core/util/assert.h"
+#include "saiga/core/util/commandLineArguments.h"
+#include "saiga/core/util/statistics.h"
+#include "saiga/core/util/table.h"
+#include "saiga/core/util/tostring.h"
+
+#include "internal/noGraphicsAPI.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+#if defined(__linux__)
+#    include <linux/perf_event.h>
+#    include <sched.h>
+#    include <sys/ioctl.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+#endif
+
+namespace Saiga
+{
+#if defined(__linux__)
+static int openPerfEvent(uint32_t type, uint64_t config)
+{
+    perf_event_attr attr = {};
+    attr.type            = type;
+    attr.size            = sizeof(perf_event_attr);
+    attr.config          = config;
+    attr.disabled        = 1;
+    attr.exclude_kernel  = 1;
+    attr.exclude_hv      = 1;
+    // pid = 0, cpu = -1: measure the calling thread on any cpu
+    return syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+#endif
+
+PerfCounters::PerfCounters()
+{
+    for (int i = 0; i < NumCounters; ++i)
+    {
+        fds[i]    = -1;
+        values[i] = -1;
+    }
+#if defined(__linux__)
+    fds[Cycles]       = openPerfEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    fds[Instructions] = openPerfEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    fds[CacheMisses]  = openPerfEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    fds[BranchMisses] = openPerfEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+#endif
+}
+
+PerfCounters::~PerfCounters()
+{
+#if defined(__linux__)
+    for (auto fd : fds)
+    {
+        if (fd >= 0) close(fd);
+    }
+#endif
+}
+
+void PerfCounters::start()
+{
+#if defined(__linux__)
+    for (auto fd : fds)
+    {
+        if (fd < 0) continue;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+void PerfCounters::stop()
+{
+#if defined(__linux__)
+    for (int i = 0; i < NumCounters; ++i)
+    {
+        values[i] = -1;
+        if (fds[i] < 0) continue;
+        ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+        int64_t v;
+        if (read(fds[i], &v, sizeof(v)) == sizeof(v)) values[i] = v;
+    }
+#endif
+}
+
+bool pinThreadToCpu(int cpu)
+{
+#if defined(__linux__)
+    if (cpu < 0 || cpu >= CPU_SETSIZE) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+void computeBenchmarkStatistics(BenchmarkResult& result, std::vector<double> samples, double outlierThreshold)
+{
+    result.samples = samples.size();
+    if (samples.empty()) return;
+
+    auto [minIt, maxIt] = std::minmax_element(samples.begin(), samples.end());
+    result.min          = *minIt;
+    result.max          = *maxIt;
+    result.median       = percentile(samples, 0.5);
+    result.p10          = percentile(samples, 0.1);
+    result.p90          = percentile(samples, 0.9);
+    result.mad          = medianAbsoluteDeviation(samples, result.median);
+
+    // Mean and standard deviation of the inliers
+    double limit = outlierThreshold * 1.4826 * result.mad;
+    double sum = 0, sumSq = 0;
+    int n = 0;
+    for (auto s : samples)
+    {
+        if (result.mad > 0 && std::abs(s - result.median) > limit) continue;
+        sum += s;
+        sumSq += s * s;
+        n++;
+    }
+    result.outliers = samples.size() - n;
+    result.mean     = sum / n;
+    result.sdev     = std::sqrt(std::max(0.0, sumSq / n - result.mean * result.mean));
+}
+
+std::string BenchmarkResult::toJson() const
+{
+    std::stringstream strm;
+    strm << std::setprecision(10);
+    strm << "{\"name\":\"" << name << "\",\"iterations\":" << iterationsPerSample << ",\"samples\":" << samples
+         << ",\"outliers\":" << outliers << ",\"items\":" << itemsPerIteration << ",\"median\":" << median
+         << ",\"mean\":" << mean << ",\"min\":" << min << ",\"max\":" << max << ",\"sdev\":" << sdev
+         << ",\"mad\":" << mad << ",\"p10\":" << p10 << ",\"p90\":" << p90 << ",\"cycles\":" << cycles
+         << ",\"instructions\":" << instructions << ",\"cache_misses\":" << cacheMisses
+         << ",\"branch_misses\":" << branchMisses << "}";
+    return strm.str();
+}
+
+BenchmarkResult BenchmarkResult::fromJson(const std::string& line)
+{
+    // This is not a general json parser. It only reads the flat objects created by toJson().
+    std::map<std::string, std::string> values;
+    size_t pos = 0;
+    while (true)
+    {
+        auto keyBegin = line.find('"', pos);
+        if (keyBegin == std::string::npos) break;
+        auto keyEnd = line.find('"', keyBegin + 1);
+        SAIGA_ASSERT(keyEnd != std::string::npos);
+        auto key   = line.substr(keyBegin + 1, keyEnd - keyBegin - 1);
+        auto colon = line.find(':', keyEnd);
+        SAIGA_ASSERT(colon != std::string::npos);
+
+        size_t valueBegin = colon + 1;
+        size_t valueEnd;
+        if (line[valueBegin] == '"')
+        {
+            valueBegin++;
+            valueEnd = line.find('"', valueBegin);
+            pos      = valueEnd + 1;
+        }
+        else
+        {
+            valueEnd = line.find_first_of(",}", valueBegin);
+            pos      = valueEnd;
+        }
+        values[key] = line.substr(valueBegin, valueEnd - valueBegin);
+    }
+
+    auto get = [&](const std::string& key, double def) {
+        auto it = values.find(key);
+        return it == values.end() ? def : to_double(it->second);
+    };
+
+    BenchmarkResult r;
+    r.name                = values["name"];
+    r.iterationsPerSample = get("iterations", 0);
+    r.samples             = get("samples", 0);
+    r.outliers            = get("outliers", 0);
+    r.itemsPerIteration   = get("items", 0);
+    r.median              = get("median", 0);
+    r.mean                = get("mean", 0);
+    r.min                 = get("min", 0);
+    r.max                 = get("max", 0);
+    r.sdev                = get("sdev", 0);
+    r.mad                 = get("mad", 0);
+    r.p10                 = get("p10", 0);
+    r.p90                 = get("p90", 0);
+    r.cycles              = get("cycles", -1);
+    r.instructions        = get("instructions", -1);
+    r.cacheMisses         = get("cache_misses", -1);
+    r.branchMisses        = get("branch_misses", -1);
+    return r;
+}
+
+static std::string formatTime(double ns)
+{
+    std::stringstream strm;
+    strm << std::fixed << std::setprecision(3);
+    if (ns < 1e3)
+        strm << ns << "ns";
+    else if (ns < 1e6)
+        strm << ns / 1e3 << "us";
+    else if (ns < 1e9)
+        strm << ns / 1e6 << "ms";
+    else
+        strm << ns / 1e9 << "s";
+    return strm.str();
+}
+
+std::ostream& operator<<(std::ostream& strm, const BenchmarkResult& result)
+{
+    strm << "[Benchmark] " << std::left << std::setw(40) << result.name << std::right
+         << " median " << std::setw(12) << formatTime(result.median) << " mean " << std::setw(12)
+         << formatTime(result.mean) << " +- " << std::setw(10) << formatTime(result.sdev) << " [p10 "
+         << formatTime(result.p10) << ", p90 " << formatTime(result.p90) << "]";
+    strm << " its " << result.iterationsPerSample << "x" << result.samples;
+    if (result.outliers > 0) strm << " outliers " << result.outliers;
+    if (result.cycles >= 0)
+    {
+        strm << " cycles " << std::fixed << std::setprecision(1) << result.cycles;
+        if (result.instructions >= 0) strm << " IPC " << std::setprecision(2) << result.instructions / result.cycles;
+        strm.unsetf(std::ios_base::floatfield);
+    }
+    if (result.itemsPerIteration > 0)
+    {
+        strm << " " << std::setprecision(4) << result.itemsPerSecond() / 1e6 << " M items/s";
+    }
+    return strm;
+}
+
+static std::vector<std::pair<std::string, BenchmarkSuite::Function>>& benchmarkRegistry()
+{
+    static std::vector<std::pair<std::string, BenchmarkSuite::Function>> registry;
+    return registry;
+}
+
+int BenchmarkSuite::registerBenchmark(const std::string& name, Function f)
+{
+    auto& r = benchmarkRegistry();
+    r.emplace_back(name, f);
+    return r.size();
+}
+
+bool BenchmarkSuite::matches(const std::string& name) const
+{
+    return filter.empty() || name.find(filter) != std::string::npos;
+}
+
+void BenchmarkSuite::runAll()
+{
+    auto registry = benchmarkRegistry();
+    std::sort(registry.begin(), registry.end(), [](auto& a, auto& b) { return a.first < b.first; });
+    for (auto& [name, f] : registry)
+    {
+        // Skip the setup of benchmarks which can not match the filter
+        if (!matches(name) && filter.rfind(name + "/", 0) != 0) continue;
+        currentBenchmark = name;
+        f(*this);
+        currentBenchmark.clear();
+    }
+}
+
+bool BenchmarkSuite::saveJson(const std::string& file) const
+{
+    std::ofstream strm(file);
+    if (!strm.is_open()) return false;
+    for (auto& r : results) strm << r.toJson() << "\n";
+    strm.close();
+    return !strm.fail();
+}
+
+std::vector<BenchmarkResult> BenchmarkSuite::loadJson(const std::string& file)
+{
+    std::vector<BenchmarkResult> results;
+    std::ifstream strm(file);
+    std::string line;
+    while (std::getline(strm, line))
+    {
+        if (line.find('{') == std::string::npos) continue;
+        results.push_back(BenchmarkResult::fromJson(line));
+    }
+    return results;
+}
+
+int BenchmarkSuite::compare(const std::vector<BenchmarkResult>& baseline, double threshold) const
+{
+    int regressions = 0;
+    Table table({50, 14, 14, 10, 12});
+    table << "Name"
+          << "Baseline"
+          << "Current"
+          << "Change"
+          << "Status";
+    for (auto& r : results)
+    {
+        auto it = std::find_if(baseline.begin(), baseline.end(), [&](auto& b) { return b.name == r.name; });
+        if (it == baseline.end())
+        {
+            table << r.name << "-" << formatTime(r.median) << "-"
+                  << "new";
+            continue;
+        }
+        double change = r.median / it->median - 1.0;
+
+        // A regression must be larger than the threshold and larger than the noise of both measurements
+        double noise       = 3 * 1.4826 * std::max(r.mad, it->mad);
+        std::string status = "ok";
+        if (change > threshold && r.median - it->median > noise)
+        {
+            status = "REGRESSION";
+            regressions++;
+        }
+        else if (change < -threshold && it->median - r.median > noise)
+        {
+            status = "faster";
+        }
+        std::stringstream changeStr;
+        changeStr << std::showpos << std::fixed << std::setprecision(1) << change * 100 << "%";
+        table << r.name << formatTime(it->median) << formatTime(r.median) << changeStr.str() << status;
+    }
+    return regressions;
+}
+
+int BenchmarkSuite::main(int argc, char* argv[])
+{
+    CommandLineArguments cla;
+    cla.arguments = {
+        {"filter", 'f', "Only run benchmarks which contain this string", "", false, false},
+        {"json", 'j', "Write the results to this file", "", false, false},
+        {"baseline", 'b', "Compare the results to this file", "", false, false},
+        {"threshold", 't', "Relative slowdown which is reported as regression", "0.1", false, false},
+        {"samples", 's', "Number of samples per benchmark", "20", false, false},
+        {"cpu", 'c', "Pin the benchmark thread to this core (-1 = no pinning)", "-1", false, false},
+        {"minSampleTime", 'm', "Minimum time per sample in ms", "10", false, false},
+        {"list", 'l', "List all registered benchmarks", "0", true, false},
+    };
+    cla.parse(argc, argv);
+
+    if (cla.getFlag("list"))
+    {
+        for (auto& [name, f] : benchmarkRegistry()) std::cout << name << std::endl;
+        return 0;
+    }
+
+    BenchmarkSuite suite;
+    suite.filter                  = cla.get("filter");
+    suite.options.samples         = cla.getLong("samples");
+    suite.options.cpu             = cla.getLong("cpu");
+    suite.options.minSampleTimeMS = to_double(cla.get("minSampleTime"));
+
+    PerfCounters perf;
+    std::cout << "Hardware counters: " << (perf.available() ? "available" : "not available") << std::endl;
+
+    suite.runAll();
+
+    auto json = cla.get("json");
+    if (!json.empty())
+    {
+        bool ok = suite.saveJson(json);
+        if (!ok)
+        {
+            std::cerr << "Could not write the results to " << json << std::endl;
+            return -1;
+        }
+        std::cout << "Results written to " << json << std::endl;
+    }
+
+    auto baselineFile = cla.get("baseline");
+    if (!baselineFile.empty())
+    {
+        auto baseline    = loadJson(baselineFile);
+        int regressions = suite.compare(baseline, to_double(cla.get("threshold")));
+        std::cout << regressions << " regression(s) compared to " << baselineFile << std::endl;
+        return regressions;
+    }
+    return 0;
+}
+
+}  // namespace Saiga
@@ -0,0 +1,265 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/config.h"
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace Saiga
+{
+/**
+ * Reads hardware counters of the calling thread with perf_event_open.
+ * Only available on Linux. If the kernel does not allow access (see /proc/sys/kernel/perf_event_paranoid)
+ * or the counters are not supported, available() returns false and all values are -1.
+ */
+class SAIGA_CORE_API PerfCounters
+{
+   public:
+    enum Counter
+    {
+        Cycles = 0,
+        Instructions,
+        CacheMisses,
+        BranchMisses,
+        NumCounters
+    };
+
+    PerfCounters();
+    ~PerfCounters();
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool available() const { return fds[Cycles] >= 0; }
+
+    void start();
+    void stop();
+
+    // The counter values of the last start()/stop() interval. -1 if the counter is not available.
+    int64_t value(Counter c) const { return values[c]; }
+
+   private:
+    int fds[NumCounters];
+    int64_t values[NumCounters];
+};
+
+/**
+ * Pins the calling thread to the given cpu core.
+ * Returns false if this is not supported or the core does not exist.
+ */
+SAIGA_CORE_API bool pinThreadToCpu(int cpu);
+
+struct SAIGA_CORE_API BenchmarkOptions
+{
+    // Run the function for at least this time before measuring.
+    double warmupTimeMS = 50;
+
+    // The number of iterations per sample is chosen so that one sample takes at least this long.
+    double minSampleTimeMS = 10;
+    long maxIterationsPerSample = 1000 * 1000 * 1000;
+
+    // Number of measured samples
+    int samples = 20;
+
+    // Pin the benchmark thread to this core. -1 = no pinning.
+    int cpu = -1;
+
+    // Sample cycles and hardware events with perf_event_open
+    bool hardwareCounters = true;
+
+    // Samples with |x - median| > outlierThreshold * 1.4826 * MAD are treated as outliers.
+    // The mean and standard deviation are only computed from the inliers.
+    double outlierThreshold = 3;
+};
+
+struct SAIGA_CORE_API BenchmarkResult
+{
+    std::string name;
+
+    long iterationsPerSample = 0;
+    int samples              = 0;
+    int outliers             = 0;
+
+    // Used to compute the throughput. For example the number of processed edges per iteration.
+    double itemsPerIteration = 0;
+
+    // Time per iteration in nanoseconds
+    double median = 0, mean = 0, min = 0, max = 0;
+    double sdev = 0, mad = 0;
+    double p10 = 0, p90 = 0;
+
+    // Hardware counters per iteration. -1 if not available.
+    double cycles       = -1;
+    double instructions = -1;
+    double cacheMisses  = -1;
+    double branchMisses = -1;
+
+    double itemsPerSecond() const { return median > 0 ? itemsPerIteration / (median * 1e-9) : 0; }
+
+    // Single line json object.
+    std::string toJson() const;
+    // Parses the output of toJson().
+    static BenchmarkResult fromJson(const std::string& line);
+};
+
+SAIGA_CORE_API std::ostream& operator<<(std::ostream& strm, const BenchmarkResult& result);
+
+/**
+ * Computes the robust statistics of the given samples.
+ * 'samples' are the nanoseconds per iteration.
+ */
+SAIGA_CORE_API void computeBenchmarkStatistics(BenchmarkResult& result, std::vector<double> samples,
+                                               double outlierThreshold);
+
+/**
+ * Measures the function f.
+ *  1. Warmup for options.warmupTimeMS
+ *  2. Find the number of iterations so that each sample takes at least options.minSampleTimeMS
+ *  3. Measure options.samples samples and compute outlier-robust statistics
+ *
+ * Usage:
+ *
+ * auto result = benchmark("memcpy", [&]() { memcpy(dst, src, N); });
+ * std::cout << result << std::endl;
+ */
+template <typename F>
+inline BenchmarkResult benchmark(const std::string& name, F&& f, const BenchmarkOptions& options = {})
+{
+    using Clock = std::chrono::steady_clock;
+    auto elapsedNS = [](Clock::time_point begin) {
+        return std::chrono::duration<double, std::nano>(Clock::now() - begin).count();
+    };
+
+    if (options.cpu >= 0) pinThreadToCpu(options.cpu);
+
+    // Warmup + calibration. The number of iterations is doubled until the sample time is reached.
+    long its = 1;
+    {
+        auto warmupBegin = Clock::now();
+        while (true)
+        {
+            auto begin = Clock::now();
+            for (long i = 0; i < its; ++i) f();
+            double t = elapsedNS(begin);
+            if (t >= options.minSampleTimeMS * 1e6 && elapsedNS(warmupBegin) >= options.warmupTimeMS * 1e6) break;
+            if (t < options.minSampleTimeMS * 1e6) its = std::min(its * 2, options.maxIterationsPerSample);
+            if (its == options.maxIterationsPerSample && elapsedNS(warmupBegin) >= options.warmupTimeMS * 1e6) break;
+        }
+    }
+
+    BenchmarkResult result;
+    result.name                = name;
+    result.iterationsPerSample = its;
+
+    std::vector<double> samples(options.samples);
+    std::vector<double> counters[PerfCounters::NumCounters];
+
+    PerfCounters perf;
+    bool usePerf = options.hardwareCounters && perf.available();
+
+    for (auto& s : samples)
+    {
+        if (usePerf) perf.start();
+        auto begin = Clock::now();
+        for (long i = 0; i < its; ++i) f();
+        s = elapsedNS(begin) / its;
+        if (usePerf)
+        {
+            perf.stop();
+            for (int c = 0; c < PerfCounters::NumCounters; ++c)
+                counters[c].push_back(double(perf.value(PerfCounters::Counter(c))) / its);
+        }
+    }
+
+    computeBenchmarkStatistics(result, samples, options.outlierThreshold);
+
+    if (usePerf)
+    {
+        double* targets[PerfCounters::NumCounters] = {&result.cycles, &result.instructions, &result.cacheMisses,
+                                                      &result.branchMisses};
+        for (int c = 0; c < PerfCounters::NumCounters; ++c)
+        {
+            BenchmarkResult tmp;
+            computeBenchmarkStatistics(tmp, counters[c], options.outlierThreshold);
+            *targets[c] = tmp.min < 0 ? -1 : tmp.median;
+        }
+    }
+    return result;
+}
+
+/**
+ * A collection of benchmarks that can be run from the command line.
+ * The benchmarks register themselves with SAIGA_REGISTER_BENCHMARK and call run() for each measured function.
+ *
+ * SAIGA_REGISTER_BENCHMARK(Memcpy)
+ * {
+ *     std::vector<char> src(N), dst(N);
+ *     suite.run("memcpy_1MB", [&]() { memcpy(dst.data(), src.data(), N); }, N);
+ * }
+ *
+ * int main(int argc, char* argv[]) { return Saiga::BenchmarkSuite::main(argc, argv); }
+ *
+ * Command line arguments:
+ *   --filter=<str>      Only run benchmarks (and cases) that contain <str>
+ *   --json=<file>       Write all results to this file. One json object per line.
+ *   --baseline=<file>   Compare the results to a previous json output
+ *   --threshold=<x>     Relative slowdown of the median which is reported as regression (default 0.1)
+ *   --samples=<n>, --cpu=<n>, --minSampleTime=<ms>, --list
+ *
+ * The return value of main is the number of regressions, or -1 if the json file could not be written.
+ */
+class SAIGA_CORE_API BenchmarkSuite
+{
+   public:
+    using Function = std::function<void(BenchmarkSuite&)>;
+
+    BenchmarkOptions options;
+    std::string filter;
+    std::vector<BenchmarkResult> results;
+
+    // Measures f and prints the result. Returns the result (or an empty result if it was filtered).
+    template <typename F>
+    BenchmarkResult run(const std::string& name, F&& f, double itemsPerIteration = 0)
+    {
+        auto fullName = currentBenchmark.empty() ? name : currentBenchmark + "/" + name;
+        if (!matches(fullName)) return {};
+        auto result              = benchmark(fullName, std::forward<F>(f), options);
+        result.itemsPerIteration = itemsPerIteration;
+        std::cout << result << std::endl;
+        results.push_back(result);
+        return result;
+    }
+
+    // Runs all registered benchmarks which match the filter.
+    void runAll();
+
+    // Returns false if the file could not be written.
+    bool saveJson(const std::string& file) const;
+    static std::vector<BenchmarkResult> loadJson(const std::string& file);
+
+    // Prints the comparison to the baseline and returns the number of regressions.
+    int compare(const std::vector<BenchmarkResult>& baseline, double threshold) const;
+
+    static int registerBenchmark(const std::string& name, Function f);
+    static int main(int argc, char* argv[]);
+
+   private:
+    std::string currentBenchmark;
+    bool matches(const std::string& name) const;
+};
+
+}  // namespace Saiga
+
+#define SAIGA_REGISTER_BENCHMARK(_name)                                            \
+    static void saiga_benchmark_##_name(Saiga::BenchmarkSuite& suite);             \
+    static int saiga_benchmark_registered_##_name =                                \
+        Saiga::BenchmarkSuite::registerBenchmark(#_name, saiga_benchmark_##_name); \
+    static void saiga_benchmark_##_name(Saiga::BenchmarkSuite& suite)
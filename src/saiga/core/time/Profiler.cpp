@@ -0,0 +1,355 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "Profiler.h"
+
+#include "saiga/core/imgui/imgui.h"
+#include "saiga/core/util/assert.h"
+
+#include "internal/noGraphicsAPI.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <tuple>
+
+namespace Saiga
+{
+struct Profiler::ThreadData
+{
+    int id;
+    std::string name;
+
+    // Single producer ring buffer. Only the owning thread writes to 'events' and 'head'.
+    std::vector<Event> events;
+    uint64_t mask;
+    std::atomic<uint64_t> head = {0};
+
+    // Only accessed by the collector with the profiler mutex locked.
+    uint64_t tail = 0;
+
+    // Current nesting depth of the owning thread.
+    int depth = 0;
+};
+
+static thread_local Profiler::ThreadData* localThreadData = nullptr;
+
+Profiler::Profiler() : startTime(Clock::now()) {}
+
+Profiler& Profiler::instance()
+{
+    static Profiler profiler;
+    return profiler;
+}
+
+Profiler::ThreadData* Profiler::threadData()
+{
+    if (!localThreadData)
+    {
+        localThreadData = instance().registerThread();
+    }
+    return localThreadData;
+}
+
+void Profiler::beginZone(ThreadData* td)
+{
+    td->depth++;
+}
+
+void Profiler::endZone(ThreadData* td, const char* name, int64_t begin, int64_t end)
+{
+    td->depth--;
+    auto h                   = td->head.load(std::memory_order_relaxed);
+    td->events[h & td->mask] = {name, begin, end, td->depth};
+    td->head.store(h + 1, std::memory_order_release);
+}
+
+Profiler::ThreadData* Profiler::registerThread()
+{
+    std::unique_lock lock(mut);
+    // The thread data is owned by the profiler, so that the events of finished threads can still be collected.
+    auto td = std::make_shared<ThreadData>();
+    td->id  = threads.size();
+
+    // Round up to the next power of two so we can use a mask instead of modulo
+    uint64_t size = 1;
+    while (size < (uint64_t)std::max(bufferSize, 2)) size <<= 1;
+    td->events.resize(size);
+    td->mask = size - 1;
+    td->name = "Thread " + std::to_string(td->id);
+    threads.push_back(td);
+    return td.get();
+}
+
+void Profiler::setThreadName(const std::string& name)
+{
+    auto td = threadData();
+    std::unique_lock lock(mut);
+    td->name = name;
+}
+
+void Profiler::nextFrame()
+{
+    std::unique_lock lock(mut);
+    frameEvents.clear();
+
+    for (auto& td : threads)
+    {
+        uint64_t size  = td->events.size();
+        uint64_t h     = td->head.load(std::memory_order_acquire);
+        uint64_t begin = td->tail;
+        if (h - begin > size)
+        {
+            dropped += h - begin - size;
+            begin = h - size;
+        }
+
+        auto first = frameEvents.size();
+        for (auto i = begin; i < h; ++i)
+        {
+            frameEvents.emplace_back(td->id, td->events[i & td->mask]);
+        }
+
+        // The owning thread might have overwritten the oldest entries while we were copying them.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t h2 = td->head.load(std::memory_order_relaxed);
+        if (h2 > size && h2 - size > begin)
+        {
+            auto invalid = std::min(h2 - size - begin, h - begin);
+            frameEvents.erase(frameEvents.begin() + first, frameEvents.begin() + first + invalid);
+            dropped += invalid;
+        }
+        td->tail = h;
+    }
+
+    aggregate();
+
+    // Append to the trace and drop the oldest events if the limit is reached
+    traceEvents.insert(traceEvents.end(), frameEvents.begin(), frameEvents.end());
+    if (traceEvents.size() > maxTraceEvents)
+    {
+        traceEvents.erase(traceEvents.begin(), traceEvents.end() - maxTraceEvents);
+    }
+}
+
+void Profiler::aggregate()
+{
+    // Sort by thread and start time. A parent starts before (or at the same time as) its children.
+    std::sort(frameEvents.begin(), frameEvents.end(), [](const auto& a, const auto& b) {
+        return std::tie(a.first, a.second.begin, a.second.depth) < std::tie(b.first, b.second.begin, b.second.depth);
+    });
+
+    for (auto& z : tree)
+    {
+        z.calls  = 0;
+        z.timeMS = 0;
+    }
+
+    std::map<std::tuple<int, int, std::string>, int> nodes;
+    for (int i = 0; i < (int)tree.size(); ++i)
+    {
+        nodes[{tree[i].thread, tree[i].parent, tree[i].name}] = i;
+    }
+
+    // (node, end time) of the currently open zones
+    std::vector<std::pair<int, int64_t>> stack;
+    int currentThread = -1;
+    for (auto& [tid, e] : frameEvents)
+    {
+        if (tid != currentThread)
+        {
+            stack.clear();
+            currentThread = tid;
+        }
+
+        // Zones that started in a previous frame are not part of this frame.
+        // -> Their children are added as root nodes.
+        while (!stack.empty() && stack.back().second < e.end) stack.pop_back();
+        int parent = stack.empty() ? -1 : stack.back().first;
+
+        auto key = std::make_tuple(tid, parent, std::string(e.name));
+        auto it  = nodes.find(key);
+        int node;
+        if (it == nodes.end())
+        {
+            ZoneStats z;
+            z.name   = e.name;
+            z.thread = tid;
+            z.parent = parent;
+            z.depth  = parent == -1 ? 0 : tree[parent].depth + 1;
+            node     = tree.size();
+            tree.push_back(z);
+            nodes[key] = node;
+        }
+        else
+        {
+            node = it->second;
+        }
+
+        auto& z = tree[node];
+        z.calls++;
+        z.timeMS += (e.end - e.begin) / 1000000.0;
+        stack.emplace_back(node, e.end);
+    }
+
+    double alpha = 0.1;
+    for (auto& z : tree)
+    {
+        z.averageMS = (1 - alpha) * z.averageMS + alpha * z.timeMS;
+    }
+}
+
+std::vector<Profiler::ZoneStats> Profiler::lastFrame()
+{
+    std::unique_lock lock(mut);
+
+    std::vector<std::vector<int>> children(tree.size());
+    std::vector<int> roots;
+    for (int i = 0; i < (int)tree.size(); ++i)
+    {
+        if (tree[i].parent == -1)
+            roots.push_back(i);
+        else
+            children[tree[i].parent].push_back(i);
+    }
+    std::stable_sort(roots.begin(), roots.end(), [this](int a, int b) { return tree[a].thread < tree[b].thread; });
+
+    std::vector<ZoneStats> result;
+    result.reserve(tree.size());
+    std::vector<int> todo(roots.rbegin(), roots.rend());
+    while (!todo.empty())
+    {
+        int n = todo.back();
+        todo.pop_back();
+        result.push_back(tree[n]);
+        todo.insert(todo.end(), children[n].rbegin(), children[n].rend());
+    }
+    return result;
+}
+
+static std::string jsonEscape(const std::string& str)
+{
+    std::string result;
+    result.reserve(str.size());
+    for (auto c : str)
+    {
+        if (c == '"' || c == '\\') result.push_back('\\');
+        result.push_back(c);
+    }
+    return result;
+}
+
+bool Profiler::saveChromeTrace(const std::string& file)
+{
+    std::unique_lock lock(mut);
+    std::ofstream strm(file);
+    if (!strm.is_open()) return false;
+
+    strm << std::fixed << std::setprecision(3);
+    strm << "{\"traceEvents\":[" << std::endl;
+
+    bool first = true;
+    for (auto& td : threads)
+    {
+        if (!first) strm << "," << std::endl;
+        first = false;
+        strm << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << td->id << ",\"args\":{\"name\":\""
+             << jsonEscape(td->name) << "\"}}";
+    }
+
+    for (auto& [tid, e] : traceEvents)
+    {
+        if (!first) strm << "," << std::endl;
+        first = false;
+        // The trace format expects microseconds
+        strm << "{\"name\":\"" << jsonEscape(e.name) << "\",\"cat\":\"saiga\",\"ph\":\"X\",\"pid\":0,\"tid\":" << tid
+             << ",\"ts\":" << e.begin / 1000.0 << ",\"dur\":" << (e.end - e.begin) / 1000.0 << "}";
+    }
+    strm << std::endl << "],\"displayTimeUnit\":\"ms\"}" << std::endl;
+    return true;
+}
+
+void Profiler::clear()
+{
+    std::unique_lock lock(mut);
+    traceEvents.clear();
+    frameEvents.clear();
+    tree.clear();
+    dropped = 0;
+}
+
+void Profiler::imgui()
+{
+    if (!ImGui::Begin("Profiler"))
+    {
+        ImGui::End();
+        return;
+    }
+
+    bool e = isEnabled();
+    if (ImGui::Checkbox("Enabled", &e)) setEnabled(e);
+
+    static char file[256] = "saiga_trace.json";
+    ImGui::InputText("File", file, 256);
+    if (ImGui::Button("Save Chrome Trace"))
+    {
+        saveChromeTrace(file);
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Clear"))
+    {
+        clear();
+    }
+
+    auto zones = lastFrame();
+    std::vector<std::string> threadNames;
+    size_t numEvents;
+    {
+        std::unique_lock lock(mut);
+        for (auto& td : threads) threadNames.push_back(td->name);
+        numEvents = traceEvents.size();
+    }
+    ImGui::Text("Threads: %d Events: %d Dropped: %d", (int)threadNames.size(), (int)numEvents, (int)dropped);
+    ImGui::Separator();
+
+    ImGui::Columns(4);
+    ImGui::Text("Zone");
+    ImGui::NextColumn();
+    ImGui::Text("Calls");
+    ImGui::NextColumn();
+    ImGui::Text("Time (ms)");
+    ImGui::NextColumn();
+    ImGui::Text("Average (ms)");
+    ImGui::NextColumn();
+    ImGui::Separator();
+
+    int currentThread = -1;
+    for (auto& z : zones)
+    {
+        if (z.thread != currentThread)
+        {
+            currentThread = z.thread;
+            ImGui::Text("%s", threadNames[z.thread].c_str());
+            ImGui::NextColumn();
+            ImGui::NextColumn();
+            ImGui::NextColumn();
+            ImGui::NextColumn();
+        }
+        ImGui::Text("%*s%s", 2 * (z.depth + 1), "", z.name.c_str());
+        ImGui::NextColumn();
+        ImGui::Text("%d", z.calls);
+        ImGui::NextColumn();
+        ImGui::Text("%.3f", z.timeMS);
+        ImGui::NextColumn();
+        ImGui::Text("%.3f", z.averageMS);
+        ImGui::NextColumn();
+    }
+    ImGui::Columns(1);
+    ImGui::End();
+}
+
+}  // namespace Saiga
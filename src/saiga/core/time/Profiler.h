@@ -0,0 +1,184 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/config.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Saiga
+{
+/**
+ * A hierarchical, low overhead frame profiler.
+ *
+ * Zones are recorded with SAIGA_PROFILE_ZONE("name") or SAIGA_PROFILE_FUNCTION() and are written into a
+ * thread local ring buffer. The hot path does not lock. The buffers are collected once per frame by
+ * SAIGA_PROFILE_FRAME(), which aggregates the nested zones of every thread into a call tree.
+ *
+ * The collected zones can be exported in the Chrome trace format (chrome://tracing or https://ui.perfetto.dev)
+ * and displayed with imgui().
+ *
+ * The macros are only active if saiga was compiled with SAIGA_PROFILER. Otherwise they expand to nothing.
+ *
+ * Usage:
+ *
+ * Profiler::instance().setEnabled(true);
+ * while (running)
+ * {
+ *     {
+ *         SAIGA_PROFILE_ZONE("Track");
+ *         track();
+ *     }
+ *     SAIGA_PROFILE_FRAME();
+ * }
+ * Profiler::instance().saveChromeTrace("trace.json");
+ */
+class SAIGA_CORE_API Profiler
+{
+   public:
+    using Clock = std::chrono::steady_clock;
+
+    // A single completed zone. Times are nanoseconds relative to the profiler start.
+    struct Event
+    {
+        const char* name;
+        int64_t begin;
+        int64_t end;
+        int depth;
+    };
+
+    // One node of the aggregated call tree of the last frame.
+    struct ZoneStats
+    {
+        std::string name;
+        int thread = 0;
+        int depth  = 0;
+        int parent = -1;
+        int calls  = 0;
+        // Sum of all calls in the last frame
+        double timeMS = 0;
+        // Exponential average over the previous frames
+        double averageMS = 0;
+    };
+
+    static Profiler& instance();
+
+    void setEnabled(bool b) { enabled.store(b, std::memory_order_relaxed); }
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    // Number of events per thread ring buffer. Only affects threads that record their first zone afterwards.
+    void setBufferSize(int events) { bufferSize = events; }
+
+    // Maximum number of events kept for the Chrome trace export. Older events are dropped first.
+    void setMaxTraceEvents(size_t events) { maxTraceEvents = events; }
+
+    // Name of the calling thread in the trace and the imgui overlay.
+    void setThreadName(const std::string& name);
+
+    /**
+     * Collects the events of all threads and aggregates them into the call tree of this frame.
+     * Call this once per frame from the main loop.
+     */
+    void nextFrame();
+
+    // The aggregated zones of the last frame in depth first order.
+    std::vector<ZoneStats> lastFrame();
+
+    // Number of events that were overwritten before they could be collected.
+    size_t droppedEvents() const { return dropped; }
+
+    bool saveChromeTrace(const std::string& file);
+
+    // Removes all collected events and statistics.
+    void clear();
+
+    void imgui();
+
+    // ========= Hot path. Use the macros below instead of calling these directly. =========
+
+    struct ThreadData;
+
+    inline static int64_t now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - instance().startTime).count();
+    }
+    static ThreadData* threadData();
+    static void beginZone(ThreadData* td);
+    static void endZone(ThreadData* td, const char* name, int64_t begin, int64_t end);
+
+   private:
+    Profiler();
+
+    std::atomic<bool> enabled = {false};
+    Clock::time_point startTime;
+    int bufferSize        = 1024 * 16;
+    size_t maxTraceEvents = 1024 * 1024;
+    size_t dropped        = 0;
+
+    std::mutex mut;
+    std::vector<std::shared_ptr<ThreadData>> threads;
+
+    // Events of all threads for the trace export. Stored together with the thread id.
+    std::vector<std::pair<int, Event>> traceEvents;
+
+    std::vector<ZoneStats> tree;
+    std::vector<std::pair<int, Event>> frameEvents;
+
+    ThreadData* registerThread();
+    void aggregate();
+};
+
+/**
+ * Records one zone in the calling thread.
+ * Only active if the profiler was enabled during construction.
+ */
+class SAIGA_CORE_API ScopedProfileZone
+{
+   public:
+    explicit ScopedProfileZone(const char* name) : name(name)
+    {
+        if (Profiler::instance().isEnabled())
+        {
+            td = Profiler::threadData();
+            Profiler::beginZone(td);
+            begin = Profiler::now();
+        }
+    }
+    ~ScopedProfileZone()
+    {
+        if (td) Profiler::endZone(td, name, begin, Profiler::now());
+    }
+    ScopedProfileZone(const ScopedProfileZone&) = delete;
+    ScopedProfileZone& operator=(const ScopedProfileZone&) = delete;
+
+   private:
+    const char* name;
+    Profiler::ThreadData* td = nullptr;
+    int64_t begin            = 0;
+};
+
+}  // namespace Saiga
+
+#define SAIGA_PROFILER_CONCAT2(_a, _b) _a##_b
+#define SAIGA_PROFILER_CONCAT(_a, _b) SAIGA_PROFILER_CONCAT2(_a, _b)
+
+#ifdef SAIGA_PROFILER
+// The name must be a string literal or another string which outlives the profiler.
+#    define SAIGA_PROFILE_ZONE(_name) \
+        Saiga::ScopedProfileZone SAIGA_PROFILER_CONCAT(__saiga_profile_zone_, __LINE__)(_name)
+#    define SAIGA_PROFILE_FUNCTION() SAIGA_PROFILE_ZONE(__func__)
+#    define SAIGA_PROFILE_FRAME() Saiga::Profiler::instance().nextFrame()
+#else
+#    define SAIGA_PROFILE_ZONE(_name)
+#    define SAIGA_PROFILE_FUNCTION()
+#    define SAIGA_PROFILE_FRAME()
+#endif
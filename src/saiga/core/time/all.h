@@ -8,6 +8,7 @@
 
 #include "saiga/config.h"
 
+#include "Profiler.h"
 #include "performanceMeasure.h"
 #include "time.h"
 #include "timer.h"
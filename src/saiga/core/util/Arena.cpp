@@ -0,0 +1,82 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "Arena.h"
+
+#include "saiga/core/util/Align.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace Saiga
+{
+static std::atomic<size_t> totalBlockAllocations = 0;
+
+MonotonicArena::~MonotonicArena()
+{
+    for (auto& b : blocks) aligned_free(b.data);
+}
+
+void MonotonicArena::rewind(Marker marker)
+{
+    if (marker.block == 0 && marker.offset == 0 && current > 0)
+    {
+        // The last frame needed multiple blocks. Merge them so that the next frame fits into one.
+        size_t total = capacity();
+        for (auto& b : blocks) aligned_free(b.data);
+        blocks.clear();
+        blocks.push_back(newBlock(total));
+    }
+    current = marker.block;
+    offset  = marker.offset;
+}
+
+size_t MonotonicArena::capacity() const
+{
+    size_t sum = 0;
+    for (auto& b : blocks) sum += b.size;
+    return sum;
+}
+
+size_t MonotonicArena::blockAllocations()
+{
+    return totalBlockAllocations;
+}
+
+void* MonotonicArena::allocateSlow(size_t bytes, size_t alignment)
+{
+    SAIGA_ASSERT(alignment <= blockAlignment);
+
+    // Blocks start at blockAlignment, so the first byte of the next large enough block is fine.
+    size_t next = blocks.empty() ? 0 : current + 1;
+    while (next < blocks.size() && blocks[next].size < bytes) ++next;
+    if (next >= blocks.size())
+    {
+        size_t size = blocks.empty() ? blockSize : blocks.back().size * 2;
+        blocks.push_back(newBlock(std::max(size, bytes)));
+        next = blocks.size() - 1;
+    }
+    current = next;
+    offset  = bytes;
+    return blocks[current].data;
+}
+
+MonotonicArena::Block MonotonicArena::newBlock(size_t size)
+{
+    totalBlockAllocations++;
+    Block b;
+    b.size = iAlignUp(size, blockAlignment);
+    b.data = static_cast<char*>(aligned_malloc<blockAlignment>(b.size));
+    return b;
+}
+
+MonotonicArena& threadArena()
+{
+    static thread_local MonotonicArena arena;
+    return arena;
+}
+
+}  // namespace Saiga
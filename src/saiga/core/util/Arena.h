@@ -0,0 +1,165 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/config.h"
+#include "saiga/core/math/imath.h"
+#include "saiga/core/util/assert.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace Saiga
+{
+/**
+ * A monotonic (bump pointer) allocator for short lived scratch memory.
+ *
+ * Memory is taken from large blocks and only released in bulk by rewinding to a marker (see ArenaScope).
+ * If a frame needed more than one block, the blocks are merged into a single block on the next full reset.
+ * Therefore a steady state workload does not allocate any memory from the system after the first frames.
+ *
+ * An arena must only be used by a single thread. Use threadArena() to get the arena of the calling thread.
+ */
+class SAIGA_CORE_API MonotonicArena
+{
+   public:
+    static constexpr size_t blockAlignment = 64;
+
+    struct Marker
+    {
+        size_t block  = 0;
+        size_t offset = 0;
+    };
+
+    MonotonicArena(size_t initialBlockSize = 64 * 1024) : blockSize(initialBlockSize) {}
+    ~MonotonicArena();
+
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t))
+    {
+        SAIGA_DEBUG_ASSERT(alignment <= blockAlignment);
+        size_t start = iAlignUp(offset, alignment);
+        if (current < blocks.size() && start + bytes <= blocks[current].size)
+        {
+            offset = start + bytes;
+            return blocks[current].data + start;
+        }
+        return allocateSlow(bytes, alignment);
+    }
+
+    // Only the most recent allocation is actually freed. This helps growing vectors.
+    void deallocate(void* ptr, size_t bytes)
+    {
+        if (current < blocks.size() && static_cast<char*>(ptr) + bytes == blocks[current].data + offset)
+        {
+            offset -= bytes;
+        }
+    }
+
+    Marker mark() const { return {current, offset}; }
+
+    // Frees all allocations after the marker.
+    void rewind(Marker marker);
+    void reset() { rewind(Marker()); }
+
+    size_t capacity() const;
+    size_t numBlocks() const { return blocks.size(); }
+
+    // Total number of blocks allocated by all arenas of this process.
+    // Use this as a test hook: In steady state this number must not change between two frames.
+    static size_t blockAllocations();
+
+   private:
+    struct Block
+    {
+        char* data;
+        size_t size;
+    };
+
+    void* allocateSlow(size_t bytes, size_t alignment);
+    Block newBlock(size_t size);
+
+    std::vector<Block> blocks;
+    size_t current = 0;
+    size_t offset  = 0;
+    size_t blockSize;
+};
+
+// The arena of the calling thread.
+SAIGA_CORE_API MonotonicArena& threadArena();
+
+/**
+ * Frees all arena allocations made during the lifetime of this object.
+ * Scopes can be nested.
+ *
+ * void computeFrame()
+ * {
+ *      ArenaScope scope;
+ *      ArenaVector<int> tmp;
+ *      tmp.reserve(1000);
+ *      ...
+ * }
+ */
+class ArenaScope
+{
+   public:
+    ArenaScope(MonotonicArena& arena = threadArena()) : arena(arena), marker(arena.mark()) {}
+    ~ArenaScope() { arena.rewind(marker); }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+   private:
+    MonotonicArena& arena;
+    MonotonicArena::Marker marker;
+};
+
+/**
+ * STL allocator that uses a MonotonicArena. The default constructed allocator uses the arena of the calling thread.
+ * Containers with this allocator must not outlive the ArenaScope in which they were created and must stay on that
+ * thread.
+ */
+template <typename T>
+class ArenaAllocator
+{
+   public:
+    using value_type = T;
+
+    ArenaAllocator() : arena(&threadArena()) {}
+    ArenaAllocator(MonotonicArena& arena) : arena(&arena) {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena)
+    {
+    }
+
+    T* allocate(size_t n) { return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T))); }
+    void deallocate(T* p, size_t n) { arena->deallocate(p, n * sizeof(T)); }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const
+    {
+        return arena == other.arena;
+    }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const
+    {
+        return arena != other.arena;
+    }
+
+   private:
+    template <typename U>
+    friend class ArenaAllocator;
+    MonotonicArena* arena;
+};
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+}  // namespace Saiga
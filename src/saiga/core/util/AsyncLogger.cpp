@@ -0,0 +1,344 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "AsyncLogger.h"
+
+#include "saiga/core/util/easylogging++.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+#include <unordered_set>
+
+namespace Saiga
+{
+static_assert(__STDCPP_DEFAULT_NEW_ALIGNMENT__ >= AsyncLogger::recordAlign, "The ring buffers are not aligned.");
+
+// Single producer (the owning thread), single consumer (the flush thread) ring buffer.
+// The positions increase monotonically and are taken modulo bufferSize.
+struct AsyncLogger::ThreadBuffer
+{
+    std::unique_ptr<char[]> data = std::unique_ptr<char[]>(new char[bufferSize]);
+    int index                    = 0;
+
+    // Normally the buffer is empty here. The payloads of records which were never written are still destroyed.
+    ~ThreadBuffer() { discard(*this); }
+
+    // Only used by the owning thread
+    size_t recordStart = 0;
+
+    alignas(SAIGA_CACHE_LINE_SIZE) std::atomic<size_t> writePos = 0;
+    alignas(SAIGA_CACHE_LINE_SIZE) std::atomic<size_t> readPos  = 0;
+};
+
+static std::atomic<AsyncLogger*> createdLogger = nullptr;
+
+AsyncLogger& AsyncLogger::instance()
+{
+    // Never destroyed, so logging is also possible in static destructors.
+    static AsyncLogger* logger = []() {
+        auto l = new AsyncLogger();
+        std::atexit([]() { instance().shutdown(); });
+        createdLogger = l;
+        return l;
+    }();
+    return *logger;
+}
+
+void AsyncLogger::flushIfCreated()
+{
+    if (auto logger = createdLogger.load()) logger->flush();
+}
+
+AsyncLogger::AsyncLogger() : startTime(std::chrono::steady_clock::now())
+{
+    setStdoutSink();
+    thread        = std::thread(&AsyncLogger::run, this);
+    flushThreadId = thread.get_id();
+}
+
+AsyncLogger::~AsyncLogger()
+{
+    shutdown();
+}
+
+void AsyncLogger::setSink(Sink s)
+{
+    std::unique_lock lock(mutex);
+    sink = std::make_shared<Sink>(std::move(s));
+}
+
+void AsyncLogger::setStdoutSink()
+{
+    setSink([](const std::string& text) {
+        fwrite(text.data(), 1, text.size(), stdout);
+        fflush(stdout);
+    });
+}
+
+AsyncLogger::ThreadBuffer& AsyncLogger::threadBuffer()
+{
+    static thread_local std::shared_ptr<ThreadBuffer> local;
+    if (!local)
+    {
+        local = std::make_shared<ThreadBuffer>();
+        std::unique_lock lock(mutex);
+        local->index = nextThreadIndex++;
+        buffers.push_back(local);
+    }
+    return *local;
+}
+
+char* AsyncLogger::beginRecord(size_t size, ThreadBuffer*& buffer)
+{
+    ThreadBuffer& b = threadBuffer();
+    buffer          = &b;
+
+    size_t pos    = b.writePos.load(std::memory_order_relaxed);
+    size_t offset = pos % bufferSize;
+    // Records are never split. The rest of the buffer is skipped if the record does not fit.
+    size_t padding = offset + size > bufferSize ? bufferSize - offset : 0;
+
+    if (size > bufferSize / 2 || pos + padding + size - b.readPos.load(std::memory_order_acquire) > bufferSize)
+    {
+        dropped++;
+        return nullptr;
+    }
+
+    if (padding >= sizeof(RecordHeader))
+    {
+        new (b.data.get() + offset) RecordHeader{nullptr, padding, LogLevel::Info, 0, nullptr, {}};
+    }
+    b.recordStart = pos + padding;
+    return b.data.get() + b.recordStart % bufferSize;
+}
+
+void AsyncLogger::endRecord(ThreadBuffer& buffer, size_t size)
+{
+    // Sequentially consistent together with 'running' and the load in drain(). Otherwise shutdown() might miss this
+    // record while this thread still sees running == true, and the record would neither be written nor destroyed.
+    buffer.writePos.store(buffer.recordStart + size);
+
+    if (!running.load())
+    {
+        // The flush thread is stopping. Once it has finished, the records are written synchronously.
+        std::unique_lock lock(mutex);
+        if (!threadStopped) return;
+        std::ostringstream strm;
+        if (drain(buffer, strm)) (*sink)(strm.str());
+    }
+}
+
+bool AsyncLogger::drain(ThreadBuffer& buffer, std::ostream& strm)
+{
+    size_t r = buffer.readPos.load(std::memory_order_relaxed);
+    size_t w = buffer.writePos.load();
+    if (r == w) return false;
+
+    static const char levelNames[] = {'V', 'D', 'I', 'W', 'E'};
+    auto defaultFlags              = strm.flags();
+    auto defaultPrecision          = strm.precision();
+
+    while (r < w)
+    {
+        size_t offset = r % bufferSize;
+        auto header   = reinterpret_cast<RecordHeader*>(buffer.data.get() + offset);
+        if (bufferSize - offset < sizeof(RecordHeader) || !header->format)
+        {
+            r += bufferSize - offset;
+            continue;
+        }
+
+        double seconds = std::chrono::duration<double>(header->time - startTime).count();
+        strm << '[' << levelNames[static_cast<int>(header->level)] << ' ' << std::fixed << std::setprecision(3)
+             << seconds << " T" << buffer.index;
+        if (header->file)
+        {
+            const char* name = header->file;
+            for (const char* c = header->file; *c; ++c)
+            {
+                if (*c == '/' || *c == '\\') name = c + 1;
+            }
+            strm << ' ' << name << ':' << header->line;
+        }
+        strm << "] ";
+        strm.flags(defaultFlags);
+        strm.precision(defaultPrecision);
+
+        header->format(&strm, reinterpret_cast<char*>(header) + alignUp(sizeof(RecordHeader)));
+        strm << '\n';
+        r += header->size;
+    }
+    buffer.readPos.store(r, std::memory_order_release);
+    return true;
+}
+
+void AsyncLogger::discard(ThreadBuffer& buffer)
+{
+    size_t r = buffer.readPos.load(std::memory_order_relaxed);
+    size_t w = buffer.writePos.load(std::memory_order_acquire);
+    while (r < w)
+    {
+        size_t offset = r % bufferSize;
+        auto header   = reinterpret_cast<RecordHeader*>(buffer.data.get() + offset);
+        if (bufferSize - offset < sizeof(RecordHeader) || !header->format)
+        {
+            r += bufferSize - offset;
+            continue;
+        }
+        header->format(nullptr, reinterpret_cast<char*>(header) + alignUp(sizeof(RecordHeader)));
+        r += header->size;
+    }
+    buffer.readPos.store(r, std::memory_order_release);
+}
+
+void AsyncLogger::run()
+{
+    std::ostringstream strm;
+    std::vector<std::shared_ptr<ThreadBuffer>> localBuffers;
+
+    std::unique_lock lock(mutex);
+    while (true)
+    {
+        uint64_t request = flushRequests;
+        bool stop        = stopRequested;
+        auto localSink   = sink;
+        localBuffers.assign(buffers.begin(), buffers.end());
+        lock.unlock();
+
+        bool any = false;
+        for (auto& b : localBuffers)
+        {
+            any |= drain(*b, strm);
+        }
+        if (any)
+        {
+            (*localSink)(strm.str());
+            strm.str("");
+        }
+        localBuffers.clear();
+
+        lock.lock();
+        // Remove the buffers of threads that have exited.
+        buffers.erase(std::remove_if(buffers.begin(), buffers.end(),
+                                     [](auto& b) {
+                                         return b.use_count() == 1 &&
+                                                b->readPos.load() == b->writePos.load(std::memory_order_acquire);
+                                     }),
+                      buffers.end());
+
+        flushedUpTo = request;
+        flushedCv.notify_all();
+        if (stop) break;
+
+        if (!any)
+        {
+            cv.wait_for(lock, std::chrono::milliseconds(5),
+                        [&]() { return flushRequests != request || stopRequested; });
+        }
+    }
+}
+
+void AsyncLogger::flush()
+{
+    if (std::this_thread::get_id() == flushThreadId) return;
+    std::unique_lock lock(mutex);
+    if (!running) return;
+    uint64_t target = ++flushRequests;
+    cv.notify_one();
+    flushedCv.wait(lock, [&]() { return flushedUpTo >= target; });
+}
+
+void AsyncLogger::shutdown()
+{
+    {
+        std::unique_lock lock(mutex);
+        if (!running) return;
+        running       = false;
+        stopRequested = true;
+    }
+    cv.notify_one();
+    thread.join();
+
+    // Records that were written while the thread was stopping. Afterwards the buffers of exited threads are empty
+    // and can be released.
+    std::unique_lock lock(mutex);
+    std::ostringstream strm;
+    bool any = false;
+    for (auto& b : buffers)
+    {
+        any |= drain(*b, strm);
+    }
+    if (any) (*sink)(strm.str());
+    buffers.erase(std::remove_if(buffers.begin(), buffers.end(), [](auto& b) { return b.use_count() == 1; }),
+                  buffers.end());
+    threadStopped = true;
+}
+
+
+namespace
+{
+class AsyncLogDispatchCallback : public el::LogDispatchCallback
+{
+   protected:
+    void handle(const el::LogDispatchData* data) override
+    {
+        auto msg = data->logMessage();
+
+        LogLevel level;
+        switch (msg->level())
+        {
+            case el::Level::Trace:
+            case el::Level::Verbose:
+                level = LogLevel::Verbose;
+                break;
+            case el::Level::Debug:
+                level = LogLevel::Debug;
+                break;
+            case el::Level::Warning:
+                level = LogLevel::Warning;
+                break;
+            case el::Level::Error:
+            case el::Level::Fatal:
+                level = LogLevel::Error;
+                break;
+            default:
+                level = LogLevel::Info;
+                break;
+        }
+
+        // The easylogging messages have already been filtered, so they bypass the level check.
+        auto& logger = AsyncLogger::instance();
+        logger.log(level, internFile(msg->file()), msg->line(), msg->message());
+
+        // Easylogging aborts after a fatal message.
+        if (msg->level() == el::Level::Fatal) logger.flush();
+    }
+
+   private:
+    // The records only store a pointer to the file name.
+    const char* internFile(const std::string& file)
+    {
+        std::unique_lock lock(fileMutex);
+        return files.insert(file).first->c_str();
+    }
+
+    std::mutex fileMutex;
+    std::unordered_set<std::string> files;
+};
+}  // namespace
+
+void AsyncLogger::routeEasylogging()
+{
+    el::Helpers::installLogDispatchCallback<AsyncLogDispatchCallback>("AsyncLogDispatchCallback");
+    auto defaultCallback =
+        el::Helpers::logDispatchCallback<el::base::DefaultLogDispatchCallback>("DefaultLogDispatchCallback");
+    if (defaultCallback) defaultCallback->setEnabled(false);
+}
+
+}  // namespace Saiga
@@ -0,0 +1,252 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/config.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Log sites below this level are removed at compile time.
+// For example, -DSAIGA_LOG_MIN_LEVEL=2 removes all Verbose and Debug logs.
+#ifndef SAIGA_LOG_MIN_LEVEL
+#    define SAIGA_LOG_MIN_LEVEL 0
+#endif
+
+/**
+ * Writes a message to the asynchronous logger. The arguments are streamed with operator<< in the flush thread.
+ *
+ * SAIGA_LOG(Info, "Loaded ", n, " images in ", time, " ms.");
+ *
+ * The arguments are not evaluated if the level is disabled.
+ */
+#define SAIGA_LOG(_level, ...)                                                                              \
+    do                                                                                                      \
+    {                                                                                                       \
+        if constexpr (static_cast<int>(Saiga::LogLevel::_level) >= SAIGA_LOG_MIN_LEVEL)                     \
+        {                                                                                                   \
+            auto& _saiga_logger = Saiga::AsyncLogger::instance();                                           \
+            if (_saiga_logger.enabled(Saiga::LogLevel::_level))                                             \
+                _saiga_logger.log(Saiga::LogLevel::_level, __FILE__, __LINE__, __VA_ARGS__);                \
+        }                                                                                                   \
+    } while (0)
+
+namespace Saiga
+{
+enum class LogLevel : int
+{
+    Verbose = 0,
+    Debug   = 1,
+    Info    = 2,
+    Warning = 3,
+    Error   = 4,
+};
+
+namespace Detail
+{
+// A copy of a char array. The array might be a local buffer, so only copying it is safe.
+template <size_t N>
+struct LogCharArray
+{
+    char data[N];
+
+    friend std::ostream& operator<<(std::ostream& strm, const LogCharArray& a)
+    {
+        return strm.write(a.data, std::find(a.data, a.data + N, '\0') - a.data);
+    }
+};
+
+// How a log argument is stored until it is formatted. Everything that might reference memory of the caller is
+// copied into the record.
+template <typename T, typename = void>
+struct LogArg
+{
+    using type = T;
+    static const T& convert(const T& t) { return t; }
+};
+// Eigen expressions (for example a.transpose() or a + b) reference their operands and are evaluated.
+template <typename T>
+struct LogArg<T, std::void_t<decltype(std::declval<const T&>().eval())>>
+{
+    using type = std::decay_t<decltype(std::declval<const T&>().eval())>;
+    static type convert(const T& t) { return t.eval(); }
+};
+template <size_t N>
+struct LogArg<char[N]>
+{
+    using type = LogCharArray<N>;
+    static type convert(const char (&t)[N])
+    {
+        type result;
+        std::memcpy(result.data, t, N);
+        return result;
+    }
+};
+template <>
+struct LogArg<const char*>
+{
+    using type = std::string;
+    static std::string convert(const char* t) { return t; }
+};
+template <>
+struct LogArg<char*> : public LogArg<const char*>
+{
+};
+template <>
+struct LogArg<std::string_view>
+{
+    using type = std::string;
+    static std::string convert(std::string_view t) { return std::string(t); }
+};
+}  // namespace Detail
+
+/**
+ * A logger that moves formatting and writing out of the calling thread.
+ *
+ * Each thread writes its log records into its own lock free ring buffer. A record contains the arguments of the
+ * log call and a pointer to a function that formats them. A background thread periodically drains all buffers,
+ * formats the records and passes the text in batches to the sink (default: stdout).
+ *
+ * - Records of one thread are written in order. Records of different threads are not ordered.
+ * - If the buffer of a thread is full, the record is dropped and counted (see numDropped()).
+ * - flush() blocks until all records that were logged before the call have been written.
+ * - routeEasylogging() forwards LOG/VLOG of easylogging++ to this logger.
+ */
+class SAIGA_CORE_API AsyncLogger
+{
+   public:
+    using Sink = std::function<void(const std::string& text)>;
+
+    // Size of each per-thread ring buffer in bytes.
+    static constexpr size_t bufferSize  = 256 * 1024;
+    static constexpr size_t recordAlign = 16;
+
+    static AsyncLogger& instance();
+
+    bool enabled(LogLevel level) const { return static_cast<int>(level) >= minLevel.load(std::memory_order_relaxed); }
+    void setLevel(LogLevel level) { minLevel = static_cast<int>(level); }
+
+    template <typename... Args>
+    void log(LogLevel level, const char* file, int line, const Args&... args)
+    {
+        using Payload = std::tuple<typename Detail::LogArg<Args>::type...>;
+
+        // Over aligned payloads (for example vectorized Eigen types) are aligned inside of the record.
+        constexpr size_t extraAlign = alignof(Payload) > recordAlign ? alignof(Payload) - recordAlign : 0;
+        size_t size                 = alignUp(sizeof(RecordHeader)) + alignUp(sizeof(Payload) + extraAlign);
+        ThreadBuffer* buffer;
+        char* ptr = beginRecord(size, buffer);
+        if (!ptr) return;
+
+        new (ptr) RecordHeader{&formatPayload<Payload>, size, level, line, file, std::chrono::steady_clock::now()};
+        new (payloadPtr<Payload>(ptr + alignUp(sizeof(RecordHeader)))) Payload(Detail::LogArg<Args>::convert(args)...);
+        endRecord(*buffer, size);
+    }
+
+    // The sink is called from the flush thread.
+    void setSink(Sink sink);
+    void setStdoutSink();
+
+    // Blocks until all previous records are written. Returns immediately if called from the flush thread (for
+    // example from a sink), because it would wait for itself.
+    void flush();
+
+    // Flushes the logger only if it has already been created. Used by code that must not create the logger, like
+    // the assertion handler.
+    static void flushIfCreated();
+
+    // Flushes and stops the background thread. Following log calls are written synchronously.
+    // Called automatically at exit.
+    void shutdown();
+
+    // Forwards all LOG and VLOG messages of easylogging++ to this logger. The filtering of easylogging++ is kept.
+    void routeEasylogging();
+
+    size_t numDropped() const { return dropped; }
+
+   private:
+    struct RecordHeader
+    {
+        // Formats and destroys the payload. Only destroys it if strm is nullptr.
+        // nullptr marks the unused end of the ring buffer
+        void (*format)(std::ostream* strm, char* payload);
+        size_t size;
+        LogLevel level;
+        int line;
+        const char* file;
+        std::chrono::steady_clock::time_point time;
+    };
+
+    struct ThreadBuffer;
+
+    AsyncLogger();
+    ~AsyncLogger();
+
+    static constexpr size_t alignUp(size_t s) { return (s + recordAlign - 1) / recordAlign * recordAlign; }
+
+    template <typename Payload>
+    static Payload* payloadPtr(char* ptr)
+    {
+        auto p = reinterpret_cast<uintptr_t>(ptr);
+        return reinterpret_cast<Payload*>((p + alignof(Payload) - 1) & ~uintptr_t(alignof(Payload) - 1));
+    }
+
+    template <typename Payload>
+    static void formatPayload(std::ostream* strm, char* payload)
+    {
+        auto& p = *payloadPtr<Payload>(payload);
+        if (strm) std::apply([&](const auto&... args) { ((*strm << args), ...); }, p);
+        p.~Payload();
+    }
+
+    // Returns nullptr if the record does not fit into the buffer of this thread.
+    char* beginRecord(size_t size, ThreadBuffer*& buffer);
+    void endRecord(ThreadBuffer& buffer, size_t size);
+
+    ThreadBuffer& threadBuffer();
+    void run();
+    // Formats all records of this buffer. Returns false if the buffer was empty.
+    bool drain(ThreadBuffer& buffer, std::ostream& strm);
+    // Destroys the records of this buffer without writing them.
+    static void discard(ThreadBuffer& buffer);
+
+    std::atomic<int> minLevel   = static_cast<int>(LogLevel::Info);
+    std::atomic<size_t> dropped = 0;
+    std::atomic<bool> running   = true;
+    std::chrono::steady_clock::time_point startTime;
+
+    std::mutex mutex;
+    std::condition_variable cv, flushedCv;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    std::shared_ptr<Sink> sink;
+    uint64_t flushRequests = 0;
+    uint64_t flushedUpTo   = 0;
+    bool stopRequested     = false;
+    bool threadStopped     = false;
+    int nextThreadIndex    = 0;
+    std::thread thread;
+    // Copy of thread.get_id() that stays valid after the thread was joined.
+    std::thread::id flushThreadId;
+};
+
+}  // namespace Saiga
@@ -0,0 +1,119 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "BufferedFileWriter.h"
+
+#include "saiga/core/util/Align.h"
+
+#include "internal/noGraphicsAPI.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#    define SAIGA_HAS_POSIX_IO
+#    include <fcntl.h>
+#    include <unistd.h>
+#elif defined(_WIN32)
+#    include <fcntl.h>
+#    include <io.h>
+#    include <sys/stat.h>
+#endif
+
+namespace Saiga
+{
+BufferedFileWriter::BufferedFileWriter(const std::string& file, size_t bufferSize, bool directIO)
+    : directIO(directIO), bufferSize(iAlignUp(std::max<size_t>(bufferSize, alignment), alignment))
+{
+    buffer = static_cast<char*>(aligned_malloc<alignment>(this->bufferSize));
+#ifdef SAIGA_HAS_POSIX_IO
+    int flags = O_WRONLY | O_CREAT | O_TRUNC;
+#    ifdef O_DIRECT
+    if (directIO) flags |= O_DIRECT;
+#    else
+    this->directIO = false;
+#    endif
+    fd = ::open(file.c_str(), flags, 0644);
+    if (fd < 0 && this->directIO)
+    {
+        // Some file systems (tmpfs) don't support O_DIRECT
+        this->directIO = false;
+        fd             = ::open(file.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    }
+#else
+    this->directIO = false;
+    fd             = _open(file.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#endif
+}
+
+BufferedFileWriter::~BufferedFileWriter()
+{
+    close();
+    aligned_free(buffer);
+}
+
+static bool writeAll(int fd, const char* data, size_t size)
+{
+    while (size > 0)
+    {
+#ifdef SAIGA_HAS_POSIX_IO
+        auto n = ::write(fd, data, size);
+#else
+        auto n = _write(fd, data, (unsigned int)std::min<size_t>(size, 1 << 30));
+#endif
+        if (n <= 0) return false;
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
+void BufferedFileWriter::flushBuffer()
+{
+    if (used == 0) return;
+    if (!writeAll(fd, buffer, used)) failed = true;
+    written += used;
+    used = 0;
+}
+
+void BufferedFileWriter::write(const void* data, size_t size)
+{
+    if (fd < 0) return;
+    auto src = static_cast<const char*>(data);
+    while (size > 0)
+    {
+        size_t n = std::min(size, bufferSize - used);
+        std::memcpy(buffer + used, src, n);
+        used += n;
+        src += n;
+        size -= n;
+        if (used == bufferSize) flushBuffer();
+    }
+}
+
+bool BufferedFileWriter::close()
+{
+    if (fd < 0) return !failed;
+#ifdef SAIGA_HAS_POSIX_IO
+#    ifdef O_DIRECT
+    if (directIO && used % alignment != 0)
+    {
+        // O_DIRECT only allows writes of full blocks. The remainder is written without it.
+        int flags = fcntl(fd, F_GETFL);
+        fcntl(fd, F_SETFL, flags & ~O_DIRECT);
+    }
+#    endif
+    flushBuffer();
+    if (::close(fd) != 0) failed = true;
+#else
+    flushBuffer();
+    if (_close(fd) != 0) failed = true;
+#endif
+    fd = -1;
+    return !failed;
+}
+
+}  // namespace Saiga
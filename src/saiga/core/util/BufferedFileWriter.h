@@ -0,0 +1,82 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/config.h"
+
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Saiga
+{
+/**
+ * Sequential binary writer with a large, page aligned buffer.
+ * Data is only written to the file in full buffer chunks, which reduces the number of syscalls compared to
+ * std::fstream.
+ *
+ * With directIO = true the file is opened with O_DIRECT (Linux only), bypassing the page cache. This is useful
+ * for very large outputs which are not read again soon. The buffer size must be a multiple of 4096 in that case.
+ *
+ * The write interface mirrors BinaryFile, so files written by this class can be read with BinaryFile or
+ * MemoryReader.
+ */
+class SAIGA_CORE_API BufferedFileWriter
+{
+   public:
+    static constexpr size_t alignment = 4096;
+
+    BufferedFileWriter(const std::string& file, size_t bufferSize = 4 * 1024 * 1024, bool directIO = false);
+    ~BufferedFileWriter();
+    BufferedFileWriter(const BufferedFileWriter&) = delete;
+    BufferedFileWriter& operator=(const BufferedFileWriter&) = delete;
+
+    bool isOpen() const { return fd >= 0; }
+
+    void write(const void* data, size_t size);
+
+    template <typename T>
+    void write(const T& v)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivial types can be written.");
+        write(&v, sizeof(T));
+    }
+
+    template <typename T>
+    void write(const std::vector<T>& vec)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivial types can be written.");
+        write((size_t)vec.size());
+        write(vec.data(), vec.size() * sizeof(T));
+    }
+
+    template <typename T>
+    BufferedFileWriter& operator<<(const T& v)
+    {
+        write(v);
+        return *this;
+    }
+
+    // Number of bytes written so far (including the buffered bytes).
+    size_t size() const { return written + used; }
+
+    // Writes the buffer and closes the file. Returns false if any write failed.
+    bool close();
+
+   private:
+    int fd = -1;
+    bool directIO;
+    bool failed = false;
+    char* buffer;
+    size_t bufferSize;
+    size_t used    = 0;
+    size_t written = 0;
+
+    void flushBuffer();
+};
+
+}  // namespace Saiga
@@ -10,7 +10,14 @@
 #include "saiga/core/util/assert.h"
 #include "saiga/core/util/fileChecker.h"
 
+#include <atomic>
+#include <functional>
+#include <future>
+#include <limits>
+#include <list>
+#include <mutex>
 #include <tuple>
+#include <unordered_map>
 #include <vector>
 
 namespace Saiga
@@ -25,48 +32,276 @@ SAIGA_CORE_API inline bool operator==(const NoParams&, const NoParams&)
 }
 
 
-template <typename KeyType, typename DataType, typename ParamType = NoParams>
+/**
+ * A thread safe key-value cache.
+ *
+ * - The entries are identified by (key, params). Only the key is hashed, so ParamType only needs operator==.
+ *   Entries with the same key but different parameters are compared linearly.
+ * - The cache is split into shards with one mutex each. The shard is selected by the hash of the key.
+ * - Each entry has a size in bytes given by the size function (default: 1 per entry). If a shard exceeds its part of
+ *   the budget, the least recently used entries of that shard are evicted. The default budget is unlimited.
+ * - getOrLoad() calls the loader only once, even if multiple threads request the same missing entry at the same time.
+ *
+ * ObjectCache<std::string, std::shared_ptr<Tile>> cache(512 * 1024 * 1024, [](auto& tile) { return tile->bytes(); });
+ * auto tile = cache.getOrLoad(file, [&]() { return loadTile(file); });
+ */
+template <typename KeyType, typename DataType, typename ParamType = NoParams, typename Hash = std::hash<KeyType>>
 class ObjectCache
 {
    public:
-    using InternalType = std::tuple<KeyType, ParamType, DataType>;
-    std::vector<InternalType> objects;
+    using SizeFunction = std::function<size_t(const DataType&)>;
 
-   public:
+    static constexpr int numShards = 16;
+
+    ObjectCache(size_t budget = std::numeric_limits<size_t>::max(), SizeFunction sizeFunction = SizeFunction())
+        : shardBudget(budget == std::numeric_limits<size_t>::max() ? budget : budget / numShards),
+          sizeFunction(sizeFunction)
+    {
+    }
     virtual ~ObjectCache() { clear(); }
-    void clear() { objects.clear(); }
 
+    ObjectCache(const ObjectCache&) = delete;
+    ObjectCache& operator=(const ObjectCache&) = delete;
+
+    void clear()
+    {
+        for (auto& s : shards)
+        {
+            std::unique_lock lock(s.mutex);
+            s.lru.clear();
+            s.index.clear();
+            s.bytes = 0;
+        }
+    }
 
+    // Inserts the object or replaces an existing object with the same key and parameters.
     void put(const KeyType& key, const DataType& obj, const ParamType& params = ParamType())
     {
-        SAIGA_ASSERT(!exists(key, params));
-        objects.emplace_back(key, params, obj);
+        Shard& s = shard(key);
+        std::unique_lock lock(s.mutex);
+        insert(s, key, params, obj);
     }
 
     bool get(const KeyType& key, DataType& obj, const ParamType& params = ParamType())
     {
-        for (auto& data : objects)
+        Shard& s = shard(key);
+        std::unique_lock lock(s.mutex);
+        auto it = find(s, key, params);
+        if (it == s.lru.end()) return false;
+        // Move to the front = most recently used
+        s.lru.splice(s.lru.begin(), s.lru, it);
+        obj = it->data;
+        return true;
+    }
+
+    bool exists(const KeyType& key, const ParamType& params = ParamType())
+    {
+        Shard& s = shard(key);
+        std::unique_lock lock(s.mutex);
+        return find(s, key, params) != s.lru.end();
+    }
+
+    bool erase(const KeyType& key, const ParamType& params = ParamType())
+    {
+        Shard& s = shard(key);
+        std::unique_lock lock(s.mutex);
+        auto it = find(s, key, params);
+        if (it == s.lru.end()) return false;
+        remove(s, it);
+        return true;
+    }
+
+    /**
+     * Returns the cached object or creates it with loader().
+     * Concurrent calls with the same key and parameters wait for the first call instead of loading the object again.
+     * If the loader throws, the exception is passed to all waiting threads and nothing is inserted.
+     */
+    template <typename Loader>
+    DataType getOrLoad(const KeyType& key, Loader&& loader, const ParamType& params = ParamType())
+    {
+        Shard& s = shard(key);
+        std::promise<DataType> promise;
+        {
+            std::unique_lock lock(s.mutex);
+            auto it = find(s, key, params);
+            if (it != s.lru.end())
+            {
+                s.lru.splice(s.lru.begin(), s.lru, it);
+                return it->data;
+            }
+
+            auto& pending = s.pending[key];
+            for (auto& p : pending)
+            {
+                if (p.params == params)
+                {
+                    auto future = p.future;
+                    lock.unlock();
+                    return future.get();
+                }
+            }
+            pending.push_back({params, promise.get_future().share()});
+        }
+
+        try
+        {
+            DataType obj = loader();
+            {
+                std::unique_lock lock(s.mutex);
+                insert(s, key, params, obj);
+                removePending(s, key, params);
+            }
+            promise.set_value(obj);
+            return obj;
+        }
+        catch (...)
         {
-            if (std::get<0>(data) == key && std::get<1>(data) == params)
             {
-                obj = std::get<2>(data);
-                return true;
+                std::unique_lock lock(s.mutex);
+                removePending(s, key, params);
             }
+            promise.set_exception(std::current_exception());
+            throw;
         }
-        return false;
     }
 
-    bool exists(const KeyType& key, const ParamType& params = ParamType())
+    /**
+     * Calls f(key, params, object) for all cached objects.
+     * The entries of each shard are copied before f is called, so f may use the cache.
+     */
+    void forEach(const std::function<void(const KeyType&, const ParamType&, const DataType&)>& f)
     {
-        for (auto& data : objects)
+        std::vector<Entry> entries;
+        for (auto& s : shards)
         {
-            if (std::get<0>(data) == key && std::get<1>(data) == params)
             {
-                return true;
+                std::unique_lock lock(s.mutex);
+                entries.assign(s.lru.begin(), s.lru.end());
             }
+            for (auto& e : entries) f(e.key, e.params, e.data);
+        }
+    }
+
+    size_t size()
+    {
+        size_t result = 0;
+        for (auto& s : shards)
+        {
+            std::unique_lock lock(s.mutex);
+            result += s.lru.size();
         }
-        return false;
+        return result;
     }
+
+    // The sum of the size function over all entries.
+    size_t bytes()
+    {
+        size_t result = 0;
+        for (auto& s : shards)
+        {
+            std::unique_lock lock(s.mutex);
+            result += s.bytes;
+        }
+        return result;
+    }
+
+    size_t numEvictions() const { return evictions; }
+
+   private:
+    struct Entry
+    {
+        KeyType key;
+        ParamType params;
+        DataType data;
+        size_t bytes;
+    };
+    using EntryIterator = typename std::list<Entry>::iterator;
+
+    struct Pending
+    {
+        ParamType params;
+        std::shared_future<DataType> future;
+    };
+
+    struct Shard
+    {
+        std::mutex mutex;
+        // Front = most recently used
+        std::list<Entry> lru;
+        std::unordered_map<KeyType, std::vector<EntryIterator>, Hash> index;
+        std::unordered_map<KeyType, std::vector<Pending>, Hash> pending;
+        size_t bytes = 0;
+    };
+
+    Shard& shard(const KeyType& key) { return shards[Hash()(key) % numShards]; }
+
+    EntryIterator find(Shard& s, const KeyType& key, const ParamType& params)
+    {
+        auto it = s.index.find(key);
+        if (it == s.index.end()) return s.lru.end();
+        for (auto e : it->second)
+        {
+            if (e->params == params) return e;
+        }
+        return s.lru.end();
+    }
+
+    void insert(Shard& s, const KeyType& key, const ParamType& params, const DataType& obj)
+    {
+        auto it = find(s, key, params);
+        if (it != s.lru.end()) remove(s, it);
+
+        size_t bytes = sizeFunction ? sizeFunction(obj) : 1;
+        s.lru.push_front({key, params, obj, bytes});
+        s.index[key].push_back(s.lru.begin());
+        s.bytes += bytes;
+
+        // Evict the least recently used entries, but never the new one.
+        while (s.bytes > shardBudget && s.lru.size() > 1)
+        {
+            remove(s, std::prev(s.lru.end()));
+            evictions++;
+        }
+    }
+
+    void remove(Shard& s, EntryIterator it)
+    {
+        auto idx     = s.index.find(it->key);
+        auto& bucket = idx->second;
+        for (auto& e : bucket)
+        {
+            if (e == it)
+            {
+                e = bucket.back();
+                bucket.pop_back();
+                break;
+            }
+        }
+        if (bucket.empty()) s.index.erase(idx);
+        s.bytes -= it->bytes;
+        s.lru.erase(it);
+    }
+
+    void removePending(Shard& s, const KeyType& key, const ParamType& params)
+    {
+        auto it       = s.pending.find(key);
+        auto& pending = it->second;
+        for (auto& p : pending)
+        {
+            if (p.params == params)
+            {
+                p = pending.back();
+                pending.pop_back();
+                break;
+            }
+        }
+        if (pending.empty()) s.pending.erase(it);
+    }
+
+    size_t shardBudget;
+    SizeFunction sizeFunction;
+    std::atomic<size_t> evictions = 0;
+    Shard shards[numShards];
 };
 
 
@@ -0,0 +1,301 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/config.h"
+#include "saiga/core/util/assert.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Saiga
+{
+/**
+ * A vector which stores the first N elements inside the object (small buffer optimization).
+ * Only if more than N elements are added, the elements are moved to the heap.
+ *
+ * Use it for the many short lists in the vision data structures, for example the image references of a world
+ * point. Most of these lists have only a few elements and std::vector would allocate each of them separately.
+ *
+ * The interface follows std::vector. Iterators are plain pointers and are invalidated if the capacity changes.
+ * Note that, unlike std::vector, moving a SmallVector in the inline state moves the elements.
+ *
+ * Usage:
+ *
+ * SmallVector<std::pair<int, int>, 4> refs;
+ * refs.emplace_back(img, ip);  // no allocation
+ */
+template <typename T, size_t N>
+class SmallVector
+{
+    static_assert(N > 0, "Use std::vector without inline storage.");
+
+   public:
+    using value_type      = T;
+    using size_type       = size_t;
+    using reference       = T&;
+    using const_reference = const T&;
+    using pointer         = T*;
+    using const_pointer   = const T*;
+    using iterator        = T*;
+    using const_iterator  = const T*;
+
+    static constexpr size_t inlineCapacity = N;
+
+    SmallVector() {}
+    explicit SmallVector(size_t n) { resize(n); }
+    SmallVector(size_t n, const T& value) { resize(n, value); }
+    SmallVector(std::initializer_list<T> list) { assign(list.begin(), list.end()); }
+
+    template <typename It, typename = typename std::iterator_traits<It>::iterator_category>
+    SmallVector(It first, It last)
+    {
+        assign(first, last);
+    }
+
+    SmallVector(const SmallVector& other) { assign(other.begin(), other.end()); }
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible<T>::value) { take(other); }
+
+    ~SmallVector()
+    {
+        clear();
+        freeHeap();
+    }
+
+    SmallVector& operator=(const SmallVector& other)
+    {
+        if (this != &other) assign(other.begin(), other.end());
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept(std::is_nothrow_move_constructible<T>::value)
+    {
+        if (this != &other)
+        {
+            clear();
+            freeHeap();
+            take(other);
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(std::initializer_list<T> list)
+    {
+        assign(list.begin(), list.end());
+        return *this;
+    }
+
+    template <typename It>
+    void assign(It first, It last)
+    {
+        clear();
+        reserve(std::distance(first, last));
+        for (; first != last; ++first) new (_data + _size++) T(*first);
+    }
+
+    size_t size() const { return _size; }
+    size_t capacity() const { return _capacity; }
+    bool empty() const { return _size == 0; }
+    // The elements are stored inside the object.
+    bool isSmall() const { return _data == inlineData(); }
+
+    T* data() { return _data; }
+    const T* data() const { return _data; }
+
+    iterator begin() { return _data; }
+    iterator end() { return _data + _size; }
+    const_iterator begin() const { return _data; }
+    const_iterator end() const { return _data + _size; }
+
+    T& operator[](size_t i)
+    {
+        SAIGA_DEBUG_ASSERT(i < _size);
+        return _data[i];
+    }
+    const T& operator[](size_t i) const
+    {
+        SAIGA_DEBUG_ASSERT(i < _size);
+        return _data[i];
+    }
+
+    T& front() { return (*this)[0]; }
+    const T& front() const { return (*this)[0]; }
+    T& back() { return (*this)[_size - 1]; }
+    const T& back() const { return (*this)[_size - 1]; }
+
+    void reserve(size_t n)
+    {
+        if (n > _capacity) grow(n);
+    }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args)
+    {
+        if (_size == _capacity) grow(_size + 1);
+        return *new (_data + _size++) T(std::forward<Args>(args)...);
+    }
+
+    void push_back(const T& v) { emplace_back(v); }
+    void push_back(T&& v) { emplace_back(std::move(v)); }
+
+    void pop_back()
+    {
+        SAIGA_DEBUG_ASSERT(_size > 0);
+        _data[--_size].~T();
+    }
+
+    void clear()
+    {
+        std::destroy(begin(), end());
+        _size = 0;
+    }
+
+    void resize(size_t n)
+    {
+        reserve(n);
+        while (_size < n) new (_data + _size++) T();
+        while (_size > n) pop_back();
+    }
+
+    void resize(size_t n, const T& value)
+    {
+        reserve(n);
+        while (_size < n) new (_data + _size++) T(value);
+        while (_size > n) pop_back();
+    }
+
+    iterator insert(const_iterator pos, const T& value) { return emplace(pos, value); }
+    iterator insert(const_iterator pos, T&& value) { return emplace(pos, std::move(value)); }
+
+    template <typename... Args>
+    iterator emplace(const_iterator pos, Args&&... args)
+    {
+        size_t i = pos - begin();
+        // Construct first, because args might reference an element of this vector.
+        T tmp(std::forward<Args>(args)...);
+        emplace_back(std::move(tmp));
+        std::rotate(begin() + i, end() - 1, end());
+        return begin() + i;
+    }
+
+    iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        iterator f = begin() + (first - begin());
+        iterator l = begin() + (last - begin());
+        // Nothing to do. Moving the tail onto itself would self-move-assign every element.
+        if (f == l) return f;
+        iterator newEnd = std::move(l, end(), f);
+        std::destroy(newEnd, end());
+        _size = newEnd - begin();
+        return f;
+    }
+
+    // Removes the element by moving the last element into its place. Does not preserve the order.
+    void eraseUnordered(iterator pos)
+    {
+        SAIGA_DEBUG_ASSERT(pos >= begin() && pos < end());
+        if (pos != end() - 1) *pos = std::move(back());
+        pop_back();
+    }
+
+    void swap(SmallVector& other)
+    {
+        SmallVector tmp = std::move(other);
+        other           = std::move(*this);
+        *this           = std::move(tmp);
+    }
+
+    // Moves the elements back into the inline storage if possible.
+    void shrink_to_fit()
+    {
+        if (isSmall() || _size > N) return;
+        SmallVector tmp(std::make_move_iterator(begin()), std::make_move_iterator(end()));
+        *this = std::move(tmp);
+    }
+
+    // The heap memory used by this vector. 0 in the inline state.
+    size_t heapMemory() const { return isSmall() ? 0 : _capacity * sizeof(T); }
+
+    friend bool operator==(const SmallVector& a, const SmallVector& b)
+    {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+    }
+    friend bool operator!=(const SmallVector& a, const SmallVector& b) { return !(a == b); }
+    friend bool operator<(const SmallVector& a, const SmallVector& b)
+    {
+        return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
+    }
+
+   private:
+    T* _data           = inlineData();
+    uint32_t _size     = 0;
+    uint32_t _capacity = N;
+    alignas(T) unsigned char inlineStorage[N * sizeof(T)];
+
+    T* inlineData() { return reinterpret_cast<T*>(inlineStorage); }
+    const T* inlineData() const { return reinterpret_cast<const T*>(inlineStorage); }
+
+    static T* allocate(size_t n)
+    {
+        if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+        else
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void freeHeap()
+    {
+        if (isSmall()) return;
+        if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+            ::operator delete(_data, std::align_val_t(alignof(T)));
+        else
+            ::operator delete(_data);
+        _data     = inlineData();
+        _capacity = N;
+    }
+
+    void grow(size_t minCapacity)
+    {
+        size_t newCapacity = std::max<size_t>(minCapacity, size_t(_capacity) * 2);
+        SAIGA_ASSERT(newCapacity <= UINT32_MAX);
+        T* newData = allocate(newCapacity);
+        std::uninitialized_move(begin(), end(), newData);
+        std::destroy(begin(), end());
+        freeHeap();
+        _data     = newData;
+        _capacity = newCapacity;
+    }
+
+    // Moves the elements of other into this empty vector. Heap storage is taken over without copying.
+    void take(SmallVector& other)
+    {
+        if (other.isSmall())
+        {
+            std::uninitialized_move(other.begin(), other.end(), _data);
+            _size = other._size;
+            other.clear();
+        }
+        else
+        {
+            _data           = other._data;
+            _size           = other._size;
+            _capacity       = other._capacity;
+            other._data     = other.inlineData();
+            other._size     = 0;
+            other._capacity = N;
+        }
+    }
+};
+
+}  // namespace Saiga
@@ -0,0 +1,137 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "MemoryMappedFile.h"
+
+#include "internal/noGraphicsAPI.h"
+
+#include <algorithm>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#    define SAIGA_HAS_MMAP
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+namespace Saiga
+{
+MemoryMappedFile& MemoryMappedFile::operator=(MemoryMappedFile&& other) noexcept
+{
+    close();
+    mapped         = other.mapped;
+    fileSize       = other.fileSize;
+    opened         = other.opened;
+    fallback       = std::move(other.fallback);
+    other.mapped   = nullptr;
+    other.fileSize = 0;
+    other.opened   = false;
+    return *this;
+}
+
+bool MemoryMappedFile::open(const std::string& file, Advice advice)
+{
+    close();
+#ifdef SAIGA_HAS_MMAP
+    int fd = ::open(file.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    fileSize = st.st_size;
+
+    if (fileSize > 0)
+    {
+        void* ptr = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (ptr == MAP_FAILED)
+        {
+            ::close(fd);
+            fileSize = 0;
+            return false;
+        }
+        mapped = static_cast<const char*>(ptr);
+    }
+    // The mapping stays valid after closing the descriptor.
+    ::close(fd);
+    opened = true;
+    advise(advice);
+#else
+    std::ifstream strm(file, std::ios::binary | std::ios::ate);
+    if (!strm.is_open()) return false;
+    fileSize = strm.tellg();
+    fallback.resize(fileSize);
+    strm.seekg(0);
+    strm.read(fallback.data(), fileSize);
+    opened = true;
+    (void)advice;
+#endif
+    return true;
+}
+
+void MemoryMappedFile::close()
+{
+#ifdef SAIGA_HAS_MMAP
+    if (mapped) munmap(const_cast<char*>(mapped), fileSize);
+#endif
+    mapped   = nullptr;
+    fileSize = 0;
+    opened   = false;
+    fallback.clear();
+}
+
+#ifdef SAIGA_HAS_MMAP
+// madvise requires a page aligned start address
+static void adviseRange(const char* mapped, size_t fileSize, size_t offset, size_t length, int flag)
+{
+    if (!mapped || offset >= fileSize) return;
+    length           = std::min(length, fileSize - offset);
+    size_t page      = sysconf(_SC_PAGESIZE);
+    size_t alignedOf = offset / page * page;
+    madvise(const_cast<char*>(mapped) + alignedOf, length + (offset - alignedOf), flag);
+}
+#endif
+
+void MemoryMappedFile::advise(Advice advice, size_t offset, size_t length)
+{
+#ifdef SAIGA_HAS_MMAP
+    int flag = MADV_NORMAL;
+    switch (advice)
+    {
+        case Advice::Normal:
+            flag = MADV_NORMAL;
+            break;
+        case Advice::Sequential:
+            flag = MADV_SEQUENTIAL;
+            break;
+        case Advice::Random:
+            flag = MADV_RANDOM;
+            break;
+    }
+    adviseRange(mapped, fileSize, offset, length, flag);
+#else
+    (void)advice;
+    (void)offset;
+    (void)length;
+#endif
+}
+
+void MemoryMappedFile::prefetch(size_t offset, size_t length)
+{
+#ifdef SAIGA_HAS_MMAP
+    adviseRange(mapped, fileSize, offset, length, MADV_WILLNEED);
+#else
+    (void)offset;
+    (void)length;
+#endif
+}
+
+}  // namespace Saiga
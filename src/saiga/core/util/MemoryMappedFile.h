@@ -0,0 +1,188 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/config.h"
+#include "saiga/core/util/DataStructures/ArrayView.h"
+#include "saiga/core/util/assert.h"
+
+#include <cstring>
+#include <istream>
+#include <streambuf>
+#include <type_traits>
+#include <string>
+#include <vector>
+
+namespace Saiga
+{
+/**
+ * A read-only memory mapped file.
+ * The content is accessed with zero-copy ArrayView slices, which are valid as long as the file is open.
+ * On systems without mmap the file is read into memory once.
+ *
+ * Usage:
+ *
+ * MemoryMappedFile file("points.bin");
+ * auto header = file.view<int>(0, 2);
+ * auto points = file.view<vec3>(2 * sizeof(int), header[0]);
+ */
+class SAIGA_CORE_API MemoryMappedFile
+{
+   public:
+    // Access pattern hints for the kernel readahead (madvise).
+    enum class Advice
+    {
+        Normal,
+        Sequential,
+        Random,
+    };
+
+    MemoryMappedFile() {}
+    explicit MemoryMappedFile(const std::string& file, Advice advice = Advice::Sequential) { open(file, advice); }
+    ~MemoryMappedFile() { close(); }
+
+    MemoryMappedFile(const MemoryMappedFile&) = delete;
+    MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+    MemoryMappedFile(MemoryMappedFile&& other) noexcept { *this = std::move(other); }
+    MemoryMappedFile& operator=(MemoryMappedFile&& other) noexcept;
+
+    bool open(const std::string& file, Advice advice = Advice::Sequential);
+    void close();
+
+    bool isOpen() const { return opened; }
+    size_t size() const { return fileSize; }
+    const char* data() const { return mapped ? mapped : fallback.data(); }
+
+    /**
+     * Elements [offset, offset + count * sizeof(T)) of the file.
+     * count = -1 returns all complete elements until the end of the file.
+     */
+    template <typename T>
+    ArrayView<const T> view(size_t offset = 0, size_t count = size_t(-1)) const
+    {
+        SAIGA_ASSERT(offset <= fileSize);
+        if (count == size_t(-1)) count = (fileSize - offset) / sizeof(T);
+        SAIGA_ASSERT(offset + count * sizeof(T) <= fileSize);
+        SAIGA_ASSERT((uintptr_t)(data() + offset) % alignof(T) == 0, "Unaligned view.");
+        return ArrayView<const T>(reinterpret_cast<const T*>(data() + offset), count);
+    }
+
+    // Change the access pattern hint of a byte range.
+    void advise(Advice advice, size_t offset = 0, size_t length = size_t(-1));
+
+    // Starts an asynchronous readahead of the given byte range (MADV_WILLNEED). Returns immediately.
+    void prefetch(size_t offset = 0, size_t length = size_t(-1));
+
+   private:
+    const char* mapped = nullptr;
+    size_t fileSize    = 0;
+    bool opened        = false;
+    std::vector<char> fallback;
+};
+
+/**
+ * Sequential binary reader on top of a memory region (for example a MemoryMappedFile).
+ * Mirrors the read interface of BinaryFile, but arrays can also be returned as views without copying.
+ * Reading past the end sets the fail state and leaves the output unchanged.
+ */
+class MemoryReader
+{
+   public:
+    MemoryReader(ArrayView<const char> data) : data(data) {}
+
+    template <typename T>
+    void read(T& v)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivial types can be read.");
+        if (!require(sizeof(T))) return;
+        std::memcpy(&v, data.data() + pos, sizeof(T));
+        pos += sizeof(T);
+    }
+
+    template <typename T>
+    void read(std::vector<T>& vec)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivial types can be read.");
+        size_t s = 0;
+        read(s);
+        if (!require(s, sizeof(T))) return;
+        vec.resize(s);
+        std::memcpy(vec.data(), data.data() + pos, s * sizeof(T));
+        pos += s * sizeof(T);
+    }
+
+    // Copies 'size' bytes to dst.
+    void read(void* dst, size_t size)
+    {
+        if (!require(size)) return;
+        std::memcpy(dst, data.data() + pos, size);
+        pos += size;
+    }
+
+    /**
+     * Returns the next n elements without copying.
+     * The current position must be aligned to T.
+     */
+    template <typename T>
+    ArrayView<const T> readView(size_t n)
+    {
+        if (!require(n, sizeof(T))) return {};
+        auto ptr = data.data() + pos;
+        SAIGA_ASSERT((uintptr_t)ptr % alignof(T) == 0, "Unaligned view.");
+        pos += n * sizeof(T);
+        return ArrayView<const T>(reinterpret_cast<const T*>(ptr), n);
+    }
+
+    template <typename T>
+    MemoryReader& operator>>(T& v)
+    {
+        read(v);
+        return *this;
+    }
+
+    void skip(size_t bytes)
+    {
+        if (require(bytes)) pos += bytes;
+    }
+    size_t position() const { return pos; }
+    size_t remaining() const { return data.size() - pos; }
+    bool ok() const { return !failed; }
+
+   private:
+    ArrayView<const char> data;
+    size_t pos  = 0;
+    bool failed = false;
+
+    bool require(size_t bytes)
+    {
+        if (failed || bytes > data.size() - pos) failed = true;
+        return !failed;
+    }
+
+    // Same as require(count * size), but a corrupt count can not overflow.
+    bool require(size_t count, size_t size)
+    {
+        if (failed || count > (data.size() - pos) / size) failed = true;
+        return !failed;
+    }
+};
+
+/**
+ * A read-only std::istream on top of a memory region.
+ * Used to parse text files from a MemoryMappedFile with the standard stream operators.
+ */
+class MemoryIStream : private std::streambuf, public std::istream
+{
+   public:
+    MemoryIStream(ArrayView<const char> data) : std::istream(static_cast<std::streambuf*>(this))
+    {
+        auto begin = const_cast<char*>(data.data());
+        setg(begin, begin, begin + data.size());
+    }
+};
+
+}  // namespace Saiga
@@ -0,0 +1,299 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/config.h"
+#include "saiga/core/util/assert.h"
+#include "saiga/core/util/statistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/**
+ * Single pass accumulators for large data sets.
+ * In contrast to Statistics<T> the values don't have to be stored, copied or sorted.
+ *
+ * OnlineStatistics: min, max, mean, variance and rms with Welford's algorithm. Mergeable.
+ * P2Quantile:       Estimates a single quantile (for example the median) with constant memory. Not mergeable.
+ * Histogram:        Fixed bins in [min,max). Mergeable, can be used to compute approximate quantiles.
+ *
+ * Usage:
+ *
+ * OnlineStatistics<double> stats;
+ * P2Quantile<double> median(0.5);
+ * for (auto r : residuals)
+ * {
+ *     stats.add(r);
+ *     median.add(r);
+ * }
+ * std::cout << stats.toStatistics(median.value()) << std::endl;
+ */
+namespace Saiga
+{
+template <typename T>
+class OnlineStatistics
+{
+   public:
+    long numValues = 0;
+    T min          = std::numeric_limits<T>::max();
+    T max          = std::numeric_limits<T>::lowest();
+    T mean         = 0;
+    T sum          = 0;
+    // Sum of the squared values (for rms)
+    T sumSquared = 0;
+    // Sum of the squared differences to the current mean (Welford)
+    T m2 = 0;
+
+    void add(T x)
+    {
+        numValues++;
+        min = std::min(min, x);
+        max = std::max(max, x);
+        sum += x;
+        sumSquared += x * x;
+        T delta = x - mean;
+        mean += delta / numValues;
+        m2 += delta * (x - mean);
+    }
+
+    // Combines the statistics of two disjoint sets. (Chan et al.)
+    void merge(const OnlineStatistics& other)
+    {
+        if (other.numValues == 0) return;
+        if (numValues == 0)
+        {
+            *this = other;
+            return;
+        }
+        long n  = numValues + other.numValues;
+        T delta = other.mean - mean;
+        mean += delta * other.numValues / n;
+        m2 += other.m2 + delta * delta * numValues * other.numValues / n;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+        sum += other.sum;
+        sumSquared += other.sumSquared;
+        numValues = n;
+    }
+
+    T variance() const { return numValues > 0 ? m2 / numValues : 0; }
+    T sdev() const { return std::sqrt(variance()); }
+    T rms() const { return numValues > 0 ? std::sqrt(sumSquared / numValues) : 0; }
+
+    // The median is not known by this class. Use P2Quantile or Histogram to estimate it.
+    Statistics<T> toStatistics(T median = 0) const
+    {
+        Statistics<T> s;
+        s.numValues = numValues;
+        if (numValues == 0) return s;
+        s.min      = min;
+        s.max      = max;
+        s.median   = median;
+        s.mean     = mean;
+        s.sum      = sum;
+        s.variance = variance();
+        s.sdev     = sdev();
+        s.rms      = rms();
+        return s;
+    }
+};
+
+/**
+ * The P² algorithm for the dynamic calculation of quantiles without storing the observations.
+ * Only 5 markers are kept, which are adjusted with a piecewise parabolic prediction.
+ *
+ * Jain, Chlamtac: "The P² algorithm for dynamic calculation of quantiles and histograms without storing
+ * observations", Communications of the ACM 1985
+ */
+template <typename T>
+class P2Quantile
+{
+   public:
+    explicit P2Quantile(double p = 0.5) : p(p)
+    {
+        SAIGA_ASSERT(p >= 0 && p <= 1);
+        dn[0] = 0;
+        dn[1] = p / 2;
+        dn[2] = p;
+        dn[3] = (1 + p) / 2;
+        dn[4] = 1;
+    }
+
+    void add(T x)
+    {
+        if (count < 5)
+        {
+            q[count++] = x;
+            if (count == 5)
+            {
+                std::sort(q, q + 5);
+                for (int i = 0; i < 5; ++i) n[i] = i;
+                np[0] = 0;
+                np[1] = 2 * p;
+                np[2] = 4 * p;
+                np[3] = 2 + 2 * p;
+                np[4] = 4;
+            }
+            return;
+        }
+        count++;
+
+        // Find the cell of x and update the extreme markers
+        int k;
+        if (x < q[0])
+        {
+            q[0] = x;
+            k    = 0;
+        }
+        else if (x >= q[4])
+        {
+            q[4] = x;
+            k    = 3;
+        }
+        else
+        {
+            k = 0;
+            while (x >= q[k + 1]) k++;
+        }
+
+        for (int i = k + 1; i < 5; ++i) n[i]++;
+        for (int i = 0; i < 5; ++i) np[i] += dn[i];
+
+        // Adjust the heights of the middle markers
+        for (int i = 1; i < 4; ++i)
+        {
+            double d = np[i] - n[i];
+            if ((d >= 1 && n[i + 1] - n[i] > 1) || (d <= -1 && n[i - 1] - n[i] < -1))
+            {
+                int s = d > 0 ? 1 : -1;
+                T qp  = parabolic(i, s);
+                q[i]  = (q[i - 1] < qp && qp < q[i + 1]) ? qp : linear(i, s);
+                n[i] += s;
+            }
+        }
+    }
+
+    // The current estimate. Exact if less than 5 values were added.
+    T value() const
+    {
+        if (count == 0) return 0;
+        if (count <= 5)
+        {
+            T tmp[5];
+            std::copy(q, q + count, tmp);
+            std::sort(tmp, tmp + count);
+            return tmp[std::min<long>(p * count, count - 1)];
+        }
+        return q[2];
+    }
+
+    long numValues() const { return count; }
+
+   private:
+    double p;
+    long count = 0;
+    // Marker heights, actual positions, desired positions and the desired position increments
+    T q[5];
+    long n[5];
+    double np[5], dn[5];
+
+    T parabolic(int i, int d) const
+    {
+        double a = double(d) / (n[i + 1] - n[i - 1]);
+        double b = (n[i] - n[i - 1] + d) * double(q[i + 1] - q[i]) / (n[i + 1] - n[i]);
+        double c = (n[i + 1] - n[i] - d) * double(q[i] - q[i - 1]) / (n[i] - n[i - 1]);
+        return q[i] + T(a * (b + c));
+    }
+
+    T linear(int i, int d) const { return q[i] + T(d * double(q[i + d] - q[i]) / (n[i + d] - n[i])); }
+};
+
+/**
+ * Histogram with a fixed number of equally sized bins in [min,max).
+ * Values outside of this range are counted in 'underflow' and 'overflow'.
+ * Two histograms with the same range and size can be merged, for example the per thread histograms of
+ * an OpenMP loop.
+ */
+template <typename T>
+class Histogram
+{
+   public:
+    Histogram(T min, T max, int numBins) : min(min), max(max), bins(numBins, 0)
+    {
+        SAIGA_ASSERT(numBins > 0);
+        SAIGA_ASSERT(max > min);
+        scale = numBins / double(max - min);
+    }
+
+    // The bin of x or -1 if x is outside of [min,max)
+    int bin(T x) const
+    {
+        if (!(x >= min && x < max)) return -1;
+        return std::min<int>((x - min) * scale, bins.size() - 1);
+    }
+
+    void add(T x, uint64_t weight = 1)
+    {
+        int b = bin(x);
+        if (b >= 0)
+            bins[b] += weight;
+        else if (x < min)
+            underflow += weight;
+        else
+            overflow += weight;  // includes NaN
+        total += weight;
+    }
+
+    void merge(const Histogram& other)
+    {
+        SAIGA_ASSERT(other.min == min && other.max == max && other.bins.size() == bins.size());
+        for (size_t i = 0; i < bins.size(); ++i) bins[i] += other.bins[i];
+        underflow += other.underflow;
+        overflow += other.overflow;
+        total += other.total;
+    }
+
+    /**
+     * Approximate quantile by linear interpolation inside the bin.
+     * The error is at most one bin width, if the quantile is inside [min,max).
+     * Otherwise min or max is returned.
+     */
+    T quantile(double p) const
+    {
+        SAIGA_ASSERT(p >= 0 && p <= 1);
+        if (total == 0) return 0;
+        double target = p * total;
+        double cum    = underflow;
+        if (target < cum) return min;
+        for (size_t i = 0; i < bins.size(); ++i)
+        {
+            if (bins[i] > 0 && cum + bins[i] >= target)
+            {
+                double alpha = (target - cum) / bins[i];
+                return min + T((i + alpha) / scale);
+            }
+            cum += bins[i];
+        }
+        return max;
+    }
+
+    T binWidth() const { return T(1 / scale); }
+    int numBins() const { return bins.size(); }
+    uint64_t operator[](int i) const { return bins[i]; }
+
+    T min, max;
+    uint64_t underflow = 0, overflow = 0, total = 0;
+
+   private:
+    double scale;
+    std::vector<uint64_t> bins;
+};
+
+}  // namespace Saiga
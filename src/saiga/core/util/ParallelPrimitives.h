@@ -0,0 +1,409 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/config.h"
+#include "saiga/core/util/DataStructures/ArrayView.h"
+#include "saiga/core/util/Thread/omp.h"
+#include "saiga/core/util/assert.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+/**
+ * CPU counterparts of the CUDA primitives in saiga/cuda (scan.h, reduce.h, bitonicSort.h, ...).
+ *
+ * All functions run on a new OpenMP thread team. Each thread processes one contiguous chunk of the input with a
+ * simd inner loop and the per thread results are combined in a short serial step. Inputs smaller than
+ * serialThreshold are processed by the calling thread only.
+ *
+ * The element type is not deduced from containers, so call the functions with an explicit type:
+ *
+ * std::vector<int> counts, offsets;
+ * int total = CPU::exclusiveScan<int>(counts, offsets);
+ */
+namespace Saiga
+{
+namespace CPU
+{
+constexpr size_t serialThreshold = 1 << 14;
+
+namespace Detail
+{
+// The chunk [begin,end) of thread tid
+inline void chunk(size_t n, int tid, int threads, size_t& begin, size_t& end)
+{
+    begin = n * tid / threads;
+    end   = n * (tid + 1) / threads;
+}
+}  // namespace Detail
+
+template <typename T>
+T reduce(ArrayView<const T> in, T init = T(0))
+{
+    size_t n = in.size();
+    T sum    = init;
+    if (n < serialThreshold)
+    {
+#pragma omp simd reduction(+ : sum)
+        for (size_t i = 0; i < n; ++i) sum += in[i];
+        return sum;
+    }
+
+#pragma omp parallel for simd reduction(+ : sum) schedule(static)
+    for (size_t i = 0; i < n; ++i) sum += in[i];
+    return sum;
+}
+
+/**
+ * Reduces the segments [offsets[i], offsets[i+1]) of the CSR array 'values' to out[i] with the binary operator.
+ * offsets has one element more than out. Empty segments are set to init.
+ */
+template <typename T, typename Op = std::plus<T>>
+void segmentedReduce(ArrayView<const T> values, ArrayView<const int> offsets, ArrayView<T> out, T init = T(0),
+                     Op op = Op())
+{
+    SAIGA_ASSERT(offsets.size() == out.size() + 1);
+    int segments = out.size();
+    bool serial  = values.size() < serialThreshold && out.size() < serialThreshold;
+
+#pragma omp parallel for schedule(dynamic, 256) if (!serial)
+    for (int s = 0; s < segments; ++s)
+    {
+        T result = init;
+        for (int i = offsets[s]; i < offsets[s + 1]; ++i) result = op(result, values[i]);
+        out[s] = result;
+    }
+}
+
+/**
+ * out[i] = init + in[0] + ... + in[i-1]
+ * Returns the total sum. in and out may be the same array.
+ */
+template <typename T>
+T exclusiveScan(ArrayView<const T> in, ArrayView<T> out, T init = T(0))
+{
+    SAIGA_ASSERT(in.size() == out.size());
+    size_t n = in.size();
+    if (n < serialThreshold)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            T tmp  = in[i];
+            out[i] = init;
+            init += tmp;
+        }
+        return init;
+    }
+
+    std::vector<T> blockPrefix(OMP::getMaxThreads() + 1);
+    T total;
+#pragma omp parallel
+    {
+        int tid = OMP::getThreadNum(), threads = OMP::getNumThreads();
+        size_t begin, end;
+        Detail::chunk(n, tid, threads, begin, end);
+
+        T sum = T(0);
+#pragma omp simd reduction(+ : sum)
+        for (size_t i = begin; i < end; ++i) sum += in[i];
+        blockPrefix[tid + 1] = sum;
+
+#pragma omp barrier
+#pragma omp single
+        {
+            blockPrefix[0] = init;
+            for (int t = 1; t <= threads; ++t) blockPrefix[t] += blockPrefix[t - 1];
+            total = blockPrefix[threads];
+        }
+
+        // Each thread only reads its own chunk, so this also works in place
+        T running = blockPrefix[tid];
+        for (size_t i = begin; i < end; ++i)
+        {
+            T tmp  = in[i];
+            out[i] = running;
+            running += tmp;
+        }
+    }
+    return total;
+}
+
+/**
+ * out[i] = in[0] + ... + in[i]
+ * Returns the total sum. in and out may be the same array.
+ */
+template <typename T>
+T inclusiveScan(ArrayView<const T> in, ArrayView<T> out)
+{
+    SAIGA_ASSERT(in.size() == out.size());
+    size_t n = in.size();
+    if (n < serialThreshold)
+    {
+        T sum = T(0);
+        for (size_t i = 0; i < n; ++i)
+        {
+            sum += in[i];
+            out[i] = sum;
+        }
+        return sum;
+    }
+
+    std::vector<T> blockPrefix(OMP::getMaxThreads() + 1);
+    T total;
+#pragma omp parallel
+    {
+        int tid = OMP::getThreadNum(), threads = OMP::getNumThreads();
+        size_t begin, end;
+        Detail::chunk(n, tid, threads, begin, end);
+
+        T sum = T(0);
+#pragma omp simd reduction(+ : sum)
+        for (size_t i = begin; i < end; ++i) sum += in[i];
+        blockPrefix[tid + 1] = sum;
+
+#pragma omp barrier
+#pragma omp single
+        {
+            blockPrefix[0] = T(0);
+            for (int t = 1; t <= threads; ++t) blockPrefix[t] += blockPrefix[t - 1];
+            total = blockPrefix[threads];
+        }
+
+        T running = blockPrefix[tid];
+        for (size_t i = begin; i < end; ++i)
+        {
+            running += in[i];
+            out[i] = running;
+        }
+    }
+    return total;
+}
+
+/**
+ * Stream compaction: Copies all elements with pred(element) == true to the front of out in their original order.
+ * out must be at least as large as the number of selected elements. Returns that number.
+ * The predicate is evaluated twice per element, so it should be cheap.
+ */
+template <typename T, typename Predicate>
+size_t compact(ArrayView<const T> in, ArrayView<T> out, Predicate pred)
+{
+    size_t n = in.size();
+    if (n < serialThreshold)
+    {
+        size_t count = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (pred(in[i])) out[count++] = in[i];
+        }
+        return count;
+    }
+
+    std::vector<size_t> blockPrefix(OMP::getMaxThreads() + 1);
+    size_t total;
+#pragma omp parallel
+    {
+        int tid = OMP::getThreadNum(), threads = OMP::getNumThreads();
+        size_t begin, end;
+        Detail::chunk(n, tid, threads, begin, end);
+
+        size_t count = 0;
+        for (size_t i = begin; i < end; ++i) count += pred(in[i]) ? 1 : 0;
+        blockPrefix[tid + 1] = count;
+
+#pragma omp barrier
+#pragma omp single
+        {
+            blockPrefix[0] = 0;
+            for (int t = 1; t <= threads; ++t) blockPrefix[t] += blockPrefix[t - 1];
+            total = blockPrefix[threads];
+            SAIGA_ASSERT(total <= out.size());
+        }
+
+        size_t o = blockPrefix[tid];
+        for (size_t i = begin; i < end; ++i)
+        {
+            if (pred(in[i])) out[o++] = in[i];
+        }
+    }
+    return total;
+}
+
+/**
+ * Counts the values in the bins [0, bins.size()). Values outside of this range are ignored.
+ * The bins are overwritten.
+ */
+template <typename T>
+void histogram(ArrayView<const T> in, ArrayView<int> bins)
+{
+    static_assert(std::is_integral<T>::value, "The input values are the bin indices.");
+    size_t n    = in.size();
+    int numBins = bins.size();
+    auto binOf  = [numBins](T v) {
+        if constexpr (std::is_signed_v<T>)
+        {
+            if (v < 0) return -1;
+        }
+        // Compared in 64 bit, because numBins might not fit into T.
+        return uint64_t(v) < uint64_t(numBins) ? int(v) : -1;
+    };
+    std::fill(bins.begin(), bins.end(), 0);
+
+    if (n < serialThreshold)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            int b = binOf(in[i]);
+            if (b >= 0) bins[b]++;
+        }
+        return;
+    }
+
+    // Private histograms per thread, merged in parallel over the bins
+    int maxThreads = OMP::getMaxThreads();
+    std::vector<int> local(size_t(maxThreads) * numBins, 0);
+    int usedThreads = 0;
+#pragma omp parallel
+    {
+        int tid = OMP::getThreadNum();
+        size_t begin, end;
+        Detail::chunk(n, tid, OMP::getNumThreads(), begin, end);
+        int* h = local.data() + size_t(tid) * numBins;
+        for (size_t i = begin; i < end; ++i)
+        {
+            int b = binOf(in[i]);
+            if (b >= 0) h[b]++;
+        }
+#pragma omp single
+        usedThreads = OMP::getNumThreads();
+
+#pragma omp for simd schedule(static)
+        for (int b = 0; b < numBins; ++b)
+        {
+            int sum = 0;
+            for (int t = 0; t < usedThreads; ++t) sum += local[size_t(t) * numBins + b];
+            bins[b] = sum;
+        }
+    }
+}
+
+namespace Detail
+{
+struct NoValues
+{
+};
+
+// Stable LSD radix sort with 8 bit digits. Passes in which all keys have the same digit are skipped.
+template <typename K, typename V>
+void radixSort(ArrayView<K> keys, ArrayView<V> values)
+{
+    static_assert(std::is_unsigned<K>::value, "Radix sort requires unsigned integer keys.");
+    constexpr bool hasValues = !std::is_same<V, NoValues>::value;
+    constexpr int radix      = 256;
+    constexpr int passes     = sizeof(K);
+
+    size_t n = keys.size();
+    if (hasValues) SAIGA_ASSERT(values.size() == n);
+    if (n < 2) return;
+
+    std::vector<K> keyTmp(n);
+    std::vector<std::conditional_t<hasValues, V, char>> valueTmp(hasValues ? n : 0);
+
+    K* srcK = keys.data();
+    K* dstK = keyTmp.data();
+    V* srcV = hasValues ? values.data() : nullptr;
+    V* dstV = hasValues ? reinterpret_cast<V*>(valueTmp.data()) : nullptr;
+
+    int maxThreads = n < serialThreshold ? 1 : OMP::getMaxThreads();
+    std::vector<size_t> hist(size_t(maxThreads) * radix);
+
+    for (int pass = 0; pass < passes; ++pass)
+    {
+        int shift = pass * 8;
+        int threads;
+        bool skip = false;
+
+#pragma omp parallel num_threads(maxThreads)
+        {
+            int tid = OMP::getThreadNum();
+#pragma omp single
+            threads = OMP::getNumThreads();
+
+            size_t begin, end;
+            Detail::chunk(n, tid, threads, begin, end);
+            size_t* h = hist.data() + size_t(tid) * radix;
+            std::fill(h, h + radix, 0);
+            for (size_t i = begin; i < end; ++i) h[(srcK[i] >> shift) & (radix - 1)]++;
+
+#pragma omp barrier
+#pragma omp single
+            {
+                // Offsets: digit major, thread minor. This keeps the sort stable.
+                size_t running = 0;
+                for (int d = 0; d < radix; ++d)
+                {
+                    size_t digitCount = 0;
+                    for (int t = 0; t < threads; ++t) digitCount += hist[size_t(t) * radix + d];
+                    if (digitCount == n) skip = true;
+
+                    for (int t = 0; t < threads; ++t)
+                    {
+                        size_t& c  = hist[size_t(t) * radix + d];
+                        size_t tmp = c;
+                        c          = running;
+                        running += tmp;
+                    }
+                }
+            }
+
+            if (!skip)
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    size_t o = h[(srcK[i] >> shift) & (radix - 1)]++;
+                    dstK[o]  = srcK[i];
+                    if constexpr (hasValues) dstV[o] = std::move(srcV[i]);
+                }
+            }
+        }
+
+        if (!skip)
+        {
+            std::swap(srcK, dstK);
+            std::swap(srcV, dstV);
+        }
+    }
+
+    // The result is in the temporary arrays after an odd number of executed passes
+    if (srcK != keys.data())
+    {
+        std::copy(srcK, srcK + n, keys.data());
+        if constexpr (hasValues) std::move(srcV, srcV + n, values.data());
+    }
+}
+}  // namespace Detail
+
+/**
+ * Stable radix sort of unsigned integer keys. The values are reordered with their keys.
+ */
+template <typename K, typename V>
+void radixSortByKey(ArrayView<K> keys, ArrayView<V> values)
+{
+    Detail::radixSort<K, V>(keys, values);
+}
+
+template <typename K>
+void radixSort(ArrayView<K> keys)
+{
+    Detail::radixSort<K, Detail::NoValues>(keys, {});
+}
+
+}  // namespace CPU
+}  // namespace Saiga
@@ -0,0 +1,43 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "TextParser.h"
+
+#include "internal/noGraphicsAPI.h"
+
+#include <cstring>
+
+namespace Saiga
+{
+void TextParser::skipComments(char c)
+{
+    while (true)
+    {
+        skipWhitespace();
+        if (pos == end || *pos != c) break;
+        skipLine();
+    }
+}
+
+void TextParser::skipLine()
+{
+    auto lineEnd = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+    pos          = lineEnd ? lineEnd + 1 : end;
+}
+
+std::string_view TextParser::line()
+{
+    auto start   = pos;
+    auto lineEnd = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+    pos          = lineEnd ? lineEnd + 1 : end;
+    if (!lineEnd) lineEnd = end;
+
+    // Windows line ending
+    if (lineEnd != start && lineEnd[-1] == '\r') lineEnd--;
+    return std::string_view(start, lineEnd - start);
+}
+
+}  // namespace Saiga
@@ -0,0 +1,122 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/config.h"
+#include "saiga/core/util/DataStructures/ArrayView.h"
+#include "saiga/core/util/tostring.h"
+
+#include <string>
+#include <string_view>
+
+namespace Saiga
+{
+/**
+ * Zero-copy parser for whitespace separated text formats.
+ * Works directly on a memory region (for example a MemoryMappedFile), without copying lines or allocating
+ * temporary strings. Numbers are parsed with parseNumber() (std::from_chars), so the parser is locale independent.
+ *
+ * If a value could not be parsed, it is left unchanged and ok() returns false.
+ *
+ * Usage:
+ *
+ * MemoryMappedFile mmf(file);
+ * TextParser parser(mmf.view<char>());
+ * parser.skipComments();
+ * int n;
+ * double x, y;
+ * parser >> n >> x >> y;
+ * SAIGA_ASSERT(parser.ok());
+ */
+class SAIGA_CORE_API TextParser
+{
+   public:
+    TextParser(std::string_view data) : pos(data.data()), end(data.data() + data.size()) {}
+    TextParser(ArrayView<const char> data) : pos(data.data()), end(data.data() + data.size()) {}
+
+    // True if only whitespace is left.
+    bool atEnd()
+    {
+        skipWhitespace();
+        return pos == end;
+    }
+
+    bool ok() const { return !failed; }
+
+    void skipWhitespace() { pos = Saiga::skipWhitespace(pos, end); }
+
+    // Skips all lines that start with c.
+    void skipComments(char c = '#');
+
+    // Skips the rest of the current line, including the '\n'.
+    void skipLine();
+
+    // Returns the rest of the current line without the line ending and moves to the next line.
+    std::string_view line();
+
+    // The next whitespace separated word. Empty at the end of the data.
+    std::string_view word()
+    {
+        skipWhitespace();
+        auto start = pos;
+        pos        = findWhitespace(pos, end);
+        return std::string_view(start, pos - start);
+    }
+
+    template <typename T>
+    bool parse(T& value)
+    {
+        skipWhitespace();
+        size_t n = parseNumber(std::string_view(pos, end - pos), value);
+        if (n == 0)
+        {
+            failed = true;
+            return false;
+        }
+        pos += n;
+        return true;
+    }
+
+    // Booleans are stored as 0 and 1.
+    bool parse(bool& value)
+    {
+        int i;
+        if (!parse(i)) return false;
+        value = i != 0;
+        return true;
+    }
+
+    bool parse(std::string& value)
+    {
+        value = std::string(word());
+        return true;
+    }
+
+    template <typename T>
+    bool parseArray(T* data, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (!parse(data[i])) return false;
+        }
+        return true;
+    }
+
+    template <typename T>
+    TextParser& operator>>(T& value)
+    {
+        parse(value);
+        return *this;
+    }
+
+   private:
+    const char* pos;
+    const char* end;
+    bool failed = false;
+};
+
+}  // namespace Saiga
@@ -0,0 +1,91 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/config.h"
+#include "saiga/core/util/BufferedFileWriter.h"
+#include "saiga/core/util/tostring.h"
+
+#include <string>
+#include <string_view>
+
+namespace Saiga
+{
+/**
+ * Writes text files through a BufferedFileWriter.
+ * Floating point numbers are written with formatNumber() (std::to_chars) in the shortest representation that reads
+ * back to the same value. This is exact, locale independent and usually much shorter than a fixed precision of 20
+ * digits. The files can be read with TextParser or the stream operators.
+ *
+ * Usage:
+ *
+ * TextWriter strm(file);
+ * strm << n << " " << x << "\n";
+ * bool ok = strm.close();
+ * SAIGA_ASSERT(ok);
+ */
+class SAIGA_CORE_API TextWriter
+{
+   public:
+    TextWriter(const std::string& file) : writer(file) {}
+
+    bool isOpen() const { return writer.isOpen(); }
+
+    // Writes the remaining data. Returns false if any write failed.
+    // Do not call it inside SAIGA_ASSERT, the expression is not evaluated if asserts are disabled.
+    bool close() { return writer.close(); }
+
+    TextWriter& operator<<(std::string_view str)
+    {
+        writer.write(str.data(), str.size());
+        return *this;
+    }
+    TextWriter& operator<<(const char* str) { return *this << std::string_view(str); }
+    TextWriter& operator<<(const std::string& str) { return *this << std::string_view(str); }
+    TextWriter& operator<<(char c)
+    {
+        writer.write(&c, 1);
+        return *this;
+    }
+    // Booleans are written as 0 and 1.
+    TextWriter& operator<<(bool b) { return *this << (b ? '1' : '0'); }
+
+    TextWriter& operator<<(int v) { return writeNumber(v); }
+    TextWriter& operator<<(long v) { return writeNumber(v); }
+    TextWriter& operator<<(long long v) { return writeNumber(v); }
+    TextWriter& operator<<(unsigned int v) { return writeNumber(v); }
+    TextWriter& operator<<(unsigned long v) { return writeNumber(v); }
+    TextWriter& operator<<(unsigned long long v) { return writeNumber(v); }
+    TextWriter& operator<<(float v) { return writeNumber(v); }
+    TextWriter& operator<<(double v) { return writeNumber(v); }
+
+    // Writes n values separated by sep.
+    template <typename T>
+    TextWriter& writeArray(const T* data, size_t n, char sep = ' ')
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (i > 0) *this << sep;
+            *this << data[i];
+        }
+        return *this;
+    }
+
+   private:
+    BufferedFileWriter writer;
+
+    template <typename T>
+    TextWriter& writeNumber(T v)
+    {
+        char buffer[32];
+        char* last = formatNumber(buffer, buffer + sizeof(buffer), v);
+        writer.write(buffer, size_t(last - buffer));
+        return *this;
+    }
+};
+
+}  // namespace Saiga
@@ -0,0 +1,265 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/config.h"
+#include "saiga/core/util/assert.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+
+namespace Saiga
+{
+/**
+ * Reference to an object of an ObjectPool.
+ * The generation is incremented every time a slot is reused. A handle to a destroyed object therefore does not
+ * match its slot anymore, which is detected by ObjectPool::get() and ObjectPool::destroy().
+ */
+struct PoolHandle
+{
+    uint32_t index      = 0xFFFFFFFF;
+    uint32_t generation = 0;
+
+    bool valid() const { return index != 0xFFFFFFFF; }
+    bool operator==(const PoolHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const PoolHandle& other) const { return !(*this == other); }
+};
+
+/**
+ * A thread safe, growable object pool.
+ *
+ * - The objects are stored in slabs of 'slabSize' objects. Slabs are never moved or freed before the pool is
+ *   destroyed, so pointers to objects stay valid until the object is destroyed.
+ * - Free slots are kept in several lock free stacks (Treiber stacks with an ABA tag). Each thread prefers the stack
+ *   selected by its thread id, which distributes the contention. Only the allocation of a new slab takes a lock.
+ * - create() returns a handle with a generation counter. get() returns nullptr for handles of destroyed objects.
+ *
+ * Usage:
+ *
+ * ObjectPool<KeyFrame> pool;
+ * PoolHandle h = pool.create(args...);
+ * pool.get(h)->foo();
+ * pool.destroy(h);
+ * SAIGA_ASSERT(pool.get(h) == nullptr);
+ */
+template <typename T>
+class SAIGA_TEMPLATE ObjectPool
+{
+   public:
+    static constexpr int numFreeLists = 16;
+
+    // At most maxObjects objects can be alive at the same time. The slab size is rounded up to a power of two.
+    ObjectPool(uint32_t minSlabSize = 1024, uint32_t maxObjects = 1 << 24)
+        : slabShift(log2Ceil(minSlabSize)),
+          slabSize(1u << slabShift),
+          maxSlabs((maxObjects + slabSize - 1) / slabSize),
+          slabs(new std::atomic<Slot*>[maxSlabs])
+    {
+        for (uint32_t i = 0; i < maxSlabs; ++i) slabs[i] = nullptr;
+        for (auto& f : freeLists) f.head = 0;
+    }
+
+    ~ObjectPool()
+    {
+        clear();
+        for (uint32_t i = 0; i < numSlabs; ++i) delete[] slabs[i].load();
+    }
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    template <typename... Args>
+    PoolHandle create(Args&&... args)
+    {
+        uint32_t index = pop();
+        Slot& s        = slot(index);
+        new (s.ptr()) T(std::forward<Args>(args)...);
+
+        // odd generation = alive
+        uint32_t generation = s.generation.load(std::memory_order_relaxed) + 1;
+        s.generation.store(generation, std::memory_order_release);
+        liveCount++;
+        return {index, generation};
+    }
+
+    // Returns false if the handle was already destroyed.
+    bool destroy(PoolHandle handle)
+    {
+        if (!handle.valid() || handle.index >= numSlabs.load(std::memory_order_acquire) * slabSize) return false;
+        Slot& s           = slot(handle.index);
+        uint32_t expected = handle.generation;
+        if (!(expected & 1)) return false;
+        // Only one thread can win this exchange, so double frees are detected.
+        if (!s.generation.compare_exchange_strong(expected, expected + 1, std::memory_order_acq_rel)) return false;
+        s.ptr()->~T();
+        liveCount--;
+        push(handle.index);
+        return true;
+    }
+
+    // nullptr if the object was destroyed.
+    T* get(PoolHandle handle)
+    {
+        if (!handle.valid() || handle.index >= numSlabs.load(std::memory_order_acquire) * slabSize) return nullptr;
+        Slot& s = slot(handle.index);
+        return s.generation.load(std::memory_order_acquire) == handle.generation ? s.ptr() : nullptr;
+    }
+
+    T& operator[](PoolHandle handle)
+    {
+        T* ptr = get(handle);
+        SAIGA_ASSERT(ptr, "Use after free of a pool object.");
+        return *ptr;
+    }
+
+    /**
+     * Calls f(handle, object) for all live objects.
+     * Objects that are created or destroyed concurrently may or may not be visited. Objects must not be destroyed
+     * by another thread while f is running on them.
+     */
+    void forEach(const std::function<void(PoolHandle, T&)>& f)
+    {
+        uint32_t n = numSlabs.load(std::memory_order_acquire);
+        for (uint32_t b = 0; b < n; ++b)
+        {
+            Slot* slab = slabs[b].load(std::memory_order_acquire);
+            for (uint32_t i = 0; i < slabSize; ++i)
+            {
+                uint32_t generation = slab[i].generation.load(std::memory_order_acquire);
+                if (generation & 1) f({b * slabSize + i, generation}, *slab[i].ptr());
+            }
+        }
+    }
+
+    // Destroys all objects. Must not be called concurrently with other functions.
+    void clear()
+    {
+        uint32_t n = numSlabs.load();
+        for (uint32_t index = 0; index < n * slabSize; ++index)
+        {
+            Slot& s = slot(index);
+            if (s.generation & 1) destroy({index, s.generation});
+        }
+    }
+
+    size_t size() const { return liveCount; }
+    size_t capacity() const { return size_t(numSlabs) * slabSize; }
+
+   private:
+    struct Slot
+    {
+        std::atomic<uint32_t> generation = 0;
+        // Next free slot + 1 in the free list. 0 = end of list.
+        std::atomic<uint32_t> next = 0;
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T* ptr() { return std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+    // Head of a Treiber stack: The lower 32 bits are the slot index + 1 and the upper 32 bits are a tag against ABA.
+    struct alignas(SAIGA_CACHE_LINE_SIZE) FreeList
+    {
+        std::atomic<uint64_t> head;
+    };
+
+    Slot& slot(uint32_t index)
+    {
+        return slabs[index >> slabShift].load(std::memory_order_acquire)[index & (slabSize - 1)];
+    }
+
+    static uint32_t log2Ceil(uint32_t n)
+    {
+        uint32_t s = 0;
+        while ((1u << s) < n) ++s;
+        return s;
+    }
+
+    static int threadFreeList()
+    {
+        static thread_local int id = std::hash<std::thread::id>()(std::this_thread::get_id()) % numFreeLists;
+        return id;
+    }
+
+    // Pushes the chain first -> ... -> last to the list.
+    void pushChain(FreeList& list, uint32_t first, uint32_t last)
+    {
+        uint64_t head = list.head.load(std::memory_order_relaxed);
+        uint64_t newHead;
+        do
+        {
+            slot(last).next.store(uint32_t(head), std::memory_order_relaxed);
+            newHead = ((head >> 32) + 1) << 32 | (first + 1);
+        } while (!list.head.compare_exchange_weak(head, newHead, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    void push(uint32_t index) { pushChain(freeLists[threadFreeList()], index, index); }
+
+    bool tryPop(FreeList& list, uint32_t& index)
+    {
+        uint64_t head = list.head.load(std::memory_order_acquire);
+        while (uint32_t(head) != 0)
+        {
+            uint32_t top     = uint32_t(head) - 1;
+            uint32_t next    = slot(top).next.load(std::memory_order_relaxed);
+            uint64_t newHead = ((head >> 32) + 1) << 32 | next;
+            if (list.head.compare_exchange_weak(head, newHead, std::memory_order_acquire, std::memory_order_acquire))
+            {
+                index = top;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    uint32_t pop()
+    {
+        uint32_t index;
+        int own = threadFreeList();
+        for (int i = 0; i < numFreeLists; ++i)
+        {
+            if (tryPop(freeLists[(own + i) % numFreeLists], index)) return index;
+        }
+        return grow();
+    }
+
+    // Allocates a new slab. Returns one slot and puts the others into the free list of this thread.
+    uint32_t grow()
+    {
+        std::unique_lock lock(growMutex);
+        uint32_t b = numSlabs.load(std::memory_order_relaxed);
+        SAIGA_ASSERT(b < maxSlabs, "ObjectPool is full.");
+        slabs[b].store(new Slot[slabSize], std::memory_order_release);
+        numSlabs.store(b + 1, std::memory_order_release);
+
+        uint32_t first = b * slabSize;
+        if (slabSize > 1)
+        {
+            for (uint32_t i = first + 1; i < first + slabSize - 1; ++i)
+            {
+                slot(i).next.store(i + 2, std::memory_order_relaxed);
+            }
+            pushChain(freeLists[threadFreeList()], first + 1, first + slabSize - 1);
+        }
+        return first;
+    }
+
+    uint32_t slabShift;
+    uint32_t slabSize;
+    uint32_t maxSlabs;
+    std::unique_ptr<std::atomic<Slot*>[]> slabs;
+    std::atomic<uint32_t> numSlabs = 0;
+    std::atomic<size_t> liveCount  = 0;
+    std::mutex growMutex;
+    FreeList freeLists[numFreeLists];
+};
+
+}  // namespace Saiga
@@ -9,6 +9,8 @@
 
 #include "saiga/config.h"
 
+#include <exception>
+#include <string>
 #include <thread>
 
 namespace Saiga
@@ -6,6 +6,8 @@
 
 #include "saiga/core/util/assert.h"
 
+#include "saiga/core/util/AsyncLogger.h"
+
 #include "internal/noGraphicsAPI.h"
 
 #include <iostream>
@@ -15,6 +17,10 @@ namespace Saiga
 void saiga_assert_fail(const std::string& __assertion, const char* __file, unsigned int __line, const char* __function,
                        const std::string& __message)
 {
+    // Write all pending log messages first, so the assertion is the last line of the output.
+    // This does not create the logger and does not block if the assertion failed in the flush thread.
+    AsyncLogger::flushIfCreated();
+
     std::cout << "Assertion '" << __assertion << "' failed!" << std::endl;
     std::cout << "  File: " << __file << ":" << __line << std::endl;
     std::cout << "  Function: " << __function << std::endl;
@@ -23,35 +23,50 @@ namespace Saiga
 PerlinNoise::PerlinNoise()
 {
     // Initialize the permutation vector with the reference values
-    p = {151, 160, 137, 91,  90,  15,  131, 13,  201, 95,  96,  53,  194, 233, 7,   225, 140, 36,  103, 30,  69,  142,
-         8,   99,  37,  240, 21,  10,  23,  190, 6,   148, 247, 120, 234, 75,  0,   26,  197, 62,  94,  252, 219, 203,
-         117, 35,  11,  32,  57,  177, 33,  88,  237, 149, 56,  87,  174, 20,  125, 136, 171, 168, 68,  175, 74,  165,
-         71,  134, 139, 48,  27,  166, 77,  146, 158, 231, 83,  111, 229, 122, 60,  211, 133, 230, 220, 105, 92,  41,
-         55,  46,  245, 40,  244, 102, 143, 54,  65,  25,  63,  161, 1,   216, 80,  73,  209, 76,  132, 187, 208, 89,
-         18,  169, 200, 196, 135, 130, 116, 188, 159, 86,  164, 100, 109, 198, 173, 186, 3,   64,  52,  217, 226, 250,
-         124, 123, 5,   202, 38,  147, 118, 126, 255, 82,  85,  212, 207, 206, 59,  227, 47,  16,  58,  17,  182, 189,
-         28,  42,  223, 183, 170, 213, 119, 248, 152, 2,   44,  154, 163, 70,  221, 153, 101, 155, 167, 43,  172, 9,
-         129, 22,  39,  253, 19,  98,  108, 110, 79,  113, 224, 232, 178, 185, 112, 104, 218, 246, 97,  228, 251, 34,
-         242, 193, 238, 210, 144, 12,  191, 179, 162, 241, 81,  51,  145, 235, 249, 14,  239, 107, 49,  192, 214, 31,
-         181, 199, 106, 157, 184, 84,  204, 176, 115, 121, 50,  45,  127, 4,   150, 254, 138, 236, 205, 93,  222, 114,
-         67,  29,  24,  72,  243, 141, 128, 195, 78,  66,  215, 61,  156, 180};
+    static const int reference[256] = {151, 160, 137, 91,  90,  15,  131, 13,  201, 95,  96,  53,  194, 233, 7,   225,
+                                       140, 36,  103, 30,  69,  142, 8,   99,  37,  240, 21,  10,  23,  190, 6,   148,
+                                       247, 120, 234, 75,  0,   26,  197, 62,  94,  252, 219, 203, 117, 35,  11,  32,
+                                       57,  177, 33,  88,  237, 149, 56,  87,  174, 20,  125, 136, 171, 168, 68,  175,
+                                       74,  165, 71,  134, 139, 48,  27,  166, 77,  146, 158, 231, 83,  111, 229, 122,
+                                       60,  211, 133, 230, 220, 105, 92,  41,  55,  46,  245, 40,  244, 102, 143, 54,
+                                       65,  25,  63,  161, 1,   216, 80,  73,  209, 76,  132, 187, 208, 89,  18,  169,
+                                       200, 196, 135, 130, 116, 188, 159, 86,  164, 100, 109, 198, 173, 186, 3,   64,
+                                       52,  217, 226, 250, 124, 123, 5,   202, 38,  147, 118, 126, 255, 82,  85,  212,
+                                       207, 206, 59,  227, 47,  16,  58,  17,  182, 189, 28,  42,  223, 183, 170, 213,
+                                       119, 248, 152, 2,   44,  154, 163, 70,  221, 153, 101, 155, 167, 43,  172, 9,
+                                       129, 22,  39,  253, 19,  98,  108, 110, 79,  113, 224, 232, 178, 185, 112, 104,
+                                       218, 246, 97,  228, 251, 34,  242, 193, 238, 210, 144, 12,  191, 179, 162, 241,
+                                       81,  51,  145, 235, 249, 14,  239, 107, 49,  192, 214, 31,  181, 199, 106, 157,
+                                       184, 84,  204, 176, 115, 121, 50,  45,  127, 4,   150, 254, 138, 236, 205, 93,
+                                       222, 114, 67,  29,  24,  72,  243, 141, 128, 195, 78,  66,  215, 61,  156, 180};
     // Duplicate the permutation vector
-    p.insert(p.end(), p.begin(), p.end());
+    std::copy(reference, reference + 256, p.begin());
+    std::copy(reference, reference + 256, p.begin() + 256);
 }
 // Generate a new permutation vector based on the value of seed
 PerlinNoise::PerlinNoise(unsigned int seed)
 {
-    p.resize(256);
     // Fill p with values from 0 to 255
-    std::iota(p.begin(), p.end(), 0);
+    std::iota(p.begin(), p.begin() + 256, 0);
     // Initialize a random engine with seed
     std::default_random_engine engine(seed);
     // Suffle using the above random engine
-    std::shuffle(p.begin(), p.end(), engine);
+    std::shuffle(p.begin(), p.begin() + 256, engine);
     // Duplicate the permutation vector
-    p.insert(p.end(), p.begin(), p.end());
+    std::copy(p.begin(), p.begin() + 256, p.begin() + 256);
 }
-double PerlinNoise::noise(double x, double y, double z)
+uint64_t PerlinNoise::hash() const
+{
+    // FNV-1a
+    uint64_t h = 14695981039346656037ull;
+    for (int i = 0; i < 256; ++i)
+    {
+        h = (h ^ uint64_t(p[i])) * 1099511628211ull;
+    }
+    return h;
+}
+
+double PerlinNoise::noise(double x, double y, double z) const
 {
     // Find the unit cube that contains the point
     int X = (int)floor(x) & 255;
@@ -96,7 +111,7 @@ double PerlinNoise::grad(int hash, double x, double y, double z)
     return ((h & 1) == 0 ? u : -u) + ((h & 2) == 0 ? v : -v);
 }
 
-double PerlinNoise::fBm(double x, double y, double z, int octaves, float lacunarity, float gain)
+double PerlinNoise::fBm(double x, double y, double z, int octaves, float lacunarity, float gain) const
 {
     float amplitude = 1.0;
     float frequency = 1.0;
@@ -110,4 +125,148 @@ double PerlinNoise::fBm(double x, double y, double z, int octaves, float lacunar
     return sum;
 }
 
+// ============ Batched float interface ============
+
+static inline int floorInt(float x)
+{
+    int i = int(x);
+    return i - (x < i);
+}
+
+static inline float fadef(float t)
+{
+    return t * t * t * (t * (t * 6 - 15) + 10);
+}
+
+static inline float lerpf(float t, float a, float b)
+{
+    return a + t * (b - a);
+}
+
+// Same as grad() but written with selects, so that it can be vectorized.
+static inline float gradf(int hash, float x, float y, float z)
+{
+    int h   = hash & 15;
+    float u = h < 8 ? x : y;
+    float v = h < 4 ? y : (h == 12 || h == 14 ? x : z);
+    return ((h & 1) == 0 ? u : -u) + ((h & 2) == 0 ? v : -v);
+}
+
+void PerlinNoise::accumulateBatch(const float* x, const float* y, const float* z, float frequency, float amplitude,
+                                  float* sum) const
+{
+    const int* perm = p.data();
+#pragma omp simd
+    for (int i = 0; i < batchSize; ++i)
+    {
+        float fx = x[i] * frequency;
+        float fy = y[i] * frequency;
+        float fz = z[i] * frequency;
+
+        int ix = floorInt(fx);
+        int iy = floorInt(fy);
+        int iz = floorInt(fz);
+        fx -= ix;
+        fy -= iy;
+        fz -= iz;
+        int X = ix & 255;
+        int Y = iy & 255;
+        int Z = iz & 255;
+
+        float u = fadef(fx);
+        float v = fadef(fy);
+        float w = fadef(fz);
+
+        int A  = perm[X] + Y;
+        int AA = perm[A] + Z;
+        int AB = perm[A + 1] + Z;
+        int B  = perm[X + 1] + Y;
+        int BA = perm[B] + Z;
+        int BB = perm[B + 1] + Z;
+
+        float res =
+            lerpf(w,
+                  lerpf(v, lerpf(u, gradf(perm[AA], fx, fy, fz), gradf(perm[BA], fx - 1, fy, fz)),
+                        lerpf(u, gradf(perm[AB], fx, fy - 1, fz), gradf(perm[BB], fx - 1, fy - 1, fz))),
+                  lerpf(v, lerpf(u, gradf(perm[AA + 1], fx, fy, fz - 1), gradf(perm[BA + 1], fx - 1, fy, fz - 1)),
+                        lerpf(u, gradf(perm[AB + 1], fx, fy - 1, fz - 1), gradf(perm[BB + 1], fx - 1, fy - 1, fz - 1))));
+        sum[i] += amplitude * ((res + 1.0f) * 0.5f);
+    }
+}
+
+void PerlinNoise::fBmBatch(const float* x, const float* y, const float* z, float* out, int octaves,
+                           float lacunarity, float gain) const
+{
+    float amplitude = 1.0;
+    float frequency = 1.0;
+    for (int i = 0; i < batchSize; ++i) out[i] = 0;
+    for (int i = 0; i < octaves; ++i)
+    {
+        accumulateBatch(x, y, z, frequency, amplitude, out);
+        amplitude *= gain;
+        frequency *= lacunarity;
+    }
+}
+
+void PerlinNoise::noise(const float* x, const float* y, const float* z, float* out, int n) const
+{
+    fBm(x, y, z, out, n, 1);
+}
+
+void PerlinNoise::fBm(const float* x, const float* y, const float* z, float* out, int n, int octaves,
+                      float lacunarity, float gain) const
+{
+    int i = 0;
+    for (; i + batchSize <= n; i += batchSize)
+    {
+        fBmBatch(x + i, y + i, z + i, out + i, octaves, lacunarity, gain);
+    }
+
+    if (i < n)
+    {
+        // Copy the remaining samples into a full batch
+        alignas(64) float bx[batchSize] = {}, by[batchSize] = {}, bz[batchSize] = {}, bout[batchSize];
+        std::copy(x + i, x + n, bx);
+        std::copy(y + i, y + n, by);
+        std::copy(z + i, z + n, bz);
+        fBmBatch(bx, by, bz, bout, octaves, lacunarity, gain);
+        std::copy(bout, bout + (n - i), out + i);
+    }
+}
+
+void PerlinNoise::fBmField(ImageView<float> out, const vec2& origin, const vec2& step, float z, int octaves,
+                           float lacunarity, float gain) const
+{
+#pragma omp parallel for if (size_t(out.rows) * out.cols > 16 * 1024)
+    for (int r = 0; r < out.rows; ++r)
+    {
+        alignas(64) float bx[batchSize], by[batchSize], bz[batchSize], bout[batchSize];
+        float y = origin.y() + r * step.y();
+        std::fill(by, by + batchSize, y);
+        std::fill(bz, bz + batchSize, z);
+
+        float* row = out.rowPtr(r);
+        for (int c = 0; c < out.cols; c += batchSize)
+        {
+            for (int i = 0; i < batchSize; ++i) bx[i] = origin.x() + (c + i) * step.x();
+            fBmBatch(bx, by, bz, bout, octaves, lacunarity, gain);
+            std::copy(bout, bout + std::min(batchSize, out.cols - c), row + c);
+        }
+    }
+}
+
+void PerlinNoise::fBmVolume(float* out, const ivec3& size, const vec3& origin, const vec3& step, int octaves,
+                            float lacunarity, float gain) const
+{
+    // Each (y,z) line of the volume is one row of an image.
+    int rows = size.y() * size.z();
+#pragma omp parallel for if (size_t(rows) * size.x() > 16 * 1024)
+    for (int r = 0; r < rows; ++r)
+    {
+        ImageView<float> line(1, size.x(), out + size_t(r) * size.x());
+        vec2 lineOrigin(origin.x(), origin.y() + (r % size.y()) * step.y());
+        fBmField(line, lineOrigin, step.head<2>(), origin.z() + (r / size.y()) * step.z(), octaves, lacunarity, gain);
+    }
+}
+
 }  // namespace Saiga
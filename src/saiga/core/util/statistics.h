@@ -32,6 +32,35 @@ class Statistics
     T rms = 0;
 };
 
+/**
+ * Returns the element at the relative position p (0 <= p <= 1) of the sorted data.
+ * The elements are reordered with std::nth_element, which has linear complexity instead of a full sort.
+ * Calling this function multiple times on the same data is fine.
+ */
+template <typename T>
+T percentile(std::vector<T>& data, double p)
+{
+    SAIGA_ASSERT(!data.empty());
+    SAIGA_ASSERT(p >= 0 && p <= 1);
+    auto k = std::min<size_t>(p * data.size(), data.size() - 1);
+    std::nth_element(data.begin(), data.begin() + k, data.end());
+    return data[k];
+}
+
+/**
+ * Median absolute deviation: median(|x_i - median(x)|).
+ * A robust estimate of the spread, which is not affected by a few large outliers.
+ * For normal distributed data the standard deviation is approximately 1.4826 * MAD.
+ */
+template <typename T>
+T medianAbsoluteDeviation(const std::vector<T>& data, T median)
+{
+    std::vector<T> deviations;
+    deviations.reserve(data.size());
+    for (auto d : data) deviations.push_back(std::abs(d - median));
+    return percentile(deviations, 0.5);
+}
+
 template <typename T>
 Statistics<T>::Statistics(const std::vector<T>& _data)
 {
@@ -40,11 +69,10 @@ Statistics<T>::Statistics(const std::vector<T>& _data)
 
     if (numValues == 0) return;
 
-    std::sort(data.begin(), data.end());
-
-    min    = data.front();
-    max    = data.back();
-    median = data[data.size() / 2];
+    auto [minIt, maxIt] = std::minmax_element(data.begin(), data.end());
+    min                 = *minIt;
+    max                 = *maxIt;
+    median              = percentile(data, 0.5);
 
     rms = 0;
     sum = 0;
@@ -11,6 +11,17 @@
 #include "internal/noGraphicsAPI.h"
 
 #include <array>
+#include <cmath>
+#include <limits>
+#include <locale.h>
+
+#ifdef __SSE2__
+#    include <emmintrin.h>
+#endif
+
+#ifdef __APPLE__
+#    include <xlocale.h>
+#endif
 
 namespace Saiga
 {
@@ -37,6 +48,186 @@ std::string concat(const std::vector<std::string>& s, char delim)
     return res;
 }
 
+static inline bool isWhitespace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+#ifdef __SSE2__
+// Bit i is set if character i is whitespace.
+static inline unsigned whitespaceMask(const char* p)
+{
+    __m128i v  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i ws = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\n')));
+    ws         = _mm_or_si128(ws, _mm_cmpeq_epi8(v, _mm_set1_epi8('\t')));
+    ws         = _mm_or_si128(ws, _mm_cmpeq_epi8(v, _mm_set1_epi8('\r')));
+    return _mm_movemask_epi8(ws);
+}
+#endif
+
+const char* findWhitespace(const char* begin, const char* end)
+{
+#ifdef __SSE2__
+    for (; end - begin >= 16; begin += 16)
+    {
+        unsigned mask = whitespaceMask(begin);
+        if (mask) return begin + __builtin_ctz(mask);
+    }
+#endif
+    while (begin != end && !isWhitespace(*begin)) ++begin;
+    return begin;
+}
+
+const char* skipWhitespace(const char* begin, const char* end)
+{
+    // Numbers are usually separated by a single space, which is handled here without the vector loop.
+    if (begin != end && !isWhitespace(*begin)) return begin;
+    if (end - begin > 1 && !isWhitespace(begin[1])) return begin + 1;
+#ifdef __SSE2__
+    for (; end - begin >= 16; begin += 16)
+    {
+        unsigned mask = ~whitespaceMask(begin) & 0xFFFF;
+        if (mask) return begin + __builtin_ctz(mask);
+    }
+#endif
+    while (begin != end && isWhitespace(*begin)) ++begin;
+    return begin;
+}
+
+const char* findAnyOf(const char* begin, const char* end, std::string_view chars)
+{
+#ifdef __SSE2__
+    if (chars.size() <= 8)
+    {
+        __m128i c[8];
+        for (size_t i = 0; i < chars.size(); ++i) c[i] = _mm_set1_epi8(chars[i]);
+
+        for (; end - begin >= 16; begin += 16)
+        {
+            __m128i v     = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+            __m128i found = _mm_setzero_si128();
+            for (size_t i = 0; i < chars.size(); ++i) found = _mm_or_si128(found, _mm_cmpeq_epi8(v, c[i]));
+            unsigned mask = _mm_movemask_epi8(found);
+            if (mask) return begin + __builtin_ctz(mask);
+        }
+    }
+#endif
+    while (begin != end && chars.find(*begin) == std::string_view::npos) ++begin;
+    return begin;
+}
+
+namespace
+{
+// The "C" locale for the locale independent number fallbacks.
+struct ClassicLocale
+{
+#ifdef _WIN32
+    _locale_t locale = _create_locale(LC_NUMERIC, "C");
+    ~ClassicLocale() { _free_locale(locale); }
+#else
+    locale_t locale = newlocale(LC_NUMERIC_MASK, "C", locale_t(0));
+    ~ClassicLocale() { freelocale(locale); }
+#endif
+};
+
+const ClassicLocale& classicLocale()
+{
+    static ClassicLocale l;
+    return l;
+}
+
+#ifdef _WIN32
+float strtoClassic(const char* str, char** next, float)
+{
+    return _strtof_l(str, next, classicLocale().locale);
+}
+double strtoClassic(const char* str, char** next, double)
+{
+    return _strtod_l(str, next, classicLocale().locale);
+}
+#else
+float strtoClassic(const char* str, char** next, float)
+{
+    return strtof_l(str, next, classicLocale().locale);
+}
+double strtoClassic(const char* str, char** next, double)
+{
+    return strtod_l(str, next, classicLocale().locale);
+}
+#endif
+
+int printClassic(char* buffer, size_t size, int precision, double v)
+{
+#ifdef _WIN32
+    return _snprintf_l(buffer, size, "%.*g", classicLocale().locale, precision, v);
+#else
+    locale_t old = uselocale(classicLocale().locale);
+    int n        = std::snprintf(buffer, size, "%.*g", precision, v);
+    uselocale(old);
+    return n;
+#endif
+}
+
+template <typename T>
+size_t parseClassic(const char* first, const char* last, T& value)
+{
+    // Like std::from_chars, no leading whitespace or '+'
+    if (first == last || *first == '+' || isWhitespace(*first)) return 0;
+
+    // strtod needs a null terminated string
+    char buffer[64];
+    size_t n = std::min<size_t>(last - first, sizeof(buffer) - 1);
+    std::copy(first, first + n, buffer);
+    buffer[n] = 0;
+    char* next;
+    T v = strtoClassic(buffer, &next, T());
+    if (next == buffer) return 0;
+    value = v;
+    return next - buffer;
+}
+
+template <typename T>
+char* formatClassic(char* first, char* last, T v)
+{
+    // Every number with at most digits10 significant digits reads back to itself, so %g with digits10 is the shortest
+    // representation for these numbers. Only the others need more digits.
+    // Subnormal numbers have less precision and are searched from a single digit.
+    using Limits  = std::numeric_limits<T>;
+    bool denormal = v != 0 && std::abs(v) < Limits::min();
+    char buffer[32];
+    int n = 0;
+    for (int precision = denormal ? 1 : Limits::digits10; precision <= Limits::max_digits10; ++precision)
+    {
+        n = printClassic(buffer, sizeof(buffer), precision, double(v));
+        T r;
+        if (parseClassic(buffer, buffer + n, r) == size_t(n) && r == v) break;
+    }
+    n = std::min<int>(n, last - first);
+    std::copy(buffer, buffer + n, first);
+    return first + n;
+}
+}  // namespace
+
+namespace Detail
+{
+size_t parseNumberClassic(const char* first, const char* last, float& value)
+{
+    return parseClassic(first, last, value);
+}
+size_t parseNumberClassic(const char* first, const char* last, double& value)
+{
+    return parseClassic(first, last, value);
+}
+char* formatNumberClassic(char* first, char* last, float v)
+{
+    return formatClassic(first, last, v);
+}
+char* formatNumberClassic(char* first, char* last, double v)
+{
+    return formatClassic(first, last, v);
+}
+}  // namespace Detail
+
 std::string leadingZeroString(int number, int characterCount)
 {
     std::string n = Saiga::to_string(number);
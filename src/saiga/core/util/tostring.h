@@ -9,18 +9,26 @@
 #include "saiga/config.h"
 #include "saiga/core/util/DataStructures/ArrayView.h"
 
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
 #include <iomanip>
 #include <sstream>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #ifdef SAIGA_HAS_STRING_VIEW
 #    include <string_view>
 #endif
 
-#if 0 && __has_include(<charconv> )
+#if __has_include(<charconv>)
 #    include <charconv>
-#    define SAIGA_USE_SV_CONV
+// Only defined if the floating point overloads are implemented (gcc >= 11, msvc >= 19.24)
+#    ifdef __cpp_lib_to_chars
+#        define SAIGA_USE_SV_CONV
+#    endif
 #endif
 
 /**
@@ -97,33 +105,113 @@ inline std::string to_string(double v, int precision)
 
 
 
-inline float to_float(const std::string& str)
+#ifdef SAIGA_HAS_STRING_VIEW
+namespace Detail
 {
-    return std::atof(str.c_str());
+// Floating point conversions for standard libraries without floating point charconv.
+// They use the "C" locale, so a decimal comma set with setlocale() does not change the format.
+SAIGA_CORE_API size_t parseNumberClassic(const char* first, const char* last, float& value);
+SAIGA_CORE_API size_t parseNumberClassic(const char* first, const char* last, double& value);
+SAIGA_CORE_API char* formatNumberClassic(char* first, char* last, float v);
+SAIGA_CORE_API char* formatNumberClassic(char* first, char* last, double v);
+}  // namespace Detail
+
+/**
+ * Parses the number at the beginning of str. Leading whitespace and a '+' sign are skipped.
+ * Returns the number of consumed characters or 0 if no number was found. In that case value is not changed.
+ *
+ * Uses std::from_chars, which is locale independent, does not allocate and is much faster than the stream operators
+ * or std::stod. Without floating point charconv, floats are parsed with strtod in the "C" locale.
+ */
+template <typename T>
+inline size_t parseNumber(std::string_view str, T& value)
+{
+    static_assert(std::is_arithmetic<T>::value, "Only numbers can be parsed.");
+    const char* begin = str.data();
+    const char* end   = str.data() + str.size();
+    const char* it    = begin;
+    while (it != end && (*it == ' ' || *it == '\t' || *it == '\n' || *it == '\r')) ++it;
+    if (it != end && *it == '+') ++it;
+
+#    ifndef SAIGA_USE_SV_CONV
+    if constexpr (std::is_floating_point<T>::value)
+    {
+        using Parsed = std::conditional_t<std::is_same<T, float>::value, float, double>;
+        Parsed v;
+        size_t n = Detail::parseNumberClassic(it, end, v);
+        if (n == 0) return 0;
+        value = T(v);
+        return (it - begin) + n;
+    }
+    else
+#    endif
+    {
+        auto result = std::from_chars(it, end, value);
+        if (result.ec != std::errc()) return 0;
+        return result.ptr - begin;
+    }
 }
 
-inline int to_int(const std::string& str)
+inline float to_float(std::string_view str)
 {
-    return std::atoi(str.c_str());
+    float v = 0;
+    parseNumber(str, v);
+    return v;
 }
 
-#ifdef SAIGA_HAS_STRING_VIEW
-inline double to_double(const std::string_view& str)
-{
-#    if 0
-    double d;
-    std::from_chars(str.data(),str.data()+str.size(),d);
-    return d;
-#    else
-    return std::atof(std::string(str).c_str());
-#    endif
+inline int to_int(std::string_view str)
+{
+    int v = 0;
+    parseNumber(str, v);
+    return v;
 }
 
-inline double to_long(const std::string_view& str)
+inline double to_double(std::string_view str)
+{
+    double v = 0;
+    parseNumber(str, v);
+    return v;
+}
+
+inline long to_long(std::string_view str)
+{
+    long v = 0;
+    parseNumber(str, v);
+    return v;
+}
+
+/**
+ * Writes the shortest representation of v, which is parsed back to exactly the same value.
+ * Returns the end of the written characters. 32 characters are always enough.
+ *
+ * Without floating point charconv, the fallback writes the first of digits10..max_digits10 significant digits that
+ * reads back exactly in the "C" locale. In rare cases this is one digit longer than the shortest representation.
+ */
+template <typename T>
+inline char* formatNumber(char* first, char* last, T v)
 {
-    return std::atol(std::string(str).c_str());
+    static_assert(std::is_arithmetic<T>::value, "Only numbers can be formatted.");
+#    ifndef SAIGA_USE_SV_CONV
+    if constexpr (std::is_floating_point<T>::value)
+    {
+        using Formatted = std::conditional_t<std::is_same<T, float>::value, float, double>;
+        return Detail::formatNumberClassic(first, last, Formatted(v));
+    }
+    else
+#    endif
+    {
+        return std::to_chars(first, last, v).ptr;
+    }
 }
 #else
+inline float to_float(const std::string& str)
+{
+    return std::atof(str.c_str());
+}
+inline int to_int(const std::string& str)
+{
+    return std::atoi(str.c_str());
+}
 inline double to_double(const std::string& str)
 {
     return std::atof(str.c_str());
@@ -146,17 +234,17 @@ struct FromStringConverter<float>
 template <>
 struct FromStringConverter<double>
 {
-    static float convert(const std::string& str) { return to_double(str); }
+    static double convert(const std::string& str) { return to_double(str); }
 };
 template <>
 struct FromStringConverter<int>
 {
-    static float convert(const std::string& str) { return to_int(str); }
+    static int convert(const std::string& str) { return to_int(str); }
 };
 template <>
 struct FromStringConverter<long>
 {
-    static float convert(const std::string& str) { return to_long(str); }
+    static long convert(const std::string& str) { return to_long(str); }
 };
 
 
@@ -164,6 +252,17 @@ struct FromStringConverter<long>
 SAIGA_CORE_API std::vector<std::string> split(const std::string& s, char delim);
 SAIGA_CORE_API std::string concat(const std::vector<std::string>& s, char delim);
 
+/**
+ * Character scanning for the text parsers. Whitespace is ' ', '\t', '\n' and '\r'.
+ * 16 characters are compared at once if SSE2 is available.
+ * All functions return end if the character is not found.
+ */
+SAIGA_CORE_API const char* findWhitespace(const char* begin, const char* end);
+SAIGA_CORE_API const char* skipWhitespace(const char* begin, const char* end);
+#ifdef SAIGA_HAS_STRING_VIEW
+SAIGA_CORE_API const char* findAnyOf(const char* begin, const char* end, std::string_view chars);
+#endif
+
 SAIGA_CORE_API std::string leadingZeroString(int number, int characterCount);
 SAIGA_CORE_API bool hasEnding(std::string const& fullString, std::string const& ending);
 SAIGA_CORE_API bool hasPrefix(std::string const& fullString, std::string const& prefix);
@@ -240,19 +339,25 @@ struct SAIGA_TEMPLATE StringViewParser
     StringViewParser(std::string_view delims = " ,\n", bool allowDoubleDelims = true)
         : delims(delims), allowDoubleDelims(allowDoubleDelims)
     {
+        isDelimTable.fill(false);
+        for (auto d : delims) isDelimTable[(unsigned char)d] = true;
     }
     std::string_view next()
     {
-        auto it = currentView.begin();
-        while (it != currentView.end() && !isDelim(*it))
-        {
-            ++it;
-        }
-        auto result = currentView.substr(0, it - currentView.begin());
-        currentView = currentView.substr(it - currentView.begin());
+        auto end    = currentView.data() + currentView.size();
+        auto it     = findAnyOf(currentView.data(), end, delims);
+        auto result = currentView.substr(0, it - currentView.data());
+        currentView = currentView.substr(it - currentView.data());
         advance();
         return result;
     }
+
+    // Parses the next element as a number. Returns false if it is not a number.
+    template <typename T>
+    bool next(T& value)
+    {
+        return parseNumber(next(), value) > 0;
+    }
     void set(std::string_view v)
     {
         currentView = v;
@@ -263,6 +368,7 @@ struct SAIGA_TEMPLATE StringViewParser
     std::string_view currentView;
     std::string_view delims;
     bool allowDoubleDelims = true;
+    std::array<bool, 256> isDelimTable;
     // Skip over all delims
     inline void advance()
     {
@@ -275,12 +381,7 @@ struct SAIGA_TEMPLATE StringViewParser
         }
         currentView = currentView.substr(it - currentView.begin());
     }
-    inline bool isDelim(char c)
-    {
-        for (auto d : delims)
-            if (d == c) return true;
-        return false;
-    }
+    inline bool isDelim(char c) { return isDelimTable[(unsigned char)c]; }
 };
 #endif
 
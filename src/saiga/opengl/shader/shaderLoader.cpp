@@ -12,18 +12,13 @@ ShaderLoader shaderLoader;
 
 void ShaderLoader::reload()
 {
-    std::cout << "ShaderLoader::reload " << cache.objects.size() << std::endl;
-    for (auto& object : cache.objects)
-    {
-        auto name   = std::get<0>(object);
-        auto sci    = std::get<1>(object);
-        auto shader = std::get<2>(object);
-
-
+    std::cout << "ShaderLoader::reload " << cache.size() << std::endl;
+    cache.forEach([this](const std::string& name, const ShaderPart::ShaderCodeInjections& sci,
+                         const std::shared_ptr<Shader>& shader) {
         std::string fullName = SearchPathes::shader(name);
         auto ret             = reload(shader, fullName, sci);
         SAIGA_ASSERT(ret);
-    }
+    });
 }
 
 bool ShaderLoader::reload(std::shared_ptr<Shader> shader, const std::string& name,
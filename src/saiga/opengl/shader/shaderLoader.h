@@ -46,25 +46,18 @@ std::shared_ptr<shader_t> ShaderLoader::load(const std::string& name, const Shad
     }
 
 
-    std::shared_ptr<Shader> objectBase;
-    auto inCache = cache.get(fullName, objectBase, sci);
-
-
-    std::shared_ptr<shader_t> object;
-    if (inCache)
-    {
-        object = std::dynamic_pointer_cast<shader_t>(objectBase);
-    }
-    else
-    {
-        ShaderPartLoader spl(fullName, sci);
-        if (spl.load())
-        {
-            object = spl.createShader<shader_t>();
-        }
-
-        cache.put(fullName, object, sci);
-    }
+    auto objectBase = cache.getOrLoad(fullName,
+                                      [&]() -> std::shared_ptr<Shader> {
+                                          ShaderPartLoader spl(fullName, sci);
+                                          if (spl.load())
+                                          {
+                                              return spl.createShader<shader_t>();
+                                          }
+                                          return nullptr;
+                                      },
+                                      sci);
+
+    auto object = std::dynamic_pointer_cast<shader_t>(objectBase);
     SAIGA_ASSERT(object);
 
     return object;
@@ -26,27 +26,15 @@ std::shared_ptr<Texture> TextureLoader::load(const std::string& name, const Text
         SAIGA_ASSERT(0);
     }
 
-    std::shared_ptr<Texture> object;
-    auto inCache = cache.get(fullName, object, params);
-
-    if (inCache)
-    {
-    }
-    else
-    {
-        bool erg;
-        Image im;
-        erg = im.load(fullName);
-
-
-        if (erg)
-        {
-            object = std::make_shared<Texture>();
-            erg    = object->fromImage(im, params.srgb, true);
-        }
-
-        cache.put(fullName, object, params);
-    }
+    auto object = cache.getOrLoad(fullName,
+                                  [&]() -> std::shared_ptr<Texture> {
+                                      Image im;
+                                      if (!im.load(fullName)) return nullptr;
+                                      auto texture = std::make_shared<Texture>();
+                                      texture->fromImage(im, params.srgb, true);
+                                      return texture;
+                                  },
+                                  params);
     SAIGA_ASSERT(object);
     return object;
 }
@@ -7,14 +7,20 @@
 #pragma once
 
 #include "saiga/core/geometry/triangle_mesh_generator.h"
+#include "saiga/core/image/TerrainPyramid.h"
 #include "saiga/opengl/indexedVertexBuffer.h"
 #include "saiga/opengl/shader/basic_shaders.h"
 #include "saiga/opengl/texture/CubeTexture.h"
 #include "saiga/opengl/texture/Texture.h"
-#include "saiga/core/util/perlinnoise.h"
 
 namespace Saiga
 {
+/**
+ * The height and normal maps of the terrain.
+ *
+ * The maps are created on the CPU by a TerrainPyramid, which can also cache them in 'cacheDirectory'. This class only
+ * copies the levels out of the pyramid and uploads them to textures.
+ */
 class SAIGA_OPENGL_API Heightmap
 {
    private:
@@ -26,19 +32,18 @@ class SAIGA_OPENGL_API Heightmap
 
     int layers, w, h;
 
-    float* heights;
-
     float heightScale = 20.0f;
-    float minH        = 125725;
-    float maxH        = -0125725;
+
+    // If not empty, the noise terrain is cached in this directory and loaded from it by loadMaps().
+    std::string cacheDirectory;
 
     vec2 mapOffset = make_vec2(0);  // vec2(50,50);
     vec2 mapScale  = make_vec2(10);
     //    vec2 mapScaleInv = make_vec2(1.0f / mapScale);
     vec2 mapScaleInv = mapScale;
 
-    std::vector<Image> heightmap;
-    std::vector<Image> normalmap;
+    std::vector<TemplatedImage<float>> heightmap;
+    std::vector<TemplatedImage<ucvec4>> normalmap;
 
     std::vector<std::shared_ptr<Texture>> texheightmap;
     std::vector<std::shared_ptr<Texture>> texnormalmap;
@@ -48,26 +53,24 @@ class SAIGA_OPENGL_API Heightmap
     void setScale(vec2 mapScale, vec2 mapOffset = make_vec2(0));
 
     void createTextures();
+    // Perlin noise terrain
     void createHeightmaps();
+    // Uses a 1 channel 8 bit, 16 bit or float image as level 0.
     void createHeightmapsFrom(const std::string& image);
 
+    // Loads the maps of a previous createHeightmaps() call with the same parameters from the cache directory.
+    // Returns false if there is no cache directory or it was written for a different terrain.
     bool loadMaps();
 
-   private:
-    void createInitialHeightmap();
-    void createRemainingLayers();
-    void createNormalmap();
-
-    void normalizeHeightMap();
+    // Call this after a part of the level 0 heights changed and then createHeightmaps() to update the maps.
+    void invalidate(int x, int y, int w, int h);
 
-    void saveHeightmaps();
-    void saveNormalmaps();
+   private:
+    std::unique_ptr<TerrainPyramid> pyramid;
 
-    float getHeight(int x, int y);
-    float getHeight(int layer, int x, int y);
-    float getHeightScaled(int x, int y);
-    float getHeightScaled(int layer, int x, int y);
-    void setHeight(int x, int y, float v);
+    void createPyramid(TerrainPyramid::HeightSource source);
+    TerrainPyramid::HeightSource noiseSource() const;
+    void downloadLevels();
 };
 
 }  // namespace Saiga
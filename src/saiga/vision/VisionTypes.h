@@ -8,6 +8,7 @@
 
 #include "saiga/core/util/DataStructures/ArrayView.h"
 #include "saiga/vision/VisionIncludes.h"
+#include "saiga/vision/cameraModel/CameraModelBatch.h"
 #include "saiga/vision/cameraModel/Distortion.h"
 #include "saiga/vision/cameraModel/Intrinsics4.h"
 
@@ -75,18 +76,29 @@ SAIGA_VISION_API extern Vec3 infinityVec3();
 
 /**
  * Undistorts all points from begin to end and writes them to output.
+ * The points are processed in blocks with CameraBatch::unprojectUndistortN.
  */
 template <typename _InputIterator1, typename _InputIterator2, typename _T>
 inline void undistortAll(_InputIterator1 __first1, _InputIterator1 __last1, _InputIterator2 __output,
                          const Intrinsics4Base<_T>& intr, const DistortionBase<_T>& dis)
 {
-    for (; __first1 != __last1; ++__first1, (void)++__output)
+    constexpr int B = CameraBatch::BatchSize;
+    _T u[B], v[B], x[B], y[B];
+    while (__first1 != __last1)
     {
-        auto tmp  = *__first1;  // make sure it works inplace
-        tmp       = intr.unproject2(tmp);
-        tmp       = undistortNormalizedPoint(tmp, dis);
-        tmp       = intr.normalizedToImage(tmp);
-        *__output = tmp;
+        // The block is read completely before it is written, so it works inplace.
+        int n = 0;
+        for (; n < B && __first1 != __last1; ++n, ++__first1)
+        {
+            auto&& p = *__first1;
+            u[n]     = p(0);
+            v[n]     = p(1);
+        }
+        CameraBatch::unprojectUndistortN(intr, dis, u, v, x, y, n);
+        for (int i = 0; i < n; ++i, (void)++__output)
+        {
+            *__output = intr.normalizedToImage(Eigen::Matrix<_T, 2, 1>(x[i], y[i]));
+        }
     }
 }
 
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "saiga/core/time/timer.h"
+#include "saiga/core/util/TextWriter.h"
 
 #include "CameraData.h"
 
@@ -72,6 +73,10 @@ struct SAIGA_VISION_API DatasetParameters
     // Load images in parallel with omp
     bool multiThreadedLoad = true;
 
+    // Only read the image files and decode them on first access. See SharedFrame.h.
+    // Currently supported by the TUM dataset.
+    bool lazyDecode = false;
+
     void fromConfigFile(const std::string& file);
 };
 
@@ -130,8 +135,8 @@ class SAIGA_TEMPLATE DatasetCameraBase : public CameraBase<FrameType>
     // <timestamp> <translation x y z> <rotation x y z w>
     void saveGroundTruthTrajectory(const std::string& file)
     {
-        std::ofstream strm(file);
-        strm << std::setprecision(20);
+        TextWriter strm(file);
+        SAIGA_ASSERT(strm.isOpen());
         for (auto& f : frames)
         {
             double time = f.timeStamp;
@@ -141,8 +146,10 @@ class SAIGA_TEMPLATE DatasetCameraBase : public CameraBase<FrameType>
             Vec3 t = gt.translation();
             Quat q = gt.unit_quaternion();
             strm << time << " " << t(0) << " " << t(1) << " " << t(2) << " " << q.x() << " " << q.y() << " " << q.z()
-                 << " " << q.w() << std::endl;
+                 << " " << q.w() << "\n";
         }
+        bool ok = strm.close();
+        SAIGA_ASSERT(ok, "Could not write " + file);
     }
 
    protected:
@@ -6,6 +6,7 @@
 
 #include "EuRoCDataset.h"
 
+#include "saiga/core/time/Profiler.h"
 #include "saiga/core/util/ProgressBar.h"
 #include "saiga/core/util/file.h"
 #include "saiga/core/util/fileChecker.h"
@@ -90,6 +91,7 @@ struct Associations
 EuRoCDataset::EuRoCDataset(const DatasetParameters& _params) : DatasetCameraBase<StereoFrameData>(_params)
 {
     intrinsics.fps = params.fps;
+    SAIGA_PROFILE_ZONE("EuRoCDataset");
 
     VLOG(1) << "Loading EuRoCDataset Stereo Dataset: " << params.dir;
 
@@ -262,6 +264,7 @@ EuRoCDataset::EuRoCDataset(const DatasetParameters& _params) : DatasetCameraBase
 #    pragma omp parallel for if (params.multiThreadedLoad)
         for (int i = 0; i < N; ++i)
         {
+            SAIGA_PROFILE_ZONE("EuRoCDataset::loadFrame");
             auto a      = assos[i];
             auto& frame = frames[i];
 
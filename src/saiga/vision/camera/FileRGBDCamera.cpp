@@ -6,6 +6,7 @@
 
 #include "FileRGBDCamera.h"
 
+#include "saiga/core/time/Profiler.h"
 #include "saiga/core/util/ProgressBar.h"
 #include "saiga/core/util/directory.h"
 #include "saiga/core/util/file.h"
@@ -27,6 +28,7 @@ FileRGBDCamera::~FileRGBDCamera() {}
 
 void FileRGBDCamera::preload(const std::string& datasetDir, bool multithreaded)
 {
+    SAIGA_PROFILE_ZONE("FileRGBDCamera::preload");
     Directory dir(datasetDir);
 
 
@@ -55,6 +57,7 @@ void FileRGBDCamera::preload(const std::string& datasetDir, bool multithreaded)
 #pragma omp parallel for if (multithreaded)
     for (int i = 0; i < N; ++i)
     {
+        SAIGA_PROFILE_ZONE("FileRGBDCamera::loadFrame");
         auto& f = frames[i];
 
         RGBImageType cimg(dir() + "/" + rgbImages[i]);
@@ -6,6 +6,7 @@
 
 #include "KittiDataset.h"
 
+#include "saiga/core/time/Profiler.h"
 #include "saiga/core/util/ProgressBar.h"
 #include "saiga/core/util/easylogging++.h"
 #include "saiga/core/util/file.h"
@@ -21,6 +22,7 @@ KittiDataset::KittiDataset(const DatasetParameters& params_) : DatasetCameraBase
 {
     // Kitti was recorded with 10 fps
     intrinsics.fps = 10;
+    SAIGA_PROFILE_ZONE("KittiDataset");
 
     VLOG(1) << "Loading KittiDataset Stereo Dataset: " << params.dir;
 
@@ -149,6 +151,7 @@ KittiDataset::KittiDataset(const DatasetParameters& params_) : DatasetCameraBase
 #pragma omp parallel for if (params.multiThreadedLoad)
         for (int id = 0; id < params.maxFrames; ++id)
         {
+            SAIGA_PROFILE_ZONE("KittiDataset::loadFrame");
             auto& frame = frames[id];
 
             int i = id + params.startFrame;
@@ -0,0 +1,124 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "SharedFrame.h"
+
+#include "saiga/core/image/imageTransformations.h"
+#include "saiga/core/util/assert.h"
+
+#include <fstream>
+
+namespace Saiga
+{
+RGBDFrameRecord::RGBDFrameRecord(const FrameMetaData& meta, std::vector<char> encodedColor,
+                                 std::vector<char> encodedDepth, double depthFactor,
+                                 std::shared_ptr<ImageBufferPool<ucvec4>> colorPool,
+                                 std::shared_ptr<ImageBufferPool<float>> depthPool)
+    : FrameMetaData(meta),
+      encodedColor(std::move(encodedColor)),
+      encodedDepth(std::move(encodedDepth)),
+      depthFactor(depthFactor),
+      colorPool(colorPool),
+      depthPool(depthPool)
+{
+}
+
+const RGBImageType& RGBDFrameRecord::color() const
+{
+    std::call_once(colorOnce, [this]() {
+        Image img;
+        if (!img.loadFromMemory(encodedColor))
+        {
+            SAIGA_EXIT_ERROR("Could not decode the color image of frame " + std::to_string(id));
+        }
+
+        auto result = colorPool->acquire(img.h, img.w);
+        if (img.type == UC3)
+        {
+            // convert to rgba
+            ImageTransformation::addAlphaChannel(img.getImageView<ucvec3>(), result->getImageView());
+        }
+        else if (img.type == UC4)
+        {
+            img.getImageView<ucvec4>().copyTo(result->getImageView());
+        }
+        else
+        {
+            SAIGA_EXIT_ERROR("invalid image type");
+        }
+        colorImg   = result;
+        colorReady = true;
+    });
+    return *colorImg;
+}
+
+const DepthImageType& RGBDFrameRecord::depth() const
+{
+    std::call_once(depthOnce, [this]() {
+        Image img;
+        if (!img.loadFromMemory(encodedDepth))
+        {
+            SAIGA_EXIT_ERROR("Could not decode the depth image of frame " + std::to_string(id));
+        }
+
+        auto result = depthPool->acquire(img.h, img.w);
+        if (img.type == US1)
+        {
+            img.getImageView<unsigned short>().copyTo(result->getImageView(), 1.0 / depthFactor);
+        }
+        else
+        {
+            SAIGA_EXIT_ERROR("invalid image type");
+        }
+        depthImg   = result;
+        depthReady = true;
+    });
+    return *depthImg;
+}
+
+RGBDFrameData RGBDFrameRecord::toFrameData() const
+{
+    RGBDFrameData data;
+    static_cast<FrameMetaData&>(data) = *this;
+    data.colorImg                     = color();
+    data.depthImg                     = depth();
+    return data;
+}
+
+RGBDFrameFactory::RGBDFrameFactory(double depthFactor, int maxFree)
+    : depthFactor(depthFactor),
+      colorPool(ImageBufferPool<ucvec4>::create(maxFree)),
+      depthPool(ImageBufferPool<float>::create(maxFree))
+{
+}
+
+SharedRGBDFrame RGBDFrameFactory::create(const FrameMetaData& meta, std::vector<char> encodedColor,
+                                         std::vector<char> encodedDepth) const
+{
+    return std::make_shared<const RGBDFrameRecord>(meta, std::move(encodedColor), std::move(encodedDepth),
+                                                   depthFactor, colorPool, depthPool);
+}
+
+static std::vector<char> readFile(const std::string& file)
+{
+    std::ifstream strm(file, std::ios::binary | std::ios::ate);
+    if (!strm.is_open())
+    {
+        SAIGA_EXIT_ERROR("Could not open file " + file);
+    }
+    std::vector<char> data(strm.tellg());
+    strm.seekg(0);
+    strm.read(data.data(), data.size());
+    return data;
+}
+
+SharedRGBDFrame RGBDFrameFactory::createFromFiles(const FrameMetaData& meta, const std::string& colorFile,
+                                                  const std::string& depthFile) const
+{
+    return create(meta, readFile(colorFile), readFile(depthFile));
+}
+
+}  // namespace Saiga
@@ -0,0 +1,93 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/core/image/ImageBufferPool.h"
+
+#include "CameraData.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+namespace Saiga
+{
+/**
+ * An RGB-D frame that is shared between multiple consumers (tracking, mapping, visualization, ...) without copies.
+ *
+ * The record keeps the encoded images (for example the png files of the TUM dataset). Each image is decoded on
+ * the first access of color() or depth() and all following accesses return the same image. The decoded images are
+ * taken from ImageBufferPools and are returned to them when the last SharedRGBDFrame of this record is released.
+ *
+ * SharedRGBDFrame frame;
+ * camera->getSharedFrameSync(frame);
+ * tracker.push(frame);
+ * mapper.push(frame);
+ * ...
+ * // In the tracker (decodes the images if no one else has done it yet)
+ * compute(frame->color(), frame->depth());
+ */
+class SAIGA_VISION_API RGBDFrameRecord : public FrameMetaData
+{
+   public:
+    RGBDFrameRecord(const FrameMetaData& meta, std::vector<char> encodedColor, std::vector<char> encodedDepth,
+                    double depthFactor, std::shared_ptr<ImageBufferPool<ucvec4>> colorPool,
+                    std::shared_ptr<ImageBufferPool<float>> depthPool);
+
+    // Decodes the image on the first call. Thread safe.
+    const RGBImageType& color() const;
+    const DepthImageType& depth() const;
+
+    bool colorDecoded() const { return colorReady; }
+    bool depthDecoded() const { return depthReady; }
+
+    size_t encodedBytes() const { return encodedColor.size() + encodedDepth.size(); }
+
+    // Deep copy to the classic frame type.
+    RGBDFrameData toFrameData() const;
+
+   private:
+    std::vector<char> encodedColor, encodedDepth;
+    double depthFactor;
+
+    std::shared_ptr<ImageBufferPool<ucvec4>> colorPool;
+    std::shared_ptr<ImageBufferPool<float>> depthPool;
+
+    mutable std::once_flag colorOnce, depthOnce;
+    mutable std::atomic_bool colorReady = false, depthReady = false;
+    mutable std::shared_ptr<RGBImageType> colorImg;
+    mutable std::shared_ptr<DepthImageType> depthImg;
+};
+
+using SharedRGBDFrame = std::shared_ptr<const RGBDFrameRecord>;
+
+/**
+ * Creates the frame records of one camera. All records share the same image pools.
+ */
+class SAIGA_VISION_API RGBDFrameFactory
+{
+   public:
+    // 'maxFree' unused images of each type are kept in the pools.
+    RGBDFrameFactory(double depthFactor, int maxFree = 32);
+
+    SharedRGBDFrame create(const FrameMetaData& meta, std::vector<char> encodedColor,
+                           std::vector<char> encodedDepth) const;
+
+    // Reads the (encoded) image files without decoding them.
+    SharedRGBDFrame createFromFiles(const FrameMetaData& meta, const std::string& colorFile,
+                                    const std::string& depthFile) const;
+
+    ImageBufferPool<ucvec4>& colorBuffers() { return *colorPool; }
+    ImageBufferPool<float>& depthBuffers() { return *depthPool; }
+
+   private:
+    double depthFactor;
+    std::shared_ptr<ImageBufferPool<ucvec4>> colorPool;
+    std::shared_ptr<ImageBufferPool<float>> depthPool;
+};
+
+}  // namespace Saiga
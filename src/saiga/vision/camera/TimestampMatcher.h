@@ -21,7 +21,7 @@ namespace Saiga
 class TimestampMatcher
 {
    public:
-    static int findNearestNeighbour(double leftTime, const std::vector<double> rightTimes)
+    static int findNearestNeighbour(double leftTime, const std::vector<double>& rightTimes)
     {
         // Returns an iterator pointing to the first element in the range [first, last) that is not less than (i.e.
         // greater or equal to) value, or last if no such element is found.
@@ -41,7 +41,8 @@ class TimestampMatcher
     }
 
 
-    static std::tuple<int, int, double> findLowHighAlphaNeighbour(double leftTime, const std::vector<double> rightTimes)
+    static std::tuple<int, int, double> findLowHighAlphaNeighbour(double leftTime,
+                                                                 const std::vector<double>& rightTimes)
     {
         // Returns an iterator pointing to the first element in the range [first, last) that is not less than (i.e.
         // greater or equal to) value, or last if no such element is found.
@@ -6,7 +6,10 @@
 
 #include "TumRGBDCamera.h"
 
+#include "saiga/core/time/Profiler.h"
+#include "saiga/core/util/MemoryMappedFile.h"
 #include "saiga/core/util/ProgressBar.h"
+#include "saiga/core/util/TextParser.h"
 #include "saiga/core/util/easylogging++.h"
 #include "saiga/core/util/file.h"
 #include "saiga/core/util/tostring.h"
@@ -22,17 +25,17 @@ static AlignedVector<TumRGBDCamera::CameraData> readCameraData(std::string file)
 {
     AlignedVector<TumRGBDCamera::CameraData> data;
     {
-        std::ifstream strm(file);
-        SAIGA_ASSERT(strm.is_open());
-        std::string line;
-        while (std::getline(strm, line))
+        MemoryMappedFile mmf(file);
+        SAIGA_ASSERT(mmf.isOpen());
+        TextParser strm(mmf.view<char>());
+        while (true)
         {
-            if (line.empty() || line[0] == '#') continue;
-            std::vector<std::string> elements = Saiga::split(line, ' ');
-            SAIGA_ASSERT(elements.size() == 2);
+            strm.skipComments();
+            if (strm.atEnd()) break;
+
             TumRGBDCamera::CameraData d;
-            d.timestamp = Saiga::to_double(elements[0]);
-            d.img       = elements[1];
+            strm >> d.timestamp >> d.img;
+            SAIGA_ASSERT(strm.ok() && !d.img.empty(), "Invalid line in " + file);
             data.push_back(d);
         }
     }
@@ -44,27 +47,19 @@ static AlignedVector<TumRGBDCamera::GroundTruth> readGT(std::string file)
 {
     AlignedVector<TumRGBDCamera::GroundTruth> data;
     {
-        std::ifstream strm(file);
-        SAIGA_ASSERT(strm.is_open());
-        std::string line;
-        while (std::getline(strm, line))
+        MemoryMappedFile mmf(file);
+        SAIGA_ASSERT(mmf.isOpen());
+        TextParser strm(mmf.view<char>());
+        while (true)
         {
-            if (line.empty() || line[0] == '#') continue;
-            std::vector<std::string> elements = Saiga::split(line, ' ');
-            SAIGA_ASSERT(elements.size() == 8);
-            TumRGBDCamera::GroundTruth d;
-            d.timestamp = Saiga::to_double(elements[0]);
+            strm.skipComments();
+            if (strm.atEnd()) break;
 
+            TumRGBDCamera::GroundTruth d;
             Vec3 t;
-            t(0) = Saiga::to_double(elements[1]);
-            t(1) = Saiga::to_double(elements[2]);
-            t(2) = Saiga::to_double(elements[3]);
-
             Quat r;
-            r.x() = Saiga::to_float(elements[4]);
-            r.y() = Saiga::to_float(elements[5]);
-            r.z() = Saiga::to_float(elements[6]);
-            r.w() = Saiga::to_float(elements[7]);
+            strm >> d.timestamp >> t(0) >> t(1) >> t(2) >> r.x() >> r.y() >> r.z() >> r.w();
+            SAIGA_ASSERT(strm.ok(), "Invalid line in " + file);
             r.normalize();
 
             d.se3 = SE3(r, t);
@@ -102,16 +97,50 @@ SE3 TumRGBDCamera::getGroundTruth(int frame)
     return gt.se3;
 }
 
+bool TumRGBDCamera::getImageSync(RGBDFrameData& data)
+{
+    if (!DatasetCameraBase::getImageSync(data)) return false;
+    if (params.lazyDecode)
+    {
+        // The record is released at the end of this scope and the decoded images are returned to the pools.
+        SharedRGBDFrame frame = std::move(sharedFrames[data.id]);
+        SAIGA_ASSERT(frame);
+        data = frame->toFrameData();
+    }
+    return true;
+}
+
+bool TumRGBDCamera::getSharedFrameSync(SharedRGBDFrame& frame)
+{
+    SAIGA_ASSERT(params.lazyDecode);
+    // Only moves the meta data. The images are not loaded in this mode.
+    RGBDFrameData meta;
+    if (!DatasetCameraBase::getImageSync(meta)) return false;
+    // Hand the record off. Otherwise the camera would keep every decoded image alive until it is destroyed.
+    frame = std::move(sharedFrames[meta.id]);
+    SAIGA_ASSERT(frame);
+    return true;
+}
+
 void TumRGBDCamera::saveRaw(const std::string& dir)
 {
     std::cout << "Saving TUM dataset as Saiga-Raw dataset in " << dir << std::endl;
 #pragma omp parallel for
     for (int i = 0; i < (int)frames.size(); ++i)
     {
-        auto str  = Saiga::leadingZeroString(i, 5);
-        auto& tmp = frames[i];
-        tmp.colorImg.save(std::string(dir) + str + ".png");
-        tmp.depthImg.save(std::string(dir) + str + ".saigai");
+        auto str = Saiga::leadingZeroString(i, 5);
+        if (params.lazyDecode)
+        {
+            SAIGA_ASSERT(sharedFrames[i], "saveRaw must be called before the frames are read.");
+            sharedFrames[i]->color().save(std::string(dir) + str + ".png");
+            sharedFrames[i]->depth().save(std::string(dir) + str + ".saigai");
+        }
+        else
+        {
+            auto& tmp = frames[i];
+            tmp.colorImg.save(std::string(dir) + str + ".png");
+            tmp.depthImg.save(std::string(dir) + str + ".saigai");
+        }
     }
     std::cout << "... Done saving the raw dataset." << std::endl;
 }
@@ -119,6 +148,7 @@ void TumRGBDCamera::saveRaw(const std::string& dir)
 
 void TumRGBDCamera::associate(const std::string& datasetDir)
 {
+    SAIGA_PROFILE_ZONE("TumRGBDCamera::associate");
     AlignedVector<CameraData> rgbData   = readCameraData(datasetDir + "/rgb.txt");
     AlignedVector<CameraData> depthData = readCameraData(datasetDir + "/depth.txt");
     AlignedVector<GroundTruth> gt       = readGT(datasetDir + "/groundtruth.txt");
@@ -160,6 +190,7 @@ void TumRGBDCamera::associate(const std::string& datasetDir)
 
 void TumRGBDCamera::load(const std::string& datasetDir, bool multithreaded)
 {
+    SAIGA_PROFILE_ZONE("TumRGBDCamera::load");
     SAIGA_ASSERT(params.startFrame < tumframes.size());
     tumframes.erase(tumframes.begin(), tumframes.begin() + params.startFrame);
 
@@ -192,11 +223,37 @@ void TumRGBDCamera::load(const std::string& datasetDir, bool multithreaded)
         }
     }
 
+    if (params.lazyDecode)
+    {
+        // Only read the files. The frames only contain the meta data and the images are decoded on demand.
+        frameFactory = std::make_unique<RGBDFrameFactory>(intrinsics().depthFactor);
+        sharedFrames.resize(N);
+
+        SyncedConsoleProgressBar loadingBar(std::cout, "Reading " + to_string(N) + " images ", N);
+#pragma omp parallel for if (params.multiThreadedLoad)
+        for (int i = 0; i < N; ++i)
+        {
+            TumFrame d       = tumframes[i];
+            RGBDFrameData& f = frames[i];
+            f.id             = i;
+            if (d.gt.timestamp != -1)
+            {
+                f.groundTruth = d.gt.se3;
+            }
+            sharedFrames[i] = frameFactory->createFromFiles(f, datasetDir + "/" + d.rgb.img,
+                                                            datasetDir + "/" + d.depth.img);
+            loadingBar.addProgress(1);
+        }
+        VLOG(1) << "Read " << tumframes.size() << " images.";
+        return;
+    }
+
     {
         SyncedConsoleProgressBar loadingBar(std::cout, "Loading " + to_string(N) + " images ", N);
 #pragma omp parallel for if (params.multiThreadedLoad)
         for (int i = 0; i < N; ++i)
         {
+            SAIGA_PROFILE_ZONE("TumRGBDCamera::loadFrame");
             TumFrame d = tumframes[i];
             Image cimg(datasetDir + "/" + d.rgb.img);
             Image dimg(datasetDir + "/" + d.depth.img);
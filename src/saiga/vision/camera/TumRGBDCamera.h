@@ -11,6 +11,7 @@
 #include "saiga/vision/VisionTypes.h"
 
 #include "RGBDCamera.h"
+#include "SharedFrame.h"
 
 
 namespace Saiga
@@ -53,6 +54,14 @@ class SAIGA_VISION_API TumRGBDCamera : public DatasetCameraBase<RGBDFrameData>
 
     RGBDIntrinsics intrinsics() { return _intrinsics; }
 
+    // With DatasetParameters::lazyDecode the images are decoded here. Prefer getSharedFrameSync in that case.
+    bool getImageSync(RGBDFrameData& data) override;
+
+    // Returns the next frame without copying the images. The camera does not keep a reference to the returned
+    // frame, so the decoded images are returned to the pools once all consumers have released it.
+    // Requires DatasetParameters::lazyDecode.
+    bool getSharedFrameSync(SharedRGBDFrame& frame);
+
 
     void saveRaw(const std::string& dir);
 
@@ -63,6 +72,10 @@ class SAIGA_VISION_API TumRGBDCamera : public DatasetCameraBase<RGBDFrameData>
 
     AlignedVector<TumFrame> tumframes;
 
+    // Only used with lazyDecode. 'frames' contains the meta data of these frames but no images.
+    std::unique_ptr<RGBDFrameFactory> frameFactory;
+    std::vector<SharedRGBDFrame> sharedFrames;
+
 
     RGBDIntrinsics _intrinsics;
 };
@@ -0,0 +1,303 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/vision/VisionIncludes.h"
+
+#include "Distortion.h"
+#include "Intrinsics4.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace Saiga
+{
+/**
+ * Batched versions of the camera functions in Intrinsics4.h and Distortion.h.
+ *
+ * The points are given in SoA layout (separate x, y and z arrays). The arrays are processed in blocks of
+ * BatchSize lanes with fixed size Eigen arrays, which are compiled to SIMD instructions without branches.
+ * The remaining elements are computed with the scalar functions, which stay the reference implementation.
+ *
+ * The output arrays may be the same as the input arrays.
+ */
+namespace CameraBatch
+{
+constexpr int BatchSize = 16;
+
+template <typename T>
+using Lane = Eigen::Array<T, BatchSize, 1>;
+
+template <typename T>
+inline Lane<T> load(const T* data)
+{
+    return Eigen::Map<const Lane<T>>(data);
+}
+
+template <typename T>
+inline void store(const Lane<T>& lane, T* data)
+{
+    Eigen::Map<Lane<T>> map(data);
+    map = lane;
+}
+
+// The rad-tan polynomial of distortNormalizedPoint. Works on scalars and on Eigen arrays.
+template <typename A, typename T>
+inline void distortRadTan(const A& x, const A& y, const DistortionBase<T>& d, A& xd, A& yd)
+{
+    T k1 = d(0), k2 = d(1), p1 = d(2), p2 = d(3), k3 = d(4);
+    A x2 = x * x, y2 = y * y;
+    A r2 = x2 + y2, _2xy = T(2) * x * y;
+    A radial      = T(1) + ((k3 * r2 + k2) * r2 + k1) * r2;
+    A tangentialX = p1 * _2xy + p2 * (r2 + T(2) * x2);
+    A tangentialY = p1 * (r2 + T(2) * y2) + p2 * _2xy;
+    xd            = x * radial + tangentialX;
+    yd            = y * radial + tangentialY;
+}
+
+// The fixed point iteration of undistortNormalizedPoint
+template <typename A, typename T>
+inline void undistortRadTan(const A& x0, const A& y0, const DistortionBase<T>& d, A& x, A& y, int iterations = 5)
+{
+    T k1 = d(0), k2 = d(1), p1 = d(2), p2 = d(3), k3 = d(4);
+    x    = x0;
+    y    = y0;
+    for (int j = 0; j < iterations; j++)
+    {
+        A x2 = x * x, y2 = y * y;
+        A r2 = x2 + y2, _2xy = T(2) * x * y;
+        A radial      = T(1) / (T(1) + ((k3 * r2 + k2) * r2 + k1) * r2);
+        A tangentialX = p1 * _2xy + p2 * (r2 + T(2) * x2);
+        A tangentialY = p1 * (r2 + T(2) * y2) + p2 * _2xy;
+        x             = (x0 - tangentialX) * radial;
+        y             = (y0 - tangentialY) * radial;
+    }
+}
+
+// Intrinsics4Base::project
+template <typename T>
+void projectN(const Intrinsics4Base<T>& K, const T* X, const T* Y, const T* Z, T* u, T* v, int n)
+{
+    int i = 0;
+    for (; i + BatchSize <= n; i += BatchSize)
+    {
+        Lane<T> invz = load(Z + i).inverse();
+        Lane<T> x    = load(X + i) * invz * K.fx + K.cx;
+        Lane<T> y    = load(Y + i) * invz * K.fy + K.cy;
+        store(x, u + i);
+        store(y, v + i);
+    }
+    for (; i < n; ++i)
+    {
+        auto p = K.project(Eigen::Matrix<T, 3, 1>(X[i], Y[i], Z[i]));
+        u[i]   = p(0);
+        v[i]   = p(1);
+    }
+}
+
+// StereoCamera4Base::projectStereo. ur is the x coordinate in the right image.
+template <typename T>
+void projectStereoN(const StereoCamera4Base<T>& K, const T* X, const T* Y, const T* Z, T* u, T* v, T* ur, int n)
+{
+    int i = 0;
+    for (; i + BatchSize <= n; i += BatchSize)
+    {
+        Lane<T> invz = load(Z + i).inverse();
+        Lane<T> x    = load(X + i) * invz * K.fx + K.cx;
+        Lane<T> y    = load(Y + i) * invz * K.fy + K.cy;
+        store(x, u + i);
+        store(y, v + i);
+        store(Lane<T>(x - K.bf * invz), ur + i);
+    }
+    for (; i < n; ++i)
+    {
+        auto p = K.projectStereo(Eigen::Matrix<T, 3, 1>(X[i], Y[i], Z[i]));
+        u[i]   = p(0);
+        v[i]   = p(1);
+        ur[i]  = p(2);
+    }
+}
+
+// Intrinsics4Base::unproject
+template <typename T>
+void unprojectN(const Intrinsics4Base<T>& K, const T* u, const T* v, const T* depth, T* X, T* Y, T* Z, int n)
+{
+    T ifx = T(1) / K.fx, ify = T(1) / K.fy;
+    int i = 0;
+    for (; i + BatchSize <= n; i += BatchSize)
+    {
+        Lane<T> d = load(depth + i);
+        Lane<T> x = (load(u + i) - K.cx) * ifx * d;
+        Lane<T> y = (load(v + i) - K.cy) * ify * d;
+        store(x, X + i);
+        store(y, Y + i);
+        store(d, Z + i);
+    }
+    for (; i < n; ++i)
+    {
+        auto p = K.unproject(Eigen::Matrix<T, 2, 1>(u[i], v[i]), depth[i]);
+        X[i]   = p(0);
+        Y[i]   = p(1);
+        Z[i]   = p(2);
+    }
+}
+
+// distortNormalizedPoint
+template <typename T>
+void distortN(const DistortionBase<T>& dis, const T* x, const T* y, T* xd, T* yd, int n)
+{
+    int i = 0;
+    for (; i + BatchSize <= n; i += BatchSize)
+    {
+        Lane<T> rx, ry;
+        distortRadTan(load(x + i), load(y + i), dis, rx, ry);
+        store(rx, xd + i);
+        store(ry, yd + i);
+    }
+    for (; i < n; ++i)
+    {
+        auto p = distortNormalizedPoint(Eigen::Matrix<T, 2, 1>(x[i], y[i]), dis);
+        xd[i]  = p(0);
+        yd[i]  = p(1);
+    }
+}
+
+// undistortNormalizedPoint
+template <typename T>
+void undistortN(const DistortionBase<T>& dis, const T* x, const T* y, T* xu, T* yu, int n)
+{
+    int i = 0;
+    for (; i + BatchSize <= n; i += BatchSize)
+    {
+        Lane<T> rx, ry;
+        undistortRadTan(load(x + i), load(y + i), dis, rx, ry);
+        store(rx, xu + i);
+        store(ry, yu + i);
+    }
+    for (; i < n; ++i)
+    {
+        auto p = undistortNormalizedPoint(Eigen::Matrix<T, 2, 1>(x[i], y[i]), dis);
+        xu[i]  = p(0);
+        yu[i]  = p(1);
+    }
+}
+
+// Pixel -> undistorted point in normalized image space. Same as unproject2 followed by undistortNormalizedPoint.
+template <typename T>
+void unprojectUndistortN(const Intrinsics4Base<T>& K, const DistortionBase<T>& dis, const T* u, const T* v, T* xu,
+                         T* yu, int n)
+{
+    T ifx = T(1) / K.fx, ify = T(1) / K.fy;
+    int i = 0;
+    for (; i + BatchSize <= n; i += BatchSize)
+    {
+        Lane<T> rx, ry;
+        undistortRadTan(Lane<T>((load(u + i) - K.cx) * ifx), Lane<T>((load(v + i) - K.cy) * ify), dis, rx, ry);
+        store(rx, xu + i);
+        store(ry, yu + i);
+    }
+    for (; i < n; ++i)
+    {
+        auto p = undistortNormalizedPoint(K.unproject2(Eigen::Matrix<T, 2, 1>(u[i], v[i])), dis);
+        xu[i]  = p(0);
+        yu[i]  = p(1);
+    }
+}
+
+}  // namespace CameraBatch
+
+/**
+ * Precomputed undistortion for images with a fixed resolution.
+ * Stores the undistorted point in normalized image space for every pixel center. Sub pixel positions are
+ * bilinearly interpolated, which replaces the iterative undistortion by 4 lookups.
+ *
+ * Usage:
+ *
+ * UndistortionMap<double> map(K, dis, 640, 480);
+ * Vec2 p = map.undistort(keypoint.point);
+ */
+template <typename T>
+class UndistortionMap
+{
+   public:
+    using Vec2 = Eigen::Matrix<T, 2, 1>;
+
+    UndistortionMap() {}
+    UndistortionMap(const Intrinsics4Base<T>& K, const DistortionBase<T>& dis, int w, int h) { create(K, dis, w, h); }
+
+    void create(const Intrinsics4Base<T>& K, const DistortionBase<T>& dis, int w, int h)
+    {
+        this->K   = K;
+        this->dis = dis;
+        width     = w;
+        height    = h;
+        mapX.resize(w * h);
+        mapY.resize(w * h);
+
+        std::vector<T> u(w);
+        for (int x = 0; x < w; ++x) u[x] = x;
+
+#pragma omp parallel for
+        for (int y = 0; y < h; ++y)
+        {
+            std::vector<T> v(w, T(y));
+            CameraBatch::unprojectUndistortN(K, dis, u.data(), v.data(), mapX.data() + y * w, mapY.data() + y * w, w);
+        }
+    }
+
+    bool valid() const { return width > 0; }
+
+    // The undistorted normalized point of pixel (x,y).
+    Vec2 operator()(int x, int y) const { return {mapX[y * width + x], mapY[y * width + x]}; }
+
+    // Bilinear interpolation. Points outside of the image are undistorted iteratively.
+    Vec2 undistort(const Vec2& pixel) const
+    {
+        T px = pixel(0), py = pixel(1);
+        if (!(px >= 0 && py >= 0 && px <= width - 1 && py <= height - 1))
+        {
+            return undistortNormalizedPoint(K.unproject2(pixel), dis);
+        }
+
+        // The neighbor is clamped for images with a width or height of 1.
+        int x0 = std::max(std::min<int>(px, width - 2), 0);
+        int y0 = std::max(std::min<int>(py, height - 2), 0);
+        int x1 = std::min(x0 + 1, width - 1);
+        int y1 = std::min(y0 + 1, height - 1);
+        T ax   = px - x0;
+        T ay   = py - y0;
+
+        int i00 = y0 * width + x0, i01 = y0 * width + x1;
+        int i10 = y1 * width + x0, i11 = y1 * width + x1;
+
+        auto bilinear = [&](const std::vector<T>& map) {
+            T top    = (1 - ax) * map[i00] + ax * map[i01];
+            T bottom = (1 - ax) * map[i10] + ax * map[i11];
+            return (1 - ay) * top + ay * bottom;
+        };
+        return {bilinear(mapX), bilinear(mapY)};
+    }
+
+    void undistortN(const T* u, const T* v, T* xu, T* yu, int n) const
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            Vec2 p = undistort(Vec2(u[i], v[i]));
+            xu[i]  = p(0);
+            yu[i]  = p(1);
+        }
+    }
+
+    int width = 0, height = 0;
+    std::vector<T> mapX, mapY;
+
+   private:
+    Intrinsics4Base<T> K;
+    DistortionBase<T> dis;
+};
+
+}  // namespace Saiga
@@ -45,7 +45,10 @@ struct PGO
         JrowTo   = from.inverse().Adj() * weight;
         JrowFrom = -JrowTo;
 #else
-        std::terminate();
+        // error = M * from * to^-1 with the left update from <- exp(d) * from
+        auto M   = inverseMeasurement.inverse();
+        JrowFrom = M.Adj() * weight;
+        JrowTo   = -(M * from * to.inverse()).Adj() * weight;
 #endif
     }
 
@@ -0,0 +1,319 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/vision/VisionTypes.h"
+
+#include <array>
+#include <type_traits>
+
+namespace Saiga
+{
+namespace Kernel
+{
+// Specialized for all transformation types supported by PGOBatch.
+template <typename TransformationType>
+struct PGOBatchTraits;
+
+template <>
+struct PGOBatchTraits<SE3>
+{
+    static constexpr bool hasScale = false;
+};
+
+template <>
+struct PGOBatchTraits<Sim3>
+{
+    static constexpr bool hasScale = true;
+};
+
+template <typename TransformationType, typename = void>
+struct HasPGOBatch : std::false_type
+{
+};
+
+template <typename TransformationType>
+struct HasPGOBatch<TransformationType, std::void_t<decltype(PGOBatchTraits<TransformationType>::hasScale)>>
+    : std::true_type
+{
+};
+
+/**
+ * The PGO kernel (see PGO.h) for N edges at once.
+ *
+ * The transformations are stored in SoA layout, so that every operation (quaternion product, rotation, log) works on
+ * N lanes with Eigen arrays and is vectorized by the compiler. The branches of the log (small angle, small scale)
+ * are evaluated for all lanes and combined with select().
+ *
+ * Residual:  log(measurement * from * to^-1) * weight
+ * Jacobians: Adj(measurement) * weight and -Adj(measurement * from * to^-1) * weight
+ *
+ * The left Jacobian of the log is approximated with the identity, same as in the scalar kernel.
+ * SE3 and Sim3 share the implementation. For SE3 the scale terms are removed at compile time.
+ */
+template <typename TransformationType, int N = 4>
+struct PGOBatch
+{
+    static constexpr bool hasScale  = PGOBatchTraits<TransformationType>::hasScale;
+    static constexpr int ResCount   = TransformationType::DoF;
+    static constexpr int BatchSize  = N;
+    static constexpr double epsilon = 1e-10;
+
+    using T              = typename TransformationType::Scalar;
+    using Lane           = Eigen::Array<T, N, 1>;
+    using ResidualType   = Eigen::Matrix<T, ResCount, 1>;
+    using PoseJacobiType = Eigen::Matrix<T, ResCount, ResCount, Eigen::RowMajor>;
+
+    // N transformations. The quaternion is normalized, the scale is stored separately.
+    struct Transformations
+    {
+        Lane qx, qy, qz, qw;
+        Lane tx, ty, tz;
+        Lane s;
+
+        void set(int i, const TransformationType& t)
+        {
+            Quat q;
+            if constexpr (hasScale)
+            {
+                q    = t.rxso3().quaternion();
+                s(i) = q.squaredNorm();
+                q.normalize();
+            }
+            else
+            {
+                q    = t.unit_quaternion();
+                s(i) = 1;
+            }
+            qx(i) = q.x();
+            qy(i) = q.y();
+            qz(i) = q.z();
+            qw(i) = q.w();
+            tx(i) = t.translation().x();
+            ty(i) = t.translation().y();
+            tz(i) = t.translation().z();
+        }
+
+        void setIdentity(int i)
+        {
+            qx(i) = qy(i) = qz(i) = 0;
+            qw(i)                 = 1;
+            tx(i) = ty(i) = tz(i) = 0;
+            s(i)                  = 1;
+        }
+    };
+
+    // The residual in SoA layout: res[r](lane)
+    using Residuals = std::array<Lane, ResCount>;
+
+    static inline void evaluateResidual(const Transformations& from, const Transformations& to,
+                                        const Transformations& measurement, const Lane& weight, Residuals& res)
+    {
+        Transformations error = multiply(multiply(measurement, from), inverse(to));
+        log(error, res);
+        for (auto& r : res) r *= weight;
+    }
+
+    static inline void evaluateResidualAndJacobian(const Transformations& from, const Transformations& to,
+                                                   const Transformations& measurement, const Lane& weight,
+                                                   Residuals& res, PoseJacobiType* JrowFrom, PoseJacobiType* JrowTo)
+    {
+        Transformations error = multiply(multiply(measurement, from), inverse(to));
+        log(error, res);
+        for (auto& r : res) r *= weight;
+
+        for (int i = 0; i < N; ++i)
+        {
+            adjoint(measurement, i, JrowFrom[i]);
+            adjoint(error, i, JrowTo[i]);
+            JrowFrom[i] *= weight(i);
+            JrowTo[i] *= -weight(i);
+        }
+    }
+
+    static inline ResidualType residual(const Residuals& res, int lane)
+    {
+        ResidualType r;
+        for (int k = 0; k < ResCount; ++k) r(k) = res[k](lane);
+        return r;
+    }
+
+   private:
+    // c = a x b
+    static inline void cross(const Lane& ax, const Lane& ay, const Lane& az, const Lane& bx, const Lane& by,
+                             const Lane& bz, Lane& cx, Lane& cy, Lane& cz)
+    {
+        cx = ay * bz - az * by;
+        cy = az * bx - ax * bz;
+        cz = ax * by - ay * bx;
+    }
+
+    // q * v * q^-1 for unit quaternions
+    static inline void rotate(const Transformations& q, const Lane& vx, const Lane& vy, const Lane& vz, Lane& rx,
+                              Lane& ry, Lane& rz)
+    {
+        Lane ux, uy, uz, wx, wy, wz;
+        cross(q.qx, q.qy, q.qz, vx, vy, vz, ux, uy, uz);
+        ux *= 2;
+        uy *= 2;
+        uz *= 2;
+        cross(q.qx, q.qy, q.qz, ux, uy, uz, wx, wy, wz);
+        rx = vx + q.qw * ux + wx;
+        ry = vy + q.qw * uy + wy;
+        rz = vz + q.qw * uz + wz;
+    }
+
+    static inline Transformations multiply(const Transformations& a, const Transformations& b)
+    {
+        Transformations c;
+        c.qw = a.qw * b.qw - a.qx * b.qx - a.qy * b.qy - a.qz * b.qz;
+        c.qx = a.qw * b.qx + a.qx * b.qw + a.qy * b.qz - a.qz * b.qy;
+        c.qy = a.qw * b.qy - a.qx * b.qz + a.qy * b.qw + a.qz * b.qx;
+        c.qz = a.qw * b.qz + a.qx * b.qy - a.qy * b.qx + a.qz * b.qw;
+
+        rotate(a, b.tx, b.ty, b.tz, c.tx, c.ty, c.tz);
+        if constexpr (hasScale)
+        {
+            c.tx *= a.s;
+            c.ty *= a.s;
+            c.tz *= a.s;
+            c.s = a.s * b.s;
+        }
+        else
+        {
+            c.s = a.s;
+        }
+        c.tx += a.tx;
+        c.ty += a.ty;
+        c.tz += a.tz;
+        return c;
+    }
+
+    static inline Transformations inverse(const Transformations& a)
+    {
+        Transformations c;
+        c.qw = a.qw;
+        c.qx = -a.qx;
+        c.qy = -a.qy;
+        c.qz = -a.qz;
+        c.s  = a.s;
+        rotate(c, a.tx, a.ty, a.tz, c.tx, c.ty, c.tz);
+        if constexpr (hasScale)
+        {
+            c.s = a.s.inverse();
+            c.tx *= -c.s;
+            c.ty *= -c.s;
+            c.tz *= -c.s;
+        }
+        else
+        {
+            c.tx = -c.tx;
+            c.ty = -c.ty;
+            c.tz = -c.tz;
+        }
+        return c;
+    }
+
+    // Same as Sophus::SE3::log and Sophus::Sim3::log
+    static inline void log(const Transformations& a, Residuals& res)
+    {
+        // Rotation: omega = theta * axis. Use the quaternion with w >= 0 to get theta <= pi.
+        Lane sign = (a.qw < 0).select(Lane::Constant(-1), Lane::Constant(1));
+        Lane w    = a.qw * sign;
+        Lane n2   = a.qx.square() + a.qy.square() + a.qz.square();
+        Lane n    = n2.sqrt();
+
+        Lane theta  = 2 * (n / w).atan();
+        Lane factor = (n < epsilon).select(2 / w - (2.0 / 3.0) * n2 / (w * w * w), theta / n);
+
+        Lane ox = a.qx * sign * factor;
+        Lane oy = a.qy * sign * factor;
+        Lane oz = a.qz * sign * factor;
+
+        Lane theta2 = ox.square() + oy.square() + oz.square();
+        theta       = theta2.sqrt();
+
+        // W = C * I + A * Omega + B * Omega^2 (Sophus::details::calcW)
+        Lane A, B, C;
+        auto smallTheta = theta < epsilon;
+        Lane sinTheta   = theta.sin();
+        Lane cosTheta   = theta.cos();
+        Lane A0         = smallTheta.select(Lane::Constant(0.5), (1 - cosTheta) / theta2);
+        Lane B0         = smallTheta.select(Lane::Constant(1.0 / 6.0), (theta - sinTheta) / (theta2 * theta));
+
+        if constexpr (hasScale)
+        {
+            Lane sigma  = a.s.log();
+            Lane sigma2 = sigma.square();
+            Lane scale  = a.s;
+            Lane Cs     = (scale - 1) / sigma;
+
+            // |sigma| >= eps and |theta| < eps
+            Lane A1 = ((sigma - 1) * scale + 1) / sigma2;
+            Lane B1 = (scale * 0.5 * sigma2 + scale - 1 - sigma * scale) / (sigma2 * sigma);
+
+            // |sigma| >= eps and |theta| >= eps
+            Lane sa = scale * sinTheta;
+            Lane sb = scale * cosTheta;
+            Lane c  = theta2 + sigma2;
+            Lane A2 = (sa * sigma + (1 - sb) * theta) / (theta * c);
+            Lane B2 = (Cs - ((sb - 1) * sigma + sa * theta) / c) / theta2;
+
+            auto smallSigma = sigma.abs() < epsilon;
+            A = smallSigma.select(A0, smallTheta.select(A1, A2));
+            B = smallSigma.select(B0, smallTheta.select(B1, B2));
+            C = smallSigma.select(Lane::Constant(1), Cs);
+
+            res[6] = sigma;
+        }
+        else
+        {
+            A = A0;
+            B = B0;
+            C = Lane::Constant(1);
+        }
+
+        // W^-1 = c0 * I + c1 * Omega + c2 * Omega^2. With Omega^3 = -theta^2 * Omega this is a 2x2 system.
+        Lane c0  = C.inverse();
+        Lane a11 = C - theta2 * B;
+        Lane det = a11.square() + theta2 * A.square();
+        Lane r1  = -A * c0;
+        Lane r2  = -B * c0;
+        Lane c1  = (r1 * a11 + theta2 * A * r2) / det;
+        Lane c2  = (a11 * r2 - A * r1) / det;
+
+        Lane ux, uy, uz, vx, vy, vz;
+        cross(ox, oy, oz, a.tx, a.ty, a.tz, ux, uy, uz);
+        cross(ox, oy, oz, ux, uy, uz, vx, vy, vz);
+
+        res[0] = c0 * a.tx + c1 * ux + c2 * vx;
+        res[1] = c0 * a.ty + c1 * uy + c2 * vy;
+        res[2] = c0 * a.tz + c1 * uz + c2 * vz;
+        res[3] = ox;
+        res[4] = oy;
+        res[5] = oz;
+    }
+
+    static inline void adjoint(const Transformations& a, int i, PoseJacobiType& adj)
+    {
+        Mat3 R = Quat(a.qw(i), a.qx(i), a.qy(i), a.qz(i)).toRotationMatrix();
+        Vec3 t(a.tx(i), a.ty(i), a.tz(i));
+
+        adj.setZero();
+        adj.template block<3, 3>(0, 0) = a.s(i) * R;
+        adj.template block<3, 3>(0, 3) = skew(t) * R;
+        adj.template block<3, 3>(3, 3) = R;
+        if constexpr (hasScale)
+        {
+            adj.template block<3, 1>(0, 6) = -t;
+            adj(6, 6)                      = 1;
+        }
+    }
+};
+
+}  // namespace Kernel
+}  // namespace Saiga
@@ -1,5 +1,7 @@
 #include "FeatureDistribution.h"
 
+#include "saiga/core/util/DataStructures/SmallVector.h"
+
 #include <algorithm>
 #include <vector>
 #include "Nanoflann.h"
@@ -35,7 +37,7 @@ int FeatureDistributionBucketing::operator()(std::vector<kpt_t>& keypoints)
     const int patchHeight = ceil((double)height / npatchesInY);
 
     int nCells = npatchesInX * npatchesInY;
-    std::vector<std::vector<kpt_t>> cellkpts(nCells);
+    std::vector<SmallVector<kpt_t, 8>> cellkpts(nCells);
     int nPerCell = (float)N / nCells;
     if (nPerCell < 1)
         nPerCell = 1;
@@ -283,7 +285,7 @@ int FeatureDistributionQuadtree::operator()(std::vector<kpt_t> &keypoints)
     auto iter = nodesList.begin();
     for (; iter != nodesList.end(); ++iter)
     {
-        std::vector<kpt_t> &nodekpts = iter->nodeKpts;
+        auto &nodekpts = iter->nodeKpts;
         kpt_t* kpt = &nodekpts[0];
         if (iter->leaf)
         {
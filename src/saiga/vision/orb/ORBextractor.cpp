@@ -10,6 +10,8 @@
 #endif
 
 #include "saiga/core/image/templatedImage.h"
+#include "saiga/core/time/Profiler.h"
+#include "saiga/core/util/Arena.h"
 #include "saiga/extra/opencv/opencv.h"
 
 #include "GaussianBlur.h"
@@ -136,6 +138,7 @@ void ORBextractor::operator()(img_t image, std::vector<kpt_t>& resultKeypoints,
                               Saiga::TemplatedImage<uchar>& outputDescriptors, FeatureDistribution& distribution,
                               bool distributePerLevel)
 {
+    SAIGA_PROFILE_ZONE("ORBextractor");
     cv::setNumThreads(0);
 
 #ifdef ORB_FIXED_DURATION
@@ -151,24 +154,30 @@ void ORBextractor::operator()(img_t image, std::vector<kpt_t>& resultKeypoints,
     ComputeScalePyramid(image, cvPyramid);
 #else
     imagePyramid[0] = image;
-    std::vector<Saiga::TemplatedImage<uchar>> templatedImages(nlevels);
+    pyramidBuffers.resize(nlevels);
 
     for (int lvl = 1; lvl < nlevels; ++lvl)
     {
         int width  = round(image.cols * invScaleFactorVec[lvl]);
         int height = round(image.rows * invScaleFactorVec[lvl]);
 
-        templatedImages[lvl] = Saiga::TemplatedImage<uchar>(height, width);
-        image.copyScaleLinear((templatedImages[lvl].getImageView()));
-        imagePyramid[lvl] = templatedImages[lvl].getImageView();
+        auto& buffer = pyramidBuffers[lvl];
+        if (buffer.h != height || buffer.w != width) buffer.create(height, width);
+        image.copyScaleLinear((buffer.getImageView()));
+        imagePyramid[lvl] = buffer.getImageView();
     }
 #endif
 
     SetSteps();
 
-    std::vector<std::vector<kpt_t>> allkpts(nlevels);
+    levelKeypoints.resize(nlevels);
+    for (auto& kpts : levelKeypoints) kpts.clear();
+    auto& allkpts = levelKeypoints;
 
-    DivideAndFAST(allkpts, distribution, 30, distributePerLevel);
+    {
+        SAIGA_PROFILE_ZONE("ORBextractor::FAST");
+        DivideAndFAST(allkpts, distribution, 30, distributePerLevel);
+    }
 
     if (!distributePerLevel)
     {
@@ -202,11 +211,15 @@ void ORBextractor::operator()(img_t image, std::vector<kpt_t>& resultKeypoints,
         nkpts += allkpts[lvl].size();
     }
 
-    Saiga::TemplatedImage<uchar> t(std::max(nkpts, 1), 32);
-    img_t BRIEFdescriptors = t.getImageView();
+    // Written directly to the output, which is only reallocated if the number of keypoints changed
+    int descriptorRows = std::max(nkpts, 1);
+    if (outputDescriptors.h != descriptorRows || outputDescriptors.w != 32) outputDescriptors.create(descriptorRows, 32);
+    img_t BRIEFdescriptors = outputDescriptors.getImageView();
 
-    ComputeDescriptors(allkpts, BRIEFdescriptors);
-    outputDescriptors = t;
+    {
+        SAIGA_PROFILE_ZONE("ORBextractor::descriptors");
+        ComputeDescriptors(allkpts, BRIEFdescriptors);
+    }
 
     for (int lvl = 0; lvl < nlevels; ++lvl)
     {
@@ -272,8 +285,10 @@ void ORBextractor::ComputeDescriptors(std::vector<std::vector<kpt_t>>& allkpts,
 
     //    int current = 0;
 
-    std::vector<int> scan(nlevels);
+    ArenaScope scope;
+    ArenaVector<int> scan(nlevels);
     scan[0] = 0;
+    blurBuffers.resize(nlevels);
 
     for (int i = 1; i < nlevels; ++i)
     {
@@ -286,7 +301,11 @@ void ORBextractor::ComputeDescriptors(std::vector<std::vector<kpt_t>>& allkpts,
     for (int lvl = 0; lvl < nlevels; ++lvl)
     {
         int current = scan[lvl];
-        Saiga::TemplatedImage<uchar> t(imagePyramid[lvl].rows, imagePyramid[lvl].cols);
+        auto& t     = blurBuffers[lvl];
+        if (t.h != imagePyramid[lvl].rows || t.w != imagePyramid[lvl].cols)
+        {
+            t.create(imagePyramid[lvl].rows, imagePyramid[lvl].cols);
+        }
         img_t lvlClone = t.getImageView();
         imagePyramid[lvl].copyTo(lvlClone);
 #ifdef ORB_USE_OPENCV
@@ -351,11 +370,13 @@ void ORBextractor::DivideAndFAST(std::vector<std::vector<kpt_t>>& allkpts, Featu
             minLvl = levelToDisplay;
             maxLvl = minLvl + 1;
         }
+        levelScratch.resize(nlevels);
+        patchScratch.resize(nlevels);
 //#pragma omp parallel for default(none) shared(minLvl, maxLvl, cellSize, distributePerLevel, allkpts)
 #pragma omp parallel for num_threads(2) schedule(dynamic)
         for (int lvl = minLvl; lvl < maxLvl; ++lvl)
         {
-            std::vector<kpt_t> levelkpts;
+            auto& levelkpts = levelScratch[lvl];
             levelkpts.clear();
             levelkpts.reserve(nfeatures * 10);
 
@@ -401,7 +422,8 @@ void ORBextractor::DivideAndFAST(std::vector<std::vector<kpt_t>>& allkpts, Featu
                         endX = maximumX;
                     }
 
-                    std::vector<kpt_t> patchkpts;
+                    auto& patchkpts = patchScratch[lvl];
+                    patchkpts.clear();
                     img_t patch = imagePyramid[lvl].subImageView(startY, startX, endY - startY, endX - startX);
 
                     fast.FAST(patch, patchkpts, iniThFAST, lvl);
@@ -435,7 +457,8 @@ void ORBextractor::DivideAndFAST(std::vector<std::vector<kpt_t>>& allkpts, Featu
                 kpt.octave = lvl;
             }
             featuresPerLevelActual[lvl] = levelkpts.size();
-            allkpts[lvl]                = levelkpts;
+            // Swap instead of copy. The old keypoint buffer is reused as scratch in the next frame.
+            allkpts[lvl].swap(levelkpts);
         }
     }
 }
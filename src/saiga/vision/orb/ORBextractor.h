@@ -150,6 +150,14 @@ class SAIGA_VISION_API ORBextractor
 
     FASTdetector fast;
 
+    // Scratch memory that is reused between frames. After the first frames the extractor does not allocate
+    // memory anymore, unless the image size or the number of keypoints grows.
+    std::vector<std::vector<kpt_t>> levelKeypoints;
+    std::vector<std::vector<kpt_t>> levelScratch;
+    std::vector<std::vector<kpt_t>> patchScratch;
+    std::vector<Saiga::TemplatedImage<uchar>> pyramidBuffers;
+    std::vector<Saiga::TemplatedImage<uchar>> blurBuffers;
+
 #ifdef _FEATURE_FILEINTERFACE_ENABLED
     FeatureFileInterface fileInterface;
     bool saveFeatures;
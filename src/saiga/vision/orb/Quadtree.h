@@ -1,5 +1,7 @@
 #pragma once
 
+#include "saiga/core/util/DataStructures/SmallVector.h"
+
 #include "Types.h"
 #include <list>
 
@@ -13,7 +15,8 @@ public:
 
     void DivideNode(QuadtreeNode &n1, QuadtreeNode &n2, QuadtreeNode &n3, QuadtreeNode &n4);
 
-    std::vector<kpt_t> nodeKpts;
+    // Most nodes are split until they contain only a few keypoints
+    SmallVector<kpt_t, 4> nodeKpts;
     ivec2 UL, UR, LL, LR;
     std::list<QuadtreeNode>::iterator lit;
     bool leaf;
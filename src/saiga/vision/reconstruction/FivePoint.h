@@ -6,12 +6,15 @@
 
 #pragma once
 #include "saiga/core/math/random.h"
+#include "saiga/core/util/Arena.h"
 #include "saiga/vision/VisionTypes.h"
 #include "saiga/vision/util/Ransac.h"
 
 #include "Epipolar.h"
 #include "unsupported/Eigen/Polynomials"
 
+#include <algorithm>
+#include <array>
 #include <random>
 
 namespace Saiga
@@ -259,13 +262,15 @@ inline void constructFivePointMatrix(double* e, double* A)
  * This is basically a copy-paste from the opencv implementation, but ported to Eigen.
  *
  * The returned int is the number of solutions.
+ * EContainer is a std::vector<Mat3> with any allocator (for example ArenaVector<Mat3>).
  */
-inline int fivePointNister(Vec2* points0, Vec2* points1, std::vector<Mat3>& es)
+template <typename EContainer>
+inline int fivePointNister(Vec2* points0, Vec2* points1, EContainer& es)
 {
-    int numPoints = 5;
-    int n         = numPoints;
+    constexpr int n = 5;
 
-    Eigen::MatrixXd QE(n, 9);
+    // Fixed size, so that neither the matrix nor the SVD allocate memory
+    Eigen::Matrix<double, n, 9> QE;
     for (int i = 0; i < n; ++i)
     {
         auto& p1 = points0[i];
@@ -281,8 +286,8 @@ inline int fivePointNister(Vec2* points0, Vec2* points1, std::vector<Mat3>& es)
         QE(i, 8) = 1;
     }
 
-    Eigen::JacobiSVD<Eigen::MatrixXd> svd = QE.jacobiSvd(Eigen::ComputeFullV);
-    Eigen::Matrix<double, 9, 4> EEE       = svd.matrixV().block(0, 5, 9, 4);
+    Eigen::JacobiSVD<Eigen::Matrix<double, n, 9>> svd(QE, Eigen::ComputeFullV);
+    Eigen::Matrix<double, 9, 4> EEE = svd.matrixV().block(0, 5, 9, 4);
 
 
 
@@ -346,13 +351,23 @@ inline int fivePointNister(Vec2* points0, Vec2* points1, std::vector<Mat3>& es)
     Eigen::PolynomialSolver<double, 10> solver(coeffs);
     //    solver.compute(coeffs);
 
-    std::vector<double> realRoots;
-    solver.realRoots(realRoots, 1e-10);
+    // The roots are copied to the stack and the scope is closed before 'es' is modified. 'es' might use the same
+    // arena and a reallocation inside the scope would be freed by it.
+    std::array<double, 10> roots;
+    int numRoots = 0;
+    {
+        ArenaScope scope;
+        ArenaVector<double> realRoots;
+        realRoots.reserve(10);
+        solver.realRoots(realRoots, 1e-10);
+        numRoots = std::min<int>(realRoots.size(), roots.size());
+        std::copy(realRoots.begin(), realRoots.begin() + numRoots, roots.begin());
+    }
 
     es.clear();
-    for (size_t i = 0; i < realRoots.size(); i++)
+    for (int i = 0; i < numRoots; i++)
     {
-        double z1 = realRoots[i];
+        double z1 = roots[i];
         double z2 = z1 * z1;
         double z3 = z2 * z1;
         double z4 = z3 * z1;
@@ -397,7 +412,8 @@ inline int fivePointNister(Vec2* points0, Vec2* points1, std::vector<Mat3>& es)
  *
  * If non of these are valid, false is returned.
  */
-inline bool bestEUsing6Points(const std::vector<Mat3>& es, const Vec2* points1, const Vec2* points2, Mat3& bestE,
+template <typename EContainer>
+inline bool bestEUsing6Points(const EContainer& es, const Vec2* points1, const Vec2* points2, Mat3& bestE,
                               SE3& bestT)
 {
     const int N = 6;
@@ -566,12 +582,13 @@ class FivePointRansac : public RansacBase<FivePointRansac, std::pair<Mat3, SE3>,
 
             bestInlierMatches.clear();
             bestInlierMatches.reserve(numInliers[idx]);
+            auto& mask = bestInliers();
             for (int i = 0; i < N; ++i)
             {
-                if (inliers[idx][i]) bestInlierMatches.push_back(i);
+                if (mask[i]) bestInlierMatches.push_back(i);
             }
 
-            inlierMask = inliers[idx];
+            inlierMask = mask;
         }
 
 
@@ -592,7 +609,10 @@ class FivePointRansac : public RansacBase<FivePointRansac, std::pair<Mat3, SE3>,
         }
 
 
-        std::vector<Mat3> es;
+        // At most 10 solutions. Allocated from the arena of this omp thread.
+        ArenaScope scope;
+        ArenaVector<Mat3> es;
+        es.reserve(10);
         fivePointNister(A.data(), B.data(), es);
 
         SE3 localBestT;
@@ -79,13 +79,13 @@ class SAIGA_VISION_API P3PRansac : public RansacBase<P3PRansac, SE3, 4>
         int idx;
         idx        = compute(_worldPoints.size());
         bestT      = models[idx];
-        inlierMask = inliers[idx];
+        inlierMask = bestInliers();
 
         bestInlierMatches.clear();
         bestInlierMatches.reserve(numInliers[idx]);
         for (int i = 0; i < N; ++i)
         {
-            if (inliers[idx][i]) bestInlierMatches.push_back(i);
+            if (inlierMask[i]) bestInlierMatches.push_back(i);
         }
 
         return numInliers[idx];
@@ -111,7 +111,18 @@ struct SAIGA_TEMPLATE SAIGA_ALIGN_CACHE RobustPoseOptimization
     }
 
     int optimizePoseRobust(const AlignedVector<Vec3>& wps, const AlignedVector<Obs>& obs, AlignedVector<int>& outlier,
-                           SE3Type& guess, const CameraType& camera)
+                           SE3Type& guess, const CameraType& camera) const
+    {
+        return optimizePoseRobust(wps.data(), obs.data(), outlier.data(), wps.size(), guess, camera);
+    }
+
+    /**
+     * Same as above on N consecutive elements of the arrays.
+     * This function only reads the thresholds and uses no heap memory. It can therefore be called concurrently from
+     * multiple threads.
+     */
+    int optimizePoseRobust(const Vec3* wps, const Obs* obs, int* outlier, int N, SE3Type& guess,
+                           const CameraType& camera) const
     {
         StereoJ JrowS;
         MonoJ JrowM;
@@ -123,7 +134,6 @@ struct SAIGA_TEMPLATE SAIGA_ALIGN_CACHE RobustPoseOptimization
             JrowM.setZero();
         }
 
-        int N       = wps.size();
         int inliers = 0;
 
         for (auto outerIt : Range(0, maxOuterIts))
@@ -309,6 +319,49 @@ struct SAIGA_TEMPLATE SAIGA_ALIGN_CACHE RobustPoseOptimization
         return inliers;
     }
 
+    /**
+     * One independent pose refinement of optimizePoseRobustBatch.
+     * The observations [begin,end) are a range of the shared wps/obs/outlier arrays.
+     */
+    struct PoseProblem
+    {
+        EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+        // Initial guess and result
+        SE3Type pose;
+        int begin = 0, end = 0;
+        // Index into the camera array
+        int camera = 0;
+        // Output
+        int inliers = 0;
+    };
+
+    /**
+     * Optimizes many independent poses (for example all relocalization candidates of a frame) in parallel.
+     * The problems are distributed dynamically over the OpenMP thread team, which balances problems of different
+     * sizes. The scratch memory of a problem lives on the stack of its thread, so no memory is allocated in steady
+     * state.
+     *
+     * Returns the total number of inliers. The inliers of each problem are stored in PoseProblem::inliers.
+     */
+    int optimizePoseRobustBatch(const AlignedVector<Vec3>& wps, const AlignedVector<Obs>& obs,
+                                AlignedVector<int>& outlier, const AlignedVector<CameraType>& cameras,
+                                AlignedVector<PoseProblem>& problems, int threads = OMP::getMaxThreads()) const
+    {
+        SAIGA_ASSERT(wps.size() == obs.size() && outlier.size() == obs.size());
+        int totalInliers = 0;
+#pragma omp parallel for schedule(dynamic) num_threads(threads) reduction(+ : totalInliers)
+        for (int p = 0; p < (int)problems.size(); ++p)
+        {
+            auto& problem = problems[p];
+            SAIGA_DEBUG_ASSERT(problem.begin >= 0 && problem.begin <= problem.end && problem.end <= (int)obs.size());
+            int b           = problem.begin;
+            problem.inliers = optimizePoseRobust(wps.data() + b, obs.data() + b, outlier.data() + b,
+                                                 problem.end - b, problem.pose, cameras[problem.camera]);
+            totalInliers += problem.inliers;
+        }
+        return totalInliers;
+    }
+
     struct SAIGA_ALIGN_CACHE ThreadLocalData
     {
         JType JtJ;
@@ -0,0 +1,167 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "TriangulationBatch.h"
+
+#include "saiga/vision/scene/Scene.h"
+
+#include <Eigen/Eigenvalues>
+
+namespace Saiga
+{
+int TriangulationBatch::triangulate(const AlignedVector<SE3>& poses, const TriangulationTracks& tracks,
+                                    AlignedVector<Vec3>& points, std::vector<char>& valid) const
+{
+    SAIGA_ASSERT(tracks.poses.size() == tracks.points.size());
+    int N = tracks.size();
+    points.resize(N);
+    valid.resize(N);
+
+    // Projection matrices and camera centers are shared by all tracks of a pose
+    AlignedVector<ProjectionMatrix> P(poses.size());
+    AlignedVector<Vec3> centers(poses.size());
+    for (int i = 0; i < (int)poses.size(); ++i)
+    {
+        P[i]       = poses[i].matrix3x4();
+        centers[i] = poses[i].inverse().translation();
+    }
+
+    int validCount = 0;
+#pragma omp parallel reduction(+ : validCount)
+    {
+        AlignedVector<Vec3> rays;
+#pragma omp for schedule(dynamic, 256)
+        for (int i = 0; i < N; ++i)
+        {
+            int begin = tracks.offsets[i];
+            int n     = tracks.offsets[i + 1] - begin;
+            valid[i]  = solveTrack(P.data(), centers.data(), tracks.poses.data() + begin,
+                                  tracks.points.data() + begin, n, points[i], rays);
+            validCount += valid[i];
+        }
+    }
+    return validCount;
+}
+
+int TriangulationBatch::triangulate(Scene& scene) const
+{
+    AlignedVector<SE3> poses(scene.extrinsics.size());
+    for (int i = 0; i < (int)poses.size(); ++i) poses[i] = scene.extrinsics[i].se3;
+
+    TriangulationTracks tracks;
+    tracks.offsets.reserve(scene.worldPoints.size() + 1);
+    for (auto& wp : scene.worldPoints)
+    {
+        for (auto [imgId, ipId] : wp.stereoreferences)
+        {
+            auto& img = scene.images[imgId];
+            auto& ip  = img.stereoPoints[ipId];
+            if (!ip) continue;
+            tracks.addObservation(img.extr, scene.intrinsics[img.intr].unproject2(ip.point));
+        }
+        tracks.finishTrack();
+    }
+
+    AlignedVector<Vec3> points;
+    std::vector<char> valid;
+    int validCount = triangulate(poses, tracks, points, valid);
+
+    for (int i = 0; i < (int)scene.worldPoints.size(); ++i)
+    {
+        auto& wp = scene.worldPoints[i];
+        if (valid[i])
+        {
+            wp.valid = true;
+            wp.p     = points[i];
+        }
+        else
+        {
+            // Also removes the references of the image points, so the scene stays consistent.
+            scene.removeWorldPoint(i);
+        }
+    }
+    return validCount;
+}
+
+bool TriangulationBatch::solveTrack(const ProjectionMatrix* P, const Vec3* centers, const int* poseIds,
+                                    const Vec2* points, int n, Vec3& result, AlignedVector<Vec3>& rays) const
+{
+    if (n < 2) return false;
+
+    // N-view DLT. Instead of the 2n x 4 system A we solve the 4x4 normal equations A^T A, which has a constant
+    // size and can be accumulated without temporary memory.
+    Mat4 AtA = Mat4::Zero();
+    for (int k = 0; k < n; ++k)
+    {
+        auto& Pk = P[poseIds[k]];
+        Vec4 r1  = points[k].x() * Pk.row(2) - Pk.row(0);
+        Vec4 r2  = points[k].y() * Pk.row(2) - Pk.row(1);
+        AtA.noalias() += r1 * r1.transpose() + r2 * r2.transpose();
+    }
+
+    Eigen::SelfAdjointEigenSolver<Mat4> eig(AtA);
+    Vec4 phom = eig.eigenvectors().col(0);
+    if (std::abs(phom(3)) < 1e-12) return false;
+    Vec3 X = phom.head<3>() / phom(3);
+
+    // Gauss-Newton on the reprojection error in normalized image space
+    for (int it = 0; it < settings.refinementIterations; ++it)
+    {
+        Mat3 JtJ = Mat3::Zero();
+        Vec3 Jtb = Vec3::Zero();
+        for (int k = 0; k < n; ++k)
+        {
+            auto& Pk = P[poseIds[k]];
+            Vec3 pc  = Pk.leftCols<3>() * X + Pk.col(3);
+            if (pc.z() < settings.minDepth) return false;
+
+            double iz = 1.0 / pc.z();
+            Vec2 res(pc.x() * iz - points[k].x(), pc.y() * iz - points[k].y());
+
+            Eigen::Matrix<double, 2, 3> Jp;
+            Jp << iz, 0, -pc.x() * iz * iz, 0, iz, -pc.y() * iz * iz;
+            Eigen::Matrix<double, 2, 3> J = Jp * Pk.leftCols<3>();
+
+            JtJ.noalias() += J.transpose() * J;
+            Jtb.noalias() += J.transpose() * res;
+        }
+        Vec3 delta = JtJ.ldlt().solve(-Jtb);
+        X += delta;
+        if (delta.squaredNorm() < 1e-20 * X.squaredNorm()) break;
+    }
+
+    // Cheirality
+    rays.resize(n);
+    for (int k = 0; k < n; ++k)
+    {
+        auto& Pk = P[poseIds[k]];
+        double z = Pk.row(2).head<3>().dot(X) + Pk(2, 3);
+        if (z < settings.minDepth) return false;
+        rays[k] = (X - centers[poseIds[k]]).normalized();
+    }
+
+    // At least one pair of rays must enclose an angle of minAngle. Same measure as TriangulationAngle, which
+    // uses the smaller of the two angles between the rays.
+    double maxCos = std::cos(settings.minAngle);
+    bool angleOk  = false;
+    for (int a = 0; a < n && !angleOk; ++a)
+    {
+        for (int b = a + 1; b < n; ++b)
+        {
+            if (std::abs(rays[a].dot(rays[b])) <= maxCos)
+            {
+                angleOk = true;
+                break;
+            }
+        }
+    }
+    if (!angleOk) return false;
+
+    result = X;
+    return true;
+}
+
+}  // namespace Saiga
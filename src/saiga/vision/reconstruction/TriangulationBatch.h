@@ -0,0 +1,97 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/vision/VisionTypes.h"
+
+#include <vector>
+
+namespace Saiga
+{
+class Scene;
+
+/**
+ * A set of point tracks in compressed sparse row (CSR) format.
+ * The observations of track i are the elements [offsets[i], offsets[i+1]) of poses and points.
+ * The points must be in normalized image space.
+ */
+struct SAIGA_VISION_API TriangulationTracks
+{
+    std::vector<int> offsets = {0};
+    std::vector<int> poses;
+    AlignedVector<Vec2> points;
+
+    int size() const { return offsets.size() - 1; }
+    int numObservations() const { return poses.size(); }
+
+    void addObservation(int pose, const Vec2& point)
+    {
+        poses.push_back(pose);
+        points.push_back(point);
+    }
+    // Closes the current track. All observations added since the last call belong to it.
+    void finishTrack() { offsets.push_back(poses.size()); }
+
+    void clear()
+    {
+        offsets = {0};
+        poses.clear();
+        points.clear();
+    }
+};
+
+struct SAIGA_VISION_API TriangulationBatchSettings
+{
+    // Gauss-Newton iterations on the reprojection error after the linear solution. 0 disables the refinement.
+    int refinementIterations = 3;
+
+    // Points with a smaller maximum triangulation angle (in radians) over all observation pairs are rejected.
+    double minAngle = pi<double>() / 180.0;
+
+    // Points must be at least this far in front of every camera.
+    double minDepth = 1e-5;
+};
+
+/**
+ * Triangulates many points from an arbitrary number of views in parallel.
+ *
+ * Each track is solved with the N-view DLT (the 4x4 normal equations of the homogeneous system of
+ * Triangulation::triangulateHomogeneous), optionally refined with Gauss-Newton and then filtered by cheirality and
+ * triangulation angle. The per pose projection matrices and camera centers are computed once for the whole batch.
+ *
+ * Poses transform from world to camera space, same as Extrinsics::se3.
+ */
+class SAIGA_VISION_API TriangulationBatch
+{
+   public:
+    TriangulationBatchSettings settings;
+
+    TriangulationBatch(const TriangulationBatchSettings& settings = {}) : settings(settings) {}
+
+    /**
+     * Triangulates all tracks. points and valid are resized to tracks.size().
+     * Returns the number of valid points.
+     */
+    int triangulate(const AlignedVector<SE3>& poses, const TriangulationTracks& tracks, AlignedVector<Vec3>& points,
+                    std::vector<char>& valid) const;
+
+    /**
+     * (Re-)triangulates all world points of the scene from their non-outlier observations.
+     * The position of accepted points is overwritten. Rejected points are removed with Scene::removeWorldPoint.
+     * Returns the number of valid points.
+     */
+    int triangulate(Scene& scene) const;
+
+   private:
+    using ProjectionMatrix = Eigen::Matrix<double, 3, 4>;
+
+    // Returns false if the point was rejected. rays is a per thread temporary.
+    bool solveTrack(const ProjectionMatrix* P, const Vec3* centers, const int* poseIds, const Vec2* points, int n,
+                    Vec3& result, AlignedVector<Vec3>& rays) const;
+};
+
+}  // namespace Saiga
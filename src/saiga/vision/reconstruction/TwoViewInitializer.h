@@ -0,0 +1,272 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/core/util/Thread/threadPool.h"
+#include "saiga/core/util/assert.h"
+#include "saiga/vision/reconstruction/TwoViewReconstruction.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+namespace Saiga
+{
+/**
+ * A frame pair for the map initialization.
+ * The matches are only referenced, see TwoViewInitialization for the lifetime requirements.
+ */
+struct TwoViewCandidate
+{
+    // Matches in normalized image space
+    ArrayView<const Vec2> points1;
+    ArrayView<const Vec2> points2;
+};
+
+struct TwoViewInitializerSettings
+{
+    // Every candidate runs single threaded, therefore RansacParameters::threads is ignored.
+    RansacParameters ransacParams;
+
+    // A candidate is accepted if it has at least minInliers inliers and the median triangulation angle is at
+    // least minMedianAngle (in radians).
+    int minInliers        = 50;
+    double minMedianAngle = pi<double>() / 180.0;
+
+    // Bundle adjustment of accepted candidates. Zero disables the refinement.
+    int baIterations  = 0;
+    float baThreshold = 0;
+};
+
+struct TwoViewInitializationResult
+{
+    // Index of the accepted candidate or -1 if no candidate passed the tests.
+    int candidate      = -1;
+    int inliers        = 0;
+    double medianAngle = 0;
+    // Owned by the TwoViewInitialization. Contains the relative pose and the triangulated points.
+    TwoViewReconstruction* reconstruction = nullptr;
+
+    explicit operator bool() const { return candidate >= 0; }
+};
+
+namespace TwoViewInitializerDetail
+{
+struct State
+{
+    TwoViewInitializerSettings settings;
+    std::vector<TwoViewCandidate> candidates;
+    std::vector<std::unique_ptr<TwoViewReconstruction>> reconstructions;
+    std::vector<double> medianAngles;
+
+    // The lowest accepted candidate index (candidates.size() if none).
+    std::atomic<int> best;
+    std::atomic<bool> cancelled = {false};
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<char> finished;
+    int numFinished = 0;
+
+    bool skip(int i) const { return cancelled || i > best; }
+
+    // The result is known if all candidates before the best one have finished.
+    bool decided()
+    {
+        int b = best;
+        if (numFinished == (int)candidates.size()) return true;
+        for (int i = 0; i < b; ++i)
+            if (!finished[i]) return false;
+        return b < (int)candidates.size();
+    }
+
+    void run(int i)
+    {
+        if (!skip(i)) evaluate(i);
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            finished[i] = true;
+            numFinished++;
+        }
+        cv.notify_all();
+    }
+
+    // The RANSAC checks the cancellation before every iteration, the other stages at their boundaries.
+    void evaluate(int i)
+    {
+        auto& tvr = *reconstructions[i];
+        auto& c   = candidates[i];
+
+        auto params   = settings.ransacParams;
+        params.cancel = [this, i]() { return skip(i); };
+        tvr.init(params);
+        tvr.compute(c.points1, c.points2);
+        if (skip(i) || tvr.inlierCount < settings.minInliers) return;
+
+        medianAngles[i] = tvr.medianAngle();
+        if (medianAngles[i] < settings.minMedianAngle) return;
+
+        if (settings.baIterations > 0)
+        {
+            if (skip(i)) return;
+            if (tvr.optimize(settings.baIterations, settings.baThreshold) < settings.minInliers) return;
+        }
+
+        // Accept and cancel all candidates with a larger index
+        int b = best;
+        while (i < b && !best.compare_exchange_weak(b, i))
+        {
+        }
+    }
+};
+}  // namespace TwoViewInitializerDetail
+
+/**
+ * Future-like handle of an asynchronous map initialization (see TwoViewInitializer).
+ *
+ * The candidate buffers are used without a copy and must stay valid until this handle is destroyed. The destructor
+ * cancels the remaining candidates and blocks until all running tasks have returned.
+ *
+ * A default constructed (or moved from) handle has no state. Like std::future, only valid(), cancel(), assignment
+ * and destruction are allowed then.
+ */
+class TwoViewInitialization
+{
+   public:
+    TwoViewInitialization() {}
+    TwoViewInitialization(std::shared_ptr<TwoViewInitializerDetail::State> state) : state(std::move(state)) {}
+    TwoViewInitialization(TwoViewInitialization&&) = default;
+    TwoViewInitialization& operator=(TwoViewInitialization&& other)
+    {
+        release();
+        state = std::move(other.state);
+        return *this;
+    }
+    ~TwoViewInitialization() { release(); }
+
+    bool valid() const { return state != nullptr; }
+
+    // Non-blocking check if get() would return immediately.
+    bool ready()
+    {
+        SAIGA_ASSERT(valid(), "TwoViewInitialization without state");
+        std::unique_lock<std::mutex> lock(state->mutex);
+        return state->decided();
+    }
+
+    void wait()
+    {
+        SAIGA_ASSERT(valid(), "TwoViewInitialization without state");
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->cv.wait(lock, [this]() { return state->decided(); });
+    }
+
+    template <typename Rep, typename Period>
+    bool wait_for(const std::chrono::duration<Rep, Period>& duration)
+    {
+        SAIGA_ASSERT(valid(), "TwoViewInitialization without state");
+        std::unique_lock<std::mutex> lock(state->mutex);
+        return state->cv.wait_for(lock, duration, [this]() { return state->decided(); });
+    }
+
+    // Blocks until the result is known.
+    // The result is the accepted candidate with the lowest index, so it does not depend on the scheduling.
+    TwoViewInitializationResult get()
+    {
+        wait();
+        TwoViewInitializationResult result;
+        int b = state->best;
+        if (b < (int)state->candidates.size())
+        {
+            result.candidate      = b;
+            result.reconstruction = state->reconstructions[b].get();
+            result.inliers        = result.reconstruction->inlierCount;
+            result.medianAngle    = state->medianAngles[b];
+        }
+        return result;
+    }
+
+    // Stops all candidates at the next RANSAC iteration or stage boundary. get() then only returns candidates accepted
+    // before.
+    void cancel()
+    {
+        if (state) state->cancelled = true;
+    }
+
+   private:
+    std::shared_ptr<TwoViewInitializerDetail::State> state;
+
+    void release()
+    {
+        if (!state) return;
+        cancel();
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->cv.wait(lock, [this]() { return state->numFinished == (int)state->candidates.size(); });
+        state = nullptr;
+    }
+};
+
+/**
+ * Asynchronous map initialization from multiple candidate frame pairs.
+ *
+ * All candidates are evaluated concurrently on a thread pool with TwoViewReconstruction. The candidates are sorted
+ * by priority: If candidate i passes the inlier and median angle test, all candidates > i are cancelled, while the
+ * candidates < i are finished because they are preferred.
+ *
+ * Usage:
+ *
+ * TwoViewInitializer initializer(settings);
+ * auto handle = initializer.start({{points1a, points2a}, {points1b, points2b}});
+ * // continue tracking
+ * if (handle.ready())
+ * {
+ *     auto result = handle.get();
+ *     if (result) ... result.reconstruction->scene ...
+ * }
+ */
+class TwoViewInitializer
+{
+   public:
+    TwoViewInitializerSettings settings;
+
+    // Uses the global thread pool if no pool is given.
+    TwoViewInitializer(const TwoViewInitializerSettings& settings, ThreadPool* pool = nullptr)
+        : settings(settings), pool(pool)
+    {
+        this->settings.ransacParams.threads = 1;
+    }
+
+    TwoViewInitialization start(const std::vector<TwoViewCandidate>& candidates)
+    {
+        ThreadPool* tp = pool ? pool : globalThreadPool.get();
+        SAIGA_ASSERT(tp);
+
+        auto state        = std::make_shared<TwoViewInitializerDetail::State>();
+        state->settings   = settings;
+        state->candidates = candidates;
+        state->best       = candidates.size();
+        state->finished.resize(candidates.size(), false);
+        state->medianAngles.resize(candidates.size(), 0);
+        for (size_t i = 0; i < candidates.size(); ++i)
+        {
+            state->reconstructions.push_back(std::make_unique<TwoViewReconstruction>());
+        }
+
+        for (int i = 0; i < (int)candidates.size(); ++i)
+        {
+            tp->enqueue([state, i]() { state->run(i); });
+        }
+        return TwoViewInitialization(state);
+    }
+
+   private:
+    ThreadPool* pool;
+};
+
+}  // namespace Saiga
@@ -6,8 +6,10 @@
 #include "BARecursive.h"
 
 #include "saiga/core/imgui/imgui.h"
+#include "saiga/core/time/Profiler.h"
 #include "saiga/core/time/timer.h"
 #include "saiga/core/util/Algorithm.h"
+#include "saiga/core/util/ParallelPrimitives.h"
 #include "saiga/core/util/Thread/omp.h"
 #include "saiga/vision/kernels/BAPose.h"
 #include "saiga/vision/kernels/BAPosePoint.h"
@@ -56,6 +58,7 @@ void BARec::init()
     Scene& scene = *_scene;
 
     SAIGA_OPTIONAL_BLOCK_TIMER(RECURSIVE_BA_USE_TIMERS && optimizationOptions.debugOutput);
+    SAIGA_PROFILE_ZONE("BARec::init");
 
 
     // currently the scene must be in a valid state
@@ -192,10 +195,8 @@ void BARec::init()
         }
     }
 
-    auto test1 =
-        Saiga::exclusive_scan(cameraPointCounts.begin(), cameraPointCounts.end(), cameraPointCountsScan.begin(), 0);
-    auto test2 =
-        Saiga::exclusive_scan(pointCameraCounts.begin(), pointCameraCounts.end(), pointCameraCountsScan.begin(), 0);
+    auto test1 = CPU::exclusiveScan<int>(cameraPointCounts, cameraPointCountsScan);
+    auto test2 = CPU::exclusiveScan<int>(pointCameraCounts, pointCameraCountsScan);
 
     SAIGA_ASSERT(test1 == observations && test2 == observations);
 
@@ -232,7 +233,10 @@ void BARec::init()
                               ? Eigen::Recursive::LinearSolverOptions::SolverType::Direct
                               : Eigen::Recursive::LinearSolverOptions::SolverType::Iterative;
     loptions.buildExplizitSchur = optimizationOptions.buildExplizitSchur;
-    solver.analyzePattern(A, loptions);
+    {
+        SAIGA_PROFILE_ZONE("BARec::analyzePattern");
+        solver.analyzePattern(A, loptions);
+    }
 #if 0
 
     // Create sparsity histogram of the schur complement
@@ -329,6 +333,7 @@ double BARec::computeQuadraticForm()
 {
     Scene& scene = *_scene;
     SAIGA_ASSERT(threads == OMP::getNumThreads());
+    SAIGA_PROFILE_ZONE("BARec::computeQuadraticForm");
 
     //    SAIGA_OPTIONAL_BLOCK_TIMER(RECURSIVE_BA_USE_TIMERS && optimizationOptions.debugOutput);
 
@@ -513,6 +518,7 @@ double BARec::computeQuadraticForm()
             }
         }
 
+        SAIGA_PROFILE_ZONE("BARec::mergePointBlocks");
 #pragma omp for
         for (int i = 0; i < m; ++i)
         {
@@ -536,6 +542,7 @@ double BARec::computeQuadraticForm()
 
 bool BARec::addDelta()
 {
+    SAIGA_PROFILE_ZONE("BARec::addDelta");
     for (auto&& info : validImages)
     {
         if (info.isConstant()) continue;
@@ -585,6 +592,7 @@ void BARec::finalize()
     Scene& scene = *_scene;
 
     SAIGA_OPTIONAL_BLOCK_TIMER(RECURSIVE_BA_USE_TIMERS && optimizationOptions.debugOutput);
+    SAIGA_PROFILE_ZONE("BARec::finalize");
 
     //#pragma omp parallel num_threads(threads)
     {
@@ -622,6 +630,7 @@ void BARec::addLambda(double lambda)
 void BARec::solveLinearSystem()
 {
     SAIGA_OPTIONAL_BLOCK_TIMER(RECURSIVE_BA_USE_TIMERS && optimizationOptions.debugOutput);
+    SAIGA_PROFILE_ZONE("BARec::solveLinearSystem");
     //#pragma omp parallel num_threads(threads)
     {
         solver.solve(A, delta_x, b, loptions);
@@ -633,6 +642,7 @@ double BARec::computeCost()
     Scene& scene = *_scene;
 
     SAIGA_OPTIONAL_BLOCK_TIMER(RECURSIVE_BA_USE_TIMERS && optimizationOptions.debugOutput);
+    SAIGA_PROFILE_ZONE("BARec::computeCost");
 
     SAIGA_ASSERT(threads == 1);
     using T = BlockBAScalar;
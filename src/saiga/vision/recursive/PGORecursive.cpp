@@ -1,9 +1,12 @@
 ﻿#include "PGORecursive.h"
 
 #include "saiga/core/imgui/imgui.h"
+#include "saiga/core/math/imath.h"
 #include "saiga/core/time/timer.h"
 #include "saiga/core/util/Algorithm.h"
+#include "saiga/core/util/Thread/omp.h"
 #include "saiga/vision/kernels/PGO.h"
+#include "saiga/vision/kernels/PGOBatch.h"
 #include "saiga/vision/kernels/Robust.h"
 #include "saiga/vision/util/HistogramImage.h"
 #include "saiga/vision/util/LM.h"
@@ -15,6 +18,88 @@
 
 namespace Saiga
 {
+namespace
+{
+// Number of edges per OpenMP work item. A multiple of the kernel batch size.
+constexpr int edgeBlockSize = 64;
+
+/**
+ * Evaluates the edges [begin,end) and calls f(k, residual, JrowFrom, JrowTo) for every edge k.
+ * Without Jacobians the callback is f(k, residual).
+ * Uses the batched kernel if it exists for this transformation type and the scalar kernel otherwise.
+ */
+template <bool jacobian, typename TransformationType, typename F>
+void evaluateEdges(const PoseGraph& scene, const AlignedVector<TransformationType>& x, int begin, int end, F&& f)
+{
+    if constexpr (Kernel::HasPGOBatch<TransformationType>::value)
+    {
+        using Batch     = Kernel::PGOBatch<TransformationType>;
+        constexpr int N = Batch::BatchSize;
+
+        typename Batch::Transformations from, to, measurement;
+        typename Batch::Lane weight;
+        typename Batch::Residuals res;
+        typename Batch::PoseJacobiType JrowFrom[N], JrowTo[N];
+
+        for (int k = begin; k < end; k += N)
+        {
+            int count = std::min(N, end - k);
+            for (int l = 0; l < N; ++l)
+            {
+                if (l < count)
+                {
+                    auto& e = scene.edges[k + l];
+                    from.set(l, x[e.from]);
+                    to.set(l, x[e.to]);
+                    measurement.set(l, e.meassurement);
+                    weight(l) = e.weight;
+                }
+                else
+                {
+                    // Padding of the last batch
+                    from.setIdentity(l);
+                    to.setIdentity(l);
+                    measurement.setIdentity(l);
+                    weight(l) = 0;
+                }
+            }
+
+            if constexpr (jacobian)
+            {
+                Batch::evaluateResidualAndJacobian(from, to, measurement, weight, res, JrowFrom, JrowTo);
+                for (int l = 0; l < count; ++l) f(k + l, Batch::residual(res, l), &JrowFrom[l], &JrowTo[l]);
+            }
+            else
+            {
+                Batch::evaluateResidual(from, to, measurement, weight, res);
+                for (int l = 0; l < count; ++l) f(k + l, Batch::residual(res, l));
+            }
+        }
+    }
+    else
+    {
+        using KernelType = Kernel::PGO<TransformationType>;
+        typename KernelType::ResidualType res;
+        typename KernelType::PoseJacobiType JrowFrom, JrowTo;
+        for (int k = begin; k < end; ++k)
+        {
+            auto& e = scene.edges[k];
+            if constexpr (jacobian)
+            {
+                KernelType::evaluateResidualAndJacobian(x[e.from], x[e.to], e.meassurement.inverse(), res, JrowFrom,
+                                                        JrowTo, e.weight);
+                f(k, res, &JrowFrom, &JrowTo);
+            }
+            else
+            {
+                KernelType::evaluateResidual(x[e.from], x[e.to], e.meassurement.inverse(), res, e.weight);
+                f(k, res);
+            }
+        }
+    }
+}
+}  // namespace
+
 void PGORec::init()
 {
     auto& scene = *_scene;
@@ -68,6 +153,7 @@ void PGORec::init()
     }
 
     // Precompute the offset in the sparse matrix for every edge
+    edgeOffsets.clear();
     edgeOffsets.reserve(scene.edges.size());
     std::vector<int> localOffsets(n, 1);
     for (auto& e : scene.edges)
@@ -85,6 +171,14 @@ void PGORec::init()
         edgeOffsets.emplace_back(offseti);
     }
 
+    // ===== Threading Tmps ======
+    threads = std::max(1, optimizationOptions.numThreads);
+    localChi2.resize(threads);
+    diagTemp.resize(threads);
+    resTemp.resize(threads);
+    for (auto& a : diagTemp) a.resize(n);
+    for (auto& a : resTemp) a.resize(n);
+
     // Create a sparsity histogram
     if (false && optimizationOptions.debugOutput)
     {
@@ -106,97 +200,78 @@ double PGORec::computeQuadraticForm()
 {
     auto& scene = *_scene;
 
-    //    SAIGA_BLOCK_TIMER();
-    //    SAIGA_OPTIONAL_BLOCK_TIMER(optimizationOptions.debugOutput);
-    // using T          = BlockPGOScalar;
-    using KernelType = Saiga::Kernel::PGO<PGOTransformation>;
+    // The actual team size might be smaller than 'threads'
+    int activeThreads = 1;
 
-    b.setZero();
-
-    // set diagonal elements of S to zero
-    for (int i = 0; i < n; ++i)
+#pragma omp parallel num_threads(threads)
     {
-        S.valuePtr()[S.outerIndexPtr()[i]].get().setZero();
-    }
-
-    double chi2 = 0;
-    //#pragma omp parallel
+        int tid = OMP::getThreadNum();
+#pragma omp single
+        activeThreads = OMP::getNumThreads();
 
-    //        auto b2 = b;
-    AlignedVector<PGOBlock> diagBlocks(n);
-    for (int i = 0; i < n; ++i)
-    {
-        diagBlocks[i].setZero();
-    }
-    double chi2local = 0;
-    //#pragma omp for
-    for (size_t k = 0; k < scene.edges.size(); ++k)
-    {
-        auto& e       = scene.edges[k];
-        auto& offsets = edgeOffsets[k];
-        int i         = e.from;
-        int j         = e.to;
-
-        auto& target_ij = S.valuePtr()[offsets].get();
-        //            auto& target_ii = S.valuePtr()[S.outerIndexPtr()[i]].get();
-        //            auto& target_jj = S.valuePtr()[S.outerIndexPtr()[j]].get();
-        auto& target_ii = diagBlocks[i];
-        auto& target_jj = diagBlocks[j];
-        auto& target_ir = b(i).get();
-        auto& target_jr = b(j).get();
+        double& chi2local = localChi2[tid];
+        chi2local         = 0;
 
+        // every thread has to zero its own local copy
+        auto& diagBlocks = diagTemp[tid];
+        auto& resBlocks  = resTemp[tid];
+        for (int i = 0; i < n; ++i)
         {
-            KernelType::PoseJacobiType Jrowi, Jrowj;
-            KernelType::ResidualType res;
-            KernelType::evaluateResidualAndJacobian(x_u[i], x_u[j], e.meassurement.inverse(), res, Jrowi, Jrowj,
-                                                    e.weight);
+            diagBlocks[i].setZero();
+            resBlocks[i].setZero();
+        }
 
-            if (scene.poses[i].constant) Jrowi.setZero();
-            if (scene.poses[j].constant) Jrowj.setZero();
+        // The edges are sorted by 'from', so a static schedule gives every thread a compact range of vertices.
+        int numBlocks = iDivUp<int>(scene.edges.size(), edgeBlockSize);
+#pragma omp for schedule(static)
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            int begin = block * edgeBlockSize;
+            int end   = std::min<int>(begin + edgeBlockSize, scene.edges.size());
+            evaluateEdges<true>(scene, x_u, begin, end, [&](int k, const auto& res, auto* JFrom, auto* JTo) {
+                auto& e = scene.edges[k];
+                int i   = e.from;
+                int j   = e.to;
+
+                PGOBlock Jrowi = *JFrom;
+                PGOBlock Jrowj = *JTo;
+                if (scene.poses[i].constant) Jrowi.setZero();
+                if (scene.poses[j].constant) Jrowj.setZero();
+
+                // JtJ
+                S.valuePtr()[edgeOffsets[k]].get() = Jrowi.transpose() * Jrowj;
+                diagBlocks[i] += Jrowi.transpose() * Jrowi;
+                diagBlocks[j] += Jrowj.transpose() * Jrowj;
 
-            auto c = res.squaredNorm();
+                // Jtb
+                resBlocks[i] -= Jrowi.transpose() * res;
+                resBlocks[j] -= Jrowj.transpose() * res;
 
-            // JtJ
-            target_ij = Jrowi.transpose() * Jrowj;
+                chi2local += res.squaredNorm();
+            });
+        }
 
-            auto ii = (Jrowi.transpose() * Jrowi).eval();
-            auto jj = (Jrowj.transpose() * Jrowj).eval();
-            //#pragma omp critical
-            {
-                target_ii += ii;
-                target_jj += jj;
-            }
-            auto ir = Jrowi.transpose() * res;
-            auto jr = Jrowj.transpose() * res;
-            //#pragma omp critical
+        // Merge the local copies
+#pragma omp for
+        for (int i = 0; i < n; ++i)
+        {
+            auto& diag = S.valuePtr()[S.outerIndexPtr()[i]].get();
+            auto& r    = b(i).get();
+            diag       = diagTemp[0][i];
+            r          = resTemp[0][i];
+            for (int t = 1; t < activeThreads; ++t)
             {
-                // Jtb
-                target_ir -= ir;
-                target_jr -= jr;
+                diag += diagTemp[t][i];
+                r += resTemp[t][i];
             }
-
-
-
-            chi2local += c;
         }
     }
 
-    //#pragma omp atomic
-    chi2 += chi2local;
-    //#pragma omp critical
-    {
-        //            b += b2;
-    }
-
-    for (int i = 0; i < n; ++i)
+    double chi2 = 0;
+    for (int i = 0; i < activeThreads; ++i)
     {
-        //#pragma omp critical
-        S.valuePtr()[S.outerIndexPtr()[i]].get() += diagBlocks[i];
+        chi2 += localChi2[i];
     }
-
-
-
-    //    if (optimizationOptions.debugOutput) std::cout << "chi2 " << chi2 << std::endl;
     return chi2;
 }
 
@@ -205,29 +280,33 @@ double PGORec::computeCost()
 {
     auto& scene = *_scene;
 
-    //    SAIGA_OPTIONAL_BLOCK_TIMER(optimizationOptions.debugOutput);
-    // using T          = BlockPGOScalar;
-    using KernelType = Saiga::Kernel::PGO<PGOTransformation>;
-
+    // Same partitioning and summation order as computeQuadraticForm, so both return exactly the same chi2.
+    int activeThreads = 1;
 
-
-    double chi2 = 0;
-    for (size_t k = 0; k < scene.edges.size(); ++k)
+#pragma omp parallel num_threads(threads)
     {
-        auto& e = scene.edges[k];
-        int i   = e.from;
-        int j   = e.to;
+        int tid = OMP::getThreadNum();
+#pragma omp single
+        activeThreads = OMP::getNumThreads();
 
+        double& chi2local = localChi2[tid];
+        chi2local         = 0;
 
+        int numBlocks = iDivUp<int>(scene.edges.size(), edgeBlockSize);
+#pragma omp for schedule(static)
+        for (int block = 0; block < numBlocks; ++block)
         {
-            KernelType::PoseJacobiType Jrowi, Jrowj;
-            KernelType::ResidualType res;
-            KernelType::evaluateResidual(x_u[i], x_u[j], e.meassurement.inverse(), res, e.weight);
-
-            auto c = res.squaredNorm();
-            chi2 += c;
+            int begin = block * edgeBlockSize;
+            int end   = std::min<int>(begin + edgeBlockSize, scene.edges.size());
+            evaluateEdges<false>(scene, x_u, begin, end, [&](int, const auto& res) { chi2local += res.squaredNorm(); });
         }
     }
+
+    double chi2 = 0;
+    for (int i = 0; i < activeThreads; ++i)
+    {
+        chi2 += localChi2[i];
+    }
     return chi2;
 }
 
@@ -36,7 +36,7 @@ class SAIGA_VISION_API PGORec : public PGOBase, public LMOptimizer
     virtual void create(PoseGraph& scene) override { _scene = &scene; }
 
 
-   private:
+   protected:
     int n;
     PSType S;
     PBType b;
@@ -51,6 +51,15 @@ class SAIGA_VISION_API PGORec : public PGOBase, public LMOptimizer
     std::vector<int> edgeOffsets;
     PoseGraph* _scene;
 
+    // ============= Multi Threading Stuff ===========
+    // The number of threads is taken from optimizationOptions.numThreads.
+    // Every thread accumulates the diagonal blocks and the gradient of its edges in a private copy, which are
+    // summed up in a second pass. The off-diagonal blocks belong to exactly one edge and are written directly.
+    int threads = 1;
+    std::vector<AlignedVector<PGOBlock>> diagTemp;
+    std::vector<AlignedVector<PGOVector>> resTemp;
+    std::vector<double> localChi2;
+
     // ============== LM Functions ==============
 
     virtual void init() override;
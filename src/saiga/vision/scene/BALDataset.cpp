@@ -6,9 +6,9 @@
 
 #include "BALDataset.h"
 
+#include "saiga/core/util/MemoryMappedFile.h"
+#include "saiga/core/util/TextParser.h"
 #include "saiga/core/util/assert.h"
-#include "saiga/core/util/file.h"
-#include "saiga/core/util/tostring.h"
 
 #include <fstream>
 
@@ -24,49 +24,35 @@ BALDataset::BALDataset(const std::string& file)
 {
     std::cout << "> Loading BALDataset " << file << std::endl;
 
-    auto data = File::loadFileStringArray(file);
+    // The file is parsed in place. This is faster than splitting it into lines and parsing them in parallel.
+    MemoryMappedFile mmf(file);
+    SAIGA_ASSERT(mmf.isOpen(), "Could not open " + file);
+    TextParser in(mmf.view<char>());
 
     int num_cameras, num_points, num_observations;
-
-    std::stringstream in(data.front());
     in >> num_cameras >> num_points >> num_observations;
+    SAIGA_ASSERT(in.ok(), "Invalid BAL header in " + file);
 
     cameras.resize(num_cameras);
     observations.resize(num_observations);
     points.resize(num_points);
 
-
-
-    int start = 1;
-#pragma omp parallel for
     for (int i = 0; i < num_observations; ++i)
     {
-        std::stringstream in(data[start + i]);
         BALObservation o;
         in >> o.camera_index >> o.point_index >> o.point[0] >> o.point[1];
         observations[i] = (o);
     }
 
-    start += num_observations;
-#pragma omp parallel for
     for (int i = 0; i < num_cameras; ++i)
     {
         BALCamera c;
         Vec3 r;
         Vec3 t;
 
-
-        r(0) = Saiga::to_double(data[start + i * 9 + 0]);
-        r(1) = Saiga::to_double(data[start + i * 9 + 1]);
-        r(2) = Saiga::to_double(data[start + i * 9 + 2]);
-
-        t(0) = Saiga::to_double(data[start + i * 9 + 3]);
-        t(1) = Saiga::to_double(data[start + i * 9 + 4]);
-        t(2) = Saiga::to_double(data[start + i * 9 + 5]);
-
-        c.f  = Saiga::to_double(data[start + i * 9 + 6]);
-        c.k1 = Saiga::to_double(data[start + i * 9 + 7]);
-        c.k2 = Saiga::to_double(data[start + i * 9 + 8]);
+        in >> r(0) >> r(1) >> r(2);
+        in >> t(0) >> t(1) >> t(2);
+        in >> c.f >> c.k1 >> c.k2;
 
         auto angle           = r.norm();
         Eigen::Vector3d axis = angle > 0.00001 ? r / angle : Eigen::Vector3d(0, 1, 0);
@@ -74,20 +60,14 @@ BALDataset::BALDataset(const std::string& file)
         c.se3      = SE3((Quat)a, t);
         cameras[i] = (c);
     }
-    start += num_cameras * 9;
 
-#pragma omp parallel for
     for (int i = 0; i < num_points; ++i)
     {
         BALPoint p;
-
-        p.point(0) = Saiga::to_double(data[start + i * 3 + 0]);
-        p.point(1) = Saiga::to_double(data[start + i * 3 + 1]);
-        p.point(2) = Saiga::to_double(data[start + i * 3 + 2]);
-
-
+        in >> p.point(0) >> p.point(1) >> p.point(2);
         points[i] = (p);
     }
+    SAIGA_ASSERT(in.ok(), "Invalid BAL file " + file);
 
 
     undistortAll();
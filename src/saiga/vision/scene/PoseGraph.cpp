@@ -7,6 +7,10 @@
 #include "PoseGraph.h"
 
 #include "saiga/core/imgui/imgui.h"
+#include "saiga/core/util/MemoryMappedFile.h"
+#include "saiga/core/util/TextParser.h"
+#include "saiga/core/util/TextWriter.h"
+#include "saiga/core/util/tostring.h"
 #include "saiga/vision/util/Random.h"
 
 #include <fstream>
@@ -67,10 +71,14 @@ PoseGraph::PoseGraph(const Scene& scene, int minEdges)
 
 void PoseGraph::addNoise(double stddev)
 {
-    for (auto& e : poses)
+    AlignedVector<Vec3> noise(poses.size());
+    RandomStream rng(Random::urand64());
+    rng.fillGaussian(noise.data(), noise.size(), 0, stddev);
+    for (size_t i = 0; i < poses.size(); ++i)
     {
+        auto& e = poses[i];
         if (e.constant) continue;
-        e.se3.translation() += Random::gaussRandMatrix<Vec3>(0, stddev);
+        e.se3.translation() += noise[i];
 
 #ifdef PGO_SIM3
         e.se3.setScale(e.se3.scale() * Random::sampleDouble(0.7, 1.3));
@@ -116,49 +124,44 @@ void PoseGraph::save(const std::string& file)
 {
     std::cout << "Saving PoseGraph to " << file << "." << std::endl;
     std::cout << "chi2 " << chi2() << std::endl;
-    std::ofstream strm(file);
-    SAIGA_ASSERT(strm.is_open());
-    strm.precision(20);
-    strm << std::scientific;
+    TextWriter strm(file);
+    SAIGA_ASSERT(strm.isOpen());
 
-    strm << poses.size() << " " << edges.size() << " " << (int)fixScale << std::endl;
+    strm << poses.size() << " " << edges.size() << " " << (int)fixScale << "\n";
     for (auto& e : poses)
     {
-        strm << e.constant << " " << e.se3.params().transpose() << std::endl;
+        strm << e.constant << " ";
+        strm.writeArray(e.se3.data(), PGOTransformation::num_parameters) << "\n";
     }
     for (auto& e : edges)
     {
-        strm << e.from << " " << e.to << " " << e.weight << " " << e.meassurement.params().transpose() << std::endl;
+        strm << e.from << " " << e.to << " " << e.weight << " ";
+        strm.writeArray(e.meassurement.data(), PGOTransformation::num_parameters) << "\n";
     }
+    bool ok = strm.close();
+    SAIGA_ASSERT(ok, "Could not write " + file);
 }
 
 void PoseGraph::load(const std::string& file)
 {
-    std::cout << "Loading scene from " << file << "." << std::endl;
-
+    auto ending = fileEnding(file);
+    if (ending == "g2o" || ending == "graph" || ending == "pgb")
+    {
+        bool ok = (ending == "g2o") ? loadG2O(file) : (ending == "graph") ? loadToro(file) : loadBinary(file);
+        SAIGA_ASSERT(ok, "Could not load " + file);
+        return;
+    }
 
-    std::ifstream strm(file);
-    SAIGA_ASSERT(strm.is_open());
+    std::cout << "Loading scene from " << file << "." << std::endl;
 
 
-    auto consumeComment = [&]() {
-        while (true)
-        {
-            auto c = strm.peek();
-            if (c == '#')
-            {
-                std::string s;
-                std::getline(strm, s);
-            }
-            else
-            {
-                break;
-            }
-        }
-    };
+    // Parse directly from the mapped file instead of copying it through an ifstream buffer
+    MemoryMappedFile mmf(file);
+    SAIGA_ASSERT(mmf.isOpen());
+    TextParser strm(mmf.view<char>());
 
 
-    consumeComment();
+    strm.skipComments();
     int num_vertices, num_edges, _fixScale;
     strm >> num_vertices >> num_edges >> _fixScale;
     fixScale = _fixScale;
@@ -168,21 +171,18 @@ void PoseGraph::load(const std::string& file)
 
     for (auto& e : poses)
     {
-        Eigen::Map<Sophus::Vector<double, SE3::num_parameters>> v2(e.se3.data());
-        Sophus::Vector<double, SE3::num_parameters> v;
-        strm >> e.constant >> v;
-        v2 = v;
+        strm >> e.constant;
+        strm.parseArray(e.se3.data(), PGOTransformation::num_parameters);
     }
 
     for (auto& e : edges)
     {
-        Eigen::Map<Sophus::Vector<double, SE3::num_parameters>> v2(e.meassurement.data());
-        Sophus::Vector<double, SE3::num_parameters> v;
-        strm >> e.from >> e.to >> e.weight >> v;
-        v2 = v;
+        strm >> e.from >> e.to >> e.weight;
+        strm.parseArray(e.meassurement.data(), PGOTransformation::num_parameters);
 
         //        e.setRel(poses[e.from].se3, poses[e.to].se3);
     }
+    SAIGA_ASSERT(strm.ok(), "Invalid pose graph file " + file);
     std::sort(edges.begin(), edges.end());
     sortEdges();
 }
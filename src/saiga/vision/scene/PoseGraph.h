@@ -89,8 +89,38 @@ struct SAIGA_VISION_API PoseGraph
     double chi2();
     double rms() { return sqrt(chi2() / edges.size()); }
     void save(const std::string& file);
+
+    /**
+     * Loads the text format of save().
+     * Files ending with .g2o, .graph (TORO) or .pgb (binary) are forwarded to the specific loaders below.
+     */
     void load(const std::string& file);
 
+    /**
+     * Streaming import of public pose graph datasets.
+     * The file is memory mapped and parsed line by line. poses and edges are reserved once.
+     *
+     * g2o:  VERTEX_SE3:QUAT, EDGE_SE3:QUAT and FIX (one or more ids per line). Vertices without FIX are optimized,
+     *       but if the file has no FIX line the first vertex is fixed (same as the g2o command line tool).
+     * TORO: VERTEX2, EDGE2 (2D, embedded in the xy-plane) and VERTEX3, EDGE3.
+     *
+     * The vertex ids are mapped to a compact index range in the order of appearance.
+     * The edge weight is computed from the information matrix as sqrt(trace(I) / dim), because PoseEdge only
+     * supports a scalar weight.
+     * Returns false if the file could not be opened.
+     */
+    bool loadG2O(const std::string& file);
+    bool loadToro(const std::string& file);
+    void saveG2O(const std::string& file);
+
+    /**
+     * Compact binary format with fixed size records.
+     * Loading is a single copy from the memory mapped file. Uses the native byte order.
+     * loadBinary returns false if the file is truncated or an edge references a vertex that does not exist.
+     */
+    void saveBinary(const std::string& file);
+    bool loadBinary(const std::string& file);
+
     /**
      * Ensures that i < j, and all edges are sorted by from->to.
      */
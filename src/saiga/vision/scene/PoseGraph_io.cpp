@@ -0,0 +1,465 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/util/BufferedFileWriter.h"
+#include "saiga/core/util/MemoryMappedFile.h"
+#include "saiga/core/util/TextParser.h"
+#include "saiga/core/util/TextWriter.h"
+#include "saiga/core/util/assert.h"
+
+#include "PoseGraph.h"
+
+#include <cmath>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+
+namespace Saiga
+{
+namespace
+{
+/**
+ * Iterates over the lines of a memory region.
+ * The numbers are parsed in place with a TextParser limited to the current line.
+ */
+class LineParser
+{
+   public:
+    LineParser(ArrayView<const char> data) : file(data) {}
+
+    bool nextLine()
+    {
+        if (file.atEnd()) return false;
+        line = TextParser(file.line());
+        return true;
+    }
+
+    // The first word of the line. Empty for empty lines.
+    std::string_view tag() { return line.word(); }
+
+    double real()
+    {
+        double v = 0;
+        if (!line.parse(v)) failed = true;
+        return v;
+    }
+
+    int integer()
+    {
+        int v = 0;
+        if (!line.parse(v)) failed = true;
+        return v;
+    }
+
+    // True if only whitespace is left in the current line.
+    bool lineEnd() { return line.atEnd(); }
+
+    bool failed = false;
+
+   private:
+    TextParser file;
+    TextParser line = TextParser(std::string_view());
+};
+
+// Counts the lines starting with prefix.
+size_t countLines(ArrayView<const char> data, const char* prefix)
+{
+    size_t n        = std::strlen(prefix);
+    size_t count    = 0;
+    const char* pos = data.data();
+    const char* end = data.data() + data.size();
+    while (pos < end)
+    {
+        auto lineEnd = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+        if (!lineEnd) lineEnd = end;
+        if (size_t(lineEnd - pos) >= n && std::memcmp(pos, prefix, n) == 0) count++;
+        pos = lineEnd + 1;
+    }
+    return count;
+}
+
+/**
+ * g2o and TORO store body-to-world poses and the relative pose of an edge in the frame of the first vertex.
+ * PoseGraph uses world-to-body poses and meassurement = to * from^-1 (see PoseEdge::setRel), so both have to be
+ * inverted.
+ */
+PGOTransformation toPGO(const SE3& T)
+{
+#ifdef PGO_SIM3
+    return sim3(T, 1.0);
+#else
+    return T;
+#endif
+}
+
+SE3 fromPGO(const PGOTransformation& T)
+{
+#ifdef PGO_SIM3
+    return SE3(T.rxso3().quaternion().normalized(), T.translation());
+#else
+    return T;
+#endif
+}
+
+// Rotation of TORO: yaw * pitch * roll
+Quat eulerToQuat(double roll, double pitch, double yaw)
+{
+    return Quat(Eigen::AngleAxisd(yaw, Vec3::UnitZ()) * Eigen::AngleAxisd(pitch, Vec3::UnitY()) *
+                Eigen::AngleAxisd(roll, Vec3::UnitX()));
+}
+
+// Weight of a 6x6 upper triangular information matrix in row major order.
+double informationWeight6(LineParser& parser)
+{
+    double trace = 0;
+    for (int r = 0; r < 6; ++r)
+    {
+        for (int c = r; c < 6; ++c)
+        {
+            double v = parser.real();
+            if (r == c) trace += v;
+        }
+    }
+    return parser.failed ? 1.0 : std::sqrt(trace / 6);
+}
+
+// Maps the file ids to a compact index range.
+struct VertexMap
+{
+    std::unordered_map<int, int> ids;
+    AlignedVector<PoseVertex>& poses;
+
+    VertexMap(AlignedVector<PoseVertex>& poses, size_t n) : poses(poses) { ids.reserve(n); }
+
+    void add(int id, const SE3& bodyToWorld)
+    {
+        auto it = ids.emplace(id, (int)poses.size());
+        if (!it.second) return;
+        PoseVertex pv;
+        pv.se3 = toPGO(bodyToWorld.inverse());
+        poses.push_back(pv);
+    }
+
+    int operator()(int id) const
+    {
+        auto it = ids.find(id);
+        return it == ids.end() ? -1 : it->second;
+    }
+};
+
+void addEdge(AlignedVector<PoseEdge>& edges, const VertexMap& map, int from, int to, const SE3& rel, double weight)
+{
+    PoseEdge e;
+    e.from         = map(from);
+    e.to           = map(to);
+    e.weight       = weight;
+    e.meassurement = toPGO(rel.inverse());
+    if (e && e.from != e.to) edges.push_back(e);
+}
+
+}  // namespace
+
+
+bool PoseGraph::loadG2O(const std::string& file)
+{
+    MemoryMappedFile mmf(file);
+    if (!mmf.isOpen()) return false;
+    auto data = mmf.view<char>();
+
+    poses.clear();
+    edges.clear();
+    poses.reserve(countLines(data, "VERTEX"));
+    edges.reserve(countLines(data, "EDGE"));
+
+    VertexMap map(poses, poses.capacity());
+    std::vector<int> fixed;
+
+    LineParser parser(data);
+    while (parser.nextLine())
+    {
+        auto tag = parser.tag();
+        if (tag == "VERTEX_SE3:QUAT")
+        {
+            int id = parser.integer();
+            Vec3 t;
+            Quat q;
+            t.x() = parser.real();
+            t.y() = parser.real();
+            t.z() = parser.real();
+            q.x() = parser.real();
+            q.y() = parser.real();
+            q.z() = parser.real();
+            q.w() = parser.real();
+            map.add(id, SE3(q.normalized(), t));
+        }
+        else if (tag == "EDGE_SE3:QUAT")
+        {
+            int from = parser.integer();
+            int to   = parser.integer();
+            Vec3 t;
+            Quat q;
+            t.x() = parser.real();
+            t.y() = parser.real();
+            t.z() = parser.real();
+            q.x() = parser.real();
+            q.y() = parser.real();
+            q.z() = parser.real();
+            q.w() = parser.real();
+            double w = informationWeight6(parser);
+            addEdge(edges, map, from, to, SE3(q.normalized(), t), w);
+        }
+        else if (tag == "FIX")
+        {
+            // A FIX line can contain multiple vertex ids.
+            while (!parser.lineEnd()) fixed.push_back(parser.integer());
+        }
+        SAIGA_ASSERT(!parser.failed, "Parse error in " + file);
+    }
+
+    for (auto id : fixed)
+    {
+        int i = map(id);
+        if (i >= 0) poses[i].constant = true;
+    }
+    if (fixed.empty() && !poses.empty()) poses.front().constant = true;
+
+    fixScale = true;
+    sortEdges();
+    return true;
+}
+
+bool PoseGraph::loadToro(const std::string& file)
+{
+    MemoryMappedFile mmf(file);
+    if (!mmf.isOpen()) return false;
+    auto data = mmf.view<char>();
+
+    poses.clear();
+    edges.clear();
+    poses.reserve(countLines(data, "VERTEX"));
+    edges.reserve(countLines(data, "EDGE"));
+
+    VertexMap map(poses, poses.capacity());
+
+    LineParser parser(data);
+    while (parser.nextLine())
+    {
+        auto tag = parser.tag();
+        if (tag == "VERTEX2" || tag == "VERTEX")
+        {
+            int id   = parser.integer();
+            double x = parser.real();
+            double y = parser.real();
+            double a = parser.real();
+            map.add(id, SE3(eulerToQuat(0, 0, a), Vec3(x, y, 0)));
+        }
+        else if (tag == "EDGE2" || tag == "EDGE")
+        {
+            int from = parser.integer();
+            int to   = parser.integer();
+            double x = parser.real();
+            double y = parser.real();
+            double a = parser.real();
+            // I11 I12 I22 I33 I13 I23
+            double info[6];
+            for (auto& i : info) i = parser.real();
+            double w = parser.failed ? 1.0 : std::sqrt((info[0] + info[2] + info[3]) / 3);
+            addEdge(edges, map, from, to, SE3(eulerToQuat(0, 0, a), Vec3(x, y, 0)), w);
+        }
+        else if (tag == "VERTEX3")
+        {
+            int id = parser.integer();
+            Vec3 t;
+            t.x()        = parser.real();
+            t.y()        = parser.real();
+            t.z()        = parser.real();
+            double roll  = parser.real();
+            double pitch = parser.real();
+            double yaw   = parser.real();
+            map.add(id, SE3(eulerToQuat(roll, pitch, yaw), t));
+        }
+        else if (tag == "EDGE3")
+        {
+            int from = parser.integer();
+            int to   = parser.integer();
+            Vec3 t;
+            t.x()        = parser.real();
+            t.y()        = parser.real();
+            t.z()        = parser.real();
+            double roll  = parser.real();
+            double pitch = parser.real();
+            double yaw   = parser.real();
+            double w     = informationWeight6(parser);
+            addEdge(edges, map, from, to, SE3(eulerToQuat(roll, pitch, yaw), t), w);
+        }
+        SAIGA_ASSERT(!parser.failed, "Parse error in " + file);
+    }
+
+    if (!poses.empty()) poses.front().constant = true;
+
+    fixScale = true;
+    sortEdges();
+    return true;
+}
+
+void PoseGraph::saveG2O(const std::string& file)
+{
+    TextWriter strm(file);
+    SAIGA_ASSERT(strm.isOpen());
+
+    for (int i = 0; i < (int)poses.size(); ++i)
+    {
+        SE3 T = fromPGO(poses[i].se3).inverse();
+        auto q = T.unit_quaternion();
+        auto t = T.translation();
+        strm << "VERTEX_SE3:QUAT " << i << " " << t.x() << " " << t.y() << " " << t.z() << " " << q.x() << " "
+             << q.y() << " " << q.z() << " " << q.w() << "\n";
+    }
+
+    for (auto& e : edges)
+    {
+        SE3 T  = fromPGO(e.meassurement).inverse();
+        auto q = T.unit_quaternion();
+        auto t = T.translation();
+        strm << "EDGE_SE3:QUAT " << e.from << " " << e.to << " " << t.x() << " " << t.y() << " " << t.z() << " "
+             << q.x() << " " << q.y() << " " << q.z() << " " << q.w();
+        double info = e.weight * e.weight;
+        for (int r = 0; r < 6; ++r)
+        {
+            for (int c = r; c < 6; ++c) strm << " " << (r == c ? info : 0.0);
+        }
+        strm << "\n";
+    }
+
+    for (int i = 0; i < (int)poses.size(); ++i)
+    {
+        if (poses[i].constant) strm << "FIX " << i << "\n";
+    }
+    bool ok = strm.close();
+    SAIGA_ASSERT(ok, "Could not write " + file);
+}
+
+// ================================================================================
+// Binary format. All records are 8 byte aligned, so the arrays can be viewed directly in the mapped file.
+
+namespace
+{
+constexpr char binaryMagic[8]    = {'S', 'A', 'I', 'G', 'A', 'P', 'G', 'B'};
+constexpr uint32_t binaryVersion = 1;
+constexpr int numParams          = PGOTransformation::num_parameters;
+
+struct BinaryHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t fixScale;
+    uint64_t numPoses;
+    uint64_t numEdges;
+};
+
+struct BinaryPose
+{
+    double params[numParams];
+    int32_t constant;
+    int32_t padding;
+};
+
+struct BinaryEdge
+{
+    int32_t from, to;
+    double weight;
+    double params[numParams];
+};
+
+static_assert(sizeof(BinaryHeader) % 8 == 0, "Header must keep the records aligned.");
+}  // namespace
+
+void PoseGraph::saveBinary(const std::string& file)
+{
+    BufferedFileWriter writer(file);
+    SAIGA_ASSERT(writer.isOpen());
+
+    BinaryHeader header;
+    std::memcpy(header.magic, binaryMagic, sizeof(binaryMagic));
+    header.version  = binaryVersion;
+    header.fixScale = fixScale;
+    header.numPoses = poses.size();
+    header.numEdges = edges.size();
+    writer << header;
+
+    for (auto& p : poses)
+    {
+        BinaryPose bp;
+        std::memcpy(bp.params, p.se3.data(), sizeof(bp.params));
+        bp.constant = p.constant;
+        bp.padding  = 0;
+        writer << bp;
+    }
+
+    for (auto& e : edges)
+    {
+        BinaryEdge be;
+        be.from   = e.from;
+        be.to     = e.to;
+        be.weight = e.weight;
+        std::memcpy(be.params, e.meassurement.data(), sizeof(be.params));
+        writer << be;
+    }
+    bool ok = writer.close();
+    SAIGA_ASSERT(ok, "Could not write " + file);
+}
+
+bool PoseGraph::loadBinary(const std::string& file)
+{
+    MemoryMappedFile mmf(file);
+    if (!mmf.isOpen()) return false;
+    MemoryReader reader(mmf.view<char>());
+
+    BinaryHeader header;
+    reader >> header;
+    if (!reader.ok() || std::memcmp(header.magic, binaryMagic, sizeof(binaryMagic)) != 0 ||
+        header.version != binaryVersion)
+    {
+        return false;
+    }
+
+    auto binaryPoses = reader.readView<BinaryPose>(header.numPoses);
+    auto binaryEdges = reader.readView<BinaryEdge>(header.numEdges);
+    if (!reader.ok()) return false;
+
+    // Reject the file instead of building a graph with invalid vertex references.
+    for (auto& be : binaryEdges)
+    {
+        if (be.from < 0 || be.to < 0 || uint64_t(be.from) >= header.numPoses || uint64_t(be.to) >= header.numPoses)
+        {
+            return false;
+        }
+    }
+
+    fixScale = header.fixScale;
+    poses.resize(header.numPoses);
+    edges.resize(header.numEdges);
+
+    for (size_t i = 0; i < poses.size(); ++i)
+    {
+        auto& bp = binaryPoses[i];
+        std::memcpy(poses[i].se3.data(), bp.params, sizeof(bp.params));
+        poses[i].constant = bp.constant;
+    }
+
+    for (size_t i = 0; i < edges.size(); ++i)
+    {
+        auto& be = binaryEdges[i];
+        auto& e  = edges[i];
+        e.from   = be.from;
+        e.to     = be.to;
+        e.weight = be.weight;
+        std::memcpy(e.meassurement.data(), be.params, sizeof(be.params));
+    }
+    return true;
+}
+
+}  // namespace Saiga
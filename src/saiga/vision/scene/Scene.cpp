@@ -7,6 +7,8 @@
 #include "Scene.h"
 
 #include "saiga/core/imgui/imgui.h"
+#include "saiga/core/util/OnlineStatistics.h"
+#include "saiga/core/util/ParallelPrimitives.h"
 #include "saiga/core/util/assert.h"
 #include "saiga/vision/util/Random.h"
 
@@ -143,9 +145,20 @@ void Scene::normalize()
 
 void Scene::fixWorldPointReferences()
 {
-    for (WorldPoint& wp : worldPoints)
+    std::vector<int> counts(worldPoints.size(), 0);
+    for (SceneImage& i : images)
     {
+        for (auto& ip : i.stereoPoints)
+        {
+            if (ip.wp >= 0) counts[ip.wp]++;
+        }
+    }
+
+    for (size_t i = 0; i < worldPoints.size(); ++i)
+    {
+        auto& wp = worldPoints[i];
         wp.stereoreferences.clear();
+        wp.stereoreferences.reserve(counts[i]);
         wp.valid = false;
     }
 
@@ -173,7 +186,7 @@ void Scene::fixWorldPointReferences()
 
 bool Scene::valid() const
 {
-    int imgid = 0;
+    size_t numObservations = 0;
     for (const SceneImage& i : images)
     {
         if (i.extr < 0 || i.intr < 0) return false;
@@ -184,55 +197,71 @@ bool Scene::valid() const
         {
             if (!ip) continue;
             if (ip.wp >= (int)worldPoints.size()) return false;
-            auto& wp = worldPoints[ip.wp];
-            if (!wp.isReferencedByStereoFrame(imgid)) return false;
+            numObservations++;
         }
-        imgid++;
     }
 
-    for (auto& wp : worldPoints)
+    // Every reference must point to an observation of this world point (outliers included). Together with unique
+    // references and the same count, every valid observation is referenced by its world point. This is linear in the
+    // number of observations.
+    size_t numReferences = 0;
+    for (int wpid = 0; wpid < (int)worldPoints.size(); ++wpid)
     {
+        auto& wp = worldPoints[wpid];
+        for (auto& ref : wp.stereoreferences)
+        {
+            if (ref.first < 0 || ref.first >= (int)images.size()) return false;
+            auto& points = images[ref.first].stereoPoints;
+            if (ref.second < 0 || ref.second >= (int)points.size()) return false;
+            auto& ip = points[ref.second];
+            if (ip.wp != wpid) return false;
+            if (ip) numReferences++;
+        }
         if (!wp.uniqueReferences()) return false;
     }
-    return true;
+    return numReferences == numObservations;
 }
 
 
 Saiga::Statistics<double> Scene::statistics()
 {
-    std::vector<double> stats;
+    // Single pass without storing the residuals. The median is estimated with P².
+    OnlineStatistics<double> stats;
+    P2Quantile<double> median(0.5);
     for (SceneImage& im : images)
     {
         for (auto& o : im.stereoPoints)
         {
-            if (!o.wp) continue;
-            stats.push_back(std::sqrt(residualNorm2(im, o)));
+            if (!o) continue;
+            double r = std::sqrt(residualNorm2(im, o));
+            stats.add(r);
+            median.add(r);
         }
     }
-
-    Saiga::Statistics<double> sr(stats);
-    return sr;
+    return stats.toStatistics(median.value());
 }
 
 Saiga::Statistics<double> Scene::depthStatistics()
 {
-    std::vector<double> stats;
+    OnlineStatistics<double> stats;
+    P2Quantile<double> median(0.5);
     for (SceneImage& im : images)
     {
         for (auto& o : im.stereoPoints)
         {
-            if (!o.wp) continue;
-            stats.push_back((depth(im, o)));
+            if (!o) continue;
+            double d = depth(im, o);
+            stats.add(d);
+            median.add(d);
         }
     }
-    Saiga::Statistics<double> sr(stats);
-    return sr;
+    return stats.toStatistics(median.value());
 }
 
 void Scene::removeOutliersFactor(float factor)
 {
     SAIGA_ASSERT(valid());
-    auto sr = statistics();
+    auto sr        = statistics();
     auto threshold = std::max(sr.median * factor, 1.0);
     removeOutliers(threshold);
 }
@@ -264,7 +293,8 @@ void Scene::removeWorldPoint(int id)
     SAIGA_ASSERT(id >= 0 && id < (int)worldPoints.size());
 
     WorldPoint& wp = worldPoints[id];
-    if (!wp) return;
+    // A point that is only marked as invalid can still be referenced. These references are removed too.
+    if (!wp.valid && wp.stereoreferences.empty()) return;
 
 
     // Remove all references
@@ -285,14 +315,13 @@ void Scene::removeCamera(int id)
 
     auto& im = images[id];
 
-    int iip = 0;
-    for (auto& ip : im.stereoPoints)
+    for (int iip = 0; iip < (int)im.stereoPoints.size(); ++iip)
     {
+        auto& ip = im.stereoPoints[iip];
         if (!ip) continue;
         auto& wp = worldPoints[ip.wp];
         wp.removeStereoReference(id, iip);
         ip.wp = -1;
-        ++iip;
     }
 
     im.validPoints = 0;
@@ -305,42 +334,51 @@ void Scene::compress()
     fixWorldPointReferences();
 
 
-    AlignedVector<WorldPoint> newWorldPoints;
+    // The new ids are the exclusive scan of the valid flags
+    int N = worldPoints.size();
+    std::vector<int> newIds(N);
+#pragma omp parallel for
+    for (int i = 0; i < N; ++i)
+    {
+        newIds[i] = worldPoints[i].isValid();
+    }
+    int validCount = CPU::exclusiveScan<int>(newIds, newIds);
 
-    for (auto& wp : worldPoints)
+    // Every image point references at most one world point, so the references can be updated in parallel
+    AlignedVector<WorldPoint> newWorldPoints(validCount);
+#pragma omp parallel for
+    for (int i = 0; i < N; ++i)
     {
-        if (wp.isValid())
-        {
-            int newid = newWorldPoints.size();
-            newWorldPoints.push_back(wp);
+        auto& wp = worldPoints[i];
+        if (!wp.isValid()) continue;
 
-            // update new world point id for every reference
-            for (auto& p : wp.stereoreferences)
-            {
-                auto& ip = images[p.first].stereoPoints[p.second];
-                ip.wp    = newid;
-            }
-        }
-        else
+        int newid = newIds[i];
+        for (auto& p : wp.stereoreferences)
         {
-            // std::cout << "removed wp" << std::endl;
+            auto& ip = images[p.first].stereoPoints[p.second];
+            ip.wp    = newid;
         }
+        newWorldPoints[newid] = std::move(wp);
     }
-    worldPoints = newWorldPoints;
+    worldPoints.swap(newWorldPoints);
     SAIGA_ASSERT(valid());
 
     // count ips for each image
-
-    int i = 0;
-    for (auto& img : images)
+    int numImages = images.size();
+#pragma omp parallel for
+    for (int i = 0; i < numImages; ++i)
     {
+        auto& img       = images[i];
         img.validPoints = 0;
         for (auto& ip : img.stereoPoints)
         {
             if (ip) img.validPoints++;
         }
-        if (img.validPoints == 0) std::cout << "invalid camera " << i << std::endl;
-        i++;
+    }
+
+    for (int i = 0; i < numImages; ++i)
+    {
+        if (images[i].validPoints == 0) std::cout << "invalid camera " << i << std::endl;
     }
 }
 
@@ -524,25 +562,41 @@ double Scene::getSchurDensity()
 
 void Scene::addWorldPointNoise(double stddev)
 {
-    for (auto& wp : worldPoints)
+    AlignedVector<Vec3> noise(worldPoints.size());
+    RandomStream rng(Random::urand64());
+    rng.fillGaussian(noise.data(), noise.size(), 0, stddev);
+    for (size_t i = 0; i < worldPoints.size(); ++i)
     {
-        wp.p += Random::gaussRandMatrix<Vec3>(0, stddev);
+        worldPoints[i].p += noise[i];
     }
 }
 
 void Scene::addImagePointNoise(double stddev)
 {
-    for (auto& img : images)
+    // One stream per image, so the images can be processed in parallel.
+    uint64_t seed = Random::urand64();
+#pragma omp parallel for
+    for (int i = 0; i < (int)images.size(); ++i)
     {
-        for (auto& mp : img.stereoPoints) mp.point += Random::gaussRandMatrix<Vec2>(0, stddev);
+        auto& points = images[i].stereoPoints;
+        AlignedVector<Vec2> noise(points.size());
+        RandomStream rng(seed, i);
+        rng.fillGaussian(noise.data(), noise.size(), 0, stddev);
+        for (size_t j = 0; j < points.size(); ++j)
+        {
+            points[j].point += noise[j];
+        }
     }
 }
 
 void Scene::addExtrinsicNoise(double stddev)
 {
-    for (auto& e : extrinsics)
+    AlignedVector<Vec3> noise(extrinsics.size());
+    RandomStream rng(Random::urand64());
+    rng.fillGaussian(noise.data(), noise.size(), 0, stddev);
+    for (size_t i = 0; i < extrinsics.size(); ++i)
     {
-        e.se3.translation() += Random::gaussRandMatrix<Vec3>(0, stddev);
+        extrinsics[i].se3.translation() += noise[i];
     }
 }
 
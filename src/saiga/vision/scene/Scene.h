@@ -8,6 +8,7 @@
 
 #include "saiga/config.h"
 #include "saiga/core/image/image.h"
+#include "saiga/core/util/DataStructures/SmallVector.h"
 #include "saiga/core/util/statistics.h"
 #include "saiga/vision/VisionTypes.h"
 
@@ -36,13 +37,14 @@ struct SAIGA_VISION_API WorldPoint
     bool valid = false;
 
     // Pair < ImageID, ImagePointID >
-    std::vector<std::pair<int, int> > stereoreferences;
+    // Most points are observed by only a few images, so the references are stored without a heap allocation.
+    SmallVector<std::pair<int, int>, 6> stereoreferences;
 
 
     bool uniqueReferences() const
     {
         // check if all references are unique
-        auto cpy = stereoreferences;
+        SmallVector<std::pair<int, int>, 32> cpy(stereoreferences.begin(), stereoreferences.end());
         std::sort(cpy.begin(), cpy.end());
         auto it = std::unique(cpy.begin(), cpy.end());
         return it == cpy.end();
@@ -59,16 +61,9 @@ struct SAIGA_VISION_API WorldPoint
 
     void removeStereoReference(int img, int ip)
     {
-        SAIGA_ASSERT(isReferencedByStereoFrame(img));
-        for (auto& p : stereoreferences)
-        {
-            if (p.first == img && p.second == ip)
-            {
-                p = stereoreferences.back();
-                break;
-            }
-        }
-        stereoreferences.resize(stereoreferences.size() - 1);
+        auto it = std::find(stereoreferences.begin(), stereoreferences.end(), std::make_pair(img, ip));
+        SAIGA_ASSERT(it != stereoreferences.end());
+        stereoreferences.eraseUnordered(it);
         //        SAIGA_ASSERT(!isReferencedByStereoFrame(img));
     }
 
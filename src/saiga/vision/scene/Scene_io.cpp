@@ -6,6 +6,9 @@
 
 #include "saiga/core/imgui/imgui.h"
 #include "saiga/core/util/assert.h"
+#include "saiga/core/util/MemoryMappedFile.h"
+#include "saiga/core/util/TextParser.h"
+#include "saiga/core/util/TextWriter.h"
 #include "saiga/core/util/fileChecker.h"
 #include "saiga/vision/util/Random.h"
 
@@ -78,47 +81,50 @@ void Scene::save(const std::string& file)
     SAIGA_ASSERT(valid());
 
     std::cout << "Saving scene to " << file << "." << std::endl;
-    std::ofstream strm(file);
-    SAIGA_ASSERT(strm.is_open());
-    strm.precision(20);
-    strm << std::scientific;
-
-
-    strm << "# Saiga Scene file." << std::endl;
-    strm << "#" << std::endl;
-    strm << "# <num_intrinsics> <num_extrinsics> <num_images> <num_worldPoints>" << std::endl;
-    strm << "# Intrinsics" << std::endl;
-    strm << "# <fx> <fy> <cx> <cy>" << std::endl;
-    strm << "# Extrinsics" << std::endl;
-    strm << "# constant tx ty tz rx ry rz rw" << std::endl;
-    strm << "# Images" << std::endl;
-    strm << "# intr extr weight num_points" << std::endl;
-    strm << "# wp depth px py weight" << std::endl;
-    strm << "# WorldPoints" << std::endl;
-    strm << "# x y z" << std::endl;
+    // The numbers are written in the shortest form that reads back exactly
+    TextWriter strm(file);
+    SAIGA_ASSERT(strm.isOpen());
+
+
+    strm << "# Saiga Scene file.\n";
+    strm << "#\n";
+    strm << "# <num_intrinsics> <num_extrinsics> <num_images> <num_worldPoints>\n";
+    strm << "# Intrinsics\n";
+    strm << "# <fx> <fy> <cx> <cy>\n";
+    strm << "# Extrinsics\n";
+    strm << "# constant tx ty tz rx ry rz rw\n";
+    strm << "# Images\n";
+    strm << "# intr extr weight num_points\n";
+    strm << "# wp depth px py weight\n";
+    strm << "# WorldPoints\n";
+    strm << "# x y z\n";
     strm << intrinsics.size() << " " << extrinsics.size() << " " << images.size() << " " << worldPoints.size() << " "
-         << bf << " " << globalScale << std::endl;
+         << bf << " " << globalScale << "\n";
     for (auto& i : intrinsics)
     {
-        strm << i.coeffs().transpose() << std::endl;
+        Vec4 c = i.coeffs();
+        strm.writeArray(c.data(), c.size()) << "\n";
     }
     for (auto& e : extrinsics)
     {
-        strm << e.constant << " " << e.se3.params().transpose() << std::endl;
+        strm << e.constant << " ";
+        strm.writeArray(e.se3.data(), SE3::num_parameters) << "\n";
     }
     for (auto& img : images)
     {
-        strm << img.intr << " " << img.extr << " " << img.imageWeight << " " << img.stereoPoints.size() << std::endl;
+        strm << img.intr << " " << img.extr << " " << img.imageWeight << " " << img.stereoPoints.size() << "\n";
         for (auto& ip : img.stereoPoints)
         {
-            strm << ip.wp << " " << ip.depth << " " << ip.point.transpose() << " " << ip.weight << std::endl;
+            strm << ip.wp << " " << ip.depth << " " << ip.point(0) << " " << ip.point(1) << " " << ip.weight << "\n";
         }
     }
 
     for (auto& wp : worldPoints)
     {
-        strm << wp.p.transpose() << std::endl;
+        strm.writeArray(wp.p.data(), 3) << "\n";
     }
+    bool ok = strm.close();
+    SAIGA_ASSERT(ok, "Could not write " + file);
 }
 
 void Scene::load(const std::string& file)
@@ -126,30 +132,15 @@ void Scene::load(const std::string& file)
     std::cout << "Loading scene from " << file << "." << std::endl;
 
 
-    std::ifstream strm(SearchPathes::data(file));
-    SAIGA_ASSERT(strm.is_open());
+    MemoryMappedFile mmf(SearchPathes::data(file));
+    SAIGA_ASSERT(mmf.isOpen());
+    TextParser strm(mmf.view<char>());
 
 
-    auto consumeComment = [&]() {
-        while (true)
-        {
-            auto c = strm.peek();
-            if (c == '#')
-            {
-                std::string s;
-                std::getline(strm, s);
-            }
-            else
-            {
-                break;
-            }
-        }
-    };
-
-
-    consumeComment();
+    strm.skipComments();
     int num_intrinsics, num_extrinsics, num_images, num_worldPoints;
     strm >> num_intrinsics >> num_extrinsics >> num_images >> num_worldPoints >> bf >> globalScale;
+    SAIGA_ASSERT(strm.ok(), "Invalid scene file " + file);
     intrinsics.resize(num_intrinsics);
     extrinsics.resize(num_extrinsics);
     images.resize(num_images);
@@ -157,15 +148,13 @@ void Scene::load(const std::string& file)
     for (auto& i : intrinsics)
     {
         Vec4 test;
-        strm >> test;
+        strm.parseArray(test.data(), 4);
         i = test;
     }
     for (auto& e : extrinsics)
     {
-        Eigen::Map<Sophus::Vector<double, SE3::num_parameters>> v2(e.se3.data());
-        Sophus::Vector<double, SE3::num_parameters> v;
-        strm >> e.constant >> v;
-        v2 = v;
+        strm >> e.constant;
+        strm.parseArray(e.se3.data(), SE3::num_parameters);
     }
 
     for (auto& img : images)
@@ -175,14 +164,15 @@ void Scene::load(const std::string& file)
         img.stereoPoints.resize(numpoints);
         for (auto& ip : img.stereoPoints)
         {
-            strm >> ip.wp >> ip.depth >> ip.point >> ip.weight;
+            strm >> ip.wp >> ip.depth >> ip.point(0) >> ip.point(1) >> ip.weight;
         }
     }
 
     for (auto& wp : worldPoints)
     {
-        strm >> wp.p;
+        strm.parseArray(wp.p.data(), 3);
     }
+    SAIGA_ASSERT(strm.ok(), "Invalid scene file " + file);
 
     fixWorldPointReferences();
     SAIGA_ASSERT(valid());
@@ -13,17 +13,30 @@ Scene SynteticScene::circleSphere(int numWorldPoints, int numCameras, int numIma
 {
     Scene scene;
 
+    // Every camera and every world point uses its own random stream, so the scene can be created in parallel and
+    // the result only depends on the seed.
+    uint64_t seed = Random::urand64();
 
+    scene.worldPoints.resize(numWorldPoints);
+#pragma omp parallel for
     for (int i = 0; i < numWorldPoints; ++i)
     {
-        WorldPoint wp;
-        wp.p = Random::ballRand(1);
-        scene.worldPoints.push_back(wp);
+        // Uniform in the unit ball by rejection sampling.
+        RandomStream rng(seed, i);
+        Vec3 p;
+        do
+        {
+            p = Vec3(rng.uniformDouble(-1, 1), rng.uniformDouble(-1, 1), rng.uniformDouble(-1, 1));
+        } while (p.squaredNorm() > 1);
+        scene.worldPoints[i].p = p;
     }
 
     Intrinsics4 intr(1000, 1000, 500, 500);
     scene.intrinsics.push_back(intr);
 
+    scene.extrinsics.resize(numCameras);
+    scene.images.resize(numCameras);
+#pragma omp parallel for
     for (int i = 0; i < numCameras; ++i)
     {
         double alpha = double(i) / numCameras;
@@ -35,25 +48,25 @@ Scene SynteticScene::circleSphere(int numWorldPoints, int numCameras, int numIma
         SE3 v;
         v.so3() = onb(-position.normalized(), Vec3(0, -1, 0));
         ;
-        v.translation() = position;
-        extr.se3        = v.inverse();
-        scene.extrinsics.push_back(extr);
+        v.translation()     = position;
+        extr.se3            = v.inverse();
+        scene.extrinsics[i] = extr;
 
 
-        SceneImage si;
-        si.intr = 0;
-        si.extr = i;
+        SceneImage& si = scene.images[i];
+        si.intr        = 0;
+        si.extr        = i;
 
 #if 1
-        auto refs = Random::uniqueIndices(numImagePoints, numWorldPoints);
-        std::sort(refs.begin(), refs.end());
+        RandomStream rng(seed, uint64_t(numWorldPoints) + i);
+        auto refs = Random::sortedUniqueIndices(numImagePoints, numWorldPoints, rng);
+        si.stereoPoints.resize(numImagePoints);
         for (int j = 0; j < numImagePoints; ++j)
         {
-            StereoImagePoint mip;
-            mip.wp    = refs[j];
-            auto p    = extr.se3 * scene.worldPoints[mip.wp].p;
-            mip.point = intr.project(p);
-            si.stereoPoints.push_back(mip);
+            StereoImagePoint& mip = si.stereoPoints[j];
+            mip.wp                = refs[j];
+            auto p                = extr.se3 * scene.worldPoints[mip.wp].p;
+            mip.point             = intr.project(p);
         }
 #else
         for (int j = 0; j < numWorldPoints; ++j)
@@ -65,8 +78,6 @@ Scene SynteticScene::circleSphere(int numWorldPoints, int numCameras, int numIma
             si.monoPoints.push_back(mip);
         }
 #endif
-
-        scene.images.push_back(si);
     }
 
 
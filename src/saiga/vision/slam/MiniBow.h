@@ -17,6 +17,10 @@
  */
 #pragma once
 
+#include "saiga/core/util/BufferedFileWriter.h"
+#include "saiga/core/util/DataStructures/SmallVector.h"
+#include "saiga/core/util/MemoryMappedFile.h"
+
 #include <algorithm>
 #include <array>
 #include <cassert>
@@ -204,7 +208,8 @@ class BowVector : public std::map<WordId, WordValue>
         }
     }
 };
-class FeatureVector : public std::map<NodeId, std::vector<unsigned int>>
+// Only a few features fall into the same node, so the index lists are stored without a heap allocation.
+class FeatureVector : public std::map<NodeId, Saiga::SmallVector<unsigned int, 8>>
 {
    public:
     void addFeature(NodeId id, unsigned int i_feature)
@@ -217,7 +222,7 @@ class FeatureVector : public std::map<NodeId, std::vector<unsigned int>>
         }
         else
         {
-            vit = this->insert(vit, FeatureVector::value_type(id, std::vector<unsigned int>()));
+            vit = this->insert(vit, FeatureVector::value_type(id, mapped_type()));
             vit->second.push_back(i_feature);
         }
     }
@@ -1480,66 +1485,16 @@ int TemplatedVocabulary<TDescriptor, F, Scoring>::stopWords(double minWeight)
 }
 
 
-struct BinaryFile
-{
-    BinaryFile(const std::string& file, std::ios_base::openmode __mode = std::ios_base::in)
-        : strm(file, std::ios::binary | __mode)
-    {
-    }
-
-    template <typename T>
-    void write(const T& v)
-    {
-        strm.write(reinterpret_cast<const char*>(&v), sizeof(T));
-    }
-
-    template <typename T>
-    void write(const std::vector<T>& vec)
-    {
-        write((size_t)vec.size());
-        for (auto& v : vec) write(v);
-    }
-
-    template <typename T>
-    void read(std::vector<T>& vec)
-    {
-        size_t s;
-        read(s);
-        vec.resize(s);
-        for (auto& v : vec) read(v);
-    }
-
-    template <typename T>
-    void read(T& v)
-    {
-        strm.read(reinterpret_cast<char*>(&v), sizeof(T));
-    }
-
-    template <typename T>
-    BinaryFile& operator<<(const T& v)
-    {
-        write(v);
-        return *this;
-    }
-
-    template <typename T>
-    BinaryFile& operator>>(T& v)
-    {
-        read(v);
-        return *this;
-    }
-
-    std::fstream strm;
-};
-
 template <class TDescriptor, class F, class Scoring>
 void TemplatedVocabulary<TDescriptor, F, Scoring>::loadRaw(const std::string& file)
 {
-    BinaryFile bf(file, std::ios_base::in);
-    if (!bf.strm.is_open())
+    // The file is memory mapped and parsed in place. No stream buffer copies.
+    Saiga::MemoryMappedFile mmf(file);
+    if (!mmf.isOpen())
     {
         throw std::runtime_error("Could not load Voc file.");
     }
+    Saiga::MemoryReader bf(mmf.view<char>());
     int scoringid;
     bf >> m_k >> m_L >> scoringid >> m_weighting;
 
@@ -1562,14 +1517,18 @@ void TemplatedVocabulary<TDescriptor, F, Scoring>::loadRaw(const std::string& fi
         if (n.id != 0) m_nodes[n.parent].children.push_back(n.id);
     }
 
-    // words
-    std::vector<std::pair<int, int>> words;
-    bf >> words;
+    // words (index, node id)
+    std::vector<std::array<int, 2>> words;
+    bf.read(words);
+    if (!bf.ok())
+    {
+        throw std::runtime_error("Voc file is truncated.");
+    }
 
     m_words.resize(words.size());
     for (auto i = 0; i < m_words.size(); ++i)
     {
-        m_words[i] = &m_nodes[words[i].second];
+        m_words[i] = &m_nodes[words[i][1]];
     }
 }
 
@@ -1578,18 +1537,18 @@ void TemplatedVocabulary<TDescriptor, F, Scoring>::loadRaw(const std::string& fi
 template <class TDescriptor, class F, class Scoring>
 void TemplatedVocabulary<TDescriptor, F, Scoring>::saveRaw(const std::string& file) const
 {
-    BinaryFile bf(file, std::ios_base::out);
+    Saiga::BufferedFileWriter bf(file);
     bf << m_k << m_L << Scoring::id << m_weighting;
     bf << (size_t)m_nodes.size();
     for (const Node& n : m_nodes)
     {
         bf << n.id << n.parent << n.weight << n.word_id << n.descriptor;
     }
-    // words
-    std::vector<std::pair<int, int>> words;
+    // words (index, node id)
+    std::vector<std::array<int, 2>> words;
     for (auto i = 0; i < m_words.size(); ++i)
     {
-        words.emplace_back(i, m_words[i]->id);
+        words.push_back({int(i), int(m_words[i]->id)});
     }
     bf << words;
 }
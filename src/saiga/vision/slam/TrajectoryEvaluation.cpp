@@ -0,0 +1,351 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "TrajectoryEvaluation.h"
+
+#include "saiga/core/util/Thread/omp.h"
+#include "saiga/core/util/assert.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+#include <tuple>
+
+namespace Saiga
+{
+namespace Trajectory
+{
+void TrajectorySoA::resize(int n)
+{
+    for (auto v : {&timestamps, &tx, &ty, &tz, &qx, &qy, &qz, &qw}) v->resize(n);
+}
+
+void TrajectorySoA::reserve(int n)
+{
+    for (auto v : {&timestamps, &tx, &ty, &tz, &qx, &qy, &qz, &qw}) v->reserve(n);
+}
+
+void TrajectorySoA::set(int i, double timestamp, const SE3& pose)
+{
+    Quat q        = pose.unit_quaternion();
+    timestamps[i] = timestamp;
+    tx[i]         = pose.translation().x();
+    ty[i]         = pose.translation().y();
+    tz[i]         = pose.translation().z();
+    qx[i]         = q.x();
+    qy[i]         = q.y();
+    qz[i]         = q.z();
+    qw[i]         = q.w();
+}
+
+void TrajectorySoA::push_back(double timestamp, const SE3& pose)
+{
+    resize(size() + 1);
+    set(size() - 1, timestamp, pose);
+}
+
+void TrajectorySoA::sort()
+{
+    if (std::is_sorted(timestamps.begin(), timestamps.end())) return;
+
+    std::vector<int> order(size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this](int a, int b) { return timestamps[a] < timestamps[b]; });
+
+    std::vector<double> tmp(size());
+    for (auto v : {&timestamps, &tx, &ty, &tz, &qx, &qy, &qz, &qw})
+    {
+        for (int i = 0; i < size(); ++i) tmp[i] = (*v)[order[i]];
+        v->swap(tmp);
+    }
+}
+
+bool TrajectorySoA::loadTUM(const std::string& file)
+{
+    std::ifstream strm(file);
+    if (!strm.is_open()) return false;
+
+    resize(0);
+    std::string line;
+    while (std::getline(strm, line))
+    {
+        const char* cur = line.c_str();
+        while (*cur == ' ' || *cur == '\t') cur++;
+        if (*cur == 0 || *cur == '#' || *cur == '\r') continue;
+
+        double values[8];
+        for (auto& v : values)
+        {
+            char* next;
+            v = std::strtod(cur, &next);
+            if (next == cur)
+            {
+                resize(0);
+                return false;
+            }
+            cur = next;
+        }
+        Quat q(values[7], values[4], values[5], values[6]);
+        push_back(values[0], SE3(q.normalized(), Vec3(values[1], values[2], values[3])));
+    }
+    return true;
+}
+
+bool TrajectorySoA::saveTUM(const std::string& file) const
+{
+    std::ofstream strm(file);
+    if (!strm.is_open()) return false;
+    strm << std::setprecision(20);
+    for (int i = 0; i < size(); ++i)
+    {
+        strm << timestamps[i] << " " << tx[i] << " " << ty[i] << " " << tz[i] << " " << qx[i] << " " << qy[i] << " "
+             << qz[i] << " " << qw[i] << "\n";
+    }
+    return strm.good();
+}
+
+std::vector<std::pair<int, int>> associate(const std::vector<double>& timestampsA,
+                                           const std::vector<double>& timestampsB, double maxDifference)
+{
+    SAIGA_ASSERT(std::is_sorted(timestampsA.begin(), timestampsA.end()));
+    SAIGA_ASSERT(std::is_sorted(timestampsB.begin(), timestampsB.end()));
+    int N = timestampsA.size();
+
+    // The candidates of A[i] are all B in [A[i] - maxDifference, A[i] + maxDifference]. Both arrays are sorted, so
+    // this is a contiguous range [first[i], last[i]) of B.
+    std::vector<int> first(N), last(N);
+#pragma omp parallel for schedule(static)
+    for (int i = 0; i < N; ++i)
+    {
+        double t = timestampsA[i];
+        first[i] = std::lower_bound(timestampsB.begin(), timestampsB.end(), t - maxDifference) - timestampsB.begin();
+        last[i]  = std::upper_bound(timestampsB.begin() + first[i], timestampsB.end(), t + maxDifference) -
+                  timestampsB.begin();
+    }
+
+    std::vector<int> offset(N + 1, 0);
+    for (int i = 0; i < N; ++i) offset[i + 1] = offset[i] + (last[i] - first[i]);
+
+    struct Candidate
+    {
+        double difference;
+        int a, b;
+    };
+    std::vector<Candidate> candidates(offset[N]);
+#pragma omp parallel for schedule(static)
+    for (int i = 0; i < N; ++i)
+    {
+        for (int j = first[i]; j < last[i]; ++j)
+        {
+            candidates[offset[i] + j - first[i]] = {std::abs(timestampsA[i] - timestampsB[j]), i, j};
+        }
+    }
+
+    // Greedy one-to-one matching in the order of the time difference (as associate.py of the TUM benchmark).
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& x, const Candidate& y) {
+        return std::tie(x.difference, x.a, x.b) < std::tie(y.difference, y.a, y.b);
+    });
+    std::vector<int> matches(N, -1);
+    std::vector<bool> usedB(timestampsB.size(), false);
+    for (auto& c : candidates)
+    {
+        if (matches[c.a] >= 0 || usedB[c.b]) continue;
+        matches[c.a] = c.b;
+        usedB[c.b]   = true;
+    }
+
+    std::vector<std::pair<int, int>> result;
+    result.reserve(N);
+    for (int i = 0; i < N; ++i)
+    {
+        if (matches[i] >= 0) result.emplace_back(i, matches[i]);
+    }
+    return result;
+}
+
+std::pair<SE3, double> alignUmeyama(const TrajectorySoA& src, const TrajectorySoA& ref, bool computeScale)
+{
+    SAIGA_ASSERT(src.size() == ref.size());
+    int N = src.size();
+    if (N == 0) return {SE3(), 1.0};
+
+    // Two passes over the SoA arrays for numerical stability: means and then the centered covariance
+    double sx = 0, sy = 0, sz = 0, rx = 0, ry = 0, rz = 0;
+#pragma omp parallel for reduction(+ : sx, sy, sz, rx, ry, rz)
+    for (int i = 0; i < N; ++i)
+    {
+        sx += src.tx[i];
+        sy += src.ty[i];
+        sz += src.tz[i];
+        rx += ref.tx[i];
+        ry += ref.ty[i];
+        rz += ref.tz[i];
+    }
+    Vec3 meanSrc = Vec3(sx, sy, sz) / N;
+    Vec3 meanRef = Vec3(rx, ry, rz) / N;
+
+    // Covariance ref * src^T
+    double c00 = 0, c01 = 0, c02 = 0, c10 = 0, c11 = 0, c12 = 0, c20 = 0, c21 = 0, c22 = 0, srcVar = 0;
+#pragma omp parallel for reduction(+ : c00, c01, c02, c10, c11, c12, c20, c21, c22, srcVar)
+    for (int i = 0; i < N; ++i)
+    {
+        double ax = src.tx[i] - meanSrc.x();
+        double ay = src.ty[i] - meanSrc.y();
+        double az = src.tz[i] - meanSrc.z();
+        double bx = ref.tx[i] - meanRef.x();
+        double by = ref.ty[i] - meanRef.y();
+        double bz = ref.tz[i] - meanRef.z();
+        c00 += bx * ax;
+        c01 += bx * ay;
+        c02 += bx * az;
+        c10 += by * ax;
+        c11 += by * ay;
+        c12 += by * az;
+        c20 += bz * ax;
+        c21 += bz * ay;
+        c22 += bz * az;
+        srcVar += ax * ax + ay * ay + az * az;
+    }
+    Mat3 C;
+    C << c00, c01, c02, c10, c11, c12, c20, c21, c22;
+
+    Eigen::JacobiSVD<Mat3> svd(C, Eigen::ComputeFullU | Eigen::ComputeFullV);
+    Vec3 S = Vec3::Ones();
+    if (svd.matrixU().determinant() * svd.matrixV().determinant() < 0) S(2) = -1;
+
+    Mat3 R       = svd.matrixU() * S.asDiagonal() * svd.matrixV().transpose();
+    double scale = 1;
+    if (computeScale && srcVar > 0)
+    {
+        scale = svd.singularValues().dot(S) / srcVar;
+    }
+    Vec3 t = meanRef - scale * (R * meanSrc);
+    return {SE3(Quat(R).normalized(), t), scale};
+}
+
+namespace
+{
+struct LocalStatistics
+{
+    OnlineStatistics<double> ate;
+    std::vector<OnlineStatistics<double>> rpeTranslation;
+    std::vector<OnlineStatistics<double>> rpeRotation;
+};
+
+inline double rotationAngle(const Quat& q)
+{
+    return 2 * std::atan2(q.vec().norm(), std::abs(q.w()));
+}
+}  // namespace
+
+TrajectoryEvaluationResult evaluate(const TrajectorySoA& estimate, const TrajectorySoA& groundTruth,
+                                    const TrajectoryEvaluationSettings& settings)
+{
+    SAIGA_ASSERT(std::is_sorted(estimate.timestamps.begin(), estimate.timestamps.end()));
+    SAIGA_ASSERT(std::is_sorted(groundTruth.timestamps.begin(), groundTruth.timestamps.end()));
+
+    for (auto d : settings.rpeDeltas) SAIGA_ASSERT(d >= 1, "The RPE deltas must be positive.");
+
+    TrajectoryEvaluationResult result;
+    int numDeltas = settings.rpeDeltas.size();
+    result.rpeTranslation.resize(numDeltas);
+    result.rpeRotation.resize(numDeltas);
+
+    auto pairs        = associate(estimate.timestamps, groundTruth.timestamps, settings.maxTimeDifference);
+    int N             = pairs.size();
+    result.associated = N;
+    if (N == 0) return result;
+
+    // Gather the associated poses into two compact trajectories of the same length
+    TrajectorySoA A, B;
+    A.resize(N);
+    B.resize(N);
+#pragma omp parallel for schedule(static)
+    for (int i = 0; i < N; ++i)
+    {
+        auto [a, b]     = pairs[i];
+        A.timestamps[i] = estimate.timestamps[a];
+        A.tx[i]         = estimate.tx[a];
+        A.ty[i]         = estimate.ty[a];
+        A.tz[i]         = estimate.tz[a];
+        A.qx[i]         = estimate.qx[a];
+        A.qy[i]         = estimate.qy[a];
+        A.qz[i]         = estimate.qz[a];
+        A.qw[i]         = estimate.qw[a];
+
+        B.timestamps[i] = groundTruth.timestamps[b];
+        B.tx[i]         = groundTruth.tx[b];
+        B.ty[i]         = groundTruth.ty[b];
+        B.tz[i]         = groundTruth.tz[b];
+        B.qx[i]         = groundTruth.qx[b];
+        B.qy[i]         = groundTruth.qy[b];
+        B.qz[i]         = groundTruth.qz[b];
+        B.qw[i]         = groundTruth.qw[b];
+    }
+
+    if (settings.align)
+    {
+        std::tie(result.alignment, result.scale) = alignUmeyama(A, B, settings.alignScale);
+
+        SE3 T    = result.alignment;
+        double s = result.scale;
+#pragma omp parallel for schedule(static)
+        for (int i = 0; i < N; ++i)
+        {
+            SE3 p = A.pose(i);
+            p.translation() *= s;
+            A.set(i, A.timestamps[i], T * p);
+        }
+    }
+
+    // ATE and RPE of all deltas in one pass. The statistics are accumulated per thread and merged in a fixed order.
+    int threads = OMP::getMaxThreads();
+    std::vector<LocalStatistics> local(threads);
+#pragma omp parallel num_threads(threads)
+    {
+        auto& l = local[OMP::getThreadNum()];
+        l.rpeTranslation.resize(numDeltas);
+        l.rpeRotation.resize(numDeltas);
+
+#pragma omp for schedule(static)
+        for (int i = 0; i < N; ++i)
+        {
+            double dx = A.tx[i] - B.tx[i];
+            double dy = A.ty[i] - B.ty[i];
+            double dz = A.tz[i] - B.tz[i];
+            l.ate.add(std::sqrt(dx * dx + dy * dy + dz * dz));
+
+            if (numDeltas == 0) continue;
+            SE3 aInv = A.pose(i).inverse();
+            SE3 bInv = B.pose(i).inverse();
+            for (int d = 0; d < numDeltas; ++d)
+            {
+                int j = i + settings.rpeDeltas[d];
+                if (j <= i || j >= N) continue;
+                SE3 relA  = aInv * A.pose(j);
+                SE3 relB  = bInv * B.pose(j);
+                SE3 error = relB.inverse() * relA;
+                l.rpeTranslation[d].add(error.translation().norm());
+                l.rpeRotation[d].add(rotationAngle(error.unit_quaternion()));
+            }
+        }
+    }
+
+    for (auto& l : local)
+    {
+        result.ate.merge(l.ate);
+        for (int d = 0; d < (int)l.rpeTranslation.size(); ++d)
+        {
+            result.rpeTranslation[d].merge(l.rpeTranslation[d]);
+            result.rpeRotation[d].merge(l.rpeRotation[d]);
+        }
+    }
+    return result;
+}
+
+}  // namespace Trajectory
+}  // namespace Saiga
@@ -0,0 +1,118 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/core/util/OnlineStatistics.h"
+#include "saiga/vision/VisionTypes.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * Trajectory evaluation for long trajectories and many runs.
+ * In contrast to Trajectory.h the poses are stored in SoA layout, the trajectories are associated by timestamp and
+ * the errors are accumulated in OnlineStatistics instead of returning the full error lists.
+ *
+ * As in Trajectory.h all poses are Camera->World transformations.
+ *
+ * The typical usage is:
+ *
+ * Trajectory::TrajectorySoA estimate, groundTruth;
+ * estimate.loadTUM("estimate.txt");
+ * groundTruth.loadTUM("groundtruth.txt");
+ *
+ * Trajectory::TrajectoryEvaluationSettings settings;
+ * settings.rpeDeltas = {1, 10, 100};
+ * auto result = Trajectory::evaluate(estimate, groundTruth, settings);
+ * std::cout << "ate: " << result.ate.rms() << std::endl;
+ */
+namespace Saiga
+{
+namespace Trajectory
+{
+struct SAIGA_VISION_API TrajectorySoA
+{
+    std::vector<double> timestamps;
+    std::vector<double> tx, ty, tz;
+    // Normalized quaternion
+    std::vector<double> qx, qy, qz, qw;
+
+    int size() const { return timestamps.size(); }
+    void resize(int n);
+    void reserve(int n);
+
+    void set(int i, double timestamp, const SE3& pose);
+    void push_back(double timestamp, const SE3& pose);
+
+    SE3 pose(int i) const { return SE3(Quat(qw[i], qx[i], qy[i], qz[i]), position(i)); }
+    Vec3 position(int i) const { return Vec3(tx[i], ty[i], tz[i]); }
+
+    // Sorts the poses by timestamp.
+    void sort();
+
+    // TUM trajectory format. One pose per line:
+    // <timestamp> <translation x y z> <rotation x y z w>
+    // Empty lines and lines starting with '#' are skipped. On a parse error the trajectory is empty.
+    bool loadTUM(const std::string& file);
+    bool saveTUM(const std::string& file) const;
+};
+
+/**
+ * Associates the timestamps of A and B one-to-one, like associate.py of the TUM RGB-D benchmark.
+ * All pairs with a time difference of at most maxDifference are candidates. They are matched greedily in the order
+ * of the time difference, so each timestamp of A and of B is used at most once.
+ * Both arrays must be sorted. Returns the index pairs (a,b) sorted by a.
+ */
+SAIGA_VISION_API std::vector<std::pair<int, int>> associate(const std::vector<double>& timestampsA,
+                                                            const std::vector<double>& timestampsB,
+                                                            double maxDifference);
+
+/**
+ * Umeyama alignment: The transformation (T,s) which minimizes
+ * sum_i || ref_i - s * R * src_i - t ||^2
+ * over the positions of both trajectories. If computeScale is false, s = 1.
+ */
+SAIGA_VISION_API std::pair<SE3, double> alignUmeyama(const TrajectorySoA& src, const TrajectorySoA& ref,
+                                                     bool computeScale);
+
+struct TrajectoryEvaluationSettings
+{
+    double maxTimeDifference = 0.02;
+
+    bool align      = true;
+    bool alignScale = false;
+
+    // The relative pose error is computed between pose i and i+delta for every delta in this list.
+    // All deltas must be >= 1.
+    std::vector<int> rpeDeltas = {1};
+};
+
+struct TrajectoryEvaluationResult
+{
+    int associated = 0;
+
+    // Transforms the estimate to the ground truth: gt = scale * alignment * estimate
+    SE3 alignment;
+    double scale = 1;
+
+    // Absolute trajectory error (translation)
+    OnlineStatistics<double> ate;
+
+    // Relative pose error, one entry for each delta. The rotational error is in radians.
+    std::vector<OnlineStatistics<double>> rpeTranslation;
+    std::vector<OnlineStatistics<double>> rpeRotation;
+};
+
+/**
+ * Associates, aligns and evaluates the trajectories. Both must be sorted by timestamp.
+ * All steps are parallelized with OpenMP. The ATE and the RPE of all deltas are computed in a single pass.
+ */
+SAIGA_VISION_API TrajectoryEvaluationResult evaluate(const TrajectorySoA& estimate, const TrajectorySoA& groundTruth,
+                                                     const TrajectoryEvaluationSettings& settings = {});
+
+}  // namespace Trajectory
+}  // namespace Saiga
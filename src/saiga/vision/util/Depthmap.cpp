@@ -15,19 +15,36 @@ namespace Depthmap
 void toPointCloud(DepthMap dm, DepthPointCloud pc, const Intrinsics4& camera)
 {
     SAIGA_ASSERT(dm.h == pc.h && dm.w == pc.w);
+
+    // The normalized x coordinate is the same for all rows
+    std::vector<double> nx(dm.w);
+    for (int j = 0; j < dm.w; ++j) nx[j] = (j - camera.cx) / camera.fx;
+
+#pragma omp parallel for
     for (int i = 0; i < dm.h; ++i)
     {
+        double ny = (i - camera.cy) / camera.fy;
         for (int j = 0; j < dm.w; ++j)
         {
-            Vec2 ip(j, i);
-            auto depth = dm(i, j);
+            double depth = dm(i, j);
+            pc(i, j)     = depth > 0 ? Vec3(nx[j] * depth, ny * depth, depth) : infinityVec3();
+        }
+    }
+}
 
-            Vec3 result;
-            if (depth > 0)
-                result = camera.unproject(ip, depth);
-            else
-                result = infinityVec3();
-            pc(i, j) = result;
+void toPointCloud(DepthMap dm, DepthPointCloud pc, const UndistortionMap<double>& map)
+{
+    SAIGA_ASSERT(dm.h == pc.h && dm.w == pc.w);
+    SAIGA_ASSERT(dm.h == map.height && dm.w == map.width);
+
+#pragma omp parallel for
+    for (int i = 0; i < dm.h; ++i)
+    {
+        for (int j = 0; j < dm.w; ++j)
+        {
+            double depth = dm(i, j);
+            Vec2 p       = map(j, i);
+            pc(i, j)     = depth > 0 ? Vec3(p.x() * depth, p.y() * depth, depth) : infinityVec3();
         }
     }
 }
@@ -8,6 +8,7 @@
 
 #include "saiga/core/image/image.h"
 #include "saiga/vision/VisionTypes.h"
+#include "saiga/vision/cameraModel/CameraModelBatch.h"
 
 namespace Saiga
 {
@@ -32,6 +33,12 @@ using DepthNormalMap  = ImageView<Vec3>;
  */
 SAIGA_VISION_API void toPointCloud(DepthMap dm, DepthPointCloud pc, const Intrinsics4& camera);
 
+/**
+ * Same as above for distorted depth images.
+ * The map must have the same size as the depth image.
+ */
+SAIGA_VISION_API void toPointCloud(DepthMap dm, DepthPointCloud pc, const UndistortionMap<double>& map);
+
 
 /**
  * Computes the normals in camera space for each point with
@@ -6,8 +6,12 @@
 
 #pragma once
 
+#include "saiga/core/util/Arena.h"
+#include "saiga/core/util/AsyncLogger.h"
 #include "saiga/vision/VisionIncludes.h"
 
+#include <algorithm>
+
 namespace Saiga
 {
 /**
@@ -171,17 +175,19 @@ struct MeanMatcher
         static_assert(std::is_same<T, DescriptorORB>::value, "Only implemented for ORB so far.");
         if (descriptors.size() == 0) return -1;
         // Compute distances between them
+        // The N*N table is scratch memory of the thread arena.
         size_t N = descriptors.size();
-        std::vector<std::vector<int>> Distances(N, std::vector<int>(N));
+        ArenaScope scope;
+        ArenaVector<int> Distances(N * N);
 
         for (size_t i = 0; i < N; i++)
         {
-            Distances[i][i] = 0;
+            Distances[i * N + i] = 0;
             for (size_t j = i + 1; j < N; j++)
             {
-                int distij      = distance(descriptors[i], descriptors[j]);
-                Distances[i][j] = distij;
-                Distances[j][i] = distij;
+                int distij           = distance(descriptors[i], descriptors[j]);
+                Distances[i * N + j] = distij;
+                Distances[j * N + i] = distij;
             }
         }
 
@@ -190,10 +196,9 @@ struct MeanMatcher
         int BestIdx    = 0;
         for (size_t i = 0; i < N; i++)
         {
-            // vector<int> vDists(Distances[i],Distances[i]+N);
-            auto& vDists = Distances[i];
-            sort(vDists.begin(), vDists.end());
-            int median = vDists[0.5 * (N - 1)];
+            int* vDists = Distances.data() + i * N;
+            std::sort(vDists, vDists + N);
+            int median = vDists[size_t(0.5 * (N - 1))];
 
             if (median < BestMedian)
             {
@@ -226,14 +231,14 @@ struct BruteForceMatcher
             ++first1;
         }
 
-        int sum = distances.sum();
-        std::cout << "distance sum: " << sum << " avg: " << double(sum) / (n * m) << std::endl;
+        SAIGA_LOG(Debug, "distance sum: ", distances.sum(), " avg: ", double(distances.sum()) / (n * m));
     }
 
     template <typename _InputIterator>
     void matchKnn2(_InputIterator first1, int n, _InputIterator first2, int m)
     {
-        knn2.resize(n, 2);
+        // The storage is kept between calls. This does not allocate if the previous frame had at least n points.
+        knn2Storage.resize(n * 2);
         for (auto i : Range(0, n))
         {
             // init best to infinity distance
@@ -273,9 +278,9 @@ struct BruteForceMatcher
     int filterMatches(DistanceType threshold, float ratioThreshold)
     {
         matches.clear();
-        matches.reserve(knn2.rows());
+        matches.reserve(knn2Rows());
 
-        for (auto i : Range<int>(0, knn2.rows()))
+        for (auto i : Range<int>(0, knn2Rows()))
         {
             // the best distance is still larger than the threshold
             if (knn2(i, 0).first > threshold) continue;
@@ -296,7 +301,10 @@ struct BruteForceMatcher
     Eigen::Matrix<DistanceType, -1, -1, Eigen::RowMajor> distances;
 
     // contains the matches index + the distance
-    Eigen::Matrix<std::pair<DistanceType, int>, -1, 2, Eigen::RowMajor> knn2;
+    // (n x 2) row major
+    std::pair<DistanceType, int>& knn2(int i, int k) { return knn2Storage[i * 2 + k]; }
+    int knn2Rows() const { return knn2Storage.size() / 2; }
+    std::vector<std::pair<DistanceType, int>> knn2Storage;
 
     std::vector<std::pair<int, int>> matches;
 };
@@ -7,13 +7,17 @@
 #include "HistogramImage.h"
 
 #include "saiga/core/image/ImageDraw.h"
-#include "saiga/core/math/imath.h"
 #include "saiga/core/util/color.h"
 
 namespace Saiga
 {
 HistogramImage::HistogramImage(int inputW, int inputH, int outputW, int outputH)
-    : inputW(inputW), inputH(inputH), outputW(std::min(inputW, outputW)), outputH(std::min(inputH, outputH))
+    : inputW(inputW),
+      inputH(inputH),
+      outputW(std::min(inputW, outputW)),
+      outputH(std::min(inputH, outputH)),
+      cols(0, inputW, this->outputW),
+      rows(0, inputH, this->outputH)
 {
     img.create(this->outputH, this->outputW);
     img.getImageView().set(0);
@@ -22,19 +26,11 @@ HistogramImage::HistogramImage(int inputW, int inputH, int outputW, int outputH)
 HistogramImage::BinIndex HistogramImage::bin(int y, int x)
 {
     // pixel center
-    double dx = x + 0.5;
-    double dy = y + 0.5;
-    // rescale
-    dx = dx * ((double)outputW / (double)inputW);
-    dy = dy * ((double)outputH / (double)inputH);
-    // round to target
-    int ox = iRound(dx - 0.5);
-    int oy = iRound(dy - 0.5);
-
-    if (!img.getImageView().inImage(oy, ox))
+    int ox = cols.bin(x + 0.5);
+    int oy = rows.bin(y + 0.5);
+    if (ox < 0 || oy < 0)
     {
-        ox = -1;
-        oy = -1;
+        return {-1, -1};
     }
     return {oy, ox};
 }
@@ -49,6 +45,20 @@ HistogramImage::BinIndex HistogramImage::add(int y, int x, int value)
     return bid;
 }
 
+void HistogramImage::merge(const HistogramImage& other)
+{
+    SAIGA_ASSERT(other.inputW == inputW && other.inputH == inputH && other.outputW == outputW &&
+                 other.outputH == outputH);
+    auto src = other.img.getConstImageView();
+    for (int i = 0; i < outputH; ++i)
+    {
+        for (int j = 0; j < outputW; ++j)
+        {
+            img(i, j) += src(i, j);
+        }
+    }
+}
+
 void HistogramImage::writeBinary(const std::string& file, int threshold)
 {
     TemplatedImage<ucvec3> outimg(outputH, outputW);
@@ -7,10 +7,17 @@
 #pragma once
 
 #include "saiga/core/image/image.h"
+#include "saiga/core/util/OnlineStatistics.h"
 #include "saiga/vision/VisionTypes.h"
 
 namespace Saiga
 {
+/**
+ * A 2D histogram with equally sized bins, for example to visualize the sparsity pattern of a large matrix.
+ * Each axis is binned by a Saiga::Histogram over [0, input) at the pixel center. The pixel x is therefore in the bin
+ * floor((x + 0.5) * output / input), which is the nearest output bin of the scaled pixel center.
+ * Images of the same size can be merged, so each thread can fill its own histogram.
+ */
 class SAIGA_VISION_API HistogramImage
 {
    public:
@@ -22,6 +29,8 @@ class SAIGA_VISION_API HistogramImage
     BinIndex bin(int y, int x);
     BinIndex add(int y, int x, int value);
 
+    void merge(const HistogramImage& other);
+
     void writeBinary(const std::string& file, int threshold = 1);
 
     int operator()(int y, int x) { return img(y, x); }
@@ -33,6 +42,7 @@ class SAIGA_VISION_API HistogramImage
 
    private:
     int inputW, inputH, outputW, outputH;
+    Histogram<double> cols, rows;
     TemplatedImage<int> img;
 };
 }  // namespace Saiga
@@ -7,6 +7,7 @@
 #include "Optimizer.h"
 
 #include "saiga/core/imgui/imgui.h"
+#include "saiga/core/time/Profiler.h"
 #include "saiga/core/util/Thread/omp.h"
 
 #include <iostream>
@@ -62,6 +63,7 @@ std::ostream& operator<<(std::ostream& strm, const OptimizationOptions& op)
 
 OptimizationResults LMOptimizer::solve()
 {
+    SAIGA_PROFILE_ZONE("LM::solve");
     double current_chi2 = 0;
 
     OptimizationResults result;
@@ -74,7 +76,12 @@ OptimizationResults LMOptimizer::solve()
 
     for (auto i = 0; i < optimizationOptions.maxIterations; ++i)
     {
-        double chi2 = computeQuadraticForm();
+        SAIGA_PROFILE_ZONE("LM::iteration");
+        double chi2;
+        {
+            SAIGA_PROFILE_ZONE("LM::computeQuadraticForm");
+            chi2 = computeQuadraticForm();
+        }
 
 
         if (optimizationOptions.debug)
@@ -102,6 +109,7 @@ OptimizationResults LMOptimizer::solve()
 
         double ltime;
         {
+            SAIGA_PROFILE_ZONE("LM::solveLinearSystem");
             Saiga::ScopedTimer<double> timer(ltime);
             solveLinearSystem();
         }
@@ -109,7 +117,11 @@ OptimizationResults LMOptimizer::solve()
 
         addDelta();
 
-        double newChi2 = computeCost();
+        double newChi2;
+        {
+            SAIGA_PROFILE_ZONE("LM::computeCost");
+            newChi2 = computeCost();
+        }
 
         if (std::isfinite(newChi2) && newChi2 < current_chi2)
         {
@@ -159,7 +171,10 @@ OptimizationResults LMOptimizer::initAndSolve()
 
     {
         Saiga::ScopedTimer<double> timer(result.total_time);
-        init();
+        {
+            SAIGA_PROFILE_ZONE("LM::init");
+            init();
+        }
 
         result = solve();
     }
@@ -169,6 +184,7 @@ OptimizationResults LMOptimizer::initAndSolve()
 OptimizationResults LMOptimizer::solveOMP()
 {
     SAIGA_ASSERT(supportOMP());
+    SAIGA_PROFILE_ZONE("LM::solveOMP");
     double current_chi2 = 0;
 
     OptimizationResults result;
@@ -185,9 +201,12 @@ OptimizationResults LMOptimizer::solveOMP()
         int tid = OMP::getThreadNum();
         for (auto i = 0; i < optimizationOptions.maxIterations && running; ++i)
         {
+            SAIGA_PROFILE_ZONE("LM::iteration");
             double chi2;
-
-            chi2 = computeQuadraticForm();
+            {
+                SAIGA_PROFILE_ZONE("LM::computeQuadraticForm");
+                chi2 = computeQuadraticForm();
+            }
 
             if (optimizationOptions.debug)
             {
@@ -212,6 +231,7 @@ OptimizationResults LMOptimizer::solveOMP()
 
             double ltime;
             {
+                SAIGA_PROFILE_ZONE("LM::solveLinearSystem");
                 auto timer = (tid == 0) ? std::make_shared<Saiga::ScopedTimer<double>>(ltime) : nullptr;
                 solveLinearSystem();
             }
@@ -219,7 +239,11 @@ OptimizationResults LMOptimizer::solveOMP()
 
             addDelta();
 
-            double newChi2 = computeCost();
+            double newChi2;
+            {
+                SAIGA_PROFILE_ZONE("LM::computeCost");
+                newChi2 = computeCost();
+            }
 
 
 #pragma omp single
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "saiga/config.h"
+#include "saiga/core/math/RandomStream.h"
 #include "saiga/core/math/random.h"
 #include "saiga/vision/VisionIncludes.h"
 
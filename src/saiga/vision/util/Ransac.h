@@ -9,6 +9,8 @@
 #include "saiga/core/util/Thread/omp.h"
 #include "saiga/vision/VisionTypes.h"
 
+#include <functional>
+
 
 namespace Saiga
 {
@@ -34,6 +36,10 @@ struct RansacParameters
     // Number of omp threads in that group
     // Note:
     int threads = 1;
+
+    // Optional. Checked before every iteration. If it returns true, the remaining iterations are skipped and the
+    // best model found so far is returned. Must be thread safe if threads > 1.
+    std::function<bool()> cancel;
 };
 
 
@@ -50,13 +56,12 @@ class RansacBase
         numInliers.resize(params.maxIterations);
         models.resize(params.maxIterations);
 
-        residuals.resize(params.maxIterations);
-        for (auto&& r : residuals) r.reserve(params.reserveN);
-
-        inliers.resize(params.maxIterations);
-        for (auto&& r : inliers) r.reserve(params.reserveN);
-
         SAIGA_ASSERT(params.threads >= 1);
+        // Each thread only keeps the inlier mask of the current iteration and of its best model.
+        // In contrast to one mask per iteration this does not allocate during compute() after the first call.
+        threadInliers.resize(params.threads * 2);
+        for (auto&& r : threadInliers) r.reserve(params.reserveN);
+
         generators.resize(params.threads);
         threadLocalBestModel.resize(params.threads);
         for (int i = 0; i < params.threads; ++i)
@@ -88,18 +93,20 @@ class RansacBase
         auto&& bestModel = threadLocalBestModel[tid]();
         bestModel        = {0, 0};
 
+        auto&& inlier     = threadInliers[tid * 2];
+        auto&& bestInlier = threadInliers[tid * 2 + 1];
+        inlier.resize(N);
+        bestInlier.assign(N, 0);
 
 #pragma omp for
         for (int it = 0; it < params.maxIterations; ++it)
         {
             auto&& model     = models[it];
-            auto&& inlier    = inliers[it];
-            auto&& residual  = residuals[it];
             auto&& numInlier = numInliers[it];
 
             numInlier = 0;
-            residual.resize(N);
-            inlier.resize(N);
+
+            if (params.cancel && params.cancel()) continue;
 
             Subset set;
             for (auto j : Range(0, ModelSize))
@@ -112,9 +119,9 @@ class RansacBase
 
             for (int j = 0; j < N; ++j)
             {
-                residual[j] = derived().computeResidual(model, j);
+                double residual = derived().computeResidual(model, j);
 
-                bool inl  = residual[j] < params.residualThreshold;
+                bool inl  = residual < params.residualThreshold;
                 inlier[j] = inl;
                 numInlier += inl;
             }
@@ -123,34 +130,39 @@ class RansacBase
             {
                 bestModel.first  = numInlier;
                 bestModel.second = it;
+                inlier.swap(bestInlier);
             }
         }
 
 #pragma omp single
         {
             bestIdx       = 0;
+            bestThread    = 0;
             int bestCount = 0;
             for (int th = 0; th < params.threads; ++th)
             {
-                auto&& thbestModel = threadLocalBestModel[tid]();
+                auto&& thbestModel = threadLocalBestModel[th]();
                 auto inl           = thbestModel.first;
                 auto it            = thbestModel.second;
                 if (inl > bestCount)
                 {
-                    bestCount = inl;
-                    bestIdx   = it;
+                    bestCount  = inl;
+                    bestIdx    = it;
+                    bestThread = th;
                 }
             }
         }
         return bestIdx;
     }
 
+    // The inlier mask of the model returned by compute().
+    const std::vector<char>& bestInliers() const { return threadInliers[bestThread * 2 + 1]; }
+
 
     // total number of sample points
     int N;
     RansacParameters params;
-    AlignedVector<std::vector<double>> residuals;
-    AlignedVector<std::vector<char>> inliers;
+    AlignedVector<std::vector<char>> threadInliers;
     AlignedVector<int> numInliers;
     AlignedVector<Model> models;
 
@@ -161,6 +173,7 @@ class RansacBase
     std::vector<std::mt19937> generators;
 
     int bestIdx;
+    int bestThread;
 
    private:
     Derived& derived() { return *static_cast<Derived*>(this); }
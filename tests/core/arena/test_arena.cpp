@@ -0,0 +1,91 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/util/Arena.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+
+using namespace Saiga;
+
+TEST(Arena, Alignment)
+{
+    MonotonicArena arena(1024);
+    for (size_t alignment = 1; alignment <= MonotonicArena::blockAlignment; alignment *= 2)
+    {
+        arena.allocate(3);
+        void* ptr = arena.allocate(5, alignment);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % alignment, 0);
+    }
+}
+
+TEST(Arena, ScopesAreNested)
+{
+    MonotonicArena arena(1024);
+    char* a = static_cast<char*>(arena.allocate(100));
+    {
+        ArenaScope outer(arena);
+        char* b = static_cast<char*>(arena.allocate(100));
+        {
+            ArenaScope inner(arena);
+            arena.allocate(100);
+        }
+        // The inner scope has freed its allocation, the next one reuses the memory.
+        char* c = static_cast<char*>(arena.allocate(100));
+        EXPECT_EQ(c, b + 112);
+        EXPECT_GT(b, a);
+    }
+    EXPECT_EQ(static_cast<char*>(arena.allocate(100)), a + 112);
+}
+
+TEST(Arena, DeallocateLast)
+{
+    MonotonicArena arena(1024);
+    void* a = arena.allocate(64);
+    arena.deallocate(a, 64);
+    EXPECT_EQ(arena.allocate(64), a);
+
+    // Only the last allocation is freed.
+    void* b = arena.allocate(64);
+    arena.deallocate(a, 64);
+    EXPECT_NE(arena.allocate(64), b);
+}
+
+TEST(Arena, MergeBlocksOnReset)
+{
+    MonotonicArena arena(1024);
+    for (int i = 0; i < 10; ++i) arena.allocate(1000);
+    EXPECT_GT(arena.numBlocks(), 1);
+    size_t capacity = arena.capacity();
+
+    arena.reset();
+    EXPECT_EQ(arena.numBlocks(), 1);
+    EXPECT_GE(arena.capacity(), capacity);
+}
+
+TEST(Arena, SteadyStateDoesNotAllocate)
+{
+    MonotonicArena arena(1024);
+    auto frame = [&]() {
+        ArenaScope scope(arena);
+        ArenaVector<int> a{ArenaAllocator<int>(arena)};
+        ArenaVector<double> b{ArenaAllocator<double>(arena)};
+        for (int i = 0; i < 5000; ++i)
+        {
+            a.push_back(i);
+            b.push_back(i);
+        }
+        EXPECT_EQ(a[4999], 4999);
+        EXPECT_EQ(b[4999], 4999);
+    };
+
+    frame();
+    frame();
+    size_t allocations = MonotonicArena::blockAllocations();
+    for (int i = 0; i < 10; ++i) frame();
+    EXPECT_EQ(MonotonicArena::blockAllocations(), allocations);
+}
@@ -0,0 +1,209 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/math/math.h"
+#include "saiga/core/time/performanceMeasure.h"
+#include "saiga/core/util/AsyncLogger.h"
+#include "saiga/core/util/assert.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+
+using namespace Saiga;
+
+// Collects the output of the logger without the record headers.
+class AsyncLoggerTest : public ::testing::Test
+{
+   protected:
+    void SetUp() override
+    {
+        AsyncLogger::instance().setLevel(LogLevel::Verbose);
+        AsyncLogger::instance().setSink([this](const std::string& text) {
+            std::unique_lock lock(mutex);
+            size_t pos = 0;
+            while (pos < text.size())
+            {
+                size_t begin = text.find("] ", pos) + 2;
+                size_t end   = text.find('\n', begin);
+                lines.push_back(text.substr(begin, end - begin));
+                pos = end + 1;
+            }
+        });
+    }
+
+    void TearDown() override
+    {
+        AsyncLogger::instance().flush();
+        AsyncLogger::instance().setStdoutSink();
+        AsyncLogger::instance().setLevel(LogLevel::Info);
+    }
+
+    std::vector<std::string> output()
+    {
+        AsyncLogger::instance().flush();
+        std::unique_lock lock(mutex);
+        return lines;
+    }
+
+    std::mutex mutex;
+    std::vector<std::string> lines;
+};
+
+struct alignas(64) OverAligned
+{
+    int value;
+    friend std::ostream& operator<<(std::ostream& strm, const OverAligned& a) { return strm << "aligned " << a.value; }
+};
+
+// Counts the live instances, so the test can check that every payload is destroyed.
+struct CountedArg
+{
+    static inline std::atomic<int> live = 0;
+    int value;
+
+    CountedArg(int value) : value(value) { live++; }
+    CountedArg(const CountedArg& other) : value(other.value) { live++; }
+    ~CountedArg() { live--; }
+    friend std::ostream& operator<<(std::ostream& strm, const CountedArg& a) { return strm << "counted " << a.value; }
+};
+
+TEST_F(AsyncLoggerTest, Levels)
+{
+    AsyncLogger::instance().setLevel(LogLevel::Warning);
+    SAIGA_LOG(Info, "hidden");
+    SAIGA_LOG(Warning, "shown");
+    SAIGA_LOG(Error, 1, " ", 2.5);
+    EXPECT_EQ(output(), std::vector<std::string>({"shown", "1 2.5"}));
+}
+
+TEST_F(AsyncLoggerTest, ArgumentsAreCopied)
+{
+    {
+        // All of these reference memory that is invalid or changed before the record is formatted.
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "buffer %d", 1);
+        std::string str = "string";
+        Vec3 a(1, 2, 3), b(1, 1, 1);
+
+        SAIGA_LOG(Info, buffer);
+        SAIGA_LOG(Info, str.c_str());
+        SAIGA_LOG(Info, std::string_view(str));
+        SAIGA_LOG(Info, (a + b).transpose());
+
+        std::memset(buffer, 'x', sizeof(buffer) - 1);
+        str = "overwritten";
+        a.setZero();
+        b.setZero();
+    }
+    EXPECT_EQ(output(), std::vector<std::string>({"buffer 1", "string", "string", "2 3 4"}));
+}
+
+TEST_F(AsyncLoggerTest, OverAligned)
+{
+    Eigen::Matrix<double, 4, 4> m = Eigen::Matrix<double, 4, 4>::Identity();
+    for (int i = 0; i < 10; ++i)
+    {
+        // Different record sizes move the payload to different offsets.
+        SAIGA_LOG(Info, std::string(i, 'a'), OverAligned{i});
+        SAIGA_LOG(Info, m.row(i % 4));
+    }
+    auto lines = output();
+    ASSERT_EQ(lines.size(), 20);
+    for (int i = 0; i < 10; ++i)
+    {
+        EXPECT_EQ(lines[2 * i], std::string(i, 'a') + "aligned " + std::to_string(i));
+    }
+    EXPECT_EQ(lines[1], "1 0 0 0");
+}
+
+TEST_F(AsyncLoggerTest, PayloadsAreDestroyed)
+{
+    SAIGA_LOG(Info, CountedArg(1));
+    // The buffer of this thread outlives the thread until it is drained.
+    std::thread([]() { SAIGA_LOG(Info, CountedArg(2)); }).join();
+    EXPECT_EQ(output(), std::vector<std::string>({"counted 1", "counted 2"}));
+    EXPECT_EQ(CountedArg::live, 0);
+}
+
+TEST(AsyncLoggerDeathTest, ShutdownDestroysPayloads)
+{
+    ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+    EXPECT_EXIT(
+        {
+            AsyncLogger::instance().setSink([](const std::string&) {});
+            std::vector<std::thread> threads;
+            for (int t = 0; t < 4; ++t)
+            {
+                threads.emplace_back([]() {
+                    for (int i = 0; i < 2000; ++i) SAIGA_LOG(Info, CountedArg(i));
+                });
+            }
+            // Records are written before, during and after the shutdown.
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            AsyncLogger::instance().shutdown();
+            for (auto& t : threads) t.join();
+            std::exit(CountedArg::live == 0 ? 0 : 1);
+        },
+        ::testing::ExitedWithCode(0), "");
+}
+
+// measureFunction writes directly to stdout, so the output stays in order with other std::cout output.
+TEST(PerformanceMeasure, OutputIsInOrder)
+{
+    ::testing::internal::CaptureStdout();
+    std::cout << "before" << std::endl;
+    measureFunction("test function", 3, []() {});
+    measureObject("test object", 3, []() {});
+    std::cout << "after" << std::endl;
+    std::string out = ::testing::internal::GetCapturedStdout();
+
+    auto function = out.find("test function");
+    auto object   = out.find("test object");
+    ASSERT_NE(function, std::string::npos);
+    ASSERT_NE(object, std::string::npos);
+    EXPECT_LT(out.find("before"), function);
+    EXPECT_LT(function, object);
+    EXPECT_LT(object, out.find("after"));
+}
+
+TEST_F(AsyncLoggerTest, FlushFromSink)
+{
+    // The sink runs in the flush thread. A flush there must not wait for itself.
+    AsyncLogger::instance().setSink([](const std::string&) { AsyncLogger::instance().flush(); });
+    SAIGA_LOG(Info, "message");
+    AsyncLogger::instance().flush();
+}
+
+#ifdef SAIGA_ASSERTS
+TEST(AsyncLoggerDeathTest, AssertFlushesPendingRecords)
+{
+    ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+    EXPECT_DEATH(
+        {
+            AsyncLogger::instance().setSink([](const std::string& text) { std::fputs(text.c_str(), stderr); });
+            SAIGA_LOG(Error, "pending message");
+            SAIGA_ASSERT(false);
+        },
+        "pending message");
+}
+
+TEST(AsyncLoggerDeathTest, AssertInFlushThread)
+{
+    ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+    EXPECT_DEATH(
+        {
+            AsyncLogger::instance().setSink([](const std::string&) { SAIGA_ASSERT(false, "assert in sink"); });
+            SAIGA_LOG(Error, "message");
+            AsyncLogger::instance().flush();
+        },
+        "");
+}
+#endif
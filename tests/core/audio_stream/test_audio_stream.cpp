@@ -0,0 +1,180 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/math/random.h"
+#include "saiga/core/sound/AudioStream.h"
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <thread>
+
+using namespace Saiga;
+using namespace Saiga::sound;
+
+// Writes a wave file and returns the samples as they are expected after decoding.
+static std::vector<int16_t> writeWave(const std::string& file, int channels, int bitsPerSample, int frames)
+{
+    std::vector<int16_t> samples(size_t(frames) * channels);
+    for (auto& s : samples) s = int16_t(Random::uniformInt(-32768, 32767));
+
+    std::vector<char> data;
+    for (auto& s : samples)
+    {
+        if (bitsPerSample == 8)
+        {
+            // 8 bit samples are unsigned and only the upper byte is stored
+            unsigned char u = (unsigned char)((s >> 8) + 128);
+            data.push_back(char(u));
+            s = int16_t((int(u) - 128) * 256);
+        }
+        else
+        {
+            data.push_back(char(s & 0xFF));
+            data.push_back(char((s >> 8) & 0xFF));
+        }
+    }
+
+    RIFF_Header riff;
+    std::memcpy(riff.chunkID, "RIFF", 4);
+    riff.chunkSize = int(4 + sizeof(WAVE_Format) + sizeof(WAVE_Data) + data.size());
+    std::memcpy(riff.format, "WAVE", 4);
+
+    WAVE_Format format;
+    std::memcpy(format.subChunkID, "fmt ", 4);
+    format.subChunkSize  = 16;
+    format.audioFormat   = 1;
+    format.numChannels   = channels;
+    format.sampleRate    = 44100;
+    format.blockAlign    = channels * bitsPerSample / 8;
+    format.byteRate      = format.sampleRate * format.blockAlign;
+    format.bitsPerSample = bitsPerSample;
+
+    WAVE_Data header;
+    std::memcpy(header.subChunkID, "data", 4);
+    header.subChunk2Size = int(data.size());
+
+    std::ofstream strm(file, std::ios::binary);
+    strm.write((const char*)&riff, sizeof(riff));
+    strm.write((const char*)&format, sizeof(format));
+    strm.write((const char*)&header, sizeof(header));
+    strm.write(data.data(), data.size());
+    return samples;
+}
+
+static std::vector<int16_t> decodeFull(const std::string& file)
+{
+    WaveDecoder decoder;
+    EXPECT_TRUE(decoder.open(file));
+    std::vector<int16_t> result, chunk(1000 * decoder.channels);
+    while (int n = decoder.read(chunk.data(), 1000))
+    {
+        result.insert(result.end(), chunk.begin(), chunk.begin() + n * decoder.channels);
+    }
+    return result;
+}
+
+// Reads up to 'frames' frames in small pieces like an audio device.
+static std::vector<int16_t> readStream(AudioStream& stream, size_t frames)
+{
+    int c = stream.channels();
+    std::vector<int16_t> result(frames * c);
+    size_t done = 0;
+    while (done < frames && !stream.finished())
+    {
+        int n = stream.read(result.data() + done * c, int(std::min<size_t>(frames - done, 300)));
+        if (n == 0) std::this_thread::yield();
+        done += n;
+    }
+    result.resize(done * c);
+    return result;
+}
+
+// The parameters are (bits per sample, channels)
+class AudioStreamTest : public ::testing::TestWithParam<std::tuple<int, int>>
+{
+   protected:
+    void SetUp() override
+    {
+        Random::setSeed(5623);
+        auto [bits, channels] = GetParam();
+        auto name = "saiga_test_audio_stream_" + std::to_string(bits) + "_" + std::to_string(channels) + ".wav";
+        file      = (std::filesystem::temp_directory_path() / name).string();
+        expected  = writeWave(file, channels, bits, frames);
+    }
+
+    void TearDown() override { std::filesystem::remove(file); }
+
+    // Not a multiple of the chunk or period size
+    int frames = 10007;
+    int chunk  = 256;
+    std::string file;
+    std::vector<int16_t> expected;
+};
+
+TEST_P(AudioStreamTest, FullDecode)
+{
+    EXPECT_EQ(decodeFull(file), expected);
+}
+
+TEST_P(AudioStreamTest, NullAudioSink)
+{
+    auto stream = AudioStream::open(file, false, chunk);
+    ASSERT_TRUE(stream);
+    EXPECT_EQ(stream->channels(), std::get<1>(GetParam()));
+    EXPECT_EQ(stream->sampleRate(), 44100);
+
+    NullAudioSink sink;
+    sink.drain(*stream, 100);
+    EXPECT_TRUE(stream->finished());
+    EXPECT_EQ(sink.framesPlayed, frames);
+    EXPECT_EQ(sink.checksum, std::accumulate(expected.begin(), expected.end(), int64_t(0)));
+}
+
+TEST_P(AudioStreamTest, Samples)
+{
+    auto stream = AudioStream::open(file, false, chunk);
+    ASSERT_TRUE(stream);
+    EXPECT_EQ(readStream(*stream, 2 * frames), expected);
+    EXPECT_TRUE(stream->finished());
+}
+
+TEST_P(AudioStreamTest, CreateFromDecoder)
+{
+    auto decoder = openDecoder(file);
+    ASSERT_TRUE(decoder);
+    auto stream = AudioStream::create(std::move(decoder), false, chunk);
+    EXPECT_EQ(readStream(*stream, 2 * frames), expected);
+    EXPECT_TRUE(stream->finished());
+}
+
+TEST_P(AudioStreamTest, Loop)
+{
+    auto stream = AudioStream::open(file, true, chunk);
+    ASSERT_TRUE(stream);
+
+    // 3.5 times the file
+    size_t n    = frames * 7 / 2;
+    auto result = readStream(*stream, n);
+    ASSERT_EQ(result.size(), n * stream->channels());
+    EXPECT_FALSE(stream->finished());
+    for (size_t i = 0; i < result.size(); ++i)
+    {
+        ASSERT_EQ(result[i], expected[i % expected.size()]) << i;
+    }
+
+    // The sink never finishes a looping stream, so only single periods are pulled.
+    NullAudioSink sink;
+    for (int i = 0; i < 10; ++i) sink.pull(*stream, 100);
+    EXPECT_FALSE(stream->finished());
+}
+
+INSTANTIATE_TEST_SUITE_P(Wave, AudioStreamTest,
+                         ::testing::Values(std::make_tuple(8, 1), std::make_tuple(8, 2), std::make_tuple(16, 1),
+                                           std::make_tuple(16, 2)));
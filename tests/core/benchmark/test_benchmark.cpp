@@ -0,0 +1,145 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/time/Benchmark.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+
+using namespace Saiga;
+
+SAIGA_REGISTER_BENCHMARK(HarnessTest)
+{
+    std::vector<int> data(1000, 1);
+    volatile int sink = 0;
+    suite.run("sum", [&]() { sink = std::accumulate(data.begin(), data.end(), 0); }, data.size());
+    suite.run("fill", [&]() { std::fill(data.begin(), data.end(), sink); });
+}
+
+static int runMain(std::vector<std::string> args)
+{
+    args.insert(args.begin(), "test_benchmark");
+    args.push_back("--filter=HarnessTest");
+    args.push_back("--samples=3");
+    args.push_back("--minSampleTime=0.1");
+    std::vector<char*> argv;
+    for (auto& a : args) argv.push_back(a.data());
+    return BenchmarkSuite::main(argv.size(), argv.data());
+}
+
+class BenchmarkTest : public ::testing::Test
+{
+   protected:
+    void SetUp() override
+    {
+        dir = std::filesystem::temp_directory_path() / "saiga_test_benchmark";
+        std::filesystem::create_directories(dir);
+    }
+    void TearDown() override { std::filesystem::remove_all(dir); }
+
+    std::filesystem::path dir;
+};
+
+TEST(Benchmark, JsonRoundTrip)
+{
+    BenchmarkResult r;
+    r.name                = "Suite/case";
+    r.iterationsPerSample = 123;
+    r.samples             = 20;
+    r.outliers            = 2;
+    r.itemsPerIteration   = 1000;
+    r.median              = 12.5;
+    r.mad                 = 0.25;
+    r.cycles              = -1;
+
+    auto r2 = BenchmarkResult::fromJson(r.toJson());
+    EXPECT_EQ(r2.name, r.name);
+    EXPECT_EQ(r2.iterationsPerSample, r.iterationsPerSample);
+    EXPECT_EQ(r2.samples, r.samples);
+    EXPECT_EQ(r2.outliers, r.outliers);
+    EXPECT_EQ(r2.itemsPerIteration, r.itemsPerIteration);
+    EXPECT_EQ(r2.median, r.median);
+    EXPECT_EQ(r2.mad, r.mad);
+    EXPECT_EQ(r2.cycles, -1);
+}
+
+TEST_F(BenchmarkTest, Json)
+{
+    auto json = (dir / "results.json").string();
+    EXPECT_EQ(runMain({"--json=" + json}), 0);
+
+    auto results = BenchmarkSuite::loadJson(json);
+    ASSERT_EQ(results.size(), 2);
+    EXPECT_EQ(results[0].name, "HarnessTest/sum");
+    EXPECT_EQ(results[1].name, "HarnessTest/fill");
+    for (auto& r : results)
+    {
+        EXPECT_EQ(r.samples, 3);
+        EXPECT_GT(r.iterationsPerSample, 0);
+        EXPECT_GT(r.median, 0);
+        EXPECT_LE(r.min, r.median);
+        EXPECT_LE(r.median, r.max);
+    }
+    EXPECT_EQ(results[0].itemsPerIteration, 1000);
+}
+
+TEST_F(BenchmarkTest, JsonWriteError)
+{
+    auto json = (dir / "missing" / "results.json").string();
+    EXPECT_EQ(runMain({"--json=" + json}), -1);
+}
+
+TEST_F(BenchmarkTest, Baseline)
+{
+    // The baseline is much faster for 'sum' and much slower for 'fill'.
+    auto baseline = (dir / "baseline.json").string();
+    {
+        BenchmarkResult sum, fill;
+        sum.name    = "HarnessTest/sum";
+        sum.median  = 1e-6;
+        fill.name   = "HarnessTest/fill";
+        fill.median = 1e12;
+        std::ofstream strm(baseline);
+        strm << sum.toJson() << "\n" << fill.toJson() << "\n";
+    }
+
+    testing::internal::CaptureStdout();
+    int regressions = runMain({"--baseline=" + baseline});
+    auto output     = testing::internal::GetCapturedStdout();
+    EXPECT_EQ(regressions, 1);
+    EXPECT_NE(output.find("REGRESSION"), std::string::npos);
+    EXPECT_NE(output.find("faster"), std::string::npos);
+    EXPECT_NE(output.find("1 regression(s)"), std::string::npos);
+}
+
+TEST(Benchmark, CompareNoise)
+{
+    BenchmarkSuite suite;
+    BenchmarkResult r;
+    r.name   = "a";
+    r.median = 115;
+    r.mad    = 10;
+    suite.results.push_back(r);
+
+    // 15% slower, but within the noise of the measurement
+    BenchmarkResult base = r;
+    base.median          = 100;
+    testing::internal::CaptureStdout();
+    EXPECT_EQ(suite.compare({base}, 0.1), 0);
+
+    // Above the threshold and the noise
+    suite.results[0].mad = 1;
+    base.mad             = 1;
+    EXPECT_EQ(suite.compare({base}, 0.1), 1);
+
+    // Below the threshold
+    EXPECT_EQ(suite.compare({base}, 0.2), 0);
+    testing::internal::GetCapturedStdout();
+}
@@ -0,0 +1,281 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/math/random.h"
+#include "saiga/core/util/MemoryMappedFile.h"
+#include "saiga/core/util/TextParser.h"
+#include "saiga/core/util/TextWriter.h"
+#include "saiga/core/util/tostring.h"
+
+#include "gtest/gtest.h"
+
+#include <clocale>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+using namespace Saiga;
+
+template <typename T>
+static std::string format(T v)
+{
+    char buffer[32];
+    char* last = formatNumber(buffer, buffer + sizeof(buffer), v);
+    return std::string(buffer, last);
+}
+
+template <typename T>
+static std::string formatClassic(T v)
+{
+    char buffer[32];
+    char* last = Detail::formatNumberClassic(buffer, buffer + sizeof(buffer), v);
+    return std::string(buffer, last);
+}
+
+// The number of significant digits. Leading and trailing zeros are not counted.
+static int significantDigits(const std::string& str)
+{
+    std::string digits;
+    for (char c : str.substr(0, str.find('e')))
+        if (c >= '0' && c <= '9') digits += c;
+    auto first = digits.find_first_not_of('0');
+    if (first == std::string::npos) return 0;
+    return int(digits.find_last_not_of('0') - first + 1);
+}
+
+template <typename T>
+static bool sameBits(T a, T b)
+{
+    return std::memcmp(&a, &b, sizeof(T)) == 0;
+}
+
+// Random values over the complete exponent range and some special values.
+template <typename T>
+static std::vector<T> testValues()
+{
+    using L = std::numeric_limits<T>;
+    std::vector<T> values = {T(0),        -T(0),       T(1),         T(-1),       T(0.1),      T(1) / 3,
+                             T(1e-5),     T(123456),   L::max(),     L::lowest(), L::min(),    L::denorm_min(),
+                             L::epsilon(), T(0.3),     T(2.5e-7),    T(1e20),     T(-7.125)};
+    Random::setSeed(9234);
+    for (int i = 0; i < 5000; ++i)
+    {
+        T mantissa = T(Random::sampleDouble(-1, 1));
+        int e      = Random::uniformInt(L::min_exponent, L::max_exponent - 1);
+        values.push_back(std::ldexp(mantissa, e));
+    }
+    return values;
+}
+
+TEST(NumberIO, ParseInteger)
+{
+    int i = 7;
+    EXPECT_EQ(parseNumber("  -123 4", i), 6);
+    EXPECT_EQ(i, -123);
+    EXPECT_EQ(parseNumber("+42", i), 3);
+    EXPECT_EQ(i, 42);
+    EXPECT_EQ(parseNumber("12abc", i), 2);
+    EXPECT_EQ(i, 12);
+
+    // Failures leave the value unchanged
+    EXPECT_EQ(parseNumber("abc", i), 0);
+    EXPECT_EQ(parseNumber("", i), 0);
+    EXPECT_EQ(parseNumber("   ", i), 0);
+    EXPECT_EQ(parseNumber("99999999999", i), 0);
+    EXPECT_EQ(i, 12);
+
+    unsigned long long u;
+    EXPECT_EQ(parseNumber("18446744073709551615", u), 20);
+    EXPECT_EQ(u, std::numeric_limits<unsigned long long>::max());
+
+    EXPECT_EQ(to_int(" 17"), 17);
+    EXPECT_EQ(to_long("-3000000000"), -3000000000L);
+}
+
+TEST(NumberIO, ParseFloat)
+{
+    double d = 5;
+    EXPECT_EQ(parseNumber(" 1.5e3,", d), 6);
+    EXPECT_EQ(d, 1500);
+    EXPECT_EQ(parseNumber("+.25", d), 4);
+    EXPECT_EQ(d, 0.25);
+    EXPECT_EQ(parseNumber("-2", d), 2);
+    EXPECT_EQ(d, -2);
+    EXPECT_EQ(parseNumber("x", d), 0);
+    EXPECT_EQ(d, -2);
+
+    // Files written with the old scientific format
+    EXPECT_EQ(to_double("1.00000000000000005551e-01"), 0.1);
+    EXPECT_EQ(to_float("3.25"), 3.25f);
+}
+
+TEST(NumberIO, FormatInteger)
+{
+    EXPECT_EQ(format(0), "0");
+    EXPECT_EQ(format(-17), "-17");
+    EXPECT_EQ(format(std::numeric_limits<long long>::min()), "-9223372036854775808");
+    EXPECT_EQ(format(std::numeric_limits<unsigned long long>::max()), "18446744073709551615");
+}
+
+TEST(NumberIO, FormatShortest)
+{
+    EXPECT_EQ(format(0.1), "0.1");
+    EXPECT_EQ(format(1.0), "1");
+    EXPECT_EQ(format(-7.125), "-7.125");
+    EXPECT_EQ(format(0.1f), "0.1");
+    EXPECT_EQ(format(1.0 / 3), "0.3333333333333333");
+}
+
+template <typename T>
+class NumberRoundTrip : public ::testing::Test
+{
+};
+using FloatTypes = ::testing::Types<float, double>;
+TYPED_TEST_SUITE(NumberRoundTrip, FloatTypes);
+
+TYPED_TEST(NumberRoundTrip, FormatParse)
+{
+    for (TypeParam v : testValues<TypeParam>())
+    {
+        auto str = format(v);
+        ASSERT_LE(str.size(), 32);
+        TypeParam r;
+        ASSERT_EQ(parseNumber(str, r), str.size()) << str;
+        ASSERT_TRUE(sameBits(r, v)) << str;
+    }
+}
+
+// The fallback for standard libraries without floating point charconv.
+TYPED_TEST(NumberRoundTrip, Classic)
+{
+    for (TypeParam v : testValues<TypeParam>())
+    {
+        auto str = formatClassic(v);
+        TypeParam r;
+        ASSERT_EQ(Detail::parseNumberClassic(str.data(), str.data() + str.size(), r), str.size()) << str;
+        ASSERT_TRUE(sameBits(r, v)) << str;
+
+        // At most one digit longer than the shortest representation
+        ASSERT_LE(significantDigits(str), significantDigits(format(v)) + 1) << str << " " << format(v);
+    }
+
+    TypeParam r = 3;
+    EXPECT_EQ(Detail::parseNumberClassic("+1", "+1" + 2, r), 0);
+    EXPECT_EQ(Detail::parseNumberClassic(" 1", " 1" + 2, r), 0);
+    EXPECT_EQ(Detail::parseNumberClassic("1.5 2", "1.5 2" + 5, r), 3);
+    EXPECT_EQ(r, TypeParam(1.5));
+}
+
+// The number format must not depend on the global locale.
+TEST(NumberIO, Locale)
+{
+    const char* locales[] = {"de_DE.UTF-8", "de_DE.utf8", "de_DE", "fr_FR.UTF-8", "fr_FR.utf8", "German"};
+    bool found            = false;
+    for (auto l : locales)
+    {
+        if (std::setlocale(LC_NUMERIC, l))
+        {
+            found = true;
+            break;
+        }
+    }
+    if (!found) GTEST_SKIP() << "No locale with a decimal comma installed.";
+
+    EXPECT_EQ(formatClassic(2.5), "2.5");
+    EXPECT_EQ(format(2.5), "2.5");
+    double d = 0;
+    EXPECT_EQ(Detail::parseNumberClassic("2.5", "2.5" + 3, d), 3);
+    EXPECT_EQ(d, 2.5);
+    EXPECT_EQ(to_double("0.75"), 0.75);
+    std::setlocale(LC_NUMERIC, "C");
+}
+
+TEST(TextParser, Parse)
+{
+    std::string text =
+        "# comment\n"
+        "  # indented comment\r\n"
+        "3 -1.5 1e-3\tname 1\r\n"
+        "the rest of the line\r\n"
+        "last";
+    TextParser parser{std::string_view(text)};
+    parser.skipComments();
+
+    int i;
+    double a, b;
+    std::string name;
+    bool flag;
+    parser >> i >> a >> b >> name >> flag;
+    EXPECT_TRUE(parser.ok());
+    EXPECT_EQ(i, 3);
+    EXPECT_EQ(a, -1.5);
+    EXPECT_EQ(b, 1e-3);
+    EXPECT_EQ(name, "name");
+    EXPECT_TRUE(flag);
+
+    // line() returns the rest of the current line
+    EXPECT_EQ(parser.line(), "");
+    EXPECT_EQ(parser.line(), "the rest of the line");
+    EXPECT_FALSE(parser.atEnd());
+    EXPECT_EQ(parser.word(), "last");
+    EXPECT_TRUE(parser.atEnd());
+    EXPECT_EQ(parser.word(), "");
+    EXPECT_TRUE(parser.ok());
+}
+
+TEST(TextParser, Failure)
+{
+    TextParser parser(std::string_view("1 2 x 4"));
+    int v[4] = {0, 0, -1, 0};
+    EXPECT_FALSE(parser.parseArray(v, 4));
+    EXPECT_FALSE(parser.ok());
+    EXPECT_EQ(v[0], 1);
+    EXPECT_EQ(v[1], 2);
+    EXPECT_EQ(v[2], -1);
+
+    TextParser empty(std::string_view("  \n"));
+    double d = 4;
+    empty >> d;
+    EXPECT_FALSE(empty.ok());
+    EXPECT_EQ(d, 4);
+}
+
+TEST(TextParser, WriterRoundTrip)
+{
+    std::string file = "test_number_io.txt";
+    auto doubles     = testValues<double>();
+    auto floats      = testValues<float>();
+    {
+        TextWriter strm(file);
+        ASSERT_TRUE(strm.isOpen());
+        strm << "# header\n";
+        strm << int(doubles.size()) << " " << -5 << " " << true << "\n";
+        strm.writeArray(doubles.data(), doubles.size()) << "\n";
+        strm.writeArray(floats.data(), floats.size(), '\n') << "\n";
+        ASSERT_TRUE(strm.close());
+    }
+
+    MemoryMappedFile mmf(file);
+    ASSERT_TRUE(mmf.isOpen());
+    TextParser parser(mmf.view<char>());
+    parser.skipComments();
+    int n, m;
+    bool flag;
+    parser >> n >> m >> flag;
+    EXPECT_EQ(n, doubles.size());
+    EXPECT_EQ(m, -5);
+    EXPECT_TRUE(flag);
+
+    std::vector<double> d(doubles.size());
+    std::vector<float> f(floats.size());
+    EXPECT_TRUE(parser.parseArray(d.data(), d.size()));
+    EXPECT_TRUE(parser.parseArray(f.data(), f.size()));
+    EXPECT_TRUE(parser.atEnd());
+    for (size_t i = 0; i < d.size(); ++i) EXPECT_TRUE(sameBits(d[i], doubles[i])) << i;
+    for (size_t i = 0; i < f.size(); ++i) EXPECT_TRUE(sameBits(f[i], floats[i])) << i;
+    std::remove(file.c_str());
+}
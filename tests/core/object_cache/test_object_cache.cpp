@@ -0,0 +1,143 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/util/DataStructures/ObjectCache.h"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using namespace Saiga;
+
+// Puts all keys into the same shard, so that the LRU order is deterministic.
+struct SingleShardHash
+{
+    size_t operator()(int) const { return 0; }
+};
+
+TEST(ObjectCache, PutGetErase)
+{
+    ObjectCache<std::string, int> cache;
+    int v = 0;
+    EXPECT_FALSE(cache.get("a", v));
+
+    cache.put("a", 1);
+    cache.put("b", 2);
+    EXPECT_TRUE(cache.get("a", v));
+    EXPECT_EQ(v, 1);
+    EXPECT_TRUE(cache.exists("b"));
+    EXPECT_EQ(cache.size(), 2);
+
+    // Replace
+    cache.put("a", 3);
+    EXPECT_TRUE(cache.get("a", v));
+    EXPECT_EQ(v, 3);
+    EXPECT_EQ(cache.size(), 2);
+
+    EXPECT_TRUE(cache.erase("a"));
+    EXPECT_FALSE(cache.erase("a"));
+    EXPECT_FALSE(cache.exists("a"));
+    EXPECT_EQ(cache.size(), 1);
+
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0);
+    EXPECT_EQ(cache.bytes(), 0);
+}
+
+TEST(ObjectCache, Params)
+{
+    ObjectCache<std::string, int, int> cache;
+    cache.put("a", 10, 0);
+    cache.put("a", 11, 1);
+    int v = 0;
+    EXPECT_TRUE(cache.get("a", v, 1));
+    EXPECT_EQ(v, 11);
+    EXPECT_TRUE(cache.get("a", v, 0));
+    EXPECT_EQ(v, 10);
+    EXPECT_FALSE(cache.exists("a", 2));
+
+    EXPECT_TRUE(cache.erase("a", 0));
+    EXPECT_FALSE(cache.exists("a", 0));
+    EXPECT_TRUE(cache.exists("a", 1));
+
+    int count = 0;
+    cache.forEach([&](const std::string& key, int params, int data) {
+        EXPECT_EQ(key, "a");
+        EXPECT_EQ(params, 1);
+        EXPECT_EQ(data, 11);
+        count++;
+    });
+    EXPECT_EQ(count, 1);
+}
+
+TEST(ObjectCache, LRUEviction)
+{
+    // Each entry has the size of its value. The single shard gets 1/numShards of the budget.
+    using Cache = ObjectCache<int, size_t, NoParams, SingleShardHash>;
+    Cache cache(Cache::numShards * 10, [](size_t bytes) { return bytes; });
+
+    cache.put(1, 3);
+    cache.put(2, 3);
+    cache.put(3, 3);
+    EXPECT_EQ(cache.bytes(), 9);
+
+    // 1 is used, so 2 is the least recently used entry.
+    size_t v;
+    EXPECT_TRUE(cache.get(1, v));
+    cache.put(4, 3);
+    EXPECT_TRUE(cache.exists(1));
+    EXPECT_FALSE(cache.exists(2));
+    EXPECT_TRUE(cache.exists(3));
+    EXPECT_TRUE(cache.exists(4));
+    EXPECT_EQ(cache.bytes(), 9);
+    EXPECT_EQ(cache.numEvictions(), 1);
+
+    // An entry larger than the budget is kept alone.
+    cache.put(5, 20);
+    EXPECT_EQ(cache.size(), 1);
+    EXPECT_TRUE(cache.exists(5));
+    EXPECT_EQ(cache.numEvictions(), 4);
+}
+
+TEST(ObjectCache, GetOrLoadOnce)
+{
+    ObjectCache<int, int> cache;
+    std::atomic<int> loads = 0;
+    auto loader            = [&]() {
+        loads++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        return 42;
+    };
+
+    std::vector<std::thread> threads;
+    std::atomic<int> wrong = 0;
+    for (int i = 0; i < 8; ++i)
+    {
+        threads.emplace_back([&]() {
+            if (cache.getOrLoad(7, loader) != 42) wrong++;
+        });
+    }
+    for (auto& t : threads) t.join();
+
+    EXPECT_EQ(loads, 1);
+    EXPECT_EQ(wrong, 0);
+    EXPECT_EQ(cache.getOrLoad(7, loader), 42);
+    EXPECT_EQ(loads, 1);
+}
+
+TEST(ObjectCache, GetOrLoadException)
+{
+    ObjectCache<int, int> cache;
+    EXPECT_THROW(cache.getOrLoad(1, []() -> int { throw std::runtime_error("load failed"); }), std::runtime_error);
+    EXPECT_FALSE(cache.exists(1));
+
+    // The failed load is not remembered.
+    EXPECT_EQ(cache.getOrLoad(1, []() { return 5; }), 5);
+    EXPECT_TRUE(cache.exists(1));
+}
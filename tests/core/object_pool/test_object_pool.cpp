@@ -0,0 +1,164 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/util/Thread/ObjectPool.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace Saiga;
+
+// Counts the live instances to check that every constructor is matched by a destructor.
+struct Counted
+{
+    static inline std::atomic<int> alive = 0;
+    int value;
+
+    Counted(int value) : value(value) { alive++; }
+    ~Counted() { alive--; }
+};
+
+TEST(ObjectPool, CreateGetDestroy)
+{
+    ObjectPool<Counted> pool(4);
+    PoolHandle h = pool.create(5);
+    ASSERT_TRUE(h.valid());
+    ASSERT_NE(pool.get(h), nullptr);
+    EXPECT_EQ(pool[h].value, 5);
+    EXPECT_EQ(pool.size(), 1);
+    EXPECT_EQ(Counted::alive, 1);
+
+    EXPECT_TRUE(pool.destroy(h));
+    EXPECT_EQ(pool.get(h), nullptr);
+    EXPECT_EQ(pool.size(), 0);
+    EXPECT_EQ(Counted::alive, 0);
+
+    // Double free and invalid handles are detected
+    EXPECT_FALSE(pool.destroy(h));
+    EXPECT_FALSE(pool.destroy(PoolHandle()));
+    EXPECT_EQ(pool.get(PoolHandle()), nullptr);
+    EXPECT_EQ(pool.get({1000, 1}), nullptr);
+}
+
+TEST(ObjectPool, StaleHandleAfterReuse)
+{
+    ObjectPool<Counted> pool(1);
+    PoolHandle a = pool.create(1);
+    pool.destroy(a);
+
+    // The slot is reused, but the old handle does not match the new generation.
+    PoolHandle b = pool.create(2);
+    EXPECT_EQ(a.index, b.index);
+    EXPECT_NE(a, b);
+    EXPECT_EQ(pool.get(a), nullptr);
+    EXPECT_FALSE(pool.destroy(a));
+    EXPECT_EQ(pool[b].value, 2);
+    pool.destroy(b);
+}
+
+TEST(ObjectPool, GrowKeepsAddresses)
+{
+    ObjectPool<Counted> pool(4);
+    std::vector<PoolHandle> handles;
+    std::vector<Counted*> ptrs;
+    for (int i = 0; i < 100; ++i)
+    {
+        handles.push_back(pool.create(i));
+        ptrs.push_back(pool.get(handles.back()));
+    }
+    EXPECT_EQ(pool.size(), 100);
+    EXPECT_EQ(pool.capacity(), 100);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_EQ(pool.get(handles[i]), ptrs[i]);
+        EXPECT_EQ(ptrs[i]->value, i);
+    }
+
+    // forEach visits exactly the live objects
+    for (int i = 0; i < 100; i += 2) pool.destroy(handles[i]);
+    std::vector<int> visited;
+    pool.forEach([&](PoolHandle h, Counted& c) {
+        EXPECT_EQ(pool.get(h), &c);
+        visited.push_back(c.value);
+    });
+    std::sort(visited.begin(), visited.end());
+    ASSERT_EQ(visited.size(), 50);
+    for (int i = 0; i < 50; ++i) EXPECT_EQ(visited[i], 2 * i + 1);
+
+    pool.clear();
+    EXPECT_EQ(pool.size(), 0);
+    EXPECT_EQ(Counted::alive, 0);
+    EXPECT_EQ(pool.get(handles[1]), nullptr);
+}
+
+TEST(ObjectPool, DestructorDestroysObjects)
+{
+    {
+        ObjectPool<Counted> pool(8);
+        for (int i = 0; i < 20; ++i) pool.create(i);
+        EXPECT_EQ(Counted::alive, 20);
+    }
+    EXPECT_EQ(Counted::alive, 0);
+}
+
+TEST(ObjectPool, Concurrent)
+{
+    ObjectPool<Counted> pool(64);
+    int numThreads = 8;
+    int n          = 20000;
+
+    // Each thread creates and destroys objects and keeps every 10th object alive.
+    std::vector<std::vector<PoolHandle>> kept(numThreads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t)
+    {
+        threads.emplace_back([&, t]() {
+            std::vector<PoolHandle> live;
+            for (int i = 0; i < n; ++i)
+            {
+                int value = t * n + i;
+                live.push_back(pool.create(value));
+                if (pool[live.back()].value != value) ADD_FAILURE();
+                if (live.size() > 5)
+                {
+                    PoolHandle h = live.front();
+                    live.erase(live.begin());
+                    if (i % 10 == 0)
+                        kept[t].push_back(h);
+                    else if (!pool.destroy(h))
+                        ADD_FAILURE();
+                }
+            }
+            for (auto h : live) pool.destroy(h);
+        });
+    }
+    for (auto& t : threads) t.join();
+
+    // All kept objects are still alive, unchanged and in different slots.
+    std::set<uint32_t> indices;
+    size_t total = 0;
+    for (int t = 0; t < numThreads; ++t)
+    {
+        for (auto h : kept[t])
+        {
+            ASSERT_NE(pool.get(h), nullptr);
+            EXPECT_EQ(pool[h].value / n, t);
+            indices.insert(h.index);
+        }
+        total += kept[t].size();
+    }
+    EXPECT_EQ(indices.size(), total);
+    EXPECT_EQ(pool.size(), total);
+    EXPECT_EQ(size_t(Counted::alive), total);
+
+    pool.clear();
+    EXPECT_EQ(Counted::alive, 0);
+}
@@ -0,0 +1,158 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/math/random.h"
+#include "saiga/core/util/ParallelPrimitives.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <numeric>
+
+using namespace Saiga;
+
+// One size below and two above CPU::serialThreshold, so the serial and the parallel paths are tested. Four threads
+// are used even on a single core machine to test the chunking.
+class ParallelPrimitives : public ::testing::TestWithParam<int>
+{
+   protected:
+    void SetUp() override
+    {
+        OMP::setNumThreads(4);
+        Random::setSeed(GetParam());
+    }
+
+    std::vector<int> randomInts(int n, int min, int max)
+    {
+        std::vector<int> v(n);
+        for (auto& x : v) x = Random::uniformInt(min, max);
+        return v;
+    }
+};
+
+TEST_P(ParallelPrimitives, Reduce)
+{
+    auto in = randomInts(GetParam(), -100, 100);
+    EXPECT_EQ(CPU::reduce<int>(in), std::accumulate(in.begin(), in.end(), 0));
+    EXPECT_EQ(CPU::reduce<int>(in, 17), std::accumulate(in.begin(), in.end(), 17));
+}
+
+TEST_P(ParallelPrimitives, SegmentedReduce)
+{
+    auto values = randomInts(GetParam(), -100, 100);
+    std::vector<int> offsets = {0};
+    while (offsets.back() < (int)values.size())
+    {
+        // Includes empty segments
+        offsets.push_back(std::min<int>(offsets.back() + Random::uniformInt(0, 20), values.size()));
+    }
+    std::vector<int> out(offsets.size() - 1);
+    CPU::segmentedReduce<int>(values, offsets, out, 0);
+    for (size_t s = 0; s < out.size(); ++s)
+    {
+        EXPECT_EQ(out[s], std::accumulate(values.begin() + offsets[s], values.begin() + offsets[s + 1], 0));
+    }
+
+    CPU::segmentedReduce<int>(values, offsets, out, std::numeric_limits<int>::min(),
+                              [](int a, int b) { return std::max(a, b); });
+    for (size_t s = 0; s < out.size(); ++s)
+    {
+        int ref = std::numeric_limits<int>::min();
+        for (int i = offsets[s]; i < offsets[s + 1]; ++i) ref = std::max(ref, values[i]);
+        EXPECT_EQ(out[s], ref);
+    }
+}
+
+TEST_P(ParallelPrimitives, Scan)
+{
+    auto in = randomInts(GetParam(), 0, 10);
+    std::vector<int> ref(in.size()), out(in.size());
+
+    std::exclusive_scan(in.begin(), in.end(), ref.begin(), 5);
+    int total = CPU::exclusiveScan<int>(in, out, 5);
+    EXPECT_EQ(out, ref);
+    EXPECT_EQ(total, std::accumulate(in.begin(), in.end(), 5));
+
+    std::inclusive_scan(in.begin(), in.end(), ref.begin());
+    total = CPU::inclusiveScan<int>(in, out);
+    EXPECT_EQ(out, ref);
+    EXPECT_EQ(total, std::accumulate(in.begin(), in.end(), 0));
+
+    // Inplace
+    std::exclusive_scan(in.begin(), in.end(), ref.begin(), 0);
+    CPU::exclusiveScan<int>(in, in);
+    EXPECT_EQ(in, ref);
+}
+
+TEST_P(ParallelPrimitives, Compact)
+{
+    auto in   = randomInts(GetParam(), 0, 10);
+    auto pred = [](int x) { return x > 6; };
+    std::vector<int> ref, out(in.size());
+    std::copy_if(in.begin(), in.end(), std::back_inserter(ref), pred);
+
+    size_t n = CPU::compact<int>(in, out, pred);
+    ASSERT_EQ(n, ref.size());
+    out.resize(n);
+    EXPECT_EQ(out, ref);
+}
+
+TEST_P(ParallelPrimitives, Histogram)
+{
+    // Includes values outside of the bins
+    auto in = randomInts(GetParam(), -5, 70);
+    std::vector<int> bins(64, 123), ref(64, 0);
+    for (auto x : in)
+        if (x >= 0 && x < 64) ref[x]++;
+    CPU::histogram<int>(in, bins);
+    EXPECT_EQ(bins, ref);
+
+    // Unsigned values and more bins than uint8_t can index
+    std::vector<uint8_t> in8(in.size());
+    for (size_t i = 0; i < in.size(); ++i) in8[i] = uint8_t(in[i] + 200);
+    std::vector<int> bins8(300, 123), ref8(300, 0);
+    for (auto x : in8) ref8[x]++;
+    CPU::histogram<uint8_t>(in8, bins8);
+    EXPECT_EQ(bins8, ref8);
+
+    std::vector<uint32_t> in32(in.begin(), in.end());
+    std::fill(bins.begin(), bins.end(), 123);
+    CPU::histogram<uint32_t>(in32, bins);
+    EXPECT_EQ(bins, ref);
+}
+
+TEST_P(ParallelPrimitives, RadixSort)
+{
+    int n = GetParam();
+    std::vector<uint32_t> keys(n);
+    for (auto& k : keys) k = Random::uniformInt(0, std::numeric_limits<int>::max());
+    auto ref = keys;
+    std::sort(ref.begin(), ref.end());
+    CPU::radixSort<uint32_t>(keys);
+    EXPECT_EQ(keys, ref);
+
+    // Few distinct keys and 64 bit keys with skipped passes. The values are the original positions, so the order of
+    // equal keys shows if the sort is stable.
+    std::vector<uint64_t> keys64(n);
+    std::vector<int> values(n);
+    for (int i = 0; i < n; ++i)
+    {
+        keys64[i] = uint64_t(Random::uniformInt(0, 20)) << 40;
+        values[i] = i;
+    }
+    std::vector<std::pair<uint64_t, int>> pairs;
+    for (int i = 0; i < n; ++i) pairs.emplace_back(keys64[i], values[i]);
+    std::stable_sort(pairs.begin(), pairs.end(), [](auto& a, auto& b) { return a.first < b.first; });
+
+    CPU::radixSortByKey<uint64_t, int>(keys64, values);
+    for (int i = 0; i < n; ++i)
+    {
+        EXPECT_EQ(keys64[i], pairs[i].first);
+        EXPECT_EQ(values[i], pairs[i].second);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Sizes, ParallelPrimitives, ::testing::Values(1000, 100003, 1 << 20));
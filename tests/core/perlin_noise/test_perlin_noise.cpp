@@ -0,0 +1,114 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/math/random.h"
+#include "saiga/core/util/perlinnoise.h"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace Saiga;
+
+// The batched float functions must match the double precision functions up to float rounding.
+// n is not a multiple of the batch size, so the remainder is tested as well.
+class PerlinNoiseTest : public ::testing::TestWithParam<float>
+{
+   protected:
+    void SetUp() override
+    {
+        Random::setSeed(7345);
+        range = GetParam();
+        for (int i = 0; i < n; ++i)
+        {
+            x.push_back(Random::sampleDouble(-range, range));
+            y.push_back(Random::sampleDouble(-range, range));
+            z.push_back(Random::sampleDouble(-range, range));
+        }
+    }
+
+    int n = 16 * 64 + 7;
+    float range;
+    std::vector<float> x, y, z;
+    PerlinNoise noise = PerlinNoise(1234);
+};
+
+TEST_P(PerlinNoiseTest, Noise)
+{
+    std::vector<float> out(n);
+    noise.noise(x.data(), y.data(), z.data(), out.data(), n);
+    for (int i = 0; i < n; ++i)
+    {
+        EXPECT_NEAR(out[i], noise.noise(x[i], y[i], z[i]), 1e-5) << x[i] << " " << y[i] << " " << z[i];
+    }
+}
+
+TEST_P(PerlinNoiseTest, FBm)
+{
+    for (int octaves : {1, 4, 8})
+    {
+        for (float lacunarity : {2.0f, 1.9f})
+        {
+            // The scaled coordinates are rounded to float, so the error grows with the highest frequency.
+            double tolerance = 1e-5 + 2e-8 * range * std::pow(lacunarity, octaves - 1);
+
+            std::vector<float> out(n);
+            noise.fBm(x.data(), y.data(), z.data(), out.data(), n, octaves, lacunarity, 0.6);
+            for (int i = 0; i < n; ++i)
+            {
+                EXPECT_NEAR(out[i], noise.fBm(x[i], y[i], z[i], octaves, lacunarity, 0.6), tolerance)
+                    << x[i] << " " << y[i] << " " << z[i] << " octaves " << octaves;
+            }
+        }
+    }
+}
+
+TEST_P(PerlinNoiseTest, FBmField)
+{
+    int h = 37, w = 53;
+    std::vector<float> data(h * w);
+    ImageView<float> img(h, w, data.data());
+    vec2 origin(x[0], y[0]);
+    vec2 step(0.013, 0.007);
+    noise.fBmField(img, origin, step, z[0], 6);
+
+    double tolerance = 1e-5 + 2e-8 * range * std::pow(2, 5);
+    for (int r = 0; r < h; ++r)
+    {
+        for (int c = 0; c < w; ++c)
+        {
+            float px = origin.x() + c * step.x();
+            float py = origin.y() + r * step.y();
+            EXPECT_NEAR(img(r, c), noise.fBm(px, py, z[0], 6), tolerance) << r << " " << c;
+        }
+    }
+}
+
+TEST_P(PerlinNoiseTest, FBmVolume)
+{
+    ivec3 size(19, 5, 3);
+    vec3 origin(x[0], y[0], z[0]);
+    vec3 step(0.05, 0.1, 0.2);
+    std::vector<float> out(size.x() * size.y() * size.z());
+    noise.fBmVolume(out.data(), size, origin, step, 4);
+
+    double tolerance = 1e-5 + 2e-8 * range * std::pow(2, 3);
+    for (int k = 0; k < size.z(); ++k)
+    {
+        for (int j = 0; j < size.y(); ++j)
+        {
+            for (int i = 0; i < size.x(); ++i)
+            {
+                vec3 p = origin + vec3(i, j, k).cwiseProduct(step);
+                EXPECT_NEAR(out[(k * size.y() + j) * size.x() + i], noise.fBm(p.x(), p.y(), p.z(), 4), tolerance)
+                    << i << " " << j << " " << k;
+            }
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Range, PerlinNoiseTest, ::testing::Values(1.0f, 100.0f, 1000.0f));
@@ -0,0 +1,313 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/geometry/QuadricDecimation.h"
+#include "saiga/core/geometry/vertex.h"
+
+#include "gtest/gtest.h"
+
+#include <array>
+#include <map>
+#include <set>
+#include <tuple>
+
+using namespace Saiga;
+
+using TestMesh = TriangleMesh<VertexNC, uint32_t>;
+
+static void addVertex(TestMesh& mesh, const vec3& p)
+{
+    VertexNC v;
+    v.position = make_vec4(p, 1);
+    mesh.vertices.push_back(v);
+}
+
+// Closed torus in the xz-plane. Genus 1.
+static TestMesh makeTorus(int U, int V, float R, float r)
+{
+    TestMesh mesh;
+    for (int i = 0; i < U; ++i)
+    {
+        for (int j = 0; j < V; ++j)
+        {
+            float u = 2 * pi<float>() * i / U;
+            float v = 2 * pi<float>() * j / V;
+            addVertex(mesh, vec3((R + r * cos(v)) * cos(u), r * sin(v), (R + r * cos(v)) * sin(u)));
+        }
+    }
+    auto idx = [&](int i, int j) { return uint32_t((i % U) * V + (j % V)); };
+    for (int i = 0; i < U; ++i)
+    {
+        for (int j = 0; j < V; ++j)
+        {
+            mesh.faces.push_back({idx(i, j), idx(i, j + 1), idx(i + 1, j)});
+            mesh.faces.push_back({idx(i + 1, j), idx(i, j + 1), idx(i + 1, j + 1)});
+        }
+    }
+    return mesh;
+}
+
+// The cube [-1,1]^3 with S x S quads on each side. The cube edges and corners are sharp features.
+static TestMesh makeBox(int S)
+{
+    TestMesh mesh;
+    std::map<std::tuple<int, int, int>, uint32_t> index;
+    auto vertex = [&](const ivec3& p) {
+        auto key = std::make_tuple(p.x(), p.y(), p.z());
+        auto it  = index.find(key);
+        if (it != index.end()) return it->second;
+        uint32_t id = mesh.vertices.size();
+        addVertex(mesh, p.cast<float>() * (2.0f / S) - vec3(1, 1, 1));
+        index[key] = id;
+        return id;
+    };
+
+    // origin, u, v with u x v = outward normal
+    ivec3 X(1, 0, 0), Y(0, 1, 0), Z(0, 0, 1), O(0, 0, 0);
+    std::vector<std::array<ivec3, 3>> sides = {{X * S, Y, Z}, {O, Z, Y}, {Y * S, Z, X},
+                                               {O, X, Z},     {Z * S, X, Y}, {O, Y, X}};
+    for (auto& s : sides)
+    {
+        for (int i = 0; i < S; ++i)
+        {
+            for (int j = 0; j < S; ++j)
+            {
+                uint32_t a = vertex(s[0] + s[1] * i + s[2] * j);
+                uint32_t b = vertex(s[0] + s[1] * (i + 1) + s[2] * j);
+                uint32_t c = vertex(s[0] + s[1] * i + s[2] * (j + 1));
+                uint32_t d = vertex(s[0] + s[1] * (i + 1) + s[2] * (j + 1));
+                mesh.faces.push_back({a, b, d});
+                mesh.faces.push_back({a, d, c});
+            }
+        }
+    }
+    return mesh;
+}
+
+// Open height field in the xz-plane with a bump in the center.
+static TestMesh makePatch(int N)
+{
+    TestMesh mesh;
+    for (int y = 0; y < N; ++y)
+    {
+        for (int x = 0; x < N; ++x)
+        {
+            float dx = x - N / 2.0f, dy = y - N / 2.0f;
+            addVertex(mesh, vec3(x, 4 * exp(-(dx * dx + dy * dy) / (N * 2.0f)), y));
+        }
+    }
+    for (int y = 0; y < N - 1; ++y)
+    {
+        for (int x = 0; x < N - 1; ++x)
+        {
+            uint32_t a = y * N + x, b = a + 1, c = a + N, d = c + 1;
+            mesh.faces.push_back({a, c, b});
+            mesh.faces.push_back({b, c, d});
+        }
+    }
+    return mesh;
+}
+
+struct Topology
+{
+    bool manifold = true;
+    int vertices = 0, edges = 0, faces = 0;
+    // Undirected edges with only one face
+    std::set<std::pair<uint32_t, uint32_t>> boundaryEdges;
+
+    int euler() const { return vertices - edges + faces; }
+};
+
+// Edge and vertex manifoldness of an indexed face set. All vertices must be referenced.
+static Topology topology(const TestMesh& mesh)
+{
+    Topology t;
+    t.vertices = mesh.vertices.size();
+    t.faces    = mesh.faces.size();
+
+    std::set<std::pair<uint32_t, uint32_t>> directed;
+    // For every vertex v: the face (v,a,b) links a -> b
+    std::vector<std::map<uint32_t, uint32_t>> rings(mesh.vertices.size());
+    for (auto& f : mesh.faces)
+    {
+        uint32_t v[3] = {f.v1, f.v2, f.v3};
+        if (v[0] == v[1] || v[1] == v[2] || v[0] == v[2]) t.manifold = false;
+        for (int k = 0; k < 3; ++k)
+        {
+            uint32_t a = v[k], b = v[(k + 1) % 3], c = v[(k + 2) % 3];
+            // The same directed edge twice is either a non-manifold edge or an inconsistent orientation
+            if (!directed.insert({a, b}).second) t.manifold = false;
+            if (!rings[a].insert({b, c}).second) t.manifold = false;
+        }
+    }
+
+    for (auto& e : directed)
+    {
+        bool hasOpposite = directed.count({e.second, e.first});
+        if (!hasOpposite) t.boundaryEdges.insert({std::min(e.first, e.second), std::max(e.first, e.second)});
+        if (!hasOpposite || e.first < e.second) t.edges++;
+    }
+
+    // The faces around each vertex form a single fan
+    for (auto& ring : rings)
+    {
+        if (ring.empty())
+        {
+            t.manifold = false;
+            continue;
+        }
+        std::set<uint32_t> targets;
+        for (auto& l : ring) targets.insert(l.second);
+        uint32_t start = ring.begin()->first;
+        for (auto& l : ring)
+        {
+            if (!targets.count(l.first)) start = l.first;
+        }
+        size_t steps = 0;
+        for (auto it = ring.find(start); it != ring.end() && steps <= ring.size(); it = ring.find(it->second))
+        {
+            steps++;
+            if (it->second == start) break;
+        }
+        if (steps != ring.size()) t.manifold = false;
+    }
+    return t;
+}
+
+static void decimate(TestMesh& mesh, int targetFaces, bool parallel,
+                     QuadricDecimationSettings settings = QuadricDecimationSettings())
+{
+    settings.partitions = 8;
+    HalfEdgeMesh<VertexNC, uint32_t> hem(mesh);
+    QuadricDecimation<VertexNC, uint32_t> qem(hem, settings);
+    int before  = qem.numFaces();
+    int removed = parallel ? qem.decimateParallel(targetFaces) : qem.decimate(targetFaces);
+    EXPECT_EQ(qem.numFaces(), before - removed);
+    EXPECT_TRUE(hem.isValid());
+    hem.toIFS(mesh);
+    mesh.removeUnusedVertices();
+    EXPECT_EQ((int)mesh.faces.size(), qem.numFaces());
+}
+
+class QuadricDecimationTest : public ::testing::TestWithParam<bool>
+{
+};
+INSTANTIATE_TEST_SUITE_P(Mode, QuadricDecimationTest, ::testing::Values(false, true));
+
+TEST_P(QuadricDecimationTest, ClosedMesh)
+{
+    TestMesh mesh = makeTorus(80, 40, 3, 1);
+    ASSERT_TRUE(topology(mesh).manifold);
+    ASSERT_EQ(topology(mesh).euler(), 0);
+
+    int target = mesh.faces.size() / 10;
+    decimate(mesh, target, GetParam());
+
+    // Every collapse removes two faces
+    EXPECT_LE((int)mesh.faces.size(), target);
+    EXPECT_GE((int)mesh.faces.size(), target - 1);
+
+    auto t = topology(mesh);
+    EXPECT_TRUE(t.manifold);
+    EXPECT_TRUE(t.boundaryEdges.empty());
+    EXPECT_EQ(t.euler(), 0);
+
+    // The vertices stay close to the surface
+    for (auto& v : mesh.vertices)
+    {
+        vec3 p  = v.position.head<3>();
+        float d = vec2(vec2(p.x(), p.z()).norm() - 3, p.y()).norm() - 1;
+        EXPECT_LT(std::abs(d), 0.05f) << p.transpose();
+    }
+}
+
+TEST_P(QuadricDecimationTest, SharpFeatures)
+{
+    TestMesh mesh = makeBox(12);
+    ASSERT_TRUE(topology(mesh).manifold);
+    ASSERT_EQ(topology(mesh).euler(), 2);
+
+    int target = 200;
+    decimate(mesh, target, GetParam());
+    EXPECT_LE((int)mesh.faces.size(), target);
+
+    auto t = topology(mesh);
+    EXPECT_TRUE(t.manifold);
+    EXPECT_TRUE(t.boundaryEdges.empty());
+    EXPECT_EQ(t.euler(), 2);
+
+    // All vertices stay on the box, the corners are kept and no triangle cuts an edge of the box.
+    int corners = 0;
+    for (auto& v : mesh.vertices)
+    {
+        vec3 p = v.position.head<3>();
+        EXPECT_NEAR(p.cwiseAbs().maxCoeff(), 1, 1e-4) << p.transpose();
+        if ((p.cwiseAbs() - vec3(1, 1, 1)).norm() < 1e-4) corners++;
+    }
+    EXPECT_EQ(corners, 8);
+
+    for (auto& f : mesh.faces)
+    {
+        vec3 a = mesh.vertices[f.v1].position.head<3>();
+        vec3 b = mesh.vertices[f.v2].position.head<3>();
+        vec3 c = mesh.vertices[f.v3].position.head<3>();
+        vec3 n = (b - a).cross(c - a).normalized();
+
+        int sides = 0;
+        for (int k = 0; k < 3; ++k)
+        {
+            for (float s : {-1.0f, 1.0f})
+            {
+                if (std::abs(a(k) - s) < 1e-4 && std::abs(b(k) - s) < 1e-4 && std::abs(c(k) - s) < 1e-4)
+                {
+                    sides++;
+                    // No flipped faces
+                    EXPECT_NEAR(n(k), s, 1e-4);
+                }
+            }
+        }
+        EXPECT_EQ(sides, 1);
+    }
+}
+
+TEST_P(QuadricDecimationTest, Boundary)
+{
+    TestMesh mesh = makePatch(40);
+    auto before   = topology(mesh);
+    ASSERT_TRUE(before.manifold);
+    ASSERT_EQ(before.euler(), 1);
+
+    std::set<std::array<float, 3>> boundaryPositions;
+    for (auto& e : before.boundaryEdges)
+    {
+        for (auto v : {e.first, e.second})
+        {
+            auto& p = mesh.vertices[v].position;
+            boundaryPositions.insert({p.x(), p.y(), p.z()});
+        }
+    }
+
+    int target = mesh.faces.size() / 8;
+    decimate(mesh, target, GetParam());
+    EXPECT_LE((int)mesh.faces.size(), target);
+
+    auto t = topology(mesh);
+    EXPECT_TRUE(t.manifold);
+    EXPECT_EQ(t.euler(), 1);
+
+    // Boundary vertices are neither removed nor moved, so the boundary keeps all of its edges.
+    EXPECT_EQ(t.boundaryEdges.size(), before.boundaryEdges.size());
+    std::set<std::array<float, 3>> positions;
+    for (auto& e : t.boundaryEdges)
+    {
+        for (auto v : {e.first, e.second})
+        {
+            auto& p = mesh.vertices[v].position;
+            positions.insert({p.x(), p.y(), p.z()});
+        }
+    }
+    EXPECT_EQ(positions, boundaryPositions);
+}
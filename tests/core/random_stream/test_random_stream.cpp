@@ -0,0 +1,207 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/math/RandomStream.h"
+#include "saiga/core/math/random.h"
+#include "saiga/core/util/Thread/omp.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+using namespace Saiga;
+
+// Known answer tests of the Random123 reference implementation (kat_vectors, philox4x32 10 rounds).
+TEST(RandomStream, PhiloxKnownAnswer)
+{
+    using Block = RandomStream::Block;
+    EXPECT_EQ(RandomStream::philox({0, 0, 0, 0}, {0, 0}), (Block{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}));
+    EXPECT_EQ(RandomStream::philox({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff}),
+              (Block{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}));
+    EXPECT_EQ(RandomStream::philox({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0}),
+              (Block{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}));
+}
+
+TEST(RandomStream, Counter)
+{
+    // The sequential interface returns the blocks in order.
+    RandomStream rng(12345, 7);
+    for (uint64_t b = 0; b < 10; ++b)
+    {
+        auto block = rng.block(b);
+        for (int j = 0; j < 4; ++j) EXPECT_EQ(rng(), block[j]);
+    }
+    EXPECT_EQ(rng.position(), 10);
+
+    // Different streams and seeds are independent
+    EXPECT_NE(RandomStream(12345, 8).block(0), rng.block(0));
+    EXPECT_NE(RandomStream(12346, 7).block(0), rng.block(0));
+
+    rng.seek(3);
+    EXPECT_EQ(rng(), rng.block(3)[0]);
+}
+
+template <typename T>
+static std::vector<T> generate(int threads, bool gaussian)
+{
+    int oldThreads = OMP::getMaxThreads();
+    OMP::setNumThreads(threads);
+    RandomStream rng(987, 3);
+    // Larger than the parallel threshold
+    std::vector<T> data(200000);
+    std::vector<T> data2(1001);
+    if (gaussian)
+    {
+        rng.fillGaussian(data.data(), data.size(), 1, 2);
+        rng.fillGaussian(data2.data(), data2.size());
+    }
+    else
+    {
+        rng.fillUniform(data.data(), data.size(), -1, 3);
+        rng.fillUniform(data2.data(), data2.size());
+    }
+    data.insert(data.end(), data2.begin(), data2.end());
+    OMP::setNumThreads(oldThreads);
+    return data;
+}
+
+TEST(RandomStream, ThreadCountIndependent)
+{
+    for (bool gaussian : {false, true})
+    {
+        auto f1 = generate<float>(1, gaussian);
+        auto d1 = generate<double>(1, gaussian);
+        for (int threads : {2, 3, 8})
+        {
+            EXPECT_EQ(generate<float>(threads, gaussian), f1);
+            EXPECT_EQ(generate<double>(threads, gaussian), d1);
+        }
+    }
+}
+
+template <typename T>
+static void checkMoments(const std::vector<T>& data, double mean, double stddev)
+{
+    double n = data.size();
+    double sum = 0, sum2 = 0, sum4 = 0;
+    for (T x : data)
+    {
+        double z = (x - mean) / stddev;
+        sum += z;
+        sum2 += z * z;
+        sum4 += z * z * z * z;
+    }
+    double m = sum / n;
+    double v = sum2 / n - m * m;
+    // The standard error of the mean is 1/sqrt(n) and of the variance sqrt(2/n).
+    EXPECT_NEAR(m, 0, 5 / std::sqrt(n));
+    EXPECT_NEAR(v, 1, 5 * std::sqrt(2 / n));
+    // Kurtosis of the normal distribution
+    EXPECT_NEAR(sum4 / n, 3, 0.05);
+
+    // Tails: P(|z| > 3) = 0.0027
+    double tail = std::count_if(data.begin(), data.end(), [&](T x) { return std::abs((x - mean) / stddev) > 3; }) / n;
+    EXPECT_NEAR(tail, 0.0027, 0.0004);
+}
+
+TEST(RandomStream, Gaussian)
+{
+    int n = 1000000;
+    RandomStream rng(4711);
+
+    std::vector<double> d(n);
+    rng.fillGaussian(d.data(), n, 2, 3);
+    checkMoments(d, 2, 3);
+
+    std::vector<float> f(n);
+    rng.fillGaussian(f.data(), n, -1, 0.5);
+    checkMoments(f, -1, 0.5);
+
+    std::vector<double> s(n);
+    for (auto& x : s) x = rng.gauss(1, 2);
+    checkMoments(s, 1, 2);
+}
+
+TEST(RandomStream, Uniform)
+{
+    int n = 1000000;
+    RandomStream rng(77);
+    std::vector<double> d(n);
+    rng.fillUniform(d.data(), n, -2, 6);
+    auto [mi, ma] = std::minmax_element(d.begin(), d.end());
+    EXPECT_GE(*mi, -2);
+    EXPECT_LT(*ma, 6);
+    double mean = 0;
+    for (auto x : d) mean += x;
+    EXPECT_NEAR(mean / n, 2, 0.02);
+
+    std::vector<int> counts(5, 0);
+    for (int i = 0; i < n; ++i)
+    {
+        int x = rng.uniformInt(-2, 2);
+        ASSERT_GE(x, -2);
+        ASSERT_LE(x, 2);
+        counts[x + 2]++;
+    }
+    for (auto c : counts) EXPECT_NEAR(c, n / 5, 0.01 * n);
+}
+
+TEST(RandomStream, UniqueIndices)
+{
+    RandomStream rng(31);
+    // Dense (bit field) and sparse (hash set) cases
+    for (auto [k, n] : std::vector<std::pair<int, int>>{{0, 10}, {1, 1}, {10, 10}, {50, 100}, {10, 100000}})
+    {
+        for (int it = 0; it < 20; ++it)
+        {
+            auto data = Random::uniqueIndices(k, n, rng);
+            ASSERT_EQ(data.size(), k);
+            for (auto i : data)
+            {
+                ASSERT_GE(i, 0);
+                ASSERT_LT(i, n);
+            }
+
+            auto sorted = Random::sortedUniqueIndices(k, n, rng);
+            ASSERT_EQ(sorted.size(), k);
+            ASSERT_TRUE(std::is_sorted(sorted.begin(), sorted.end()));
+            if (k > 0)
+            {
+                ASSERT_GE(sorted.front(), 0);
+                ASSERT_LT(sorted.back(), n);
+            }
+
+            std::sort(data.begin(), data.end());
+            ASSERT_TRUE(std::adjacent_find(data.begin(), data.end()) == data.end());
+            ASSERT_TRUE(std::adjacent_find(sorted.begin(), sorted.end()) == sorted.end());
+        }
+    }
+
+    auto data = Random::uniqueIndices(20, 30);
+    std::sort(data.begin(), data.end());
+    EXPECT_EQ(std::unique(data.begin(), data.end()), data.end());
+}
+
+// Every ordered sample must have the same probability, not only every subset.
+TEST(RandomStream, UniqueIndicesOrder)
+{
+    RandomStream rng(5);
+    for (int n : {3, 40})
+    {
+        int runs = 60000;
+        std::map<std::vector<int>, int> counts;
+        for (int i = 0; i < runs; ++i) counts[Random::uniqueIndices(3, 3, rng)]++;
+        EXPECT_EQ(counts.size(), 6);
+        for (auto& [perm, c] : counts) EXPECT_NEAR(c, runs / 6, 600);
+
+        // The first element is uniform over all indices
+        std::vector<int> first(n, 0);
+        for (int i = 0; i < runs; ++i) first[Random::uniqueIndices(2, n, rng)[0]]++;
+        for (auto c : first) EXPECT_NEAR(c, runs / n, 6 * std::sqrt(runs / n));
+    }
+}
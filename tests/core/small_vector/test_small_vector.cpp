@@ -0,0 +1,307 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/math/random.h"
+#include "saiga/core/util/DataStructures/SmallVector.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+#include <vector>
+
+using namespace Saiga;
+
+// Counts the live objects. A destroyed object is marked, so a double destroy or the use of a destroyed object fails.
+struct Tracked
+{
+    static int alive;
+    static constexpr int magicAlive = 0x5A5A5A5A;
+
+    int value;
+    int magic = magicAlive;
+    // Heap memory, so leaks are also visible to sanitizers
+    std::string payload;
+
+    Tracked(int v = 0) : value(v), payload(40, char('a' + v % 26)) { alive++; }
+    Tracked(const Tracked& o) : value(o.value), payload(o.payload)
+    {
+        EXPECT_EQ(o.magic, magicAlive);
+        alive++;
+    }
+    Tracked(Tracked&& o) noexcept : value(o.value), payload(std::move(o.payload))
+    {
+        EXPECT_EQ(o.magic, magicAlive);
+        o.value = -1;
+        alive++;
+    }
+    Tracked& operator=(const Tracked& o)
+    {
+        EXPECT_EQ(magic, magicAlive);
+        EXPECT_EQ(o.magic, magicAlive);
+        value   = o.value;
+        payload = o.payload;
+        return *this;
+    }
+    Tracked& operator=(Tracked&& o) noexcept
+    {
+        EXPECT_EQ(magic, magicAlive);
+        EXPECT_EQ(o.magic, magicAlive);
+        value   = o.value;
+        payload = std::move(o.payload);
+        o.value = -1;
+        return *this;
+    }
+    ~Tracked()
+    {
+        EXPECT_EQ(magic, magicAlive);
+        magic = 0;
+        alive--;
+    }
+    bool operator==(const Tracked& o) const { return value == o.value; }
+};
+int Tracked::alive = 0;
+
+using Vec = SmallVector<Tracked, 4>;
+
+static std::vector<int> values(const Vec& v)
+{
+    std::vector<int> result;
+    for (auto& t : v) result.push_back(t.value);
+    return result;
+}
+
+class SmallVectorTest : public ::testing::Test
+{
+   protected:
+    void SetUp() override { Tracked::alive = 0; }
+    void TearDown() override { EXPECT_EQ(Tracked::alive, 0); }
+};
+
+TEST_F(SmallVectorTest, InlineToHeapAndBack)
+{
+    Vec v;
+    EXPECT_TRUE(v.isSmall());
+    EXPECT_EQ(v.capacity(), 4);
+    for (int i = 0; i < 4; ++i) v.emplace_back(i);
+    EXPECT_TRUE(v.isSmall());
+    EXPECT_EQ(v.heapMemory(), 0);
+    EXPECT_EQ(Tracked::alive, 4);
+
+    v.emplace_back(4);
+    EXPECT_FALSE(v.isSmall());
+    EXPECT_GE(v.capacity(), 5);
+    EXPECT_EQ(v.heapMemory(), v.capacity() * sizeof(Tracked));
+    EXPECT_EQ(values(v), (std::vector<int>{0, 1, 2, 3, 4}));
+    EXPECT_EQ(Tracked::alive, 5);
+
+    // Too large for the inline storage
+    v.shrink_to_fit();
+    EXPECT_FALSE(v.isSmall());
+
+    v.pop_back();
+    v.pop_back();
+    EXPECT_EQ(Tracked::alive, 3);
+    v.shrink_to_fit();
+    EXPECT_TRUE(v.isSmall());
+    EXPECT_EQ(values(v), (std::vector<int>{0, 1, 2}));
+    EXPECT_EQ(Tracked::alive, 3);
+
+    v.resize(10, Tracked(7));
+    EXPECT_FALSE(v.isSmall());
+    EXPECT_EQ(v.size(), 10);
+    EXPECT_EQ(v.back().value, 7);
+    v.resize(2);
+    EXPECT_EQ(values(v), (std::vector<int>{0, 1}));
+    v.clear();
+    EXPECT_TRUE(v.empty());
+    EXPECT_EQ(Tracked::alive, 0);
+}
+
+TEST_F(SmallVectorTest, CopyAndMove)
+{
+    for (int n : {3, 9})
+    {
+        Vec v;
+        for (int i = 0; i < n; ++i) v.emplace_back(i);
+        bool small = v.isSmall();
+        EXPECT_EQ(small, n <= 4);
+
+        // Copy
+        Vec c(v);
+        EXPECT_EQ(c, v);
+        EXPECT_EQ(c.isSmall(), small);
+        EXPECT_NE(c.data(), v.data());
+        EXPECT_EQ(Tracked::alive, 2 * n);
+
+        // Move construct. Heap storage is taken over, inline elements are moved.
+        const Tracked* data = c.data();
+        Vec m(std::move(c));
+        EXPECT_EQ(m, v);
+        EXPECT_TRUE(c.empty());
+        EXPECT_TRUE(c.isSmall());
+        EXPECT_EQ(m.data() == data, !small);
+        EXPECT_EQ(Tracked::alive, 2 * n);
+
+        // The moved-from vector is usable
+        c.emplace_back(42);
+        EXPECT_EQ(values(c), (std::vector<int>{42}));
+
+        // Copy and move assignment into a small and into a heap vector
+        for (int m2 : {1, 7})
+        {
+            Vec a, b;
+            for (int i = 0; i < m2; ++i)
+            {
+                a.emplace_back(100 + i);
+                b.emplace_back(100 + i);
+            }
+            a = v;
+            EXPECT_EQ(a, v);
+            b = std::move(m);
+            EXPECT_EQ(b, v);
+            EXPECT_TRUE(m.empty());
+            m = b;
+        }
+
+        // Self assignment
+        auto& ref = v;
+        v         = ref;
+        v         = std::move(ref);
+        EXPECT_EQ(v.size(), n);
+        EXPECT_EQ(values(v)[n - 1], n - 1);
+
+        // Swap small and heap
+        Vec s = {Tracked(50)};
+        s.swap(v);
+        EXPECT_EQ(values(v), (std::vector<int>{50}));
+        EXPECT_EQ(s.size(), n);
+    }
+}
+
+TEST_F(SmallVectorTest, EraseAndEmplace)
+{
+    Vec v = {Tracked(0), Tracked(1), Tracked(2)};
+    v.emplace(v.begin() + 1, 10);
+    EXPECT_EQ(values(v), (std::vector<int>{0, 10, 1, 2}));
+    // Grows to the heap while inserting an element of itself
+    v.insert(v.begin(), v[3]);
+    EXPECT_EQ(values(v), (std::vector<int>{2, 0, 10, 1, 2}));
+    v.insert(v.end(), Tracked(5));
+    EXPECT_EQ(values(v), (std::vector<int>{2, 0, 10, 1, 2, 5}));
+
+    auto it = v.erase(v.begin() + 1);
+    EXPECT_EQ(it->value, 10);
+    EXPECT_EQ(values(v), (std::vector<int>{2, 10, 1, 2, 5}));
+    // Empty range
+    it = v.erase(v.begin() + 1, v.begin() + 1);
+    EXPECT_EQ(it->value, 10);
+    EXPECT_EQ(values(v), (std::vector<int>{2, 10, 1, 2, 5}));
+    it = v.erase(v.begin() + 1, v.begin() + 3);
+    EXPECT_EQ(it->value, 2);
+    EXPECT_EQ(values(v), (std::vector<int>{2, 2, 5}));
+    it = v.erase(v.begin() + 2, v.end());
+    EXPECT_EQ(it, v.end());
+    EXPECT_EQ(Tracked::alive, 2);
+
+    v = {Tracked(0), Tracked(1), Tracked(2), Tracked(3)};
+    v.eraseUnordered(v.begin() + 1);
+    EXPECT_EQ(values(v), (std::vector<int>{0, 3, 2}));
+    v.eraseUnordered(v.end() - 1);
+    EXPECT_EQ(values(v), (std::vector<int>{0, 3}));
+    EXPECT_EQ(Tracked::alive, 2);
+}
+
+TEST_F(SmallVectorTest, RandomOperations)
+{
+    Random::setSeed(3462);
+    Vec v;
+    std::vector<int> reference;
+    for (int it = 0; it < 5000; ++it)
+    {
+        int op = Random::uniformInt(0, 5);
+        int n  = reference.size();
+        int x  = Random::uniformInt(0, 1000);
+        if (op == 0 || n == 0)
+        {
+            v.emplace_back(x);
+            reference.push_back(x);
+        }
+        else if (op == 1)
+        {
+            int pos = Random::uniformInt(0, n);
+            v.emplace(v.begin() + pos, x);
+            reference.insert(reference.begin() + pos, x);
+        }
+        else if (op == 2)
+        {
+            int pos = Random::uniformInt(0, n - 1);
+            v.erase(v.begin() + pos);
+            reference.erase(reference.begin() + pos);
+        }
+        else if (op == 3)
+        {
+            int pos = Random::uniformInt(0, n - 1);
+            v.eraseUnordered(v.begin() + pos);
+            reference[pos] = reference.back();
+            reference.pop_back();
+        }
+        else if (op == 4)
+        {
+            int first = Random::uniformInt(0, n);
+            int last  = Random::uniformInt(first, std::min(n, first + 3));
+            v.erase(v.begin() + first, v.begin() + last);
+            reference.erase(reference.begin() + first, reference.begin() + last);
+        }
+        else
+        {
+            // Keep the size small, so the vector switches between inline and heap storage
+            if (n > 6)
+            {
+                v.resize(2);
+                reference.resize(2);
+                v.shrink_to_fit();
+                EXPECT_TRUE(v.isSmall());
+            }
+        }
+        ASSERT_EQ(values(v), reference);
+        ASSERT_EQ(Tracked::alive, (int)reference.size());
+    }
+}
+
+struct alignas(64) OverAligned
+{
+    double v = 0;
+    OverAligned(double v = 0) : v(v) {}
+};
+
+TEST(SmallVector, OverAligned)
+{
+    static_assert(alignof(SmallVector<OverAligned, 2>) >= 64);
+    SmallVector<OverAligned, 2> v;
+    auto aligned = [&]() { return reinterpret_cast<uintptr_t>(v.data()) % 64 == 0; };
+    v.emplace_back(1);
+    EXPECT_TRUE(aligned());
+    for (int i = 0; i < 20; ++i)
+    {
+        v.emplace_back(i);
+        EXPECT_TRUE(aligned());
+    }
+    EXPECT_FALSE(v.isSmall());
+    EXPECT_EQ(v[20].v, 19);
+
+    std::vector<SmallVector<OverAligned, 2>> many(10, v);
+    for (auto& m : many) EXPECT_EQ(reinterpret_cast<uintptr_t>(m.data()) % 64, 0);
+}
+
+TEST(SmallVector, Compare)
+{
+    SmallVector<int, 2> a = {1, 2, 3}, b = {1, 2}, c = {1, 2, 3};
+    EXPECT_EQ(a, c);
+    EXPECT_NE(a, b);
+    EXPECT_LT(b, a);
+    EXPECT_EQ((SmallVector<int, 2>(a.begin(), a.end())), a);
+    EXPECT_EQ((SmallVector<int, 2>(3, 7)), (SmallVector<int, 2>{7, 7, 7}));
+}
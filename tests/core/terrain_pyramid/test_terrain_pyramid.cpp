@@ -0,0 +1,112 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/image/TerrainPyramid.h"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <filesystem>
+
+using namespace Saiga;
+
+class TerrainPyramidTest : public ::testing::Test
+{
+   protected:
+    void SetUp() override { std::filesystem::remove_all(dir); }
+    void TearDown() override { std::filesystem::remove_all(dir); }
+
+    void assemble(TerrainPyramid& pyramid, TemplatedImage<float>& heights)
+    {
+        TemplatedImage<ucvec4> normals;
+        for (int l = pyramid.numLevels() - 1; l >= 0; --l) pyramid.assembleLevel(l, heights, normals);
+    }
+
+    std::string dir = "test_terrain_pyramid_cache";
+    int size = 128, levels = 3, tileSize = 32;
+};
+
+TEST_F(TerrainPyramidTest, PerlinKey)
+{
+    auto a = TerrainPyramid::perlinSource(PerlinNoise(), 1.0f / 32);
+    EXPECT_EQ(a.key, TerrainPyramid::perlinSource(PerlinNoise(), 1.0f / 32).key);
+    EXPECT_NE(a.key, TerrainPyramid::perlinSource(PerlinNoise(5), 1.0f / 32).key);
+    EXPECT_NE(a.key, TerrainPyramid::perlinSource(PerlinNoise(), 1.0f / 31).key);
+    EXPECT_NE(a.key, TerrainPyramid::perlinSource(PerlinNoise(), 1.0f / 32, 7).key);
+    EXPECT_EQ(PerlinNoise(5).hash(), PerlinNoise(5).hash());
+    EXPECT_NE(PerlinNoise(5).hash(), PerlinNoise(6).hash());
+}
+
+TEST_F(TerrainPyramidTest, CacheReused)
+{
+    auto source = TerrainPyramid::perlinSource(PerlinNoise(), 1.0f / 32);
+    TemplatedImage<float> first, second;
+    {
+        TerrainPyramid pyramid(size, size, levels, tileSize, source, dir);
+        EXPECT_FALSE(pyramid.cacheMatched());
+        assemble(pyramid, first);
+        EXPECT_GT(pyramid.numGenerated(), 0);
+    }
+
+    TerrainPyramid pyramid(size, size, levels, tileSize, source, dir);
+    EXPECT_TRUE(pyramid.cacheMatched());
+    assemble(pyramid, second);
+    EXPECT_EQ(pyramid.numGenerated(), 0);
+    EXPECT_EQ(first.getImageView()(17, 93), second.getImageView()(17, 93));
+}
+
+TEST_F(TerrainPyramidTest, CacheOfDifferentScaleIsDiscarded)
+{
+    auto source   = TerrainPyramid::perlinSource(PerlinNoise(), 1.0f / 32);
+    size_t budget = size_t(64) * 1024 * 1024;
+    {
+        TerrainPyramid pyramid(size, size, levels, tileSize, source, dir, budget, 1.0f, 1.0f);
+        TemplatedImage<float> heights;
+        assemble(pyramid, heights);
+    }
+
+    // These differ from 1 only in the 8th significant digit
+    float pixelSize   = std::nextafter(1.0f, 2.0f);
+    float heightScale = std::nextafter(1.0f, 0.0f);
+    {
+        TerrainPyramid pyramid(size, size, levels, tileSize, source, dir, budget, pixelSize, 1.0f);
+        EXPECT_FALSE(pyramid.cacheMatched());
+    }
+    {
+        TerrainPyramid pyramid(size, size, levels, tileSize, source, dir, budget, pixelSize, heightScale);
+        EXPECT_FALSE(pyramid.cacheMatched());
+    }
+    TerrainPyramid pyramid(size, size, levels, tileSize, source, dir, budget, pixelSize, heightScale);
+    EXPECT_TRUE(pyramid.cacheMatched());
+}
+
+TEST_F(TerrainPyramidTest, CacheOfDifferentSourceIsDiscarded)
+{
+    {
+        TerrainPyramid pyramid(size, size, levels, tileSize, TerrainPyramid::perlinSource(PerlinNoise(), 1.0f / 32),
+                               dir);
+        TemplatedImage<float> heights;
+        assemble(pyramid, heights);
+    }
+
+    // Same layout, different noise
+    auto source = TerrainPyramid::perlinSource(PerlinNoise(3), 1.0f / 32);
+    TemplatedImage<float> cached, reference;
+    TerrainPyramid pyramid(size, size, levels, tileSize, source, dir);
+    EXPECT_FALSE(pyramid.cacheMatched());
+    assemble(pyramid, cached);
+    EXPECT_GT(pyramid.numGenerated(), 0);
+
+    TerrainPyramid uncached(size, size, levels, tileSize, source);
+    assemble(uncached, reference);
+    for (int r = 0; r < size; ++r)
+    {
+        for (int c = 0; c < size; ++c)
+        {
+            ASSERT_EQ(cached.getImageView()(r, c), reference.getImageView()(r, c)) << r << " " << c;
+        }
+    }
+}
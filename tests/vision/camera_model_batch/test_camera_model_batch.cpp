@@ -0,0 +1,158 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/math/random.h"
+#include "saiga/vision/VisionTypes.h"
+#include "saiga/vision/cameraModel/CameraModelBatch.h"
+
+#include "gtest/gtest.h"
+
+using namespace Saiga;
+
+// The batched kernels are compared to the scalar functions of Intrinsics4.h and Distortion.h.
+// n is not a multiple of the batch size, so the scalar tail is tested too.
+class CameraModelBatch : public ::testing::Test
+{
+   protected:
+    int n = 1003;
+    StereoCamera4Base<double> K = StereoCamera4Base<double>(535.4, 539.2, 320.1, 247.6, 40.0);
+    Distortion dis;
+    std::vector<double> X, Y, Z, u, v;
+
+    void SetUp() override
+    {
+        Random::setSeed(4687);
+        dis << -0.28, 0.07, 0.001, -0.0005, 0.01;
+        for (int i = 0; i < n; ++i)
+        {
+            X.push_back(Random::sampleDouble(-2, 2));
+            Y.push_back(Random::sampleDouble(-2, 2));
+            Z.push_back(Random::sampleDouble(1, 10));
+            u.push_back(Random::sampleDouble(0, 640));
+            v.push_back(Random::sampleDouble(0, 480));
+        }
+    }
+};
+
+TEST_F(CameraModelBatch, Project)
+{
+    std::vector<double> pu(n), pv(n), pr(n);
+    CameraBatch::projectN<double>(K, X.data(), Y.data(), Z.data(), pu.data(), pv.data(), n);
+    for (int i = 0; i < n; ++i)
+    {
+        Vec2 ref = K.project(Vec3(X[i], Y[i], Z[i]));
+        EXPECT_NEAR(pu[i], ref(0), 1e-9);
+        EXPECT_NEAR(pv[i], ref(1), 1e-9);
+    }
+
+    CameraBatch::projectStereoN<double>(K, X.data(), Y.data(), Z.data(), pu.data(), pv.data(), pr.data(), n);
+    for (int i = 0; i < n; ++i)
+    {
+        Vec3 ref = K.projectStereo(Vec3(X[i], Y[i], Z[i]));
+        EXPECT_NEAR(pu[i], ref(0), 1e-9);
+        EXPECT_NEAR(pv[i], ref(1), 1e-9);
+        EXPECT_NEAR(pr[i], ref(2), 1e-9);
+    }
+}
+
+TEST_F(CameraModelBatch, Unproject)
+{
+    std::vector<double> rx(n), ry(n), rz(n);
+    CameraBatch::unprojectN<double>(K, u.data(), v.data(), Z.data(), rx.data(), ry.data(), rz.data(), n);
+    for (int i = 0; i < n; ++i)
+    {
+        Vec3 ref = K.unproject(Vec2(u[i], v[i]), Z[i]);
+        EXPECT_NEAR(rx[i], ref(0), 1e-12);
+        EXPECT_NEAR(ry[i], ref(1), 1e-12);
+        EXPECT_EQ(rz[i], ref(2));
+    }
+}
+
+TEST_F(CameraModelBatch, Distortion)
+{
+    // Normalized points inside the image
+    std::vector<double> x(n), y(n), rx(n), ry(n);
+    for (int i = 0; i < n; ++i)
+    {
+        Vec2 p = K.unproject2(Vec2(u[i], v[i]));
+        x[i]   = p(0);
+        y[i]   = p(1);
+    }
+
+    CameraBatch::distortN(dis, x.data(), y.data(), rx.data(), ry.data(), n);
+    for (int i = 0; i < n; ++i)
+    {
+        Vec2 ref = distortNormalizedPoint(Vec2(x[i], y[i]), dis);
+        EXPECT_NEAR(rx[i], ref(0), 1e-12);
+        EXPECT_NEAR(ry[i], ref(1), 1e-12);
+    }
+
+    CameraBatch::undistortN(dis, x.data(), y.data(), rx.data(), ry.data(), n);
+    for (int i = 0; i < n; ++i)
+    {
+        Vec2 ref = undistortNormalizedPoint(Vec2(x[i], y[i]), dis);
+        EXPECT_NEAR(rx[i], ref(0), 1e-12);
+        EXPECT_NEAR(ry[i], ref(1), 1e-12);
+    }
+
+    CameraBatch::unprojectUndistortN<double>(K, dis, u.data(), v.data(), rx.data(), ry.data(), n);
+    for (int i = 0; i < n; ++i)
+    {
+        Vec2 ref = undistortNormalizedPoint(K.unproject2(Vec2(u[i], v[i])), dis);
+        EXPECT_NEAR(rx[i], ref(0), 1e-12);
+        EXPECT_NEAR(ry[i], ref(1), 1e-12);
+    }
+}
+
+TEST_F(CameraModelBatch, UndistortAll)
+{
+    std::vector<Vec2> points, result(n);
+    for (int i = 0; i < n; ++i) points.emplace_back(u[i], v[i]);
+
+    undistortAll(points.begin(), points.end(), result.begin(), K, dis);
+    // Inplace
+    undistortAll(points.begin(), points.end(), points.begin(), K, dis);
+
+    for (int i = 0; i < n; ++i)
+    {
+        Vec2 ref = K.normalizedToImage(undistortNormalizedPoint(K.unproject2(Vec2(u[i], v[i])), dis));
+        EXPECT_NEAR(result[i](0), ref(0), 1e-9);
+        EXPECT_NEAR(result[i](1), ref(1), 1e-9);
+        EXPECT_EQ(points[i], result[i]);
+    }
+}
+
+TEST_F(CameraModelBatch, UndistortionMap)
+{
+    UndistortionMap<double> map(K, dis, 640, 480);
+    for (int i = 0; i < n; ++i)
+    {
+        // Pixel centers are exact, sub pixel positions are interpolated.
+        Vec2 ref = undistortNormalizedPoint(K.unproject2(Vec2(u[i], v[i])), dis);
+        EXPECT_NEAR((map.undistort(Vec2(u[i], v[i])) - ref).norm(), 0, 1e-5);
+
+        int px = int(u[i]) % 640, py = int(v[i]) % 480;
+        ref    = undistortNormalizedPoint(K.unproject2(Vec2(px, py)), dis);
+        EXPECT_NEAR((map.undistort(Vec2(px, py)) - ref).norm(), 0, 1e-12);
+    }
+}
+
+TEST_F(CameraModelBatch, UndistortionMapSmall)
+{
+    // A single row or column must not read outside of the map.
+    for (auto [w, h] : {std::pair<int, int>(1, 1), std::pair<int, int>(1, 5), std::pair<int, int>(5, 1)})
+    {
+        UndistortionMap<double> map(K, dis, w, h);
+        for (double y = 0; y <= h - 1; y += 0.25)
+        {
+            for (double x = 0; x <= w - 1; x += 0.25)
+            {
+                Vec2 ref = undistortNormalizedPoint(K.unproject2(Vec2(x, y)), dis);
+                EXPECT_NEAR((map.undistort(Vec2(x, y)) - ref).norm(), 0, 1e-5);
+            }
+        }
+    }
+}
@@ -0,0 +1,76 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/math/random.h"
+#include "saiga/vision/reconstruction/FivePoint.h"
+
+#include "gtest/gtest.h"
+
+using namespace Saiga;
+
+// Matches in normalized image space of two cameras with the relative pose T.
+static void makeMatches(const SE3& T, int n, AlignedVector<Vec2>& points1, AlignedVector<Vec2>& points2)
+{
+    for (int i = 0; i < n; ++i)
+    {
+        Vec3 p(Random::sampleDouble(-2, 2), Random::sampleDouble(-2, 2), Random::sampleDouble(4, 8));
+        Vec3 q = T * p;
+        points1.push_back(p.head<2>() / p.z());
+        points2.push_back(q.head<2>() / q.z());
+    }
+}
+
+TEST(FivePoint, ArenaContainerWithoutReserve)
+{
+    Random::setSeed(9283);
+    AlignedVector<Vec2> points1, points2;
+    SE3 T = SE3::exp((Vec6() << 0.5, 0.1, 0, 0.02, 0.05, -0.01).finished());
+    makeMatches(T, 5, points1, points2);
+
+    std::vector<Mat3> reference;
+    int n = fivePointNister(points1.data(), points2.data(), reference);
+    ASSERT_GT(n, 0);
+
+    // 'es' grows inside of fivePointNister and must not be freed by an inner arena scope.
+    ArenaScope scope;
+    ArenaVector<Mat3> es;
+    EXPECT_EQ(fivePointNister(points1.data(), points2.data(), es), n);
+
+    // Overwrite the memory behind 'es' if it was freed.
+    ArenaVector<double> other(1000, -1.0);
+
+    ASSERT_EQ(es.size(), reference.size());
+    for (int i = 0; i < n; ++i)
+    {
+        EXPECT_EQ(es[i], reference[i]);
+    }
+}
+
+TEST(FivePoint, RansacSteadyStateDoesNotAllocate)
+{
+    Random::setSeed(9283);
+    AlignedVector<Vec2> points1, points2;
+    SE3 T = SE3::exp((Vec6() << 0.5, 0.1, 0, 0.02, 0.05, -0.01).finished());
+    makeMatches(T, 200, points1, points2);
+
+    RansacParameters params;
+    params.maxIterations     = 50;
+    params.residualThreshold = 1e-6;
+    params.reserveN          = 200;
+    FivePointRansac ransac(params);
+
+    Mat3 E;
+    SE3 rel;
+    std::vector<int> inliers;
+    std::vector<char> mask;
+    auto solve = [&]() { EXPECT_EQ(ransac.solve(points1, points2, E, rel, inliers, mask), 200); };
+
+    solve();
+    solve();
+    size_t allocations = MonotonicArena::blockAllocations();
+    for (int i = 0; i < 5; ++i) solve();
+    EXPECT_EQ(MonotonicArena::blockAllocations(), allocations);
+}
@@ -0,0 +1,76 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/vision/util/HistogramImage.h"
+
+#include "gtest/gtest.h"
+
+using namespace Saiga;
+
+// The bin of the scaled pixel center. This is the rule HistogramImage has always used.
+static std::pair<int, int> referenceBin(int inputW, int inputH, int outputW, int outputH, int y, int x)
+{
+    outputW = std::min(inputW, outputW);
+    outputH = std::min(inputH, outputH);
+    int ox  = int(std::floor((x + 0.5) * outputW / inputW));
+    int oy  = int(std::floor((y + 0.5) * outputH / inputH));
+    if (ox < 0 || ox >= outputW || oy < 0 || oy >= outputH) return {-1, -1};
+    return {oy, ox};
+}
+
+TEST(HistogramImage, Bin)
+{
+    for (auto [inputW, inputH, outputW, outputH] : {std::array<int, 4>{10, 10, 3, 3}, std::array<int, 4>{7, 13, 2, 5},
+                                                    std::array<int, 4>{1000, 1000, 512, 512},
+                                                    std::array<int, 4>{5, 5, 8, 8}, std::array<int, 4>{1, 3, 1, 2}})
+    {
+        HistogramImage img(inputW, inputH, outputW, outputH);
+        for (int y = -2; y < inputH + 2; ++y)
+        {
+            for (int x = -2; x < inputW + 2; ++x)
+            {
+                EXPECT_EQ(img.bin(y, x), referenceBin(inputW, inputH, outputW, outputH, y, x));
+            }
+        }
+    }
+}
+
+TEST(HistogramImage, PixelCenter)
+{
+    // 10 pixels in 3 bins: the centers 0.5, 1.5, ..., 9.5 are scaled by 0.3
+    HistogramImage img(10, 1, 3, 1);
+    std::vector<int> expected = {0, 0, 0, 1, 1, 1, 1, 2, 2, 2};
+    for (int x = 0; x < 10; ++x)
+    {
+        EXPECT_EQ(img.bin(0, x).second, expected[x]);
+    }
+    EXPECT_EQ(img.bin(0, -1).first, -1);
+    EXPECT_EQ(img.bin(0, 10).first, -1);
+}
+
+TEST(HistogramImage, Merge)
+{
+    HistogramImage a(100, 100, 10, 10), b(100, 100, 10, 10), both(100, 100, 10, 10);
+    for (int i = 0; i < 100; ++i)
+    {
+        a.add(i, i, 1);
+        both.add(i, i, 1);
+        b.add(i, 99 - i, 2);
+        both.add(i, 99 - i, 2);
+    }
+    a.merge(b);
+    for (int i = 0; i < 10; ++i)
+    {
+        for (int j = 0; j < 10; ++j)
+        {
+            EXPECT_EQ(a(i, j), both(i, j));
+        }
+    }
+    EXPECT_EQ(a(0, 0), 10);
+    EXPECT_EQ(a(0, 9), 20);
+    EXPECT_EQ(a(5, 4), 20);
+    EXPECT_EQ(a(0, 5), 0);
+}
@@ -0,0 +1,117 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/math/random.h"
+#include "saiga/vision/kernels/PGO.h"
+#include "saiga/vision/kernels/PGOBatch.h"
+#include "saiga/vision/util/Random.h"
+
+#include "gtest/gtest.h"
+
+using namespace Saiga;
+
+template <typename T>
+static T randomTransformation(double maxScale);
+
+template <>
+SE3 randomTransformation<SE3>(double)
+{
+    return Random::randomSE3();
+}
+
+template <>
+Sim3 randomTransformation<Sim3>(double maxScale)
+{
+    SE3 p = Random::randomSE3();
+    return Sim3(Sophus::RxSO3d(Random::sampleDouble(1 / maxScale, maxScale), p.so3()), p.translation());
+}
+
+template <typename T>
+static T fromSE3(const SE3& p, double scale);
+
+template <>
+SE3 fromSE3<SE3>(const SE3& p, double)
+{
+    return p;
+}
+
+template <>
+Sim3 fromSE3<Sim3>(const SE3& p, double scale)
+{
+    return Sim3(Sophus::RxSO3d(scale, p.so3()), p.translation());
+}
+
+template <typename T>
+class PGOBatchTest : public ::testing::Test
+{
+};
+using TransformationTypes = ::testing::Types<SE3, Sim3>;
+TYPED_TEST_SUITE(PGOBatchTest, TransformationTypes);
+
+// The batched kernel must produce the same residuals and Jacobians as the scalar kernel.
+TYPED_TEST(PGOBatchTest, MatchesScalarKernel)
+{
+    using Transformation = TypeParam;
+    using Batch          = Kernel::PGOBatch<Transformation, 4>;
+    using Scalar         = Kernel::PGO<Transformation>;
+    constexpr int N      = Batch::BatchSize;
+
+    Random::setSeed(3467);
+
+    // The error (measurement * from * to^-1) of each test case. Small and zero errors use the series expansions of
+    // the log, pure rotations and pure scales the mixed branches of the Sim3 log.
+    std::vector<Transformation, Eigen::aligned_allocator<Transformation>> errors;
+    for (int i = 0; i < 40; ++i) errors.push_back(randomTransformation<Transformation>(2));
+    errors.push_back(Transformation());
+    errors.push_back(fromSE3<Transformation>(SE3(Quat::Identity(), Vec3(1, -2, 3)), 1));
+    errors.push_back(fromSE3<Transformation>(SE3(Quat::Identity(), Vec3(1, -2, 3)), 1.5));
+    errors.push_back(fromSE3<Transformation>(SE3(Sophus::SO3d::exp(Vec3(0.3, -0.2, 0.1)), Vec3(1, 0, 0)), 1));
+    errors.push_back(fromSE3<Transformation>(SE3(Sophus::SO3d::exp(Vec3(1e-12, 0, 0)), Vec3(0, 1, 0)), 1 + 1e-12));
+    errors.push_back(fromSE3<Transformation>(SE3(Sophus::SO3d::exp(Vec3(1e-7, 2e-7, 0)), Vec3(0, 1, 0)), 1 + 1e-7));
+    // Close to a rotation of pi
+    errors.push_back(fromSE3<Transformation>(SE3(Sophus::SO3d::exp(Vec3(0, 3.1, 0)), Vec3(1, 1, 1)), 0.8));
+    while (errors.size() % N != 0) errors.push_back(randomTransformation<Transformation>(1.2));
+
+    for (size_t k = 0; k < errors.size(); k += N)
+    {
+        typename Batch::Transformations from, to, measurement;
+        typename Batch::Lane weight;
+        std::vector<Transformation, Eigen::aligned_allocator<Transformation>> f(N), t(N), m(N);
+        for (int l = 0; l < N; ++l)
+        {
+            f[l] = randomTransformation<Transformation>(2);
+            t[l] = randomTransformation<Transformation>(2);
+            m[l] = errors[k + l] * t[l] * f[l].inverse();
+            from.set(l, f[l]);
+            to.set(l, t[l]);
+            measurement.set(l, m[l]);
+            weight(l) = Random::sampleDouble(0.5, 2);
+        }
+
+        typename Batch::Residuals res;
+        typename Batch::PoseJacobiType JrowFrom[N], JrowTo[N];
+        Batch::evaluateResidualAndJacobian(from, to, measurement, weight, res, JrowFrom, JrowTo);
+
+        typename Batch::Residuals resOnly;
+        Batch::evaluateResidual(from, to, measurement, weight, resOnly);
+
+        for (int l = 0; l < N; ++l)
+        {
+            typename Scalar::ResidualType expectedRes;
+            typename Scalar::PoseJacobiType expectedFrom, expectedTo;
+            Scalar::evaluateResidualAndJacobian(f[l], t[l], m[l].inverse(), expectedRes, expectedFrom, expectedTo,
+                                                weight(l));
+
+            auto r = Batch::residual(res, l);
+            EXPECT_LT((r - expectedRes).norm(), 1e-9 * (1 + expectedRes.norm())) << "case " << k + l << "\n"
+                                                                                   << r.transpose() << "\n"
+                                                                                   << expectedRes.transpose();
+            EXPECT_EQ(Batch::residual(resOnly, l), r);
+            EXPECT_LT((JrowFrom[l] - expectedFrom).norm(), 1e-9 * (1 + expectedFrom.norm())) << "case " << k + l;
+            EXPECT_LT((JrowTo[l] - expectedTo).norm(), 1e-9 * (1 + expectedTo.norm())) << "case " << k + l;
+        }
+    }
+}
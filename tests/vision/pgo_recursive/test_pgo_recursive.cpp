@@ -0,0 +1,159 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/math/random.h"
+#include "saiga/vision/kernels/PGO.h"
+#include "saiga/vision/recursive/PGORecursive.h"
+#include "saiga/vision/scene/PoseGraph.h"
+#include "saiga/vision/scene/SynteticScene.h"
+
+#include "gtest/gtest.h"
+
+using namespace Saiga;
+
+static PoseGraph makePoseGraph()
+{
+    Random::setSeed(9235);
+    SynteticScene sscene;
+    sscene.numCameras     = 120;
+    sscene.numWorldPoints = 500;
+    sscene.numImagePoints = 80;
+    PoseGraph pg(sscene.circleSphere(), 5);
+    pg.addNoise(0.05);
+    for (auto& e : pg.edges) e.weight = Random::sampleDouble(0.5, 2);
+    pg.poses[0].constant  = true;
+    pg.poses[17].constant = true;
+    return pg;
+}
+
+// Gives access to the linear system of the recursive solver.
+class PGORecLinearSystem : public PGORec
+{
+   public:
+    PGORecLinearSystem(PoseGraph& pg, int threads)
+    {
+        optimizationOptions.numThreads = threads;
+        create(pg);
+        init();
+        chi2 = computeQuadraticForm();
+        cost = computeCost();
+    }
+
+    // The full symmetric Hessian. Only the upper triangle is stored in S.
+    Eigen::MatrixXd hessian() const
+    {
+        constexpr int B = pgoBlockSizeCamera;
+        Eigen::MatrixXd H(n * B, n * B);
+        H.setZero();
+        for (int i = 0; i < n; ++i)
+        {
+            for (int k = S.outerIndexPtr()[i]; k < S.outerIndexPtr()[i + 1]; ++k)
+            {
+                int j                       = S.innerIndexPtr()[k];
+                H.block<B, B>(i * B, j * B) = S.valuePtr()[k].get();
+                if (i != j) H.block<B, B>(j * B, i * B) = S.valuePtr()[k].get().transpose();
+            }
+        }
+        return H;
+    }
+
+    Eigen::VectorXd gradient() const
+    {
+        constexpr int B = pgoBlockSizeCamera;
+        Eigen::VectorXd g(n * B);
+        for (int i = 0; i < n; ++i) g.segment<B>(i * B) = b(i).get();
+        return g;
+    }
+
+    double chi2, cost;
+};
+
+// Dense serial reference assembled directly from the scalar kernel.
+static void referenceSystem(const PoseGraph& pg, Eigen::MatrixXd& H, Eigen::VectorXd& g, double& chi2)
+{
+    using KernelType = Kernel::PGO<PGOTransformation>;
+    constexpr int B  = PGORec::pgoBlockSizeCamera;
+    int n            = pg.poses.size();
+    H.setZero(n * B, n * B);
+    g.setZero(n * B);
+    chi2 = 0;
+    for (auto& e : pg.edges)
+    {
+        KernelType::ResidualType res;
+        KernelType::PoseJacobiType Ji, Jj;
+        KernelType::evaluateResidualAndJacobian(pg.poses[e.from].se3, pg.poses[e.to].se3, e.meassurement.inverse(), res,
+                                                Ji, Jj, e.weight);
+        if (pg.poses[e.from].constant) Ji.setZero();
+        if (pg.poses[e.to].constant) Jj.setZero();
+        int i = e.from * B;
+        int j = e.to * B;
+        H.block<B, B>(i, i) += Ji.transpose() * Ji;
+        H.block<B, B>(j, j) += Jj.transpose() * Jj;
+        H.block<B, B>(i, j) += Ji.transpose() * Jj;
+        H.block<B, B>(j, i) += Jj.transpose() * Ji;
+        g.segment<B>(i) -= Ji.transpose() * res;
+        g.segment<B>(j) -= Jj.transpose() * res;
+        chi2 += res.squaredNorm();
+    }
+}
+
+TEST(PGORecursive, ParallelAssemblyMatchesSerial)
+{
+    PoseGraph pg = makePoseGraph();
+    // Enough edges to give every thread several blocks
+    ASSERT_GT(pg.edges.size(), 4 * 64 * 2);
+
+    Eigen::MatrixXd Href;
+    Eigen::VectorXd gref;
+    double chi2ref;
+    referenceSystem(pg, Href, gref, chi2ref);
+
+    PGORecLinearSystem serial(pg, 1);
+    Eigen::MatrixXd H1 = serial.hessian();
+    Eigen::VectorXd g1 = serial.gradient();
+
+    EXPECT_LT((H1 - Href).norm(), 1e-10 * Href.norm());
+    EXPECT_LT((g1 - gref).norm(), 1e-10 * gref.norm());
+    EXPECT_NEAR(serial.chi2, chi2ref, 1e-10 * chi2ref);
+
+    for (int threads : {2, 3, 4, 8})
+    {
+        PGORecLinearSystem parallel(pg, threads);
+        Eigen::MatrixXd H = parallel.hessian();
+        Eigen::VectorXd g = parallel.gradient();
+
+        // Only the summation order of the diagonal blocks and the gradient changes with the thread count.
+        EXPECT_LT((H - H1).norm(), 1e-12 * H1.norm()) << threads << " threads";
+        EXPECT_LT((g - g1).norm(), 1e-12 * g1.norm()) << threads << " threads";
+        EXPECT_NEAR(parallel.chi2, serial.chi2, 1e-12 * serial.chi2) << threads << " threads";
+        EXPECT_EQ(parallel.chi2, parallel.cost) << threads << " threads";
+    }
+}
+
+// A full optimization gives the same poses independent of the thread count.
+TEST(PGORecursive, ParallelSolveMatchesSerial)
+{
+    PoseGraph pg1     = makePoseGraph();
+    PoseGraph pg4     = pg1;
+    double chi2Before = pg1.chi2();
+
+    PGORec rec1, rec4;
+    rec1.optimizationOptions.numThreads    = 1;
+    rec4.optimizationOptions.numThreads    = 4;
+    rec1.optimizationOptions.maxIterations = 5;
+    rec4.optimizationOptions.maxIterations = 5;
+    rec1.create(pg1);
+    rec4.create(pg4);
+    rec1.initAndSolve();
+    rec4.initAndSolve();
+
+    EXPECT_LT(pg1.chi2(), chi2Before);
+    EXPECT_NEAR(pg1.chi2(), pg4.chi2(), 1e-8 * pg1.chi2());
+    for (size_t i = 0; i < pg1.poses.size(); ++i)
+    {
+        EXPECT_LT((pg1.poses[i].se3.inverse() * pg4.poses[i].se3).log().norm(), 1e-8) << "pose " << i;
+    }
+}
@@ -0,0 +1,164 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/math/random.h"
+#include "saiga/core/util/file.h"
+#include "saiga/vision/scene/PoseGraph.h"
+#include "saiga/vision/scene/SynteticScene.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+
+using namespace Saiga;
+
+static PoseGraph makePoseGraph(bool noise = true)
+{
+    Random::setSeed(3465);
+    SynteticScene sscene;
+    sscene.numCameras     = 20;
+    sscene.numWorldPoints = 200;
+    sscene.numImagePoints = 50;
+    PoseGraph pg(sscene.circleSphere(), 10);
+    if (noise) pg.addNoise(0.05);
+    return pg;
+}
+
+TEST(PoseGraphIO, G2OFixLine)
+{
+    std::string file = "test_posegraph_fix.g2o";
+    {
+        std::ofstream strm(file);
+        strm << "VERTEX_SE3:QUAT 0 0 0 0 0 0 0 1\n";
+        strm << "VERTEX_SE3:QUAT 1 1 0 0 0 0 0 1\n";
+        strm << "VERTEX_SE3:QUAT 2 2 0 0 0 0 0 1\n";
+        strm << "VERTEX_SE3:QUAT 3 3 0 0 0 0 0 1\n";
+        strm << "EDGE_SE3:QUAT 0 1 1 0 0 0 0 0 1 1 0 0 0 0 0 1 0 0 0 0 1 0 0 0 1 0 0 1 0 1\n";
+        strm << "FIX 0 2\n";
+        strm << "FIX 3\n";
+    }
+
+    PoseGraph pg;
+    ASSERT_TRUE(pg.loadG2O(file));
+    ASSERT_EQ(pg.poses.size(), 4);
+    EXPECT_EQ(pg.edges.size(), 1);
+    EXPECT_TRUE(pg.poses[0].constant);
+    EXPECT_FALSE(pg.poses[1].constant);
+    EXPECT_TRUE(pg.poses[2].constant);
+    EXPECT_TRUE(pg.poses[3].constant);
+    std::remove(file.c_str());
+}
+
+TEST(PoseGraphIO, BinaryRoundTrip)
+{
+    std::string file = "test_posegraph.pgb";
+    PoseGraph pg     = makePoseGraph();
+    pg.saveBinary(file);
+
+    PoseGraph pg2;
+    ASSERT_TRUE(pg2.loadBinary(file));
+    ASSERT_EQ(pg2.poses.size(), pg.poses.size());
+    ASSERT_EQ(pg2.edges.size(), pg.edges.size());
+    for (size_t i = 0; i < pg.poses.size(); ++i)
+    {
+        EXPECT_EQ(pg2.poses[i].se3.params(), pg.poses[i].se3.params());
+        EXPECT_EQ(pg2.poses[i].constant, pg.poses[i].constant);
+    }
+    for (size_t i = 0; i < pg.edges.size(); ++i)
+    {
+        EXPECT_EQ(pg2.edges[i].from, pg.edges[i].from);
+        EXPECT_EQ(pg2.edges[i].to, pg.edges[i].to);
+        EXPECT_EQ(pg2.edges[i].weight, pg.edges[i].weight);
+        EXPECT_EQ(pg2.edges[i].meassurement.params(), pg.edges[i].meassurement.params());
+    }
+    std::remove(file.c_str());
+}
+
+TEST(PoseGraphIO, BinaryRejectsCorruptFiles)
+{
+    std::string file = "test_posegraph_corrupt.pgb";
+    PoseGraph pg     = makePoseGraph();
+    ASSERT_GT(pg.edges.size(), 0);
+
+    // An edge that references a vertex which does not exist
+    pg.edges.back().to = pg.poses.size();
+    pg.saveBinary(file);
+    PoseGraph pg2;
+    EXPECT_FALSE(pg2.loadBinary(file));
+
+    // Truncated file
+    pg = makePoseGraph();
+    pg.saveBinary(file);
+    auto data = File::loadFileBinary(file);
+    data.resize(data.size() - 1);
+    File::saveFileBinary(file, data.data(), data.size());
+    EXPECT_FALSE(pg2.loadBinary(file));
+    std::remove(file.c_str());
+}
+
+static void expectEqual(const PoseGraph& pg, const PoseGraph& pg2)
+{
+    ASSERT_EQ(pg2.poses.size(), pg.poses.size());
+    ASSERT_EQ(pg2.edges.size(), pg.edges.size());
+    for (size_t i = 0; i < pg.poses.size(); ++i)
+    {
+        EXPECT_EQ(pg2.poses[i].se3.params(), pg.poses[i].se3.params());
+        EXPECT_EQ(pg2.poses[i].constant, pg.poses[i].constant);
+    }
+    for (size_t i = 0; i < pg.edges.size(); ++i)
+    {
+        EXPECT_EQ(pg2.edges[i].from, pg.edges[i].from);
+        EXPECT_EQ(pg2.edges[i].to, pg.edges[i].to);
+        EXPECT_EQ(pg2.edges[i].weight, pg.edges[i].weight);
+        EXPECT_EQ(pg2.edges[i].meassurement.params(), pg.edges[i].meassurement.params());
+    }
+}
+
+TEST(PoseGraphIO, TextRoundTrip)
+{
+    std::string file   = "test_posegraph.posegraph";
+    PoseGraph pg       = makePoseGraph();
+    pg.edges[0].weight = 0.1;
+    pg.fixScale        = false;
+    pg.save(file);
+
+    PoseGraph pg2;
+    pg2.load(file);
+    expectEqual(pg, pg2);
+    EXPECT_EQ(pg2.fixScale, pg.fixScale);
+    std::remove(file.c_str());
+}
+
+TEST(PoseGraphIO, G2ORoundTrip)
+{
+    // g2o stores SE3 poses, so the graph is created without the scale noise.
+    std::string file     = "test_posegraph_round_trip.g2o";
+    PoseGraph pg         = makePoseGraph(false);
+    pg.edges[0].weight   = 0.5;
+    pg.poses[3].constant = true;
+    pg.saveG2O(file);
+
+    // The g2o file stores the inverse transformations, so the values are only equal up to rounding.
+    PoseGraph pg2;
+    ASSERT_TRUE(pg2.loadG2O(file));
+    ASSERT_EQ(pg2.poses.size(), pg.poses.size());
+    for (size_t i = 0; i < pg.poses.size(); ++i)
+    {
+        EXPECT_LT((pg2.poses[i].se3.params() - pg.poses[i].se3.params()).norm(), 1e-10);
+        EXPECT_EQ(pg2.poses[i].constant, pg.poses[i].constant);
+    }
+    ASSERT_EQ(pg2.edges.size(), pg.edges.size());
+    for (size_t i = 0; i < pg.edges.size(); ++i)
+    {
+        EXPECT_EQ(pg2.edges[i].from, pg.edges[i].from);
+        EXPECT_EQ(pg2.edges[i].to, pg.edges[i].to);
+        EXPECT_NEAR(pg2.edges[i].weight, pg.edges[i].weight, 1e-12);
+        EXPECT_LT((pg2.edges[i].meassurement.params() - pg.edges[i].meassurement.params()).norm(), 1e-10);
+    }
+    EXPECT_NEAR(pg2.chi2(), pg.chi2(), 1e-10);
+    std::remove(file.c_str());
+}
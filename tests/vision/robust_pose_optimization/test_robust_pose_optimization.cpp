@@ -0,0 +1,109 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/math/random.h"
+#include "saiga/vision/reconstruction/RobustPoseOptimization.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+
+using namespace Saiga;
+
+template <typename T>
+struct RobustPoseProblems
+{
+    using RPO     = RobustPoseOptimization<T>;
+    using Obs     = typename RPO::Obs;
+    using Problem = typename RPO::PoseProblem;
+    using Vec2T   = Eigen::Matrix<T, 2, 1>;
+    using Vec3T   = Eigen::Matrix<T, 3, 1>;
+
+    AlignedVector<Vec3T> wps;
+    AlignedVector<Obs> obs;
+    AlignedVector<StereoCamera4Base<T>> cameras;
+    AlignedVector<Problem> problems;
+
+    // Problems of different sizes with mono and stereo observations and gross outliers.
+    RobustPoseProblems(int numProblems)
+    {
+        Random::setSeed(9812);
+        cameras.push_back(StereoCamera4Base<T>(500, 500, 320, 240, 40));
+        cameras.push_back(StereoCamera4Base<T>(350, 360, 300, 200, 25));
+
+        for (int p = 0; p < numProblems; ++p)
+        {
+            Problem problem;
+            SE3 pose       = SE3::exp(Vec6::Random() * 0.1);
+            problem.camera = p % cameras.size();
+            problem.begin  = wps.size();
+            auto& K        = cameras[problem.camera];
+
+            int n = Random::uniformInt(10, 300);
+            for (int i = 0; i < n; ++i)
+            {
+                Vec3 pv(Random::sampleDouble(-4, 4), Random::sampleDouble(-3, 3), Random::sampleDouble(2, 10));
+                Obs o;
+                o.ip = K.project(pv.cast<T>()) + Vec2T(Random::gaussRand(0, 1), Random::gaussRand(0, 1));
+                if (Random::sampleBool(0.3)) o.depth = pv.z();
+                if (Random::sampleBool(0.15)) o.ip += Vec2T(Random::sampleDouble(-50, 50), 0);
+                o.weight = Random::sampleDouble(0.5, 1.5);
+                wps.push_back((pose.inverse() * pv).cast<T>());
+                obs.push_back(o);
+            }
+            problem.end  = wps.size();
+            problem.pose = (SE3::exp(Vec6::Random() * 0.02) * pose).cast<T>();
+            problems.push_back(problem);
+        }
+    }
+};
+
+template <typename T>
+class RobustPoseOptimizationTest : public ::testing::Test
+{
+};
+using ScalarTypes = ::testing::Types<float, double>;
+TYPED_TEST_SUITE(RobustPoseOptimizationTest, ScalarTypes);
+
+// The batch only distributes the problems over threads. Poses, inliers and outlier flags must be exactly the same
+// as calling optimizePoseRobust on every problem.
+TYPED_TEST(RobustPoseOptimizationTest, BatchMatchesSingle)
+{
+    using T = TypeParam;
+    RobustPoseProblems<T> data(97);
+    typename RobustPoseProblems<T>::RPO rpo = {2.45, 2.8};
+
+    auto expectedProblems = data.problems;
+    AlignedVector<int> expectedOutlier(data.obs.size(), false);
+    int expectedInliers = 0;
+    for (auto& p : expectedProblems)
+    {
+        p.inliers = rpo.optimizePoseRobust(data.wps.data() + p.begin, data.obs.data() + p.begin,
+                                           expectedOutlier.data() + p.begin, p.end - p.begin, p.pose,
+                                           data.cameras[p.camera]);
+        expectedInliers += p.inliers;
+    }
+
+    // Sanity check that the outlier rejection is exercised
+    int numOutliers = std::count(expectedOutlier.begin(), expectedOutlier.end(), true);
+    EXPECT_GT(numOutliers, 0);
+    EXPECT_GT(expectedInliers, numOutliers);
+
+    for (int threads : {1, 2, 4, 7})
+    {
+        auto problems = data.problems;
+        AlignedVector<int> outlier(data.obs.size(), false);
+        int inliers = rpo.optimizePoseRobustBatch(data.wps, data.obs, outlier, data.cameras, problems, threads);
+
+        EXPECT_EQ(inliers, expectedInliers) << threads << " threads";
+        EXPECT_EQ(outlier, expectedOutlier) << threads << " threads";
+        for (size_t p = 0; p < problems.size(); ++p)
+        {
+            EXPECT_EQ(problems[p].inliers, expectedProblems[p].inliers) << "problem " << p;
+            EXPECT_EQ(problems[p].pose.params(), expectedProblems[p].pose.params()) << "problem " << p;
+        }
+    }
+}
@@ -0,0 +1,179 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/math/random.h"
+#include "saiga/vision/scene/Scene.h"
+#include "saiga/vision/scene/SynteticScene.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+
+using namespace Saiga;
+
+static Scene makeScene()
+{
+    Random::setSeed(8236);
+    SynteticScene sscene;
+    sscene.numCameras     = 10;
+    sscene.numWorldPoints = 100;
+    sscene.numImagePoints = 30;
+    return sscene.circleSphere();
+}
+
+// Returns (image, point) of an observation of a world point that is observed at least twice.
+static std::pair<int, int> findObservation(const Scene& scene, int& wpid)
+{
+    for (wpid = 0; wpid < (int)scene.worldPoints.size(); ++wpid)
+    {
+        if (scene.worldPoints[wpid].stereoreferences.size() >= 2) return scene.worldPoints[wpid].stereoreferences[0];
+    }
+    return {-1, -1};
+}
+
+TEST(Scene, Valid)
+{
+    Scene scene = makeScene();
+    EXPECT_TRUE(scene.valid());
+
+    // Outliers are referenced but not counted as observations.
+    scene.images[0].stereoPoints[0].outlier = true;
+    EXPECT_TRUE(scene.valid());
+}
+
+TEST(Scene, MissingReference)
+{
+    Scene scene = makeScene();
+    int wpid;
+    auto [img, ip] = findObservation(scene, wpid);
+    ASSERT_GE(img, 0);
+
+    scene.worldPoints[wpid].removeStereoReference(img, ip);
+    EXPECT_FALSE(scene.valid());
+
+    scene.fixWorldPointReferences();
+    EXPECT_TRUE(scene.valid());
+}
+
+TEST(Scene, DuplicateReference)
+{
+    Scene scene = makeScene();
+    int wpid;
+    auto ref = findObservation(scene, wpid);
+    ASSERT_GE(ref.first, 0);
+
+    scene.worldPoints[wpid].stereoreferences.push_back(ref);
+    EXPECT_FALSE(scene.valid());
+}
+
+TEST(Scene, WrongReference)
+{
+    Scene scene = makeScene();
+    int wpid;
+    auto [img, ip] = findObservation(scene, wpid);
+    ASSERT_GE(img, 0);
+
+    // The reference points to another observation of the same image. The image is still referenced, but the
+    // observation is not.
+    auto& points = scene.images[img].stereoPoints;
+    int other    = ip == 0 ? 1 : 0;
+    ASSERT_NE(points[other].wp, wpid);
+    for (auto& r : scene.worldPoints[wpid].stereoreferences)
+    {
+        if (r == std::make_pair(img, ip)) r.second = other;
+    }
+    EXPECT_FALSE(scene.valid());
+
+    // Out of range
+    scene.fixWorldPointReferences();
+    scene.worldPoints[wpid].stereoreferences[0].second = points.size();
+    EXPECT_FALSE(scene.valid());
+}
+
+// An invalid point before valid ones must not shift the image point ids.
+TEST(Scene, RemoveCamera)
+{
+    Scene scene  = makeScene();
+    auto& points = scene.images[0].stereoPoints;
+    ASSERT_GE(points.size(), 3);
+    points[0].wp = -1;
+    scene.fixWorldPointReferences();
+    ASSERT_TRUE(scene.valid());
+
+    scene.removeCamera(0);
+    EXPECT_TRUE(scene.valid());
+    EXPECT_FALSE(scene.images[0]);
+    for (auto& ip : points) EXPECT_EQ(ip.wp, -1);
+    for (auto& wp : scene.worldPoints)
+    {
+        EXPECT_FALSE(wp.isReferencedByStereoFrame(0));
+    }
+}
+
+TEST(Scene, SaveLoad)
+{
+    Scene scene = makeScene();
+    scene.addWorldPointNoise(0.1);
+    scene.addImagePointNoise(1.5);
+    scene.addExtrinsicNoise(0.05);
+    scene.extrinsics[0].constant = true;
+    scene.images[1].imageWeight  = 0.3;
+    scene.bf                     = 1.0 / 3;
+    scene.globalScale            = 0.7;
+
+    std::string file = "test_scene_save_load.scene";
+    scene.save(file);
+    Scene scene2;
+    scene2.load(file);
+    std::remove(file.c_str());
+
+    // All numbers are read back bit-exactly
+    EXPECT_EQ(scene2.bf, scene.bf);
+    EXPECT_EQ(scene2.globalScale, scene.globalScale);
+    ASSERT_EQ(scene2.intrinsics.size(), scene.intrinsics.size());
+    for (size_t i = 0; i < scene.intrinsics.size(); ++i)
+    {
+        EXPECT_EQ(scene2.intrinsics[i].coeffs(), scene.intrinsics[i].coeffs());
+    }
+    ASSERT_EQ(scene2.extrinsics.size(), scene.extrinsics.size());
+    for (size_t i = 0; i < scene.extrinsics.size(); ++i)
+    {
+        EXPECT_EQ(scene2.extrinsics[i].se3.params(), scene.extrinsics[i].se3.params());
+        EXPECT_EQ(scene2.extrinsics[i].constant, scene.extrinsics[i].constant);
+    }
+    ASSERT_EQ(scene2.images.size(), scene.images.size());
+    for (size_t i = 0; i < scene.images.size(); ++i)
+    {
+        auto& img  = scene.images[i];
+        auto& img2 = scene2.images[i];
+        EXPECT_EQ(img2.intr, img.intr);
+        EXPECT_EQ(img2.extr, img.extr);
+        EXPECT_EQ(img2.imageWeight, img.imageWeight);
+        ASSERT_EQ(img2.stereoPoints.size(), img.stereoPoints.size());
+        for (size_t j = 0; j < img.stereoPoints.size(); ++j)
+        {
+            auto& ip  = img.stereoPoints[j];
+            auto& ip2 = img2.stereoPoints[j];
+            EXPECT_EQ(ip2.wp, ip.wp);
+            EXPECT_EQ(ip2.depth, ip.depth);
+            EXPECT_EQ(ip2.point, ip.point);
+            EXPECT_EQ(ip2.weight, ip.weight);
+        }
+    }
+    ASSERT_EQ(scene2.worldPoints.size(), scene.worldPoints.size());
+    for (size_t i = 0; i < scene.worldPoints.size(); ++i)
+    {
+        auto& wp  = scene.worldPoints[i];
+        auto& wp2 = scene2.worldPoints[i];
+        EXPECT_EQ(wp2.p, wp.p);
+        auto refs  = wp.stereoreferences;
+        auto refs2 = wp2.stereoreferences;
+        std::sort(refs.begin(), refs.end());
+        std::sort(refs2.begin(), refs2.end());
+        EXPECT_EQ(refs2, refs);
+    }
+    EXPECT_EQ(scene2.rms(), scene.rms());
+}
@@ -0,0 +1,133 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/image/templatedImage.h"
+#include "saiga/core/util/file.h"
+#include "saiga/vision/camera/SharedFrame.h"
+#include "saiga/vision/camera/TumRGBDCamera.h"
+
+#include "gtest/gtest.h"
+
+#include <filesystem>
+#include <fstream>
+
+using namespace Saiga;
+
+static const int h = 12, w = 16;
+
+// A TUM dataset with 'n' small frames.
+static std::string makeDataset(int n)
+{
+    std::string dir = "test_shared_frame_dataset";
+    std::filesystem::create_directories(dir);
+
+    std::ofstream rgb(dir + "/rgb.txt"), depth(dir + "/depth.txt"), gt(dir + "/groundtruth.txt");
+    // The timestamp matcher ignores the first depth image
+    depth << 0.5 << " depth_0.png\n";
+    for (int i = 0; i < n; ++i)
+    {
+        TemplatedImage<ucvec3> cimg(h, w);
+        TemplatedImage<unsigned short> dimg(h, w);
+        for (int y = 0; y < h; ++y)
+        {
+            for (int x = 0; x < w; ++x)
+            {
+                cimg(y, x) = ucvec3(x, y, i);
+                dimg(y, x) = 5000 + 100 * i + x;
+            }
+        }
+        auto name = std::to_string(i) + ".png";
+        EXPECT_TRUE(cimg.save(dir + "/rgb_" + name));
+        EXPECT_TRUE(dimg.save(dir + "/depth_" + name));
+
+        double t = 1 + i * 0.1;
+        rgb << t << " rgb_" << name << "\n";
+        depth << t + 0.01 << " depth_" << name << "\n";
+    }
+    gt << 0 << " 0 0 0 0 0 0 1\n";
+    gt << 10 << " 0 0 0 0 0 0 1\n";
+    return dir;
+}
+
+TEST(SharedFrame, DecodeOnce)
+{
+    auto dir = makeDataset(1);
+    RGBDFrameFactory factory(5000);
+
+    FrameMetaData meta;
+    meta.id    = 3;
+    auto frame = factory.createFromFiles(meta, dir + "/rgb_0.png", dir + "/depth_0.png");
+    EXPECT_FALSE(frame->colorDecoded());
+    EXPECT_FALSE(frame->depthDecoded());
+
+    auto& c = frame->color();
+    EXPECT_TRUE(frame->colorDecoded());
+    EXPECT_FALSE(frame->depthDecoded());
+    EXPECT_EQ(&c, &frame->color());
+    EXPECT_EQ(c.h, h);
+    EXPECT_EQ(c.w, w);
+    EXPECT_EQ(c.getConstImageView()(5, 7), ucvec4(7, 5, 0, 255));
+    EXPECT_FLOAT_EQ(frame->depth().getConstImageView()(5, 7), (5000 + 7) / 5000.0);
+
+    auto data = frame->toFrameData();
+    EXPECT_EQ(data.id, 3);
+    EXPECT_EQ(data.colorImg(5, 7), ucvec4(7, 5, 0, 255));
+    EXPECT_FLOAT_EQ(data.depthImg(5, 7), frame->depth().getConstImageView()(5, 7));
+}
+
+TEST(SharedFrame, BuffersReturnToPool)
+{
+    auto dir = makeDataset(1);
+    RGBDFrameFactory factory(5000);
+
+    for (int i = 0; i < 5; ++i)
+    {
+        auto frame = factory.createFromFiles(FrameMetaData(), dir + "/rgb_0.png", dir + "/depth_0.png");
+        frame->color();
+        frame->depth();
+        EXPECT_EQ(factory.colorBuffers().numFree(), 0);
+        EXPECT_EQ(factory.depthBuffers().numFree(), 0);
+    }
+
+    // Each record has returned its images and the next one reused them.
+    EXPECT_EQ(factory.colorBuffers().numFree(), 1);
+    EXPECT_EQ(factory.depthBuffers().numFree(), 1);
+    EXPECT_EQ(factory.colorBuffers().numAllocations(), 1);
+    EXPECT_EQ(factory.depthBuffers().numAllocations(), 1);
+}
+
+TEST(SharedFrame, CameraHandsOffFrames)
+{
+    DatasetParameters params;
+    params.dir               = makeDataset(3);
+    params.fps               = 1000;
+    params.multiThreadedLoad = false;
+    params.lazyDecode        = true;
+    TumRGBDCamera camera(params, RGBDIntrinsics());
+
+    SharedRGBDFrame frame;
+    for (int i = 0; i < 2; ++i)
+    {
+        ASSERT_TRUE(camera.getSharedFrameSync(frame));
+        EXPECT_EQ(frame->id, i);
+        EXPECT_EQ(frame->color().getConstImageView()(0, 1), ucvec4(1, 0, i, 255));
+
+        // The camera does not keep a reference, so releasing the frame frees the decoded images.
+        EXPECT_EQ(frame.use_count(), 1);
+        std::weak_ptr<const RGBDFrameRecord> weak = frame;
+        frame.reset();
+        EXPECT_TRUE(weak.expired());
+    }
+
+    // The classic interface decodes a copy and releases the record as well.
+    RGBDFrameData data;
+    ASSERT_TRUE(camera.getImageSync(data));
+    EXPECT_EQ(data.id, 2);
+    EXPECT_EQ(data.colorImg(0, 1), ucvec4(1, 0, 2, 255));
+    EXPECT_FLOAT_EQ(data.depthImg(0, 1), (5000 + 200 + 1) / 5000.0);
+
+    EXPECT_FALSE(camera.getSharedFrameSync(frame));
+}
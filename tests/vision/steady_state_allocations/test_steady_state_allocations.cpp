@@ -0,0 +1,175 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/math/random.h"
+#include "saiga/vision/reconstruction/FivePoint.h"
+#include "saiga/vision/util/Features.h"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Replaces the global operator new of this test binary and counts all calls from all threads.
+// The arena blocks are allocated with aligned_malloc. They are counted by MonotonicArena::blockAllocations().
+static std::atomic<size_t> newCalls{0};
+
+static void* countedNew(size_t size, size_t alignment)
+{
+    newCalls++;
+    size      = size ? size : 1;
+    void* ptr = nullptr;
+    if (alignment <= alignof(std::max_align_t))
+        ptr = std::malloc(size);
+    else if (posix_memalign(&ptr, alignment, size) != 0)
+        ptr = nullptr;
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new(size_t size)
+{
+    return countedNew(size, alignof(std::max_align_t));
+}
+void* operator new[](size_t size)
+{
+    return countedNew(size, alignof(std::max_align_t));
+}
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    return countedNew(size, static_cast<size_t>(alignment));
+}
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+    return countedNew(size, static_cast<size_t>(alignment));
+}
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+void operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+void operator delete[](void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+void operator delete[](void* ptr, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+using namespace Saiga;
+
+struct AllocationCounter
+{
+    size_t news   = newCalls;
+    size_t blocks = MonotonicArena::blockAllocations();
+
+    size_t newAllocations() const { return newCalls - news; }
+    size_t blockAllocations() const { return MonotonicArena::blockAllocations() - blocks; }
+};
+
+TEST(SteadyStateAllocations, CounterWorks)
+{
+    AllocationCounter counter;
+    auto ptr = std::make_unique<std::array<char, 100>>();
+    std::vector<int> v(10);
+    EXPECT_EQ(counter.newAllocations(), 2);
+    EXPECT_EQ(counter.blockAllocations(), 0);
+}
+
+TEST(SteadyStateAllocations, FivePointRansac)
+{
+    Random::setSeed(9283);
+    AlignedVector<Vec2> points1, points2;
+    SE3 T = SE3::exp((Vec6() << 0.5, 0.1, 0, 0.02, 0.05, -0.01).finished());
+    for (int i = 0; i < 200; ++i)
+    {
+        Vec3 p(Random::sampleDouble(-2, 2), Random::sampleDouble(-2, 2), Random::sampleDouble(4, 8));
+        Vec3 q = T * p;
+        points1.push_back(p.head<2>() / p.z());
+        points2.push_back(q.head<2>() / q.z());
+    }
+
+    RansacParameters params;
+    params.maxIterations     = 50;
+    params.residualThreshold = 1e-6;
+    params.reserveN          = 200;
+    FivePointRansac ransac(params);
+
+    Mat3 E;
+    SE3 rel;
+    std::vector<int> inliers;
+    std::vector<char> mask;
+    int results[5];
+
+    // Warm up the thread arenas, the OpenMP threads and the output vectors.
+    ransac.solve(points1, points2, E, rel, inliers, mask);
+    ransac.solve(points1, points2, E, rel, inliers, mask);
+
+    AllocationCounter counter;
+    for (auto& r : results) r = ransac.solve(points1, points2, E, rel, inliers, mask);
+    EXPECT_EQ(counter.newAllocations(), 0);
+    EXPECT_EQ(counter.blockAllocations(), 0);
+
+    for (auto r : results) EXPECT_EQ(r, 200);
+}
+
+TEST(SteadyStateAllocations, Matchers)
+{
+    Random::setSeed(2371);
+    auto randomDescriptors = [](int n) {
+        std::vector<DescriptorORB> descriptors(n);
+        for (auto& d : descriptors)
+            for (auto& x : d) x = Random::urand64();
+        return descriptors;
+    };
+    auto d1 = randomDescriptors(300);
+    auto d2 = randomDescriptors(400);
+
+    BruteForceMatcher<DescriptorORB> matcher;
+    MeanMatcher<DescriptorORB> meanMatcher;
+    int matches[5], best[5];
+
+    auto frame = [&](int i) {
+        matcher.matchKnn2(d1.begin(), d1.size(), d2.begin(), d2.size());
+        matches[i] = matcher.filterMatches(100, 0.9);
+        best[i]    = meanMatcher.bestDescriptorFromArray(d1);
+    };
+
+    frame(0);
+    frame(0);
+
+    AllocationCounter counter;
+    for (int i = 0; i < 5; ++i) frame(i);
+    EXPECT_EQ(counter.newAllocations(), 0);
+    EXPECT_EQ(counter.blockAllocations(), 0);
+
+    for (int i = 1; i < 5; ++i)
+    {
+        EXPECT_EQ(matches[i], matches[0]);
+        EXPECT_EQ(best[i], best[0]);
+    }
+}
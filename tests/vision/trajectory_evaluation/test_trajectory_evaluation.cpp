@@ -0,0 +1,200 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/math/random.h"
+#include "saiga/vision/slam/TrajectoryEvaluation.h"
+#include "saiga/vision/util/Random.h"
+
+#include "gtest/gtest.h"
+
+#include <filesystem>
+#include <fstream>
+
+using namespace Saiga;
+using namespace Saiga::Trajectory;
+
+using Pairs = std::vector<std::pair<int, int>>;
+
+// A random walk with smooth rotations, sampled at 30 Hz.
+static TrajectorySoA makeTrajectory(int n)
+{
+    TrajectorySoA t;
+    SE3 pose;
+    for (int i = 0; i < n; ++i)
+    {
+        t.push_back(i / 30.0, pose);
+        Vec3 dt = Vec3(0.05, 0, 0) + Random::gaussRandMatrix<Vec3>(0, 0.01);
+        Vec3 dr = Random::gaussRandMatrix<Vec3>(0, 0.02);
+        pose    = pose * SE3(Sophus::SO3d::exp(dr), dt);
+    }
+    return t;
+}
+
+TEST(TrajectoryEvaluation, Associate)
+{
+    std::vector<double> A = {0, 1, 2, 3};
+    std::vector<double> B = {0, 1.005, 2.5, 3.01};
+    EXPECT_EQ(associate(A, B, 0.02), (Pairs{{0, 0}, {1, 1}, {3, 3}}));
+    EXPECT_EQ(associate(A, B, 0.001), (Pairs{{0, 0}}));
+    EXPECT_EQ(associate(A, {}, 0.02), Pairs());
+    EXPECT_EQ(associate({}, B, 0.02), Pairs());
+}
+
+TEST(TrajectoryEvaluation, AssociateBorders)
+{
+    // Exactly at the first timestamp of B, before the first and after the last one
+    std::vector<double> B = {1, 2, 3};
+    EXPECT_EQ(associate({1}, B, 0.02), (Pairs{{0, 0}}));
+    EXPECT_EQ(associate({0.99}, B, 0.02), (Pairs{{0, 0}}));
+    EXPECT_EQ(associate({3}, B, 0.02), (Pairs{{0, 2}}));
+    EXPECT_EQ(associate({3.01}, B, 0.02), (Pairs{{0, 2}}));
+    EXPECT_EQ(associate({3.05}, B, 0.02), Pairs());
+    EXPECT_EQ(associate({0.9}, B, 0.02), Pairs());
+
+    // Single element
+    EXPECT_EQ(associate({5}, {5.01}, 0.02), (Pairs{{0, 0}}));
+}
+
+TEST(TrajectoryEvaluation, AssociateOneToOne)
+{
+    // Both timestamps of A are closest to B[1]. The closer one gets it, the other one falls back to B[0].
+    std::vector<double> A = {1.0, 1.0008};
+    std::vector<double> B = {0.995, 1.0005};
+    EXPECT_EQ(associate(A, B, 0.01), (Pairs{{0, 0}, {1, 1}}));
+
+    // Without a second candidate only one of them is matched.
+    EXPECT_EQ(associate(A, {1.0005}, 0.01), (Pairs{{1, 0}}));
+
+    // Many estimates for one ground truth pose
+    EXPECT_EQ(associate({0.99, 0.995, 1.0, 1.005}, {1.0}, 0.02), (Pairs{{2, 0}}));
+}
+
+TEST(TrajectoryEvaluation, AlignUmeyama)
+{
+    Random::setSeed(923);
+    TrajectorySoA src, ref;
+    SE3 T    = Random::randomSE3();
+    double s = 2.5;
+    for (int i = 0; i < 100; ++i)
+    {
+        Vec3 p = Random::gaussRandMatrix<Vec3>(0, 3);
+        src.push_back(i, SE3(Quat::Identity(), p));
+        ref.push_back(i, SE3(Quat::Identity(), s * (T.so3() * p) + T.translation()));
+    }
+
+    auto [T2, s2] = alignUmeyama(src, ref, true);
+    EXPECT_NEAR(s2, s, 1e-10);
+    EXPECT_LT((T2.matrix() - T.matrix()).norm(), 1e-10);
+
+    // SE3: the data has no scale
+    TrajectorySoA ref2;
+    for (int i = 0; i < src.size(); ++i) ref2.push_back(i, SE3(Quat::Identity(), T * src.position(i)));
+    auto [T3, s3] = alignUmeyama(src, ref2, false);
+    EXPECT_EQ(s3, 1);
+    EXPECT_LT((T3.matrix() - T.matrix()).norm(), 1e-10);
+}
+
+TEST(TrajectoryEvaluation, KnownOffset)
+{
+    Random::setSeed(4386);
+    TrajectorySoA gt = makeTrajectory(500);
+
+    // The estimate is shifted by a constant vector in world space and slightly in time.
+    Vec3 offset(0.1, -0.2, 0.05);
+    TrajectorySoA estimate;
+    for (int i = 0; i < gt.size(); ++i)
+    {
+        estimate.push_back(gt.timestamps[i] + 0.005, SE3(Quat::Identity(), offset) * gt.pose(i));
+    }
+
+    TrajectoryEvaluationSettings settings;
+    settings.align     = false;
+    settings.rpeDeltas = {1, 10};
+    auto result        = evaluate(estimate, gt, settings);
+    EXPECT_EQ(result.associated, 500);
+    EXPECT_NEAR(result.ate.mean, offset.norm(), 1e-10);
+    EXPECT_NEAR(result.ate.max, offset.norm(), 1e-10);
+    ASSERT_EQ(result.rpeTranslation.size(), 2);
+    EXPECT_EQ(result.rpeTranslation[0].numValues, 499);
+    EXPECT_EQ(result.rpeTranslation[1].numValues, 490);
+    // A world space offset does not change the relative poses
+    EXPECT_LT(result.rpeTranslation[1].max, 1e-10);
+    EXPECT_LT(result.rpeRotation[1].max, 1e-6);
+
+    // The alignment removes the offset
+    settings.align = true;
+    result         = evaluate(estimate, gt, settings);
+    EXPECT_LT(result.ate.max, 1e-10);
+    EXPECT_LT((result.alignment.translation() + offset).norm(), 1e-10);
+}
+
+TEST(TrajectoryEvaluation, Noise)
+{
+    Random::setSeed(782);
+    TrajectorySoA gt = makeTrajectory(5000);
+
+    double sigma = 0.01;
+    TrajectorySoA estimate;
+    for (int i = 0; i < gt.size(); ++i)
+    {
+        SE3 p = gt.pose(i);
+        p.translation() += Random::gaussRandMatrix<Vec3>(0, sigma);
+        estimate.push_back(gt.timestamps[i], p);
+    }
+
+    TrajectoryEvaluationSettings settings;
+    settings.align     = false;
+    settings.rpeDeltas = {1};
+    auto result        = evaluate(estimate, gt, settings);
+
+    // The rms of a 3D gaussian with stddev sigma is sqrt(3) * sigma.
+    EXPECT_NEAR(result.ate.rms(), std::sqrt(3.0) * sigma, 0.05 * sigma);
+    // The relative translation contains the noise of two poses.
+    EXPECT_NEAR(result.rpeTranslation[0].rms(), std::sqrt(6.0) * sigma, 0.1 * sigma);
+    EXPECT_LT(result.rpeRotation[0].max, 1e-6);
+}
+
+TEST(TrajectoryEvaluationDeathTest, InvalidDelta)
+{
+    TrajectorySoA gt = makeTrajectory(10);
+    TrajectoryEvaluationSettings settings;
+    settings.rpeDeltas = {1, 0};
+    EXPECT_DEATH(evaluate(gt, gt, settings), "");
+    settings.rpeDeltas = {-1};
+    EXPECT_DEATH(evaluate(gt, gt, settings), "");
+}
+
+TEST(TrajectoryEvaluation, LoadTUM)
+{
+    auto dir = std::filesystem::temp_directory_path() / "saiga_test_trajectory_evaluation";
+    std::filesystem::create_directories(dir);
+    auto file = (dir / "trajectory.txt").string();
+
+    Random::setSeed(21);
+    TrajectorySoA t = makeTrajectory(20);
+    ASSERT_TRUE(t.saveTUM(file));
+    TrajectorySoA t2;
+    ASSERT_TRUE(t2.loadTUM(file));
+    ASSERT_EQ(t2.size(), t.size());
+    for (int i = 0; i < t.size(); ++i)
+    {
+        EXPECT_EQ(t2.timestamps[i], t.timestamps[i]);
+        EXPECT_LT((t2.pose(i).matrix() - t.pose(i).matrix()).norm(), 1e-12);
+    }
+
+    // A parse error after some valid lines leaves an empty trajectory
+    {
+        std::ofstream strm(file);
+        strm << "# comment\n";
+        strm << "1 0 0 0 0 0 0 1\n";
+        strm << "2 0 0 0 0 0 0 1\n";
+        strm << "3 0 0 x 0 0 0 1\n";
+    }
+    EXPECT_FALSE(t2.loadTUM(file));
+    EXPECT_EQ(t2.size(), 0);
+    EXPECT_EQ(t2.qw.size(), 0);
+    std::filesystem::remove_all(dir);
+}
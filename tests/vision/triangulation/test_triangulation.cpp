@@ -0,0 +1,66 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/math/random.h"
+#include "saiga/vision/reconstruction/TriangulationBatch.h"
+#include "saiga/vision/scene/Scene.h"
+#include "saiga/vision/scene/SynteticScene.h"
+
+#include "gtest/gtest.h"
+
+using namespace Saiga;
+
+// The synthetic scene has exact observations, so the points can be recovered.
+static Scene makeScene()
+{
+    Random::setSeed(9234);
+    SynteticScene sscene;
+    return sscene.circleSphere(500, 10, 100);
+}
+
+TEST(TriangulationBatch, Scene)
+{
+    Scene scene = makeScene();
+    AlignedVector<Vec3> reference;
+    for (auto& wp : scene.worldPoints) reference.push_back(wp.p);
+    for (auto& wp : scene.worldPoints) wp.p = Vec3::Zero();
+
+    int numValid = 0;
+    for (auto& wp : scene.worldPoints) numValid += wp.stereoreferences.size() >= 2;
+    ASSERT_GT(numValid, 100);
+
+    TriangulationBatch triangulation;
+    EXPECT_EQ(triangulation.triangulate(scene), numValid);
+    for (int i = 0; i < (int)scene.worldPoints.size(); ++i)
+    {
+        auto& wp = scene.worldPoints[i];
+        if (!wp) continue;
+        EXPECT_NEAR((wp.p - reference[i]).norm(), 0, 1e-6);
+    }
+    EXPECT_TRUE(scene.valid());
+}
+
+TEST(TriangulationBatch, RejectedPointsAreRemoved)
+{
+    Scene scene = makeScene();
+
+    // No pair of rays has an angle of 179 degrees, so every point is rejected.
+    TriangulationBatchSettings settings;
+    settings.minAngle = pi<double>() * 179.0 / 180.0;
+    TriangulationBatch triangulation(settings);
+    EXPECT_EQ(triangulation.triangulate(scene), 0);
+
+    for (auto& wp : scene.worldPoints)
+    {
+        EXPECT_FALSE(wp);
+        EXPECT_TRUE(wp.stereoreferences.empty());
+    }
+    for (auto& img : scene.images)
+    {
+        for (auto& ip : img.stereoPoints) EXPECT_EQ(ip.wp, -1);
+    }
+    EXPECT_TRUE(scene.valid());
+}
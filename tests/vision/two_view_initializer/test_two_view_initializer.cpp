@@ -0,0 +1,156 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/core/math/random.h"
+#include "saiga/vision/reconstruction/TwoViewInitializer.h"
+
+#include "gtest/gtest.h"
+
+#include <future>
+
+using namespace Saiga;
+
+// Matches in normalized image space of two cameras with the relative pose T (first camera to second camera).
+// The last outlierCount matches are random.
+struct TwoViewData
+{
+    AlignedVector<Vec2> points1, points2;
+    SE3 T;
+
+    TwoViewData(const SE3& T, int n, int outlierCount) : T(T)
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            Vec3 p(Random::sampleDouble(-2, 2), Random::sampleDouble(-2, 2), Random::sampleDouble(4, 8));
+            Vec3 q = T * p;
+            points1.push_back(p.head<2>() / p.z());
+            points2.push_back(q.head<2>() / q.z());
+            if (i >= n - outlierCount)
+            {
+                points2.back() = Vec2(Random::sampleDouble(-0.5, 0.5), Random::sampleDouble(-0.5, 0.5));
+            }
+        }
+    }
+
+    TwoViewCandidate candidate() const { return {points1, points2}; }
+};
+
+static TwoViewInitializerSettings makeSettings()
+{
+    TwoViewInitializerSettings settings;
+    settings.ransacParams.maxIterations     = 200;
+    settings.ransacParams.residualThreshold = 1e-6;
+    settings.ransacParams.reserveN          = 300;
+    settings.minInliers                     = 100;
+    return settings;
+}
+
+TEST(TwoViewInitializer, FivePointRansacCancel)
+{
+    Random::setSeed(3580);
+    TwoViewData data(SE3::exp((Vec6() << 0.5, 0, 0, 0.02, 0.05, -0.01).finished()), 300, 50);
+
+    auto params = makeSettings().ransacParams;
+    Mat3 E;
+    SE3 rel;
+    std::vector<int> inliers;
+    std::vector<char> mask;
+
+    std::atomic<int> calls = {0};
+    params.cancel          = [&]() {
+        calls++;
+        return false;
+    };
+    FivePointRansac ransac(params);
+    EXPECT_GE(ransac.solve(data.points1, data.points2, E, rel, inliers, mask), 250);
+    // The hook is checked before every iteration.
+    EXPECT_EQ(calls, params.maxIterations);
+
+    // Cancelled before the first iteration: no model is evaluated.
+    params.cancel = []() { return true; };
+    ransac.init(params);
+    EXPECT_EQ(ransac.solve(data.points1, data.points2, E, rel, inliers, mask), 0);
+    EXPECT_TRUE(inliers.empty());
+}
+
+TEST(TwoViewInitializer, PriorityOrder)
+{
+    Random::setSeed(7854);
+    SE3 T = SE3::exp((Vec6() << 0.5, 0.1, 0, 0.02, 0.05, -0.01).finished());
+
+    // 0: Pure rotation, rejected by the median angle
+    // 1: Accepted
+    // 2: Also good, but has a lower priority than 1
+    TwoViewData rotation(SE3(T.so3(), Vec3::Zero()), 300, 30);
+    TwoViewData good(T, 300, 50);
+    TwoViewData good2(T, 300, 10);
+
+    ThreadPool pool(2);
+    TwoViewInitializer initializer(makeSettings(), &pool);
+    auto handle = initializer.start({rotation.candidate(), good.candidate(), good2.candidate()});
+    auto result = handle.get();
+    EXPECT_TRUE(handle.ready());
+
+    ASSERT_TRUE(result);
+    EXPECT_EQ(result.candidate, 1);
+    EXPECT_GE(result.inliers, 240);
+    EXPECT_GE(result.medianAngle, makeSettings().minMedianAngle);
+
+    // The relative pose is recovered up to the scale of the translation.
+    SE3 rel = result.reconstruction->pose2();
+    EXPECT_LT((rel.so3().inverse() * T.so3()).log().norm(), 1e-4);
+    EXPECT_GT(rel.translation().normalized().dot(T.translation().normalized()), 0.9999);
+}
+
+TEST(TwoViewInitializer, Cancel)
+{
+    Random::setSeed(2384);
+    TwoViewData good(SE3::exp((Vec6() << 0.5, 0, 0, 0.02, 0.05, -0.01).finished()), 300, 50);
+
+    // Block the only worker, so the candidates are cancelled before they start.
+    ThreadPool pool(1);
+    std::promise<void> unblock;
+    auto blocker = pool.enqueue([f = unblock.get_future().share()]() { f.wait(); });
+
+    TwoViewInitializer initializer(makeSettings(), &pool);
+    auto handle = initializer.start({good.candidate(), good.candidate()});
+    EXPECT_FALSE(handle.ready());
+    handle.cancel();
+    unblock.set_value();
+
+    auto result = handle.get();
+    EXPECT_FALSE(result);
+    EXPECT_EQ(result.candidate, -1);
+}
+
+TEST(TwoViewInitializer, EmptyHandle)
+{
+    TwoViewInitialization handle;
+    EXPECT_FALSE(handle.valid());
+    handle.cancel();
+
+    Random::setSeed(2384);
+    TwoViewData good(SE3::exp((Vec6() << 0.5, 0, 0, 0.02, 0.05, -0.01).finished()), 300, 50);
+    ThreadPool pool(1);
+    TwoViewInitializer initializer(makeSettings(), &pool);
+    handle = initializer.start({good.candidate()});
+    EXPECT_TRUE(handle.valid());
+
+    TwoViewInitialization other = std::move(handle);
+    EXPECT_FALSE(handle.valid());
+    EXPECT_TRUE(other.get());
+}
+
+#ifdef SAIGA_ASSERTS
+TEST(TwoViewInitializerDeathTest, EmptyHandle)
+{
+    ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+    TwoViewInitialization handle;
+    EXPECT_DEATH(handle.ready(), "");
+    EXPECT_DEATH(handle.get(), "");
+    EXPECT_DEATH(handle.wait_for(std::chrono::milliseconds(1)), "");
+}
+#endif